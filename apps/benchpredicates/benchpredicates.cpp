@@ -0,0 +1,117 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/logger.h"
+#include "volmesh/predicates.h"
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+#include <fmt/core.h>
+#include <cxxopts.hpp>
+
+using namespace volmesh;
+
+/**
+ * @brief Creates the points of a workload inside the unit cube.
+ *
+ * Random points are in general position, grid points are often coplanar and cospherical, and
+ * perturbed grid points are nearly so.
+ */
+static std::vector<vec3> CreateWorkload(const std::string& name, uint64_t count, uint32_t seed) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<real_t> distribution(0.0, 1.0);
+  std::uniform_int_distribution<int> grid(0, 15);
+
+  std::vector<vec3> points(count);
+  for (vec3& p : points) {
+    if (name == "random") {
+      p = vec3(distribution(generator), distribution(generator), distribution(generator));
+    } else {
+      p = vec3(grid(generator), grid(generator), grid(generator)) / 15.0;
+      if (name == "perturbed") {
+        p += vec3(distribution(generator), distribution(generator), distribution(generator)) * 1e-12;
+      }
+    }
+  }
+  return points;
+}
+
+/**
+ * @brief Evaluates a predicate on consecutive points and prints the time per call and the stage counts.
+ */
+static void Measure(const std::string& workload, const std::string& predicate, const std::vector<vec3>& points, int arity,
+                    const std::function<int(const vec3* p, PredicateStatistics* inout_stats)>& fn) {
+  PredicateStatistics stats;
+  int64_t sum = 0;
+  const auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i + arity <= points.size(); i++) {
+    sum += fn(&points[i], &stats);
+  }
+  const auto end = std::chrono::steady_clock::now();
+
+  const real_t count = static_cast<real_t>(std::max<uint64_t>(stats.count(), 1));
+  const real_t nanoseconds = static_cast<real_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+  fmt::print("{:<10} {:<24} {:>10} {:>8.1f} {:>8.2f}% {:>8.2f}% {:>8.2f}% {:>8.2f}% {:>8.4f}% (sum {})\n",
+             workload, predicate, stats.count(), nanoseconds / count,
+             100.0 * stats.count_static / count, 100.0 * stats.count_semi_static / count,
+             100.0 * stats.count_dynamic / count, 100.0 * stats.count_exact / count,
+             100.0 * stats.filterHitRate(), sum);
+}
+
+int main(int argc, const char* argv[]) {
+  SetLogFormat();
+
+  cxxopts::Options options("benchpredicates", "Measure the filter hit rate and the cost of the exact geometric predicates.");
+
+  options.add_options()
+    ("n,count", "Number of points per workload", cxxopts::value<uint64_t>()->default_value("1000000"))
+    ("s,seed", "Seed of the random points", cxxopts::value<uint32_t>()->default_value("1"))
+    ("h,help", "Print usage")
+  ;
+
+  auto args = options.parse(argc, argv);
+
+  if (args.count("help")) {
+    std::cout << options.help() << std::endl;
+    exit(0);
+  }
+
+  const uint64_t count = args["count"].as<uint64_t>();
+  const uint32_t seed = args["seed"].as<uint32_t>();
+  const StaticPredicateFilter filter(AABB(vec3(0, 0, 0), vec3(1, 1, 1)));
+
+  fmt::print("{:<10} {:<24} {:>10} {:>8} {:>9} {:>9} {:>9} {:>9} {:>9}\n",
+             "workload", "predicate", "calls", "ns/call", "static", "semi", "dynamic", "exact", "hit rate");
+  for (const std::string workload : {"random", "grid", "perturbed"}) {
+    const std::vector<vec3> points = CreateWorkload(workload, count, seed);
+
+    Measure(workload, "orient2d", points, 3, [](const vec3* p, PredicateStatistics* inout_stats) {
+      return Orient2d(p[0].head<2>(), p[1].head<2>(), p[2].head<2>(), inout_stats);
+    });
+    Measure(workload, "orient2d static", points, 3, [&filter](const vec3* p, PredicateStatistics* inout_stats) {
+      return filter.orient2d(p[0].head<2>(), p[1].head<2>(), p[2].head<2>(), inout_stats);
+    });
+    Measure(workload, "orient3d", points, 4, [](const vec3* p, PredicateStatistics* inout_stats) {
+      return Orient3d(p[0], p[1], p[2], p[3], inout_stats);
+    });
+    Measure(workload, "orient3d static", points, 4, [&filter](const vec3* p, PredicateStatistics* inout_stats) {
+      return filter.orient3d(p[0], p[1], p[2], p[3], inout_stats);
+    });
+    Measure(workload, "insphere", points, 5, [](const vec3* p, PredicateStatistics* inout_stats) {
+      return InSphere(p[0], p[1], p[2], p[3], p[4], inout_stats);
+    });
+    Measure(workload, "insphere static", points, 5, [&filter](const vec3* p, PredicateStatistics* inout_stats) {
+      return filter.inSphere(p[0], p[1], p[2], p[3], p[4], inout_stats);
+    });
+  }
+
+  return EXIT_SUCCESS;
+}
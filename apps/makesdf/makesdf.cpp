@@ -7,10 +7,14 @@
 //-----------------------------------------------------------------------------
 
 #include "volmesh/logger.h"
+#include "volmesh/pointcloudserializer.h"
 #include "volmesh/tetmesh.h"
 #include "volmesh/stlserializer.h"
 #include "volmesh/signeddistancefield.h"
 
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
 #include <iostream>
 #include <filesystem>
 #include <fmt/core.h>
@@ -20,6 +24,30 @@ using namespace volmesh;
 
 namespace fs = std::filesystem;
 
+static bool SaveSDF(const SignedDistanceField& sdf, const std::string& filepath, const std::string& surface_filepath, bool log_placement) {
+  if (log_placement) {
+    sdf.logPagePlacement();
+  }
+
+  if (surface_filepath.empty() == false) {
+    if (sdf.saveIsoSurfaceAsSTL(surface_filepath) == false) {
+      SPDLOG_ERROR("Failed when saving the iso surface under [{}].", surface_filepath.c_str());
+      return false;
+    }
+
+    SPDLOG_INFO("Saved the iso surface under [{}]", surface_filepath.c_str());
+  }
+
+  const fs::path extension = fs::path(filepath).extension();
+  if (extension == ".sdf") {
+    return sdf.saveAsBinary(filepath);
+  } else if (extension == ".npy") {
+    return sdf.saveAsNpy(filepath);
+  }
+
+  return sdf.saveAsVTI(filepath);
+}
+
 int main(int argc, const char* argv[]) {
   SetLogFormat();
 
@@ -29,9 +57,20 @@ int main(int argc, const char* argv[]) {
   ss_default_voxelsize << SignedDistanceField::kDefaultVoxelSize;
 
   options.add_options()
-    ("i,input", "Input surface mesh (STL format only)", cxxopts::value<std::string>())
-    ("o,output", "Output SDF in the VTK Image Data (VTI format)", cxxopts::value<std::string>())
+    ("i,input", "Input surface mesh (.stl), oriented point cloud (.ply or .xyz), or the input SDF when resampling", cxxopts::value<std::string>())
+    ("o,output", "Output SDF in the VTK Image Data (.vti), the binary SDF (.sdf) or the NumPy array (.npy) format", cxxopts::value<std::string>())
     ("v,voxelsize", "Voxel size", cxxopts::value<float>()->default_value(ss_default_voxelsize.str().c_str()))
+    ("m,method", "Generation method (exact or edt)", cxxopts::value<std::string>()->default_value("exact"))
+    ("s,sign", "Sign mode (pseudonormals, windingnumber or scanlineparity)", cxxopts::value<std::string>()->default_value("pseudonormals"))
+    ("b,budget", "Memory budget in MiB for the out-of-core generation, requires the .sdf output format", cxxopts::value<uint64_t>())
+    ("c,closest", "Closest feature data to keep with the exact method and export to VTI (none, faceids or offsets)", cxxopts::value<std::string>()->default_value("none"))
+    ("r,resample", "Resample the input SDF (.vti or .sdf) to the voxel size instead of generating it from a mesh")
+    ("interpolation", "Interpolation for resampling (trilinear or tricubic)", cxxopts::value<std::string>()->default_value("trilinear"))
+    ("radius", "Smoothing radius for point cloud inputs, zero selects twice the voxel size", cxxopts::value<float>()->default_value("0"))
+    ("surface", "Also extract the zero iso surface with marching cubes into a binary STL file", cxxopts::value<std::string>())
+    ("shard", "Generate only shard i of N, given as i/N with i in [0, N), requires the .sdf output format", cxxopts::value<std::string>())
+    ("hugepages", "Huge pages for the grid storage (none, transparent or explicit)", cxxopts::value<std::string>()->default_value("transparent"))
+    ("placement", "Log the NUMA placement and the huge page coverage of the grid storage")
     ("h,help", "Print usage")
   ;
 
@@ -42,8 +81,8 @@ int main(int argc, const char* argv[]) {
     exit(0);
   }
 
-  std::string surface_mesh_filepath = args["input"].as<std::string>();
-  SPDLOG_INFO("input surface mesh = [{}]", surface_mesh_filepath.c_str());
+  std::string input_filepath = args["input"].as<std::string>();
+  SPDLOG_INFO("input filepath = [{}]", input_filepath.c_str());
 
   std::string sdf_filepath = args["output"].as<std::string>();
   SPDLOG_INFO("output filepath = [{}]", sdf_filepath.c_str());
@@ -51,9 +90,132 @@ int main(int argc, const char* argv[]) {
   const real_t voxel_size = static_cast<real_t>(args["voxelsize"].as<float>());
   SPDLOG_INFO("voxel size = [{}]", voxel_size);
 
+  const std::string surface_filepath = args.count("surface") ? args["surface"].as<std::string>() : std::string();
+
+  const std::string huge_pages_name = args["hugepages"].as<std::string>();
+  if (huge_pages_name == "none") {
+    SetHugePagesMode(kHugePagesNone);
+  } else if (huge_pages_name == "explicit") {
+    SetHugePagesMode(kHugePagesExplicit);
+  } else if (huge_pages_name != "transparent") {
+    SPDLOG_ERROR("Unknown huge pages mode [{}]", huge_pages_name.c_str());
+    return EXIT_FAILURE;
+  }
+
+  const bool binary_output = fs::path(sdf_filepath).extension() == ".sdf";
+
+  if (args.count("resample")) {
+    SignedDistanceField::Interpolation interpolation = SignedDistanceField::kInterpolationTrilinear;
+    const std::string interpolation_name = args["interpolation"].as<std::string>();
+    if (interpolation_name == "tricubic") {
+      interpolation = SignedDistanceField::kInterpolationTricubic;
+    } else if (interpolation_name != "trilinear") {
+      SPDLOG_ERROR("Unknown interpolation [{}]", interpolation_name.c_str());
+      return EXIT_FAILURE;
+    }
+    SPDLOG_INFO("interpolation = [{}]", interpolation_name.c_str());
+
+    SignedDistanceField source;
+    const bool binary_input = fs::path(input_filepath).extension() == ".sdf";
+    const bool loaded = binary_input ? source.mapBinary(input_filepath) : source.loadAsVTI(input_filepath);
+    if (loaded == false) {
+      SPDLOG_ERROR("Failed to load the SDF file [{}]", input_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("Resampling from voxel size [{}] to [{}]", source.voxelSize(), voxel_size);
+
+    SignedDistanceField sdf;
+    if (sdf.resample(source, source.bounds(), voxel_size, interpolation) == false) {
+      SPDLOG_ERROR("Failed to resample SDF");
+      return EXIT_FAILURE;
+    }
+
+    const bool saved = SaveSDF(sdf, sdf_filepath, surface_filepath, args.count("placement") > 0);
+    if (saved == false) {
+      SPDLOG_ERROR("Failed when saving the SDF under [{}].", sdf_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("Saved SDF under [{}]", sdf_filepath.c_str());
+    return EXIT_SUCCESS;
+  }
+
+  // the point cloud reader takes the extension in any case
+  std::string input_extension = fs::path(input_filepath).extension().string();
+  std::transform(input_extension.begin(), input_extension.end(), input_extension.begin(),
+                 [](unsigned char c){ return std::tolower(c); });
+  if (input_extension == ".ply" || input_extension == ".xyz") {
+    if (args.count("budget") || args.count("shard") || args["method"].as<std::string>() != "exact") {
+      SPDLOG_ERROR("The point cloud generation does not support the out-of-core, sharded or edt generation");
+      return EXIT_FAILURE;
+    }
+
+    std::vector<vec3> positions;
+    std::vector<vec3> normals;
+    if (volmesh::ReadPointCloud(input_filepath, positions, normals) == false) {
+      SPDLOG_ERROR("Failed to load the point cloud file [{}]", input_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    const real_t smoothing_radius = static_cast<real_t>(args["radius"].as<float>());
+    SPDLOG_INFO("points count = [{}], smoothing radius = [{}]", positions.size(), smoothing_radius);
+
+    SignedDistanceField sdf;
+    const vec3 expansion(voxel_size, voxel_size, voxel_size);
+    if (sdf.generateFromPointCloud(positions, normals, expansion, voxel_size, smoothing_radius) == false) {
+      SPDLOG_ERROR("Failed to generate SDF");
+      return EXIT_FAILURE;
+    }
+
+    const bool saved = SaveSDF(sdf, sdf_filepath, surface_filepath, args.count("placement") > 0);
+    if (saved == false) {
+      SPDLOG_ERROR("Failed when saving the SDF under [{}].", sdf_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("Saved SDF under [{}]", sdf_filepath.c_str());
+    return EXIT_SUCCESS;
+  }
+
+  const std::string method_name = args["method"].as<std::string>();
+  if (method_name != "exact" && method_name != "edt") {
+    SPDLOG_ERROR("Unknown generation method [{}]", method_name.c_str());
+    return EXIT_FAILURE;
+  }
+  SPDLOG_INFO("generation method = [{}]", method_name.c_str());
+
+  SignedDistanceField::SignMode sign_mode = SignedDistanceField::kSignModePseudoNormals;
+  const std::string sign_mode_name = args["sign"].as<std::string>();
+  if (sign_mode_name == "windingnumber") {
+    sign_mode = SignedDistanceField::kSignModeWindingNumber;
+  } else if (sign_mode_name == "scanlineparity") {
+    sign_mode = SignedDistanceField::kSignModeScanlineParity;
+  } else if (sign_mode_name != "pseudonormals") {
+    SPDLOG_ERROR("Unknown sign mode [{}]", sign_mode_name.c_str());
+    return EXIT_FAILURE;
+  }
+  SPDLOG_INFO("sign mode = [{}]", sign_mode_name.c_str());
+
+  SignedDistanceField::ClosestFeatureStorage closest_feature_storage = SignedDistanceField::kClosestFeatureNone;
+  const std::string closest_feature_name = args["closest"].as<std::string>();
+  if (closest_feature_name == "faceids") {
+    closest_feature_storage = SignedDistanceField::kClosestFeatureFaceIds;
+  } else if (closest_feature_name == "offsets") {
+    closest_feature_storage = SignedDistanceField::kClosestFeatureFaceIdsAndOffsets;
+  } else if (closest_feature_name != "none") {
+    SPDLOG_ERROR("Unknown closest feature data [{}]", closest_feature_name.c_str());
+    return EXIT_FAILURE;
+  }
+  SPDLOG_INFO("closest feature data = [{}]", closest_feature_name.c_str());
+
+  if (closest_feature_storage != SignedDistanceField::kClosestFeatureNone && fs::path(sdf_filepath).extension() != ".vti") {
+    SPDLOG_WARN("Only the VTI format stores the closest feature data");
+  }
+
   TriangleMesh tri_mesh;
-  if (volmesh::ReadSTL(surface_mesh_filepath, tri_mesh) == false) {
-    SPDLOG_ERROR("Failed to load the surface mesh file [{}]", surface_mesh_filepath.c_str());
+  if (volmesh::ReadSTL(input_filepath, tri_mesh) == false) {
+    SPDLOG_ERROR("Failed to load the surface mesh file [{}]", input_filepath.c_str());
     return EXIT_FAILURE;
   }
 
@@ -62,13 +224,107 @@ int main(int argc, const char* argv[]) {
   SPDLOG_INFO("Mesh upper bounds [{}, {}, {}]", bounds.upper().x(), bounds.upper().y(), bounds.upper().z());
   SPDLOG_INFO("Mesh AABB extent [{}, {}, {}]", bounds.extent().x(), bounds.extent().y(), bounds.extent().z());
 
-  tri_mesh.computeHalfEdgePseudoNormals();
-  tri_mesh.computeVertexPseudoNormals();
+  const vec3 expansion(voxel_size, voxel_size, voxel_size);
+
+  uint32_t shard_index = 0;
+  uint32_t shard_count = 0;
+  if (args.count("shard")) {
+    const std::string shard_spec = args["shard"].as<std::string>();
+    if (std::sscanf(shard_spec.c_str(), "%u/%u", &shard_index, &shard_count) != 2 || shard_index >= shard_count) {
+      SPDLOG_ERROR("Invalid shard [{}], expected i/N with i in [0, N)", shard_spec.c_str());
+      return EXIT_FAILURE;
+    }
+
+    if (binary_output == false || method_name != "exact" || args.count("budget")) {
+      SPDLOG_ERROR("The sharded generation requires the exact method and the .sdf output format, without a budget");
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("shard = [{} of {}]", shard_index, shard_count);
+
+    AABB global_bounds = tri_mesh.bounds();
+    global_bounds.expand(expansion);
+
+    AABB shard_bounds;
+    if (SignedDistanceField::ComputeShardBounds(global_bounds, voxel_size, shard_index, shard_count, shard_bounds) == false) {
+      return EXIT_FAILURE;
+    }
+
+    // a shard is only renamed to its final path once it is complete, so a restarted job skips it
+    if (fs::exists(sdf_filepath)) {
+      SignedDistanceField existing;
+      if (existing.mapBinary(sdf_filepath) &&
+          existing.voxelSize() == voxel_size &&
+          existing.bounds().lower() == shard_bounds.lower() &&
+          existing.bounds().upper() == shard_bounds.upper()) {
+        SPDLOG_INFO("Shard [{}] is already complete under [{}]", shard_index, sdf_filepath.c_str());
+        return EXIT_SUCCESS;
+      }
+
+      SPDLOG_WARN("The existing file [{}] does not hold this shard and will be regenerated", sdf_filepath.c_str());
+    }
+  }
+
+  // only the pseudo normal sign mode needs the pseudo normals
+  if (method_name == "exact" && sign_mode == SignedDistanceField::kSignModePseudoNormals) {
+    tri_mesh.computeHalfEdgePseudoNormals();
+    tri_mesh.computeVertexPseudoNormals();
+  }
 
   SignedDistanceField sdf;
-  bool result = sdf.generate(tri_mesh, vec3(voxel_size, voxel_size, voxel_size), voxel_size);
+  bool result = false;
+  if (shard_count > 0) {
+    if (sdf.generateShard(tri_mesh, expansion, voxel_size, shard_index, shard_count, sign_mode) == false) {
+      SPDLOG_ERROR("Failed to generate SDF shard");
+      return EXIT_FAILURE;
+    }
+
+    const std::string partial_filepath = sdf_filepath + ".partial";
+    if (sdf.saveAsBinary(partial_filepath) == false) {
+      SPDLOG_ERROR("Failed when saving the SDF shard under [{}].", partial_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    std::error_code ec;
+    fs::rename(partial_filepath, sdf_filepath, ec);
+    if (ec) {
+      SPDLOG_ERROR("Failed to move [{}] to [{}]: {}", partial_filepath.c_str(), sdf_filepath.c_str(), ec.message().c_str());
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("Saved SDF shard under [{}]", sdf_filepath.c_str());
+    return EXIT_SUCCESS;
+  }
+
+  if (args.count("budget")) {
+    if (binary_output == false || method_name != "exact") {
+      SPDLOG_ERROR("The out-of-core generation requires the exact method and the .sdf output format");
+      return EXIT_FAILURE;
+    }
+
+    const uint64_t budget_bytes = args["budget"].as<uint64_t>() * 1024 * 1024;
+    SPDLOG_INFO("memory budget = [{}] bytes", budget_bytes);
+
+    // the out-of-core generation writes the output file directly
+    result = sdf.generateOutOfCore(tri_mesh, expansion, voxel_size, sdf_filepath, budget_bytes, sign_mode);
+    if (result == false) {
+      SPDLOG_ERROR("Failed to generate SDF");
+      return EXIT_FAILURE;
+    }
+
+    SPDLOG_INFO("Saved SDF under [{}]", sdf_filepath.c_str());
+    return EXIT_SUCCESS;
+  }
+
+  if (method_name == "edt") {
+    result = sdf.generateByDistanceTransform(tri_mesh, expansion, voxel_size);
+  } else {
+    sdf.setClosestFeatureStorage(closest_feature_storage);
+    result = sdf.generate(tri_mesh, expansion, voxel_size, sign_mode);
+  }
   if (result == true) {
-    if (sdf.saveAsVTI(sdf_filepath)) {
+    const bool saved = SaveSDF(sdf, sdf_filepath, surface_filepath, args.count("placement") > 0);
+    if (saved) {
       SPDLOG_INFO("Saved SDF under [{}]", sdf_filepath.c_str());
     } else {
       SPDLOG_ERROR("Failed when saving the SDF under [{}].", sdf_filepath.c_str());
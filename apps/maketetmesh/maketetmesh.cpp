@@ -6,11 +6,19 @@
 // LICENSE file in the root directory of this source tree.
 //-----------------------------------------------------------------------------
 
+#include "volmesh/isosurfacestuffing.h"
 #include "volmesh/logger.h"
+#include "volmesh/mathutils.h"
 #include "volmesh/tetmesh.h"
+#include "volmesh/tetmeshstreamwriter.h"
+#include "volmesh/tetrahedra.h"
 #include "volmesh/stlserializer.h"
 #include "volmesh/signeddistancefield.h"
+#include "volmesh/octreetetmesher.h"
+#include "volmesh/voxeltetmesher.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <filesystem>
 #include <fmt/core.h>
@@ -33,6 +41,12 @@ int main(int argc, const char* argv[]) {
     ("o,output", "Output tetrahedral mesh", cxxopts::value<std::string>())
     ("s,sdf", "Save SDF in the VTK Image Data (VTI format)", cxxopts::value<std::string>())
     ("v,voxelsize", "Voxel size for SDF generation", cxxopts::value<float>()->default_value(ss_default_voxelsize.str().c_str()))
+    ("l,latticespacing", "Edge length of the cubes of the BCC lattice, zero selects twice the voxel size", cxxopts::value<float>()->default_value("0"))
+    ("x,voxels", "Split the interior voxels of the SDF into tetrahedra instead of stuffing the surface, a voxel is interior when this many of its corners are inside", cxxopts::value<int>()->implicit_value("8"))
+    ("g,graded", "Fill the SDF with an octree graded mesh instead of stuffing the surface, coarse inside and with the voxel size along the surface, optionally with at most this many cells", cxxopts::value<uint64_t>()->implicit_value("0"))
+    ("b,binary", "Save the tetrahedral mesh in the binary VTK format")
+    ("t,stream", "Stream the tetrahedra of the voxels or the lattice to the output file without building the mesh in memory")
+    ("boundary", "Save the boundary of the streamed mesh as binary STL", cxxopts::value<std::string>())
     ("h,help", "Print usage")
   ;
 
@@ -49,7 +63,7 @@ int main(int argc, const char* argv[]) {
   std::string tetmesh_filepath = args["output"].as<std::string>();
   SPDLOG_INFO("output tetrahedral mesh filepath = [{}]", tetmesh_filepath.c_str());
 
-  std::string sdf_filepath = args["sdf"].as<std::string>();
+  std::string sdf_filepath = args.count("sdf") ? args["sdf"].as<std::string>() : std::string();
   if (sdf_filepath.length() != 0) {
     SPDLOG_INFO("output SDF filepath = [{}]", sdf_filepath.c_str());
   }
@@ -57,6 +71,12 @@ int main(int argc, const char* argv[]) {
   const real_t voxel_size = static_cast<real_t>(args["voxelsize"].as<float>());
   SPDLOG_INFO("voxel size = [{}]", voxel_size);
 
+  real_t lattice_spacing = static_cast<real_t>(args["latticespacing"].as<float>());
+  if (lattice_spacing <= 0.0) {
+    lattice_spacing = 2.0 * voxel_size;
+  }
+  SPDLOG_INFO("lattice spacing = [{}]", lattice_spacing);
+
   TriangleMesh tri_mesh;
   if (volmesh::ReadSTL(trimesh_filepath, tri_mesh) == false) {
     SPDLOG_ERROR("Failed to load the triangle mesh file [{}]", trimesh_filepath.c_str());
@@ -72,7 +92,9 @@ int main(int argc, const char* argv[]) {
   tri_mesh.computeVertexPseudoNormals();
 
   SignedDistanceField sdf;
-  bool result = sdf.generate(tri_mesh, vec3(voxel_size, voxel_size, voxel_size), voxel_size);
+  // the lattice vertices away from the surface need the sign of the field too
+  bool result = sdf.generate(tri_mesh, vec3(voxel_size, voxel_size, voxel_size), voxel_size,
+                             SignedDistanceField::kSignModeScanlineParity);
   if (result == false) {
     SPDLOG_ERROR("Failed to generate SDF");
     return EXIT_FAILURE;
@@ -86,7 +108,119 @@ int main(int argc, const char* argv[]) {
     }
   }
 
+  // stream the tetrahedra to the output file
+  if (args.count("stream")) {
+    if (args.count("graded")) {
+      SPDLOG_ERROR("The octree graded mesh cannot be streamed");
+      return EXIT_FAILURE;
+    }
+
+    TetMeshStreamWriter writer;
+    if (writer.open(tetmesh_filepath, args.count("binary") > 0) == false) {
+      return EXIT_FAILURE;
+    }
+
+    bool streamed = false;
+    if (args.count("voxels")) {
+      const int min_inside_corners = args["voxels"].as<int>();
+      SPDLOG_INFO("interior voxels have at least [{}] inside corners", min_inside_corners);
+      streamed = StreamInteriorVoxels(sdf, writer, min_inside_corners);
+    } else {
+      streamed = StuffIsosurface(sdf, lattice_spacing, writer);
+    }
+
+    if (streamed == false) {
+      SPDLOG_ERROR("Failed to generate the tetrahedral mesh");
+      return EXIT_FAILURE;
+    }
+    SPDLOG_INFO("The tetrahedral mesh has [{}] vertices and [{}] cells", writer.countVertices(), writer.countCells());
+
+    if (args.count("boundary")) {
+      const std::string boundary_filepath = args["boundary"].as<std::string>();
+      std::vector<vec3> boundary_vertices;
+      std::vector<vec3i> boundary_faces;
+      if (writer.extractBoundary(boundary_vertices, boundary_faces) &&
+          WriteBinarySTL(boundary_filepath, boundary_vertices, boundary_faces)) {
+        SPDLOG_INFO("Saved the boundary under [{}]", boundary_filepath.c_str());
+      } else {
+        SPDLOG_ERROR("Failed when saving the boundary under [{}].", boundary_filepath.c_str());
+        return EXIT_FAILURE;
+      }
+    }
+
+    if (writer.close()) {
+      SPDLOG_INFO("Saved the tetrahedral mesh under [{}]", tetmesh_filepath.c_str());
+    } else {
+      SPDLOG_ERROR("Failed when saving the tetrahedral mesh under [{}].", tetmesh_filepath.c_str());
+      return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+  }
+
   // generate tetrahedral mesh
+  TetMesh tet_mesh;
+  if (args.count("voxels")) {
+    const int min_inside_corners = args["voxels"].as<int>();
+    SPDLOG_INFO("interior voxels have at least [{}] inside corners", min_inside_corners);
+
+    if (MeshInteriorVoxels(sdf, tet_mesh, min_inside_corners) == false) {
+      SPDLOG_ERROR("Failed to generate the tetrahedral mesh");
+      return EXIT_FAILURE;
+    }
+  } else if (args.count("graded")) {
+    const uint64_t target_cells_count = args["graded"].as<uint64_t>();
+    bool graded = false;
+    if (target_cells_count == 0) {
+      graded = MeshGradedOctree(sdf, OctreeSizeField(), tet_mesh);
+    } else {
+      SPDLOG_INFO("target cells count = [{}]", target_cells_count);
+
+      std::vector<vec3> vertices;
+      std::vector<vec4i> cells;
+      graded = MeshGradedOctree(sdf, target_cells_count, vertices, cells) && tet_mesh.readFromList(vertices, cells);
+    }
+
+    if (graded == false) {
+      SPDLOG_ERROR("Failed to generate the tetrahedral mesh");
+      return EXIT_FAILURE;
+    }
+  } else {
+    std::vector<vec3> vertices;
+    std::vector<vec4i> cells;
+    if (StuffIsosurface(sdf, lattice_spacing, vertices, cells) == false) {
+      SPDLOG_ERROR("Failed to generate the tetrahedral mesh");
+      return EXIT_FAILURE;
+    }
+
+    real_t min_angle = M_PI;
+    real_t max_angle = 0.0;
+    for (const vec4i& cell : cells) {
+      Tetrahedra::TetraVertexArray tet_vertices;
+      for (int i = 0; i < Tetrahedra::kNumVerticesPerCell; i++) {
+        tet_vertices.col(i) = vertices[cell[i]];
+      }
+
+      for (real_t angle : Tetrahedra(tet_vertices).dihedralAngles()) {
+        min_angle = std::min(min_angle, angle);
+        max_angle = std::max(max_angle, angle);
+      }
+    }
+    SPDLOG_INFO("Dihedral angles are within [{}, {}] degrees", RadToDeg(min_angle), RadToDeg(max_angle));
+
+    if (tet_mesh.readFromList(vertices, cells) == false) {
+      SPDLOG_ERROR("Failed to build the tetrahedral mesh");
+      return EXIT_FAILURE;
+    }
+  }
+  SPDLOG_INFO("The tetrahedral mesh has [{}] vertices and [{}] cells", tet_mesh.countVertices(), tet_mesh.countCells());
+
+  if (tet_mesh.exportToVTK(tetmesh_filepath, args.count("binary") > 0)) {
+    SPDLOG_INFO("Saved the tetrahedral mesh under [{}]", tetmesh_filepath.c_str());
+  } else {
+    SPDLOG_ERROR("Failed when saving the tetrahedral mesh under [{}].", tetmesh_filepath.c_str());
+    return EXIT_FAILURE;
+  }
 
   return EXIT_SUCCESS;
 }
\ No newline at end of file
@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/logger.h"
+#include "volmesh/signeddistancefield.h"
+
+#include <iostream>
+#include <filesystem>
+#include <fmt/core.h>
+#include <cxxopts.hpp>
+
+using namespace volmesh;
+
+namespace fs = std::filesystem;
+
+int main(int argc, const char* argv[]) {
+  SetLogFormat();
+
+  cxxopts::Options options("mergesdf", "Stitch the shards generated by makesdf --shard into one signed distance field.");
+
+  options.add_options()
+    ("i,input", "Comma separated list of the binary SDF shards (.sdf)", cxxopts::value<std::vector<std::string>>())
+    ("o,output", "Output SDF in the binary SDF (.sdf) or the parallel VTK Image Data (.pvti) format", cxxopts::value<std::string>())
+    ("h,help", "Print usage")
+  ;
+
+  auto args = options.parse(argc, argv);
+
+  if (args.count("help")) {
+    std::cout << options.help() << std::endl;
+    exit(0);
+  }
+
+  const std::vector<std::string> shard_filepaths = args["input"].as<std::vector<std::string>>();
+  SPDLOG_INFO("input shards count = [{}]", shard_filepaths.size());
+
+  const std::string sdf_filepath = args["output"].as<std::string>();
+  SPDLOG_INFO("output filepath = [{}]", sdf_filepath.c_str());
+
+  const fs::path extension = fs::path(sdf_filepath).extension();
+  bool result = false;
+  if (extension == ".sdf") {
+    result = SignedDistanceField::MergeBinaryShards(shard_filepaths, sdf_filepath);
+  } else if (extension == ".pvti") {
+    result = SignedDistanceField::SaveShardsAsPVTI(shard_filepaths, sdf_filepath);
+  } else {
+    SPDLOG_ERROR("Unsupported output format [{}]", extension.string().c_str());
+    return EXIT_FAILURE;
+  }
+
+  if (result == false) {
+    SPDLOG_ERROR("Failed to merge the shards into [{}]", sdf_filepath.c_str());
+    return EXIT_FAILURE;
+  }
+
+  SPDLOG_INFO("Saved SDF under [{}]", sdf_filepath.c_str());
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,83 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/tetmesh.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Computes the Delaunay tetrahedralization of a point set by incremental insertion.
+ *
+ * The points are inserted with the Bowyer-Watson algorithm. Each point is located by a stochastic
+ * visibility walk from the last created tetrahedron, the tetrahedra whose circumspheres contain it
+ * form a cavity that is found by a breadth first search, and the cavity is replaced by the
+ * tetrahedra joining the point to its boundary faces. The outside of the convex hull is covered by
+ * ghost tetrahedra sharing a vertex at infinity, so points outside the current hull need no
+ * bounding tetrahedron. The slots of removed tetrahedra are reused by the new ones.
+ *
+ * The points are inserted in a biased randomized insertion order (BRIO): they are shuffled and
+ * split into rounds of doubling size, and every round is sorted along a Hilbert curve, which keeps
+ * the walks short while the randomness keeps the expected amount of work optimal.
+ *
+ * The orientation and in-sphere decisions are exact, see `Orient3d` and `InSphere`. Cospherical
+ * points, as on regular grids, therefore yield one of the valid Delaunay tetrahedralizations.
+ * Duplicate points are skipped and remain unused.
+ *
+ * @ref Bowyer, A. (1981). Computing Dirichlet tessellations. The Computer Journal, 24(2), 162-166.
+ * @ref Amenta, N., Choi, S., Rote, G. (2003). Incremental constructions con BRIO. Symposium on
+ * Computational Geometry, 211-219.
+ * @ref Shewchuk, J. R. (1997). Adaptive precision floating-point arithmetic and fast robust
+ * geometric predicates. Discrete & Computational Geometry, 18(3), 305-363.
+ *
+ * @param in_points The points to tetrahedralize.
+ * @param out_tet_cells_by_vertex_ids The positively oriented tetrahedra, by ids of the points.
+ * @return True if the points span a volume, otherwise false.
+ */
+bool TetrahedralizeDelaunay(const std::vector<vec3>& in_points,
+                            std::vector<vec4i>& out_tet_cells_by_vertex_ids);
+
+/**
+ * @brief Computes the Delaunay tetrahedralization of a point set on all worker threads.
+ *
+ * The points are split into slabs along the longest axis of their bounding box, one per worker
+ * thread, and every slab is tetrahedralized independently by `TetrahedralizeDelaunay`. The slab
+ * tetrahedra sharing a circumsphere are kept together when that sphere lies strictly inside the
+ * slab, since no point of another slab can then invalidate them. The vertices of the other slab
+ * tetrahedra, along the slab boundaries and the convex hull, are tetrahedralized once more, and
+ * the tetrahedra of that pass that lie outside the kept ones fill the rest of the hull.
+ *
+ * For points in general position the tetrahedra are the same as those of `TetrahedralizeDelaunay`,
+ * in another order. Small point sets, single threaded runs and cospherical points that the second
+ * pass splits differently than the slabs use `TetrahedralizeDelaunay`.
+ *
+ * @param in_points The points to tetrahedralize.
+ * @param out_tet_cells_by_vertex_ids The positively oriented tetrahedra, by ids of the points.
+ * @return True if the points span a volume, otherwise false.
+ */
+bool TetrahedralizeDelaunayParallel(const std::vector<vec3>& in_points,
+                                    std::vector<vec4i>& out_tet_cells_by_vertex_ids);
+
+/**
+ * @brief Builds a tetrahedral mesh from the Delaunay tetrahedralization of a point set.
+ *
+ * The tetrahedralization is computed by `TetrahedralizeDelaunayParallel` and every point becomes a
+ * vertex of the mesh, in order.
+ *
+ * @param in_points The points to tetrahedralize.
+ * @param out_mesh The tetrahedral mesh.
+ * @return True if the points span a volume and the mesh was built, otherwise false.
+ */
+bool TetrahedralizeDelaunay(const std::vector<vec3>& in_points,
+                            TetMesh& out_mesh);
+
+}
@@ -0,0 +1,44 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief The value used for grid points without a feature in the distance transform input.
+ *
+ * It is larger than any squared distance on a grid, and finite so that the parabola
+ * intersections stay well defined.
+ */
+static constexpr const real_t kDistanceTransformInfinity = 1e20;
+
+/**
+ * @brief Computes the exact squared Euclidean distance transform of a 3D grid in place.
+ *
+ * On input every grid point holds zero for feature points and `kDistanceTransformInfinity`
+ * otherwise. On output every grid point holds the squared distance to the nearest feature
+ * point, measured in grid units. The grid is stored with x varying fastest, then y, then z.
+ *
+ * The transform is separable: it runs the linear time 1D lower envelope of parabolas along x,
+ * then y, then z. All lines of a pass are independent and processed in parallel.
+ *
+ * @ref Felzenszwalb, P. F., Huttenlocher, D. P. (2012). Distance transforms of sampled functions.
+ * Theory of Computing, 8(19).
+ *
+ * @param dims The number of grid points along each axis.
+ * @param inout_values The input feature grid and the output squared distances.
+ * @return True if the transform was computed, false if the grid size does not match `dims`.
+ */
+bool SquaredDistanceTransform(const vec3i& dims, std::vector<real_t>& inout_values);
+
+}
@@ -0,0 +1,196 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/parallel.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Arrays smaller than this many bytes are served by the default allocator.
+ */
+static constexpr const uint64_t kGridAllocationThresholdInBytes = 2ull << 20;
+
+/**
+ * @enum HugePagesMode
+ * @brief Selects how the large grid allocations are backed by huge pages.
+ */
+enum HugePagesMode : int {
+  kHugePagesNone = 0, /**< Regular pages only. */
+  kHugePagesTransparent = 1, /**< Regular mappings advised with MADV_HUGEPAGE, so the kernel may back them with transparent huge pages. */
+  kHugePagesExplicit = 2, /**< Mappings from the reserved huge page pool (MAP_HUGETLB), falling back to transparent huge pages when the pool is empty. */
+};
+
+/**
+ * @brief Selects how the large grid allocations made from now on are backed by huge pages.
+ *
+ * The default is `kHugePagesTransparent`. Platforms without huge page support ignore the mode.
+ *
+ * @param mode The huge pages mode.
+ */
+void SetHugePagesMode(HugePagesMode mode);
+
+/**
+ * @brief Returns the huge pages mode of the large grid allocations.
+ */
+HugePagesMode GetHugePagesMode();
+
+/**
+ * @brief Allocates a large, zero filled block of memory for grid arrays.
+ *
+ * The block is mapped directly from the operating system with its length rounded up to a whole
+ * number of huge pages of the system's default size (`Hugepagesize` in /proc/meminfo, 2 MiB when
+ * unknown), and advised or backed according to `GetHugePagesMode`. Its pages are not touched, so
+ * on a NUMA system every page lands on the node of the thread that writes it first, and the loop
+ * that fills the block decides the placement. On platforms without anonymous mappings the block is
+ * allocated and zero filled by the allocating thread.
+ *
+ * @param size_in_bytes The size of the block.
+ * @return The start of the block, or nullptr if the mapping failed.
+ */
+void* AllocateGridMemory(uint64_t size_in_bytes);
+
+/**
+ * @brief Releases a block returned by `AllocateGridMemory`.
+ *
+ * @param address The start of the block.
+ * @param size_in_bytes The size that was passed to `AllocateGridMemory`.
+ */
+void FreeGridMemory(void* address, uint64_t size_in_bytes);
+
+/**
+ * @brief Counts the resident pages of a block of memory per NUMA node.
+ *
+ * Only available on Linux, where the pages are queried with the move_pages system call.
+ *
+ * @param address The start of the block.
+ * @param size_in_bytes The size of the block.
+ * @param out_pages_per_node The number of resident pages per NUMA node, pages that are not resident are counted under node -1.
+ * @return True if the placement was queried, otherwise false.
+ */
+bool QueryPagePlacement(const void* address,
+                        uint64_t size_in_bytes,
+                        std::map<int, uint64_t>& out_pages_per_node);
+
+/**
+ * @brief Logs the NUMA placement of the pages of a block of memory and its transparent huge page coverage.
+ *
+ * @param label A name for the block in the log.
+ * @param address The start of the block.
+ * @param size_in_bytes The size of the block.
+ */
+void LogPagePlacement(const char* label, const void* address, uint64_t size_in_bytes);
+
+/**
+ * @class GridAllocator
+ * @brief A standard allocator for the large arrays of grids and meshes.
+ *
+ * Arrays of at least `kGridAllocationThresholdInBytes` come from `AllocateGridMemory`, so they
+ * are backed by huge pages and placed by the threads that fill them, while smaller arrays use the
+ * default allocator. The allocator is stateless, so containers using it can be swapped and moved
+ * freely.
+ */
+template <typename T>
+class GridAllocator {
+public:
+  typedef T value_type;
+
+  GridAllocator() noexcept = default;
+
+  template <typename U>
+  GridAllocator(const GridAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+
+    const uint64_t size_in_bytes = static_cast<uint64_t>(n) * sizeof(T);
+    if (size_in_bytes < kGridAllocationThresholdInBytes) {
+      return static_cast<T*>(::operator new(size_in_bytes));
+    }
+
+    void* address = AllocateGridMemory(size_in_bytes);
+    if (address == nullptr) {
+      throw std::bad_alloc();
+    }
+
+    return static_cast<T*>(address);
+  }
+
+  void deallocate(T* p, std::size_t n) noexcept {
+    const uint64_t size_in_bytes = static_cast<uint64_t>(n) * sizeof(T);
+    if (size_in_bytes < kGridAllocationThresholdInBytes) {
+      ::operator delete(p);
+    } else {
+      FreeGridMemory(p, size_in_bytes);
+    }
+  }
+
+  /**
+   * @brief Default initializes instead of value initializing, so resizing does not write every element.
+   */
+  template <typename U>
+  void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+    ::new(static_cast<void*>(p)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U* p, Args&&... args) {
+    ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  bool operator==(const GridAllocator<U>&) const noexcept {
+    return true;
+  }
+
+  template <typename U>
+  bool operator!=(const GridAllocator<U>&) const noexcept {
+    return false;
+  }
+};
+
+/**
+ * @brief A vector whose large buffers come from `GridAllocator`.
+ *
+ * Resizing leaves new elements of trivial types uninitialized, use `ParallelAssign` to fill them.
+ */
+template <typename T>
+using GridVector = std::vector<T, GridAllocator<T>>;
+
+/**
+ * @brief Resizes a grid vector and sets all of its elements in parallel.
+ *
+ * @param out_values The vector to fill.
+ * @param count The new number of elements.
+ * @param value The value of every element.
+ */
+template <typename T>
+void ParallelAssign(GridVector<T>& out_values, uint64_t count, const T& value) {
+  static const uint64_t kGrainSize = 1ull << 16;
+
+  out_values.resize(count);
+  T* data = out_values.data();
+  ParallelFor(0, count, [data, &value](uint64_t chunk_begin, uint64_t chunk_end) {
+    std::fill(data + chunk_begin, data + chunk_end, value);
+  }, kGrainSize);
+}
+
+}
@@ -0,0 +1,98 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetmeshstreamwriter.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Largest fraction of a long lattice edge over which a vertex is snapped to a cut point.
+ */
+static constexpr const real_t kIsosurfaceStuffingAlphaLong = 0.24999;
+
+/**
+ * @brief Largest fraction of a short lattice edge over which a vertex is snapped to a cut point.
+ */
+static constexpr const real_t kIsosurfaceStuffingAlphaShort = 0.41189;
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with tetrahedra.
+ *
+ * The field is sampled on a body centered cubic (BCC) lattice, made of the corners and the centers
+ * of cubes with edge length `lattice_spacing`. Every lattice edge that crosses the surface gets a
+ * cut point, found by root finding on the field. A lattice vertex that is too close to a cut point
+ * of one of its edges, within `kIsosurfaceStuffingAlphaLong` or `kIsosurfaceStuffingAlphaShort` of
+ * the edge length, is snapped onto it. Every BCC tetrahedron with an inside vertex is then clipped
+ * to the surface and filled by one of a few stencils. Its quadrilateral faces are split by the
+ * diagonal through their smallest lattice key, so neighboring tetrahedra agree on their shared faces
+ * and the mesh is conforming. The boundary vertices lie on the surface. The paper splits the
+ * quadrilaterals by a parity rule instead, so its dihedral angle bounds are not guaranteed here.
+ *
+ * Vertices are identified by lattice keys, the index of a lattice vertex or of the lattice edge
+ * that holds a cut point, and are merged by sorting the keys rather than hashing positions. The
+ * snapping, the stencils and the key mapping run in parallel over slabs of lattice cubes, and the
+ * output does not depend on the number of threads.
+ *
+ * The lattice vertices are classified by the sign of the field, so the grid points outside the
+ * narrow band must be signed too, as with `SignedDistanceField::kSignModeScanlineParity`. The
+ * surface must be resolved by the lattice, i.e. the lattice spacing must be small compared to the
+ * local feature size.
+ *
+ * @ref Labelle, F., Shewchuk, J. R. (2007). Isosurface stuffing: fast tetrahedral meshes with good
+ * dihedral angles. ACM Transactions on Graphics, 26(3).
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param lattice_spacing The edge length of the lattice cubes.
+ * @param out_vertices The vertex positions.
+ * @param out_tet_cells_by_vertex_ids The positively oriented tetrahedra.
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                     real_t lattice_spacing,
+                     std::vector<vec3>& out_vertices,
+                     std::vector<vec4i>& out_tet_cells_by_vertex_ids);
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with tetrahedra.
+ *
+ * @param in_sdf The signed distance field, negative inside.
+ * @param lattice_spacing The edge length of the lattice cubes.
+ * @param out_mesh The tetrahedral mesh.
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                     real_t lattice_spacing,
+                     TetMesh& out_mesh);
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with tetrahedra and streams them to a file.
+ *
+ * The lattice is swept one slab of cubes at a time, and only the field values, the snapped vertices
+ * and the signs of the 4 lattice layers around the slab are kept. The vertices first used by a slab
+ * and its tetrahedra are passed to the writer before the next slab is filled, so the memory does not
+ * grow with the lattice. A slab only shares vertices with the one before it, so the vertex ids follow
+ * the slabs as `TetMeshStreamWriter::extractBoundary` expects. The mesh is the one of the vertex and
+ * cell lists, with the vertices numbered in the order of the slabs.
+ *
+ * @param in_sdf The signed distance field, negative inside.
+ * @param lattice_spacing The edge length of the lattice cubes.
+ * @param inout_writer An open stream writer, closed by the caller.
+ * @return True if a non-empty mesh was written, otherwise false.
+ */
+bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                     real_t lattice_spacing,
+                     TetMeshStreamWriter& inout_writer);
+
+}
@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/trianglemesh.h"
+
+#include <string>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @class LabeledDistanceField
+ * @brief A distance field over several objects that share one grid.
+ *
+ * Every grid point holds the label of the nearest object and the signed distance to it, where
+ * the label is the index of the object in the list passed to `generate`. The grid layout is the
+ * same as in the `SignedDistanceField`.
+ *
+ * Optionally the signed distance of every object is kept on its own, but only inside the band of
+ * the object, which is the bounding box of the object grown by one voxel on each side.
+ */
+class LabeledDistanceField {
+public:
+  /**
+   * @brief The label of the grid points outside the bands of all objects.
+   */
+  static constexpr const uint32_t kNoLabel = 0xFFFFFFFF;
+
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes an empty field.
+   */
+  LabeledDistanceField();
+
+  /**
+   * @brief Destructor.
+   */
+  ~LabeledDistanceField();
+
+  /**
+   * @brief Generates the labels and the signed distances of several triangle meshes in one pass.
+   *
+   * The faces of all meshes are binned by the z slabs of the grid overlapped by their bands, and
+   * the slabs are processed in parallel. Every grid point within one voxel of the bounding box of
+   * a face keeps the closest face over all meshes, so the grid is swept once instead of once per
+   * mesh. Grid points outside the bands of all objects get `kNoLabel` and the largest finite
+   * distance.
+   *
+   * The pseudo normal sign mode requires the vertex and half-edge pseudo normals of every mesh.
+   * The winding number sign mode evaluates the winding number of the nearest object only. The
+   * scanline parity sign mode is not supported.
+   *
+   * @param in_meshes The input triangle meshes, one per label.
+   * @param expansion The expansion vector to apply around the union of the meshes.
+   * @param voxel_size The size of the voxels.
+   * @param keep_object_fields Whether to keep the signed distance of every object inside its band.
+   * @param sign_mode The method used for computing the sign of the field.
+   * @return True if the field was successfully generated, otherwise false.
+   */
+  bool generate(const std::vector<const TriangleMesh*>& in_meshes,
+                const vec3& expansion,
+                real_t voxel_size = SignedDistanceField::kDefaultVoxelSize,
+                bool keep_object_fields = false,
+                SignedDistanceField::SignMode sign_mode = SignedDistanceField::kSignModePseudoNormals);
+
+  /**
+   * @brief Gets the bounding box of the grid.
+   */
+  AABB bounds() const;
+
+  /**
+   * @brief Retrieves the voxel size of the grid.
+   */
+  real_t voxelSize() const;
+
+  /**
+   * @brief Retrieves the number of grid points along each axis.
+   */
+  vec3i gridPointsCount() const;
+
+  /**
+   * @brief Gets the total number of grid points.
+   */
+  uint64_t totalGridPointsCount() const;
+
+  /**
+   * @brief Retrieves the memory usage of the field in bytes.
+   */
+  uint64_t getTotalMemoryUsageInBytes() const;
+
+  /**
+   * @brief Returns the number of objects of the last generation.
+   */
+  uint32_t countObjects() const;
+
+  /**
+   * @brief Retrieves the position of a grid point in 3D space.
+   *
+   * @param coords The grid point coordinates.
+   * @return The 3D position of the grid point.
+   */
+  vec3 gridPointPosition(const vec3i& coords) const;
+
+  /**
+   * @brief Retrieves the label of the object nearest to a grid point.
+   *
+   * @param coords The grid point coordinates.
+   * @return The label, or `kNoLabel` if the grid point is outside the bands of all objects.
+   */
+  uint32_t label(const vec3i& coords) const;
+
+  /**
+   * @brief Retrieves the signed distance to the object nearest to a grid point.
+   *
+   * @param coords The grid point coordinates.
+   * @return The signed distance.
+   */
+  real_t fieldValue(const vec3i& coords) const;
+
+  /**
+   * @brief Checks whether the signed distance of every object is kept inside its band.
+   */
+  bool hasObjectFields() const;
+
+  /**
+   * @brief Checks whether a grid point lies inside the band of an object.
+   *
+   * @param in_label The label of the object.
+   * @param coords The grid point coordinates.
+   * @return True if the object field is kept and holds the grid point, otherwise false.
+   */
+  bool isInObjectBand(uint32_t in_label, const vec3i& coords) const;
+
+  /**
+   * @brief Retrieves the signed distance of one object at a grid point.
+   *
+   * @param in_label The label of the object.
+   * @param coords The grid point coordinates.
+   * @return The signed distance to the object, or the largest finite value outside its band.
+   */
+  real_t objectFieldValue(uint32_t in_label, const vec3i& coords) const;
+
+  /**
+   * @brief Saves the labels and the signed distances to a VTK Image data (VTI) file.
+   *
+   * The signed distances are written as the `SignedDistanceField` array, so the file can be
+   * loaded with `SignedDistanceField::loadAsVTI`, followed by the `Label` array.
+   *
+   * @param filepath The file path where the field will be saved.
+   * @return True if the field was successfully saved, otherwise false.
+   */
+  bool saveAsVTI(const std::string& filepath) const;
+
+private:
+  /**
+   * @brief The signed distances of one object inside its band.
+   */
+  struct ObjectBand {
+    vec3i start = vec3i(0, 0, 0); /**< First grid point of the band. */
+    vec3i count = vec3i(0, 0, 0); /**< Number of grid points of the band along each axis. */
+    std::vector<real_t> values; /**< The signed distances, x varying fastest. */
+  };
+
+  void assertGridPointCoords(const vec3i& coords) const;
+
+  uint64_t gridPointId(const vec3i& coords) const;
+
+private:
+  real_t voxel_size_ = SignedDistanceField::kDefaultVoxelSize; /**< The size of each voxel. */
+  AABB bounds_; /**< The bounding box of the grid. */
+  vec3i gridpoints_count_ = vec3i(0, 0, 0); /**< Number of grid points along each axis. */
+  GridVector<real_t> field_values_; /**< The signed distance to the nearest object at each grid point. */
+  GridVector<uint32_t> labels_; /**< The label of the nearest object at each grid point. */
+  std::vector<ObjectBand> object_bands_; /**< The per object signed distances, if kept. */
+  uint32_t count_objects_ = 0; /**< Number of objects of the last generation. */
+};
+
+}
@@ -0,0 +1,91 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+
+#include <array>
+
+namespace volmesh {
+
+/**
+ * @class MarchingCubes
+ * @brief The lookup tables of the marching cubes isosurface extraction.
+ *
+ * The corners of a cube are numbered as in Bourke's tables, corners 0-3 run counter clockwise
+ * around the bottom face starting at the origin and corners 4-7 lie above them. A cube index has
+ * bit i set when corner i is inside, i.e. its value is below the iso value.
+ *
+ * The triangles are built once from the contours on the cube faces rather than stored as a
+ * hand written table. On a face with two diagonal inside corners the inside corners are kept
+ * apart. The rule only depends on the face itself, so neighbouring cubes agree on their shared
+ * face and the surface is closed. The triangles are oriented with their normals pointing to the
+ * outside.
+ *
+ * @ref Bourke, P. (1994). Polygonising a scalar field. https://paulbourke.net/geometry/polygonise/
+ */
+class MarchingCubes {
+public:
+  /**
+   * @brief Number of corners of a cube.
+   */
+  static constexpr const int kCountCorners = 8;
+
+  /**
+   * @brief Number of edges of a cube.
+   */
+  static constexpr const int kCountEdges = 12;
+
+  /**
+   * @brief Largest number of triangles emitted for one cube.
+   */
+  static constexpr const int kMaxTrianglesPerCube = 5;
+
+  /**
+   * @brief Offset of a cube corner from the lowest corner of the cube.
+   *
+   * @param corner The corner id in [0, 8).
+   * @return The grid offset of the corner.
+   */
+  static vec3i cornerOffset(int corner);
+
+  /**
+   * @brief Retrieves the two corners of a cube edge, the first one being the lower end.
+   *
+   * @param edge The edge id in [0, 12).
+   * @return The corner ids of the edge.
+   */
+  static vec2i edgeCornerIds(int edge);
+
+  /**
+   * @brief Retrieves the axis of a cube edge, 0 for x, 1 for y and 2 for z.
+   *
+   * @param edge The edge id in [0, 12).
+   * @return The axis along which the edge runs.
+   */
+  static int edgeAxis(int edge);
+
+  /**
+   * @brief Retrieves the edges crossed by the surface for a cube index.
+   *
+   * @param cube_index The cube index in [0, 256).
+   * @return A mask with bit i set when edge i is crossed.
+   */
+  static uint16_t edgeMask(int cube_index);
+
+  /**
+   * @brief Retrieves the triangles of a cube index as triplets of edge ids.
+   *
+   * @param cube_index The cube index in [0, 256).
+   * @return The edge ids of the triangles, terminated by -1.
+   */
+  static const std::array<int8_t, 3 * kMaxTrianglesPerCube + 1>& triangleEdges(int cube_index);
+};
+
+}
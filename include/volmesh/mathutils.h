@@ -187,6 +187,25 @@ real_t PointTriangleDistance(const vec3& p,
                              vec3& q,
                              ClosestTriangleFeature& closest_feature);
 
+/**
+ * @brief Computes the signed solid angle subtended by a triangle at a point.
+ *
+ * Uses the closed form of Van Oosterom and Strackee. The result is positive when the
+ * triangle normal (counter-clockwise winding of `a`, `b`, `c`) points away from `p`.
+ * Summing the solid angles of all triangles of a closed and outward oriented mesh yields
+ * 4 * pi for points inside the mesh and zero for points outside of it.
+ *
+ * @param p The point at which the solid angle is measured.
+ * @param a First vertex of the triangle.
+ * @param b Second vertex of the triangle.
+ * @param c Third vertex of the triangle.
+ * @return The signed solid angle in steradians, in the range [-2 * pi, 2 * pi].
+ */
+real_t TriangleSolidAngle(const vec3& p,
+                          const vec3& a,
+                          const vec3& b,
+                          const vec3& c);
+
 /**
  * @brief Computes the axis-aligned bounding box (AABB) of a triangle.
  *
@@ -197,4 +216,17 @@ real_t PointTriangleDistance(const vec3& p,
  */
 AABB ComputeTriangleAABB(const std::array<vec3, 3>& vertices);
 
-}
\ No newline at end of file
+/**
+ * @brief Computes the number of voxels of the given size that cover an extent.
+ *
+ * The count is rounded up, except when the extent is within a millionth of a voxel of a whole
+ * number of voxels. Bounds rebuilt from grid point positions, such as the bounds of a sub-grid,
+ * then get the same count as the grid they were taken from.
+ *
+ * @param extent The length to cover.
+ * @param voxel_size The size of the voxels.
+ * @return The number of voxels along the extent.
+ */
+int ComputeVoxelsCount(real_t extent, real_t voxel_size);
+
+}
@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/trianglemesh.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @class OccupancyGrid
+ * @brief A bit-packed inside/outside grid with the same layout as the `SignedDistanceField`.
+ *
+ * The grid points are located at `bounds.lower() + voxel_size * (x, y, z)`, and the number of
+ * grid points along each axis is computed exactly as in the `SignedDistanceField`, so an
+ * occupancy grid generated over the bounds of an SDF can be used to seed its signs.
+ *
+ * Every row of grid points along the x axis starts at a new 64-bit word. Rows can therefore
+ * be written concurrently without synchronization.
+ */
+class OccupancyGrid {
+public:
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes an empty occupancy grid.
+   */
+  OccupancyGrid();
+
+  /**
+   * @brief Destructor.
+   */
+  ~OccupancyGrid();
+
+  /**
+   * @brief Allocates the grid for the given bounds and voxel size and marks all grid points as outside.
+   *
+   * @param bounds The bounding box of the grid.
+   * @param voxel_size The size of the voxels.
+   * @return True if the grid was allocated, otherwise false.
+   */
+  bool resize(const AABB& bounds, real_t voxel_size);
+
+  /**
+   * @brief Voxelizes a closed triangle mesh by scanline parity.
+   *
+   * An axis-aligned ray is cast along the x axis through every (y, z) row of grid points. The
+   * triangles are binned by the z rows they overlap, and every row is processed in parallel.
+   * Ray-triangle crossings are classified with a top-left tie rule in the yz plane so that rays
+   * passing exactly through shared edges or vertices are counted once. Grid points that are
+   * preceded by an odd number of crossings are marked inside.
+   *
+   * The result does not depend on the orientation of the triangles, but the mesh must be closed.
+   *
+   * @param in_mesh The input triangle mesh.
+   * @param bounds The bounding box of the grid.
+   * @param voxel_size The size of the voxels.
+   * @return True if the mesh was voxelized, otherwise false.
+   */
+  bool generate(const TriangleMesh& in_mesh,
+                const AABB& bounds,
+                real_t voxel_size);
+
+  /**
+   * @brief Voxelizes a closed triangle mesh over its bounding box expanded by `expansion`.
+   *
+   * @param in_mesh The input triangle mesh.
+   * @param expansion The expansion vector to apply around the mesh.
+   * @param voxel_size The size of the voxels.
+   * @return True if the mesh was voxelized, otherwise false.
+   */
+  bool generate(const TriangleMesh& in_mesh,
+                const vec3& expansion,
+                real_t voxel_size);
+
+  /**
+   * @brief Voxelizes a closed triangle soup by scanline parity.
+   *
+   * @param in_triangle_vertices Three consecutive vertices per triangle.
+   * @param bounds The bounding box of the grid.
+   * @param voxel_size The size of the voxels.
+   * @return True if the soup was voxelized, otherwise false.
+   */
+  bool generate(const std::vector<vec3>& in_triangle_vertices,
+                const AABB& bounds,
+                real_t voxel_size);
+
+  /**
+   * @brief Gets the bounding box of the grid.
+   */
+  AABB bounds() const;
+
+  /**
+   * @brief Retrieves the voxel size of the grid.
+   */
+  real_t voxelSize() const;
+
+  /**
+   * @brief Retrieves the number of grid points along each axis.
+   */
+  vec3i gridPointsCount() const;
+
+  /**
+   * @brief Gets the total number of grid points.
+   */
+  uint64_t totalGridPointsCount() const;
+
+  /**
+   * @brief Returns the number of 64-bit words used by each row of grid points along the x axis.
+   */
+  uint32_t countWordsPerRow() const;
+
+  /**
+   * @brief Retrieves the memory usage of the grid in bytes.
+   */
+  uint64_t getTotalMemoryUsageInBytes() const;
+
+  /**
+   * @brief Checks whether a grid point is inside.
+   *
+   * @param coords The grid point coordinates.
+   * @return True if the grid point is inside, otherwise false.
+   */
+  bool isOccupied(const vec3i& coords) const;
+
+  /**
+   * @brief Marks a grid point as inside or outside.
+   *
+   * @param coords The grid point coordinates.
+   * @param occupied The new state of the grid point.
+   */
+  void setOccupied(const vec3i& coords, bool occupied);
+
+  /**
+   * @brief Counts the grid points that are inside.
+   */
+  uint64_t countOccupied() const;
+
+  /**
+   * @brief Returns the packed bits of a row of grid points along the x axis.
+   *
+   * Bit `x % 64` of word `x / 64` holds the state of grid point x.
+   *
+   * @param y The row coordinate along the y axis.
+   * @param z The row coordinate along the z axis.
+   * @return A pointer to the first word of the row.
+   */
+  const uint64_t* rowWords(int y, int z) const;
+
+private:
+  void assertGridPointCoords(const vec3i& coords) const;
+
+  uint64_t* rowWords(int y, int z);
+
+private:
+  real_t voxel_size_ = 0.0; /**< The size of each voxel. */
+  AABB bounds_; /**< The bounding box of the grid. */
+  vec3i gridpoints_count_ = vec3i(0, 0, 0); /**< Number of grid points along each axis. */
+  uint32_t words_per_row_ = 0; /**< Number of 64-bit words per row along the x axis. */
+  std::vector<uint64_t> words_; /**< The packed occupancy bits, row by row. */
+};
+
+}
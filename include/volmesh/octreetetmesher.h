@@ -0,0 +1,88 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+
+#include <functional>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief The largest edge length allowed for the octree cells around a point.
+ */
+typedef std::function<real_t(const vec3& p)> OctreeSizeField;
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with tetrahedra of graded size.
+ *
+ * The voxels of the field are the finest cells of an octree. A cell is split while it contains a
+ * voxel crossed by the surface or while it is larger than the size field at its center, so the
+ * cells along the surface have the size of a voxel and grow towards the inside. The octree is then
+ * balanced, leaf cells sharing a face, an edge or a corner differ by at most one level.
+ *
+ * The faces of the leaves inside the surface are triangulated by transition templates that only
+ * depend on the face and its neighborhood, so neighboring leaves agree on their shared faces and the
+ * mesh is conforming. A face against finer leaves is split into their four faces, a face with the
+ * corner of a finer leaf on one of its edges is fanned around its center, and a plain face is split
+ * along the diagonal of `Voxel::fittingTetrahedraVertexIdsLut`. A leaf with only plain faces is split
+ * into the six tetrahedra of a voxel, any other leaf into one tetrahedron per face triangle sharing
+ * its center. A leaf is inside when its center is, i.e. when its field value or the mean of its
+ * corners is negative.
+ *
+ * The leaf cells are classified by the sign of the field, so the grid points outside the narrow band
+ * must be signed too, as with `SignedDistanceField::kSignModeScanlineParity`. The vertices are merged
+ * by sorting their grid keys and the output does not depend on the number of threads.
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param size_field The largest cell edge length at a point, or an empty function for no limit.
+ * @param out_vertices The vertex positions.
+ * @param out_tet_cells_by_vertex_ids The positively oriented tetrahedra.
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                      const OctreeSizeField& size_field,
+                      std::vector<vec3>& out_vertices,
+                      std::vector<vec4i>& out_tet_cells_by_vertex_ids);
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with about a target number of tetrahedra.
+ *
+ * Meshes the field by `MeshGradedOctree` with a uniform size limit, halving the limit from the size of
+ * the octree root down to the voxel size while the mesh stays within the target. The number of cells
+ * can therefore only be met up to the steps of the octree levels, and the mesh is never coarser than
+ * the surface requires, so it has more cells than the target when the target is too small.
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param target_cells_count The largest number of tetrahedra wanted.
+ * @param out_vertices The vertex positions.
+ * @param out_tet_cells_by_vertex_ids The positively oriented tetrahedra.
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                      uint64_t target_cells_count,
+                      std::vector<vec3>& out_vertices,
+                      std::vector<vec4i>& out_tet_cells_by_vertex_ids);
+
+/**
+ * @brief Fills the inside of the zero level set of a signed distance field with tetrahedra of graded size.
+ *
+ * @param in_sdf The signed distance field, negative inside.
+ * @param size_field The largest cell edge length at a point, or an empty function for no limit.
+ * @param out_mesh The tetrahedral mesh.
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                      const OctreeSizeField& size_field,
+                      TetMesh& out_mesh);
+
+}
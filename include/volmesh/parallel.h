@@ -0,0 +1,63 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace volmesh {
+
+/**
+ * @brief Returns the number of worker threads used by the parallel loops.
+ *
+ * This is the number of hardware threads unless it has been overridden by SetMaxThreadsCount.
+ *
+ * @return The number of worker threads, at least one.
+ */
+uint32_t CountWorkerThreads();
+
+/**
+ * @brief Limits the number of worker threads used by the parallel loops.
+ *
+ * @param in_max_threads The maximum number of threads. Zero restores the hardware default.
+ */
+void SetMaxThreadsCount(uint32_t in_max_threads);
+
+/**
+ * @brief Checks whether the calling thread is running a chunk of `ParallelFor`.
+ *
+ * Work that is itself split with `ParallelFor` can run serially instead when it is already
+ * called from the workers, rather than starting another set of threads per worker.
+ *
+ * @return True on the workers and the calling thread while they run the chunks, otherwise false.
+ */
+bool IsInsideParallelFor();
+
+/**
+ * @brief Runs a function over the range [begin, end) on all worker threads.
+ *
+ * The range is split into chunks of `grain_size` consecutive indices which are handed out
+ * dynamically to the workers, so uneven work per index is balanced automatically. The function
+ * receives a sub-range [chunk_begin, chunk_end) which lets the caller reuse scratch memory
+ * for all indices of a chunk. Ranges smaller than two chunks run on the calling thread.
+ *
+ * The first exception thrown by any worker is rethrown on the calling thread once all workers
+ * have finished.
+ *
+ * @param begin The first index of the range.
+ * @param end One past the last index of the range.
+ * @param fn The function to run for every chunk.
+ * @param grain_size The number of indices per chunk (default is 1).
+ */
+void ParallelFor(uint64_t begin,
+                 uint64_t end,
+                 const std::function<void(uint64_t chunk_begin, uint64_t chunk_end)>& fn,
+                 uint64_t grain_size = 1);
+
+}
@@ -0,0 +1,64 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+
+#include <string>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Reads an oriented point cloud from an XYZ or a PLY file.
+ *
+ * The format is selected by the file extension, `.xyz` or `.ply`. The normals are normalized
+ * after reading, and points with a zero normal are dropped.
+ *
+ * @param in_filepath The file path of the input point cloud.
+ * @param out_positions The point positions.
+ * @param out_normals The unit point normals, one per position.
+ * @return True if the point cloud was successfully read, false otherwise.
+ */
+bool ReadPointCloud(const std::string& in_filepath,
+                    std::vector<vec3>& out_positions,
+                    std::vector<vec3>& out_normals);
+
+/**
+ * @brief Reads an oriented point cloud from an XYZ file.
+ *
+ * Every non-empty line that does not start with `#` holds the position and the normal of one
+ * point as six numbers separated by white space or commas: `x y z nx ny nz`.
+ *
+ * @param in_filepath The file path of the input XYZ file.
+ * @param out_positions The point positions.
+ * @param out_normals The point normals, one per position.
+ * @return True if the XYZ file was successfully read, false otherwise.
+ */
+bool ReadXYZ(const std::string& in_filepath,
+             std::vector<vec3>& out_positions,
+             std::vector<vec3>& out_normals);
+
+/**
+ * @brief Reads an oriented point cloud from a PLY file.
+ *
+ * The ASCII, binary little endian and binary big endian encodings are supported. The `vertex`
+ * element must have the scalar properties `x`, `y`, `z`, `nx`, `ny` and `nz`, and any other
+ * scalar properties are skipped. The elements after the vertices, such as faces, are ignored.
+ *
+ * @param in_filepath The file path of the input PLY file.
+ * @param out_positions The point positions.
+ * @param out_normals The point normals, one per position.
+ * @return True if the PLY file was successfully read, false otherwise.
+ */
+bool ReadPLY(const std::string& in_filepath,
+             std::vector<vec3>& out_positions,
+             std::vector<vec3>& out_normals);
+
+}
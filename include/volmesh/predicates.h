@@ -0,0 +1,135 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/aabb.h"
+
+#include <cstdint>
+
+namespace volmesh {
+
+/**
+ * @brief Counts of the predicate evaluations decided by each stage.
+ *
+ * Every predicate is first evaluated in floating point and its sign is accepted when the value
+ * exceeds an error bound. The static filter uses a bound computed once from the bounding box of
+ * all inputs, the semi-static filter scales a constant by the largest coordinate differences of
+ * the call, and the dynamic filter bounds the error by the permanent of the determinant. The
+ * remaining evaluations are decided in exact arithmetic.
+ */
+struct PredicateStatistics {
+  uint64_t count_static = 0; /**< Decided by the static filter. */
+  uint64_t count_semi_static = 0; /**< Decided by the semi-static filter. */
+  uint64_t count_dynamic = 0; /**< Decided by the dynamic filter. */
+  uint64_t count_exact = 0; /**< Decided in exact arithmetic. */
+
+  /**
+   * @brief The number of evaluations of all stages.
+   */
+  uint64_t count() const;
+
+  /**
+   * @brief The fraction of evaluations decided without exact arithmetic, one when there are none.
+   */
+  real_t filterHitRate() const;
+
+  /**
+   * @brief Adds the counts of another set of statistics.
+   */
+  PredicateStatistics& operator+=(const PredicateStatistics& rhs);
+};
+
+/**
+ * @brief The sign of the orientation of three points, positive when they are counter clockwise.
+ *
+ * The sign is exact, the predicate starts with the semi-static filter.
+ *
+ * @ref Shewchuk, J. R. (1997). Adaptive precision floating-point arithmetic and fast robust
+ * geometric predicates. Discrete & Computational Geometry, 18(3), 305-363.
+ *
+ * @param a The first point.
+ * @param b The second point.
+ * @param c The third point.
+ * @param inout_stats Optional statistics to count the deciding stage in.
+ * @return 1 for counter clockwise points, -1 for clockwise points and 0 for collinear points.
+ */
+int Orient2d(const vec2& a, const vec2& b, const vec2& c, PredicateStatistics* inout_stats = nullptr);
+
+/**
+ * @brief The sign of the orientation of four points, positive when d lies below the plane of a, b
+ * and c, which appear counter clockwise when seen from above.
+ *
+ * The sign is exact, the predicate starts with the semi-static filter. A positive orientation of
+ * the vertices of a tetrahedron is the orientation of `TetMesh`, where `Tetrahedra::determinant`
+ * is negative.
+ *
+ * @param a The first point.
+ * @param b The second point.
+ * @param c The third point.
+ * @param d The fourth point.
+ * @param inout_stats Optional statistics to count the deciding stage in.
+ * @return 1 for positive, -1 for negative and 0 for coplanar points.
+ */
+int Orient3d(const vec3& a, const vec3& b, const vec3& c, const vec3& d, PredicateStatistics* inout_stats = nullptr);
+
+/**
+ * @brief The sign of the in-sphere test of a point against the circumsphere of four points.
+ *
+ * The sign is exact, the predicate starts with the semi-static filter.
+ *
+ * @param a The first point of the sphere.
+ * @param b The second point of the sphere.
+ * @param c The third point of the sphere.
+ * @param d The fourth point of the sphere, `Orient3d` of a, b, c and d is positive.
+ * @param e The point to test.
+ * @param inout_stats Optional statistics to count the deciding stage in.
+ * @return 1 when e lies inside the sphere, -1 when it lies outside and 0 when it lies on it.
+ */
+int InSphere(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e, PredicateStatistics* inout_stats = nullptr);
+
+/**
+ * @brief Exact predicates that start with a static filter for points inside a bounding box.
+ *
+ * The error bounds of the static filter follow from the extent of the box and are computed once,
+ * so most evaluations cost a determinant and a comparison. The semi-static and dynamic filters and
+ * the exact arithmetic decide the rest, as in the free predicates. Points outside the box make the
+ * static filter unsound.
+ */
+class StaticPredicateFilter {
+public:
+  /**
+   * @brief Prepares the static filter for points inside a bounding box.
+   *
+   * @param bounds The bounding box of all points passed to the predicates.
+   */
+  explicit StaticPredicateFilter(const AABB& bounds);
+
+  /**
+   * @brief The sign of the orientation of three points on the xy plane of the box, as `Orient2d`.
+   */
+  int orient2d(const vec2& a, const vec2& b, const vec2& c, PredicateStatistics* inout_stats = nullptr) const;
+
+  /**
+   * @brief The sign of the orientation of four points, as `Orient3d`.
+   */
+  int orient3d(const vec3& a, const vec3& b, const vec3& c, const vec3& d, PredicateStatistics* inout_stats = nullptr) const;
+
+  /**
+   * @brief The sign of the in-sphere test of a point, as `InSphere`.
+   */
+  int inSphere(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e, PredicateStatistics* inout_stats = nullptr) const;
+
+private:
+  double orient2d_bound_;
+  double orient3d_bound_;
+  double insphere_bound_;
+};
+
+}
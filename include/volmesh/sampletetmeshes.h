@@ -32,7 +32,10 @@ void createTwoTetrahedra(TetMesh& inout_mesh);
  * @brief Creates a voxel grid of tetrahedra and adds it to the input/output tetrahedral mesh.
  *
  * This function generates a voxel grid of tetrahedra based on the specified grid dimensions
- * and cell size, and adds the grid to the given `TetMesh`.
+ * and cell size, and adds the grid to the given `TetMesh`. The topology is built in bulk by
+ * `TetMesh::readFromVoxelGrid`. The grid point (i, j, k) becomes the vertex (i * ny + j) * nz + k,
+ * and the voxels follow the same order with six cells each. The half-edge and half-face ids are
+ * those `TetMesh::readFromList` gives the same lists.
  *
  * @param inout_mesh The tetrahedral mesh to which the voxel grid will be added.
  * @param nx Number of cells along the x-axis.
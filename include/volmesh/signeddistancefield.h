@@ -8,12 +8,21 @@
 
 #pragma once
 
+#include "volmesh/gridallocator.h"
 #include "volmesh/trianglemesh.h"
 
+#include <array>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <vector>
 
 namespace volmesh {
 
+class OccupancyGrid;
+class TetMesh;
+class WindingNumberTree;
+
 /**
  * @class SignedDistanceField
  * @brief A class for representing and computing a signed distance field (SDF).
@@ -51,6 +60,92 @@ public:
    */
   static constexpr const real_t kDefaultVoxelSize = 0.5;
 
+  /**
+   * @brief The default memory budget for the out-of-core generation, 1 GiB.
+   */
+  static constexpr const uint64_t kDefaultMemoryBudgetInBytes = 1ull << 30;
+
+  /**
+   * @brief The version of the binary SDF file format.
+   */
+  static const uint32_t kBinaryFormatVersion = 1;
+
+  /**
+   * @enum SignMode
+   * @brief Selects how the inside/outside sign of the distance field is computed.
+   */
+  enum SignMode : int {
+    kSignModePseudoNormals = 0, /**< Sign from the angle weighted pseudo normal of the closest feature. Requires a watertight mesh. */
+    kSignModeWindingNumber = 1, /**< Sign from the generalized winding number. Robust to holes and non-manifold input. */
+    kSignModeScanlineParity = 2, /**< Sign from a scanline parity voxelization. Requires a closed mesh, ignores orientation. */
+  };
+
+  /**
+   * @brief The closest face id of the grid points outside the narrow band.
+   */
+  static constexpr const uint32_t kInvalidFaceId = 0xFFFFFFFF;
+
+  /**
+   * @enum ClosestFeatureStorage
+   * @brief Selects which closest feature data `generate` keeps per grid point.
+   */
+  enum ClosestFeatureStorage : int {
+    kClosestFeatureNone = 0, /**< Only the field values are kept. */
+    kClosestFeatureFaceIds = 1, /**< The id of the closest face is kept. */
+    kClosestFeatureFaceIdsAndOffsets = 2, /**< The id of the closest face and the offset to the closest point are kept. */
+  };
+
+  /**
+   * @enum CsgOperation
+   * @brief Selects how two signed distance fields are combined.
+   */
+  enum CsgOperation : int {
+    kCsgUnion = 0, /**< The minimum of both fields. */
+    kCsgIntersection = 1, /**< The maximum of both fields. */
+    kCsgDifference = 2, /**< This field minus the other one, the maximum of this field and the negated other field. */
+  };
+
+  /**
+   * @enum Interpolation
+   * @brief Selects how the field is reconstructed between grid points when resampling.
+   */
+  enum Interpolation : int {
+    kInterpolationTrilinear = 0, /**< Trilinear interpolation of the 8 surrounding grid points. */
+    kInterpolationTricubic = 1, /**< Catmull-Rom interpolation of the 64 surrounding grid points. */
+  };
+
+  /**
+   * @enum SliceAxis
+   * @brief Selects the axis normal to a slice of the grid.
+   */
+  enum SliceAxis : int {
+    kSliceAxisX = 0, /**< Slices of constant x, spanned by y and z. */
+    kSliceAxisY = 1, /**< Slices of constant y, spanned by x and z. */
+    kSliceAxisZ = 2, /**< Slices of constant z, spanned by x and y. */
+  };
+
+  /**
+   * @brief A read-only view of an axis aligned slice of the field values.
+   *
+   * The view points into the storage of the field instead of copying it, so it stays valid only
+   * until the field is regenerated, loaded, assigned or destroyed. The slice is spanned by the two
+   * remaining axes (u, v) in increasing order, so (y, z) for x slices, (x, z) for y slices and
+   * (x, y) for z slices.
+   */
+  struct SliceView {
+    const real_t* data = nullptr; /**< The field value at (u, v) = (0, 0). */
+    vec2i size = vec2i(0, 0); /**< Number of grid points along u and v. */
+    int64_t stride_u = 0; /**< Distance between neighbouring values along u, in values. */
+    int64_t stride_v = 0; /**< Distance between neighbouring values along v, in values. */
+
+    /**
+     * @brief Retrieves the field value at (u, v) without bounds checking.
+     */
+    real_t at(int u, int v) const {
+      return data[u * stride_u + v * stride_v];
+    }
+  };
+
   /**
    * @brief Copies data from another `SignedDistanceField` object.
    *
@@ -102,6 +197,50 @@ public:
    */
   uint64_t getTotalMemoryUsageInBytes() const;
 
+  /**
+   * @brief Selects which closest feature data the next call to `generate` keeps.
+   *
+   * The closest face ids take 4 bytes and the closest point offsets 24 bytes per grid point.
+   * They are only computed by `generate`, every other operation that replaces the field values
+   * drops them.
+   *
+   * @param storage The closest feature data to keep.
+   */
+  void setClosestFeatureStorage(ClosestFeatureStorage storage);
+
+  /**
+   * @brief Returns the closest feature data kept by `generate`.
+   */
+  ClosestFeatureStorage closestFeatureStorage() const;
+
+  /**
+   * @brief Checks whether the field holds the closest face id of every grid point.
+   */
+  bool hasClosestFaceIds() const;
+
+  /**
+   * @brief Checks whether the field holds the closest point offset of every grid point.
+   */
+  bool hasClosestPointOffsets() const;
+
+  /**
+   * @brief Retrieves the index of the mesh face closest to a grid point.
+   *
+   * @param coords The grid point coordinates.
+   * @return The face index, or `kInvalidFaceId` if the grid point is outside the narrow band or the ids are not kept.
+   */
+  uint32_t closestFaceId(const vec3i& coords) const;
+
+  /**
+   * @brief Retrieves the vector from a grid point to the closest point on the mesh.
+   *
+   * Adding the offset to `gridPointPosition` yields the closest point on the surface.
+   *
+   * @param coords The grid point coordinates.
+   * @return The offset vector, or zero if the grid point is outside the narrow band or the offsets are not kept.
+   */
+  vec3 closestPointOffset(const vec3i& coords) const;
+
   /**
    * @brief Retrieves the ID of a grid point based on its coordinates.
    *
@@ -139,14 +278,196 @@ public:
    * This function computes the signed distance field based on an input triangle mesh,
    * with optional expansion and voxel size parameters.
    *
+   * The pseudo normal sign mode requires the vertex and half-edge pseudo normals of the mesh.
+   * The winding number sign mode does not, and evaluates the winding number only for the
+   * grid points inside the narrow band around the surface. The scanline parity mode seeds the
+   * signs of all grid points from an `OccupancyGrid`. The other modes sign the grid points outside
+   * the band along the x rows, from the band values at the ends of each run, so in every mode the
+   * grid points outside the band hold the largest value with the sign of their side.
+   *
    * @param in_mesh The input triangle mesh to generate the SDF from.
    * @param expansion The expansion vector to apply around the mesh.
    * @param voxel_size The size of the voxels (default is `kDefaultVoxelSize`).
+   * @param sign_mode The method used for computing the sign of the field (default is `kSignModePseudoNormals`).
    * @return True if the SDF was successfully generated, otherwise false.
    */
   bool generate(const TriangleMesh& in_mesh,
                 const vec3& expansion,
-                real_t voxel_size = kDefaultVoxelSize);
+                real_t voxel_size = kDefaultVoxelSize,
+                SignMode sign_mode = kSignModePseudoNormals);
+
+  /**
+   * @brief Generates a signed distance field from the boundary of a tetrahedral mesh.
+   *
+   * The boundary half-faces of the tetrahedral mesh (see `TetMesh::getBoundaryHalfFaces`) are
+   * walked directly, without extracting a separate triangle mesh. The pseudo normals are computed
+   * from the boundary topology of the tetrahedral mesh: the vertex pseudo normals are indexed by
+   * the vertex ids of the tetrahedral mesh, and the edge pseudo normals by its half-edges.
+   *
+   * When closest face ids are kept, they are the half-face ids of the tetrahedral mesh.
+   *
+   * @param in_mesh The input tetrahedral mesh, whose boundary must be closed for the pseudo normal and scanline parity sign modes.
+   * @param expansion The expansion vector to apply around the boundary.
+   * @param voxel_size The size of the voxels (default is `kDefaultVoxelSize`).
+   * @param sign_mode The method used for computing the sign of the field (default is `kSignModePseudoNormals`).
+   * @return True if the SDF was successfully generated, otherwise false.
+   */
+  bool generate(const TetMesh& in_mesh,
+                const vec3& expansion,
+                real_t voxel_size = kDefaultVoxelSize,
+                SignMode sign_mode = kSignModePseudoNormals);
+
+  /**
+   * @brief Generates a signed distance field that does not fit in memory, slab by slab.
+   *
+   * The grid is processed in slabs of consecutive z layers. The faces are pre-binned to the slabs
+   * overlapped by their bands, every slab is generated in memory, appended to a binary SDF file
+   * (see `saveAsBinary`) and freed. The slab depth is the largest one that fits in the memory
+   * budget, after subtracting the occupancy grid for the scanline parity sign mode. The budget
+   * does not include the input mesh.
+   *
+   * The slabs are written to `filepath` with a `.partial` suffix, which replaces `filepath` once it
+   * is complete. On success the file is mapped with `mapBinary`, so the field can be queried right
+   * away. On failure the field is left as it was.
+   *
+   * @param in_mesh The input triangle mesh to generate the SDF from.
+   * @param expansion The expansion vector to apply around the mesh.
+   * @param voxel_size The size of the voxels.
+   * @param filepath The path of the binary SDF file to write.
+   * @param memory_budget_bytes The maximum memory used for the grid values (default is `kDefaultMemoryBudgetInBytes`).
+   * @param sign_mode The method used for computing the sign of the field (default is `kSignModePseudoNormals`).
+   * @return True if the SDF was successfully generated and mapped, otherwise false.
+   */
+  bool generateOutOfCore(const TriangleMesh& in_mesh,
+                         const vec3& expansion,
+                         real_t voxel_size,
+                         const std::string& filepath,
+                         uint64_t memory_budget_bytes = kDefaultMemoryBudgetInBytes,
+                         SignMode sign_mode = kSignModePseudoNormals);
+
+  /**
+   * @brief Computes the bounds of one shard of a grid that is generated by several processes.
+   *
+   * The z layers of the grid are split into `shard_count` runs of nearly equal depth. Every shard
+   * spans the whole grid along x and y, and shares its last z layer with the first layer of the
+   * next shard, so the shards can be interpolated up to their borders and tile the grid without
+   * gaps.
+   *
+   * @param global_bounds The bounding box of the whole grid.
+   * @param voxel_size The size of the voxels.
+   * @param shard_index The zero based index of the shard.
+   * @param shard_count The number of shards, at most the number of z layers of the grid.
+   * @param out_shard_bounds The bounding box of the shard.
+   * @return True if the shard bounds were computed, otherwise false.
+   */
+  static bool ComputeShardBounds(const AABB& global_bounds,
+                                 real_t voxel_size,
+                                 uint32_t shard_index,
+                                 uint32_t shard_count,
+                                 AABB& out_shard_bounds);
+
+  /**
+   * @brief Generates a single shard of a signed distance field.
+   *
+   * The resulting field covers the bounds returned by `ComputeShardBounds` for the mesh bounds
+   * expanded by `expansion`, and holds the same values as the corresponding grid points of
+   * `generate`. The halo of the shard is the set of faces whose bands reach into it, including
+   * faces that lie outside of the shard, so the bands near the shard borders are complete.
+   * Shards do not depend on each other and can be generated by separate processes, then stitched
+   * together with `MergeBinaryShards` or `SaveShardsAsPVTI`.
+   *
+   * The winding number and scanline parity sign modes are evaluated on the whole mesh. The
+   * scanline parity mode voxelizes only the layers of the shard, at one bit per grid point, since
+   * its scanlines run along x. On failure the field is left as it was.
+   *
+   * @param in_mesh The input triangle mesh to generate the SDF from.
+   * @param expansion The expansion vector to apply around the mesh.
+   * @param voxel_size The size of the voxels.
+   * @param shard_index The zero based index of the shard.
+   * @param shard_count The number of shards.
+   * @param sign_mode The method used for computing the sign of the field (default is `kSignModePseudoNormals`).
+   * @return True if the shard was successfully generated, otherwise false.
+   */
+  bool generateShard(const TriangleMesh& in_mesh,
+                     const vec3& expansion,
+                     real_t voxel_size,
+                     uint32_t shard_index,
+                     uint32_t shard_count,
+                     SignMode sign_mode = kSignModePseudoNormals);
+
+  /**
+   * @brief Stitches binary SDF shards into a single binary SDF file.
+   *
+   * The shards may be listed in any order. They must share the voxel size and the grid along x
+   * and y, and their z layers must cover the grid without gaps. The shards are mapped and copied
+   * layer by layer, so the merged field does not have to fit in memory.
+   *
+   * @param in_shard_filepaths The file paths of the binary SDF shards.
+   * @param out_filepath The file path of the merged binary SDF file.
+   * @return True if the shards were successfully merged, otherwise false.
+   */
+  static bool MergeBinaryShards(const std::vector<std::string>& in_shard_filepaths,
+                                const std::string& out_filepath);
+
+  /**
+   * @brief Saves binary SDF shards as a parallel VTK Image data (PVTI) collection.
+   *
+   * Every shard is written as a VTI piece next to the PVTI file, named after it with the shard
+   * number appended, and the PVTI file references the pieces by their extents in the whole grid.
+   * The shards must satisfy the same requirements as in `MergeBinaryShards`.
+   *
+   * @param in_shard_filepaths The file paths of the binary SDF shards.
+   * @param out_filepath The file path of the PVTI file.
+   * @return True if the collection was successfully saved, otherwise false.
+   */
+  static bool SaveShardsAsPVTI(const std::vector<std::string>& in_shard_filepaths,
+                               const std::string& out_filepath);
+
+  /**
+   * @brief Generates a voxel accurate signed distance field with a Euclidean distance transform.
+   *
+   * The mesh is voxelized by scanline parity into an `OccupancyGrid`, then the exact squared
+   * Euclidean distance transform is computed in parallel for the inside and the outside grid
+   * points. The distance of an outside point is its distance to the nearest inside point minus
+   * half a voxel, and vice versa for inside points, so the zero level set lies between the
+   * two. The result differs from `generate` by at most about one voxel, and it is defined on
+   * the entire grid instead of a narrow band.
+   *
+   * @param in_mesh The input triangle mesh, which must be closed.
+   * @param expansion The expansion vector to apply around the mesh.
+   * @param voxel_size The size of the voxels (default is `kDefaultVoxelSize`).
+   * @return True if the SDF was successfully generated, otherwise false.
+   */
+  bool generateByDistanceTransform(const TriangleMesh& in_mesh,
+                                   const vec3& expansion,
+                                   real_t voxel_size = kDefaultVoxelSize);
+
+  /**
+   * @brief Generates a signed distance field from an oriented point cloud.
+   *
+   * The points are hashed into a uniform grid with cells as large as the smoothing radius. Every
+   * grid point within the smoothing radius of some points holds the weighted average of its
+   * signed distances to their tangent planes, n_i . (p - x_i), with Wendland weights that fall off
+   * smoothly to zero at the smoothing radius. The grid is processed in parallel in bricks of
+   * grid points, and only the bricks near the points are visited. Grid points farther than the
+   * smoothing radius from all points keep the largest finite value, like the grid points outside
+   * the narrow band of `generate`.
+   *
+   * The smoothing radius should span a few point spacings, so that the neighborhoods are not empty
+   * between the points.
+   *
+   * @param in_positions The point positions.
+   * @param in_normals The unit outward normals, one per position.
+   * @param expansion The expansion vector to apply around the points.
+   * @param voxel_size The size of the voxels (default is `kDefaultVoxelSize`).
+   * @param smoothing_radius The radius of the neighborhood of every grid point, zero selects twice the voxel size.
+   * @return True if the SDF was successfully generated, otherwise false.
+   */
+  bool generateFromPointCloud(const std::vector<vec3>& in_positions,
+                              const std::vector<vec3>& in_normals,
+                              const vec3& expansion,
+                              real_t voxel_size = kDefaultVoxelSize,
+                              real_t smoothing_radius = 0.0);
 
   /**
    * @brief Retrieves the field value at a specific point in 3D space.
@@ -168,10 +489,197 @@ public:
    */
   real_t fieldValue(const vec3i& coords) const;
 
+  /**
+   * @brief Interpolates the field trilinearly at a point in space.
+   *
+   * Unlike `fieldValue`, grid points outside the narrow band are left out of the blend unless all
+   * corners are, and points outside the grid are treated as far outside of the surface. The field
+   * is read without locking, so it can be sampled from many threads at once but must not be
+   * modified meanwhile.
+   *
+   * @param p The 3D point at which to sample the field.
+   * @return The interpolated field value, or the largest real value outside the grid.
+   */
+  real_t sampleFieldValue(const vec3& p) const;
+
+  /**
+   * @brief Combines another signed distance field into this one with a CSG operation.
+   *
+   * The result is computed in place on the grid of this field, in parallel over its z layers.
+   * When both grids have the same voxel size and their grid points coincide, the values of `rhs`
+   * are read directly, otherwise `rhs` is resampled with trilinear interpolation. Grid points
+   * outside the bounds of `rhs` are treated as far outside of it. A mapped field is copied into
+   * memory first.
+   *
+   * A positive `blend_radius` replaces the minimum and the maximum with their polynomial smooth
+   * versions, which round the creases within `blend_radius` of the intersection of both surfaces.
+   *
+   * @ref Quilez, I. (2013). Smooth minimum. https://iquilezles.org/articles/smin/
+   *
+   * @param rhs The field to combine with this one.
+   * @param op The CSG operation.
+   * @param blend_radius The radius of the smooth blend, zero for sharp creases (default is 0).
+   * @return True if the fields were combined, otherwise false.
+   */
+  bool combine(const SignedDistanceField& rhs,
+               CsgOperation op,
+               real_t blend_radius = 0.0);
+
+  /**
+   * @brief Replaces this field with a resampled copy of another field on a new grid.
+   *
+   * Every grid point of the new grid is mapped with `transform` into the frame of `source`, where
+   * the field is reconstructed with the requested interpolation. The transform must be rigid, so
+   * the distances are preserved. The target grid is processed in parallel in cubic tiles, so the
+   * source grid points read by a tile stay within a small window of the source. The tricubic
+   * interpolation falls back to trilinear next to grid points outside the narrow band, and the
+   * grid points that map outside of `source` get the largest finite value.
+   *
+   * @param source The field to resample, which may be this field.
+   * @param bounds The bounding box of the new grid, in the frame of this field.
+   * @param voxel_size The voxel size of the new grid.
+   * @param interpolation The reconstruction method (default is `kInterpolationTrilinear`).
+   * @param transform The rigid transform from the frame of this field to the frame of `source` (default is identity).
+   * @return True if the field was resampled, otherwise false.
+   */
+  bool resample(const SignedDistanceField& source,
+                const AABB& bounds,
+                real_t voxel_size,
+                Interpolation interpolation = kInterpolationTrilinear,
+                const mat4& transform = mat4::Identity());
+
+  /**
+   * @brief Extracts an iso surface of the field as an indexed triangle list with marching cubes.
+   *
+   * The cell layers are split into slabs of fixed thickness that are processed in parallel. Each
+   * slab shares the vertices of its cells through rolling edge caches, and the vertices on the
+   * top layer of a slab are taken from the slab above it in a single stitching pass, so every
+   * crossed edge yields one vertex and the surface is closed wherever the band is. Cells with a
+   * corner outside the narrow band are skipped. The output only depends on the field, not on the
+   * number of threads.
+   *
+   * @ref Lorensen, W. E., & Cline, H. E. (1987). Marching cubes: A high resolution 3D surface construction algorithm. ACM SIGGRAPH Computer Graphics, 21(4), 163-169.
+   *
+   * @param out_vertices The vertex positions.
+   * @param out_faces The vertex ids of each triangle, counter clockwise when seen from outside.
+   * @param iso_value The field value of the surface (default is 0).
+   * @return True if the surface was extracted, otherwise false.
+   */
+  bool extractIsoSurface(std::vector<vec3>& out_vertices,
+                         std::vector<vec3i>& out_faces,
+                         real_t iso_value = 0.0) const;
+
+  /**
+   * @brief Extracts an iso surface of the field as a triangle mesh with marching cubes.
+   *
+   * @param out_mesh The triangle mesh, cleared before the surface is inserted.
+   * @param iso_value The field value of the surface (default is 0).
+   * @return True if the surface was extracted, otherwise false.
+   */
+  bool extractIsoSurface(TriangleMesh& out_mesh,
+                         real_t iso_value = 0.0) const;
+
+  /**
+   * @brief Extracts an iso surface of the field as an indexed triangle list with surface nets.
+   *
+   * Every cell whose corners straddle the iso value gets one vertex, and every crossed grid edge
+   * joins the vertices of its four cells with a quad, which is split along its shorter diagonal.
+   * On a closed surface this gives about as many triangles as marching cubes, two per crossed
+   * edge, but without the slivers marching cubes cuts next to grid points. The vertex is the
+   * mean of the closest points of the cell corners when the closest point offsets are kept,
+   * otherwise the mass point of the edge crossings moved by one gradient step of the trilinear
+   * field towards the surface. Either way it is clamped to its cell. Cells with a corner outside
+   * the narrow band are skipped.
+   *
+   * The cell layers are processed in parallel, and the vertex ids follow from the number of
+   * vertices per layer, so no vertex welding is needed and the output does not depend on the
+   * number of threads.
+   *
+   * @ref Gibson, S. F. F. (1998). Constrained elastic surface nets: Generating smooth surfaces from binary segmented data. MICCAI, 888-898.
+   *
+   * @param out_vertices The vertex positions.
+   * @param out_faces The vertex ids of each triangle, counter clockwise when seen from outside.
+   * @param iso_value The field value of the surface (default is 0).
+   * @return True if the surface was extracted, otherwise false.
+   */
+  bool extractSurfaceNets(std::vector<vec3>& out_vertices,
+                          std::vector<vec3i>& out_faces,
+                          real_t iso_value = 0.0) const;
+
+  /**
+   * @brief Extracts an iso surface of the field as a triangle mesh with surface nets.
+   *
+   * @param out_mesh The triangle mesh, cleared before the surface is inserted.
+   * @param iso_value The field value of the surface (default is 0).
+   * @return True if the surface was extracted, otherwise false.
+   */
+  bool extractSurfaceNets(TriangleMesh& out_mesh,
+                          real_t iso_value = 0.0) const;
+
+  /**
+   * @brief Extracts an iso surface with marching cubes and writes it to a binary STL file.
+   *
+   * The triangles are written directly from the indexed triangle list, without building the
+   * half-edge structure of a triangle mesh.
+   *
+   * @param filepath The file path where the surface will be saved.
+   * @param iso_value The field value of the surface (default is 0).
+   * @return True if the surface was extracted and saved, otherwise false.
+   */
+  bool saveIsoSurfaceAsSTL(const std::string& filepath,
+                           real_t iso_value = 0.0) const;
+
+  /**
+   * @brief Retrieves a view of an axis aligned slice of the field without copying it.
+   *
+   * The view is not guarded by the field mutex, so it must not be read while the field is being
+   * modified. It also works for mapped fields.
+   *
+   * @param axis The axis normal to the slice.
+   * @param index The grid point index of the slice along the axis.
+   * @return The view of the slice.
+   * @throws std::out_of_range if the index is outside the grid.
+   */
+  SliceView slice(SliceAxis axis, int index) const;
+
+  /**
+   * @brief Saves the field values to a NumPy array (NPY) file.
+   *
+   * The values are written in native byte order as a C ordered array of shape (nz, ny, nx), in a
+   * single write after the header. The header is padded so the values start at a 64 byte aligned
+   * offset, which lets `numpy.load(filepath, mmap_mode='r')` map the file without copying it.
+   *
+   * @ref NumPy format specification. https://numpy.org/doc/stable/reference/generated/numpy.lib.format.html
+   *
+   * @param filepath The file path where the field values will be saved.
+   * @return True if the field values were successfully saved, otherwise false.
+   */
+  bool saveAsNpy(const std::string& filepath) const;
+
+  /**
+   * @brief Saves an axis aligned slice of the field as a grayscale binary PGM image.
+   *
+   * The values in [-range, range] are mapped linearly to [0, 255], so the surface is mid gray,
+   * and the values outside are clamped. The image rows run along u and the last row is v = 0,
+   * see `SliceView`.
+   *
+   * @param filepath The file path where the image will be saved.
+   * @param axis The axis normal to the slice.
+   * @param index The grid point index of the slice along the axis.
+   * @param range The largest distance magnitude mapped inside [0, 255], zero selects the largest finite magnitude in the slice (default is 0).
+   * @return True if the image was successfully saved, otherwise false.
+   */
+  bool saveSliceAsPGM(const std::string& filepath,
+                      SliceAxis axis,
+                      int index,
+                      real_t range = 0.0) const;
+
   /**
    * @brief Saves the signed distance field to a VTK Image data (VTI) file.
    *
-   * This function writes the SDF data to a VTK Image data file for later use.
+   * This function writes the SDF data to a VTK Image data file for later use. The closest face
+   * ids and closest point offsets are written as the extra `ClosestFaceId` and
+   * `ClosestPointOffset` point data arrays when the field holds them.
    *
    * @param filepath The file path where the SDF will be saved.
    * @return True if the SDF was successfully saved, otherwise false.
@@ -188,6 +696,50 @@ public:
    */
   bool loadAsVTI(const std::string& filepath);
 
+  /**
+   * @brief Saves the signed distance field to a binary SDF file.
+   *
+   * The file starts with a fixed size header holding a magic string, the format version, the size
+   * of `real_t`, the grid points count, the voxel size and the bounds. It is followed by the raw
+   * field values in native byte order, laid out as in `gridPointId`.
+   *
+   * @param filepath The file path where the SDF will be saved.
+   * @return True if the SDF was successfully saved, otherwise false.
+   */
+  bool saveAsBinary(const std::string& filepath) const;
+
+  /**
+   * @brief Loads a binary SDF file into memory.
+   *
+   * @param filepath The file path of the binary SDF file.
+   * @return True if the SDF was successfully loaded, otherwise false.
+   */
+  bool loadAsBinary(const std::string& filepath);
+
+  /**
+   * @brief Maps a binary SDF file into memory for read-only queries.
+   *
+   * The field values are paged in by the operating system on demand, so fields larger than the
+   * physical memory can be queried. The mapping is released when the field is regenerated,
+   * loaded, assigned or destroyed.
+   *
+   * @param filepath The file path of the binary SDF file.
+   * @return True if the file was successfully mapped, otherwise false.
+   */
+  bool mapBinary(const std::string& filepath);
+
+  /**
+   * @brief Logs the NUMA placement and the huge page coverage of the field storage.
+   */
+  void logPagePlacement() const;
+
+  /**
+   * @brief Checks whether the field values are served from a mapped file.
+   *
+   * @return True if the field is mapped, otherwise false.
+   */
+  bool isMapped() const;
+
   /**
    * @brief Assignment operator.
    *
@@ -219,14 +771,105 @@ private:
    */
   void assertGridPointCoords(const vec3i& coords) const;
 
+  bool validateGenerateArgs(const TriangleMesh& in_mesh,
+                            real_t voxel_size,
+                            SignMode sign_mode) const;
+
+  bool prepareSignEvaluation(const TriangleMesh& in_mesh,
+                             SignMode sign_mode,
+                             std::unique_ptr<WindingNumberTree>& out_tree,
+                             std::unique_ptr<OccupancyGrid>& out_occupancy) const;
+
+  bool prepareSignEvaluation(const std::vector<vec3>& in_triangle_vertices,
+                             SignMode sign_mode,
+                             std::unique_ptr<WindingNumberTree>& out_tree,
+                             std::unique_ptr<OccupancyGrid>& out_occupancy) const;
+
+  /**
+   * @brief Computes the range of grid points [out_start, out_stop) within the band of a face.
+   */
+  void computeFaceBand(const std::array<vec3, 3>& in_face_vertices,
+                       vec3i& out_start,
+                       vec3i& out_stop) const;
+
+  /**
+   * @brief Computes the signed field values of the z layers [z_begin, z_end) from the given faces.
+   *
+   * The surface provides `faceVertices` and `facePseudoNormals` per face id, see the surface
+   * adapters of the triangle mesh and of the tetrahedral mesh boundary in the source file.
+   */
+  template <typename SurfaceT>
+  void generateSlab(const SurfaceT& in_surface,
+                    const std::vector<uint32_t>& in_face_ids,
+                    int z_begin,
+                    int z_end,
+                    SignMode sign_mode,
+                    const WindingNumberTree* tree,
+                    const OccupancyGrid* occupancy,
+                    GridVector<real_t>& out_values,
+                    GridVector<uint32_t>* out_closest_face_ids = nullptr,
+                    GridVector<vec3>* out_closest_point_offsets = nullptr) const;
+
+  /**
+   * @brief Maps the shards, sorts them along z and computes their first z layer in the whole grid.
+   */
+  static bool MapShards(const std::vector<std::string>& in_shard_filepaths,
+                        std::vector<std::unique_ptr<SignedDistanceField>>& out_shards,
+                        std::vector<int>& out_z_offsets);
+
+  /**
+   * @brief Writes the field as a VTI file whose extents start at extent_offset in a larger grid.
+   */
+  bool writeVTI(const std::string& filepath, const vec3i& extent_offset) const;
+
+  /**
+   * @brief Interpolates the field trilinearly at p without locking, or returns outside_value if p is outside the grid.
+   *
+   * Corners outside the narrow band are left out of the blend, unless all of them are.
+   */
+  real_t interpolateTrilinear(const vec3& p, real_t outside_value) const;
+
+  /**
+   * @brief Interpolates the field with Catmull-Rom splines at p without locking, or returns outside_value if p is outside the grid.
+   */
+  real_t interpolateTricubic(const vec3& p, real_t outside_value) const;
+
+  /**
+   * @brief Finds the cell that contains p in local grid coordinates, returns false if p is outside the grid.
+   */
+  bool locateCell(const vec3& p, vec3i& out_cell, vec3& out_t) const;
+
+  bool writeBinaryHeader(std::ostream& out_stream) const;
+
+  /**
+   * @brief Reads and validates a binary header without changing the field, and seeks to the field values.
+   */
+  bool readBinaryHeader(std::istream& in_stream,
+                        AABB& out_bounds,
+                        real_t& out_voxel_size,
+                        uint64_t& out_count_values) const;
+
+  const real_t* fieldValuesData() const;
+
+  uint64_t countFieldValues() const;
+
+  void clearClosestFeatures();
+
+  void releaseMapping();
+
   bool parseAsciiValues(const std::string& in_data_string,
-                        std::vector<real_t>& out_data_values);
+                        GridVector<real_t>& out_data_values);
 
 private:
   real_t voxel_size_ = kDefaultVoxelSize; /**< The size of each voxel in the SDF. */
   AABB bounds_; /**< The axis-aligned bounding box (AABB) of the SDF. */
-  std::vector<real_t> field_values_; /**< The field values at each grid point. */
+  GridVector<real_t> field_values_; /**< The field values at each grid point. */
   mutable std::mutex field_values_mutex_; /**< Mutex for thread-safe access to magnitudes and signs. */
+  ClosestFeatureStorage closest_feature_storage_ = kClosestFeatureNone; /**< The closest feature data kept by generate. */
+  GridVector<uint32_t> closest_face_ids_; /**< The closest face id at each grid point, if kept. */
+  GridVector<vec3> closest_point_offsets_; /**< The offset to the closest point at each grid point, if kept. */
+  void* mapped_address_ = nullptr; /**< Start of the mapped binary file, or nullptr. */
+  uint64_t mapped_length_ = 0; /**< Length of the mapped binary file in bytes. */
 };
 
 }
\ No newline at end of file
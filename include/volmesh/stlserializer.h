@@ -8,7 +8,11 @@
 
 #pragma once
 
+#include "volmesh/basetypes.h"
+
 #include <string>
+#include <vector>
+
 namespace volmesh {
 
 class TriangleMesh;
@@ -62,4 +66,19 @@ bool ReadBinarySTL(const std::string& in_mesh_filepath, TriangleMesh& out_triang
  */
 bool WriteBinarySTL(const std::string& in_mesh_filepath, const TriangleMesh& in_triangle_mesh);
 
+/**
+ * @brief Writes an indexed triangle list to a binary STL file.
+ *
+ * This function writes the triangles directly, without building the half-edge structure of a
+ * `TriangleMesh`. The normal of each triangle is computed from its vertices.
+ *
+ * @param in_mesh_filepath The file path where the output binary STL file will be written.
+ * @param in_vertices The vertex positions.
+ * @param in_faces The vertex ids of each triangle, counter clockwise when seen from outside.
+ * @return True if the binary STL file was successfully written, false otherwise.
+ */
+bool WriteBinarySTL(const std::string& in_mesh_filepath,
+                    const std::vector<vec3>& in_vertices,
+                    const std::vector<vec3i>& in_faces);
+
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 
 #include "volmesh/basetypes.h"
 #include "volmesh/mathutils.h"
+#include "volmesh/gridallocator.h"
 #include "volmesh/index.h"
 #include "volmesh/halfface.h"
 #include "volmesh/aabb.h"
@@ -237,7 +238,7 @@ private:
    * Each half-face is represented by the type HalfFaceType, which holds information
    * about the face's connectivity and orientation.
    */
-  std::vector<HalfFaceType> hfaces_;
+  GridVector<HalfFaceType> hfaces_;
 
   /**
    * @brief Vector storing the normals associated with each half-face.
@@ -271,7 +272,7 @@ private:
    * This vector contains all the half-edges present in the mesh. Each half-edge represents a directed edge
    * in the mesh structure.
    */
-  std::vector<HalfEdge> hedges_;
+  GridVector<HalfEdge> hedges_;
 
   /**
    * @brief Stores the pseudo-normal vectors of half-edges.
@@ -304,7 +305,7 @@ private:
    * This vector contains the positions (as real numbers) of each vertex in the mesh. Each entry in the vector
    * corresponds to the coordinates of a vertex.
    */
-  std::vector<real_t> vertices_;
+  GridVector<real_t> vertices_;
 
   /**
    * @brief Stores the pseudo-normal vectors of vertices.
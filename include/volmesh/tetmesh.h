@@ -92,6 +92,95 @@ public:
   bool insertVoxel(const std::array<int, Voxel::kNumVerticesPerCell>& in_voxel_vertex_ids,
                    std::array<CellIndex, Voxel::kNumFittingTetrahedra>& out_tet_cell_ids);
 
+  /**
+   * @brief Reads a tetrahedral mesh from the selected voxels of a regular grid.
+   *
+   * Every selected voxel is split into the tetrahedra of `insertVoxel`. The vertices are the used
+   * grid points in grid order, and the cells are the tetrahedra of `Voxel::fittingTetrahedraVertexIdsLut`
+   * for each selected voxel in voxel order. Instead of hashing or sorting the elements, the topology
+   * is built with structured index arithmetic. An edge or a face is identified by the grid point it is
+   * anchored at and its shape, and its first occurrence in the cells is found from the few selected
+   * voxels around that grid point. Numbering the elements at their first occurrence with a prefix sum
+   * over the z layers gives the half-edges, half-faces and cells the same ids as `readFromList` and as
+   * inserting the cells one by one with `insertTetrahedra`, for any number of threads.
+   *
+   * @param origin The position of the first grid point.
+   * @param voxel_size The edge length of the voxels.
+   * @param voxels_count The number of voxels along each axis.
+   * @param in_voxel_mask One entry per voxel with x varying fastest, non-zero for the selected voxels.
+   * @return True if at least one voxel was selected and the mesh was built, otherwise false.
+   */
+  bool readFromVoxelGrid(const vec3& origin,
+                         real_t voxel_size,
+                         const vec3i& voxels_count,
+                         const std::vector<uint8_t>& in_voxel_mask);
+
+  /**
+   * @brief Reads a tetrahedral mesh from the selected voxels of a regular grid with another id order.
+   *
+   * Builds the same mesh as the overload above, except that the used grid points and the selected
+   * voxels are numbered along the given axes instead of with x varying fastest. With the axes
+   * (0, 1, 2), z varies fastest and the vertex and cell ids of a full grid are those of
+   * `createVoxelGrid`. The voxel mask keeps x varying fastest.
+   *
+   * @param origin The position of the first grid point.
+   * @param voxel_size The edge length of the voxels.
+   * @param voxels_count The number of voxels along each axis.
+   * @param in_voxel_mask One entry per voxel with x varying fastest, non-zero for the selected voxels.
+   * @param in_id_axes The axes from the slowest to the fastest varying in the vertex and cell ids.
+   * @return True if at least one voxel was selected and the mesh was built, otherwise false.
+   */
+  bool readFromVoxelGrid(const vec3& origin,
+                         real_t voxel_size,
+                         const vec3i& voxels_count,
+                         const std::vector<uint8_t>& in_voxel_mask,
+                         const vec3i& in_id_axes);
+
+  /**
+   * @brief Assigns a material label to every cell.
+   *
+   * The labels are a column next to the cells, in cell order. Reading a new mesh drops them, and
+   * inserting or removing cells afterwards invalidates them, see `hasCellLabels`.
+   *
+   * @param in_cell_labels One label per cell.
+   * @return True if there is one label per cell, otherwise false.
+   */
+  bool setCellLabels(const std::vector<uint32_t>& in_cell_labels);
+
+  /**
+   * @brief Checks whether every cell has a material label.
+   */
+  bool hasCellLabels() const;
+
+  /**
+   * @brief Retrieves the material label of a cell.
+   *
+   * @param in_cell_id The cell id.
+   * @return The label of the cell.
+   */
+  uint32_t cellLabel(const CellIndex& in_cell_id) const;
+
+  /**
+   * @brief Retrieves the material labels of all cells, in cell order.
+   */
+  const std::vector<uint32_t>& cellLabels() const;
+
+  /**
+   * @brief Collects the half-faces on the boundary of the tetrahedral mesh.
+   *
+   * The two halves of every edge and of every face are stored next to each other, so `hedge ^ 1`
+   * and `hface ^ 1` are the opposite halves. A neighboring cell references a shared face with the
+   * opposite half-edges, so a cell face is keyed by the edges of its half-edges and the faces that
+   * occur in a single cell are on the boundary. Their opposite half-faces are returned, in
+   * increasing order, and face away from the cells when the cells are positively oriented, as
+   * inserted by `insertVoxel`. No half-face is returned when the halves are not paired, as after
+   * inserting a cell with a repeated vertex.
+   *
+   * @param out_boundary_hfaces The ids of the boundary half-faces.
+   * @return The number of boundary half-faces.
+   */
+  uint32_t getBoundaryHalfFaces(std::vector<HalfFaceIndex>& out_boundary_hfaces) const;
+
   /**
    * @brief Extracts the boundary triangle mesh from the tetrahedral mesh.
    *
@@ -103,6 +192,15 @@ public:
   /**
    * @brief Reads a tetrahedral mesh from a list of vertices and tetrahedral cells.
    *
+   * The topology is built in bulk rather than cell by cell. The edges, faces and cells of all
+   * tetrahedra are keyed, the keys are bucketed by their smallest vertex or half-edge id, and equal
+   * keys are merged within each bucket, so no element is looked up in the incidence lists. The
+   * elements get the ids that inserting the cells one by one with `insertTetrahedra` gives them, and
+   * a repeated cell is kept once. Lists with a cell that repeats a vertex are inserted one by one.
+   *
+   * The keys are made and merged by all worker threads, in blocks of cells and ranges of keys that
+   * do not depend on the number of threads, so the ids are the same for any `SetMaxThreadsCount`.
+   *
    * @param in_vertices List of vertex positions.
    * @param in_tet_cells_by_vertex_ids List of tetrahedral cells, each defined by four vertex indices.
    * @return True if the mesh was successfully read, false otherwise.
@@ -123,11 +221,16 @@ public:
   /**
    * @brief Exports the tetrahedral mesh to a VTK file.
    *
+   * When every cell has a material label, the labels are written as the `Material` cell data.
+   *
    * @param filepath The path where the VTK file will be saved.
    * @param is_binary Flag to determine whether the VTK file should be in binary format.
    * @return True if the mesh was successfully exported, false otherwise.
    */
   bool exportToVTK(const std::string& filepath, const bool is_binary);
+
+private:
+  std::vector<uint32_t> cell_labels_; /**< The material label of each cell, if assigned. */
 };
 
 }
\ No newline at end of file
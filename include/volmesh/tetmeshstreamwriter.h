@@ -0,0 +1,160 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @class TetMeshStreamWriter
+ * @brief Writes a tetrahedral mesh to a legacy VTK file in chunks, without building a `TetMesh`.
+ *
+ * Meshers that only need the output file pass their vertices and cells in chunks as they generate
+ * them, so the half-edges, half-faces and incidence lists of a `TetMesh` are never allocated. The
+ * chunks are appended to raw temporary files next to the output, and `close` assembles the file in
+ * the format of `TetMesh::exportToVTK`, so both write the same bytes for the same mesh.
+ *
+ * The cells may refer to vertices that are written later, as long as all of them are written before
+ * `close`. The boundary of the mesh is extracted by a second pass over the written cells, see
+ * `extractBoundary`.
+ */
+class TetMeshStreamWriter {
+public:
+  /**
+   * @brief Default constructor.
+   */
+  TetMeshStreamWriter();
+
+  /**
+   * @brief Destructor, discards the output of a writer that was not closed.
+   */
+  ~TetMeshStreamWriter();
+
+  TetMeshStreamWriter(const TetMeshStreamWriter&) = delete;
+  TetMeshStreamWriter& operator=(const TetMeshStreamWriter&) = delete;
+
+  /**
+   * @brief Starts a new mesh for a VTK file.
+   *
+   * @param filepath The path of the VTK file written by `close`.
+   * @param is_binary True for the binary VTK format, false for ASCII.
+   * @return True if the temporary files were created, otherwise false.
+   */
+  bool open(const std::string& filepath, bool is_binary);
+
+  /**
+   * @brief Checks whether a mesh was opened and not closed yet.
+   */
+  bool isOpen() const;
+
+  /**
+   * @brief Appends vertices, numbered after the vertices written before.
+   *
+   * @param in_vertices The vertex positions.
+   * @return True if the vertices were written, otherwise false.
+   */
+  bool writeVertices(const std::vector<vec3>& in_vertices);
+
+  /**
+   * @brief Appends cells, numbered after the cells written before.
+   *
+   * @param in_tet_cells_by_vertex_ids The positively oriented tetrahedra, by vertex ids.
+   * @return True if the cells were written, otherwise false.
+   */
+  bool writeCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids);
+
+  /**
+   * @brief Appends cells with a material label each, see `TetMesh::cellLabels`.
+   *
+   * Either all cells of a mesh have labels or none of them.
+   *
+   * @param in_tet_cells_by_vertex_ids The positively oriented tetrahedra, by vertex ids.
+   * @param in_cell_labels One material label per cell.
+   * @return True if the cells were written, otherwise false.
+   */
+  bool writeCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids,
+                  const std::vector<uint32_t>& in_cell_labels);
+
+  /**
+   * @brief The number of vertices written so far.
+   */
+  uint64_t countVertices() const;
+
+  /**
+   * @brief The number of cells written so far.
+   */
+  uint64_t countCells() const;
+
+  /**
+   * @brief Extracts the boundary faces of the cells written so far, by a second pass over them.
+   *
+   * A face is on the boundary when a single cell has it. The cells are read back one chunk of
+   * `writeCells` at a time, and a face is settled as soon as no later chunk can have it, because
+   * its smallest vertex id is below the smallest vertex id of all later chunks. When the chunks
+   * follow the vertex ids, as the layers of a grid do, only the faces along the current chunk are
+   * held in memory. The boundary vertices are read back from the written vertices.
+   *
+   * @param out_vertices The positions of the boundary vertices.
+   * @param out_faces The boundary triangles by ids of out_vertices, counter clockwise when seen from outside.
+   * @return True if the boundary was extracted, otherwise false.
+   */
+  bool extractBoundary(std::vector<vec3>& out_vertices,
+                       std::vector<vec3i>& out_faces);
+
+  /**
+   * @brief Writes the VTK file and removes the temporary files.
+   *
+   * @return True if the file was written, otherwise false.
+   */
+  bool close();
+
+private:
+  /**
+   * @brief Removes the temporary files and resets the writer.
+   */
+  void discard();
+
+  /**
+   * @brief Appends cells and records the chunk for `extractBoundary`.
+   */
+  bool appendCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids);
+
+  /**
+   * @brief A chunk of cells passed to `writeCells`.
+   */
+  struct CellChunk {
+    uint64_t count_cells;
+    int32_t min_vertex_id;
+  };
+
+  std::string filepath_;
+  bool is_binary_ = false;
+  bool is_open_ = false;
+
+  std::string vertices_filepath_;
+  std::string cells_filepath_;
+  std::string labels_filepath_;
+  std::ofstream vertices_file_;
+  std::ofstream cells_file_;
+  std::ofstream labels_file_;
+
+  uint64_t count_vertices_ = 0;
+  uint64_t count_cells_ = 0;
+  uint64_t count_labels_ = 0;
+  int64_t max_vertex_id_ = -1;
+  std::vector<CellChunk> cell_chunks_;
+};
+
+}
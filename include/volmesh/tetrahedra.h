@@ -120,6 +120,15 @@ public:
    */
   real_t aspectRatio() const;
 
+  /**
+   * @brief Computes the dihedral angles of the tetrahedron.
+   *
+   * The dihedral angle of an edge is the interior angle between the two faces that share it.
+   *
+   * @return The dihedral angles in radians, in the order of the edges of `edgeVertexIdsLut`.
+   */
+  std::array<real_t, kNumEdges> dihedralAngles() const;
+
   /**
    * @brief Computes the centroid of the tetrahedron.
    *
@@ -138,6 +147,15 @@ public:
    */
   real_t determinant() const;
 
+  /**
+   * @brief Computes the exact sign of the determinant of the tetrahedron.
+   *
+   * Unlike the sign of `determinant`, it is reliable for nearly flat tetrahedra, see `Orient3d`.
+   *
+   * @return 1 for a positive determinant, -1 for a negative one and 0 for a flat tetrahedron.
+   */
+  int orientation() const;
+
   /**
    * @brief Computes the volume of the tetrahedron.
    *
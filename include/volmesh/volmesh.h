@@ -10,8 +10,13 @@
 
 #include "volmesh/cell.h"
 #include "volmesh/basetypes.h"
+#include "volmesh/gridallocator.h"
 #include "volmesh/index.h"
+#include "volmesh/parallel.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <unordered_map>
 #include <mutex>
@@ -185,6 +190,25 @@ public:
    */
   bool insertAllVertices(const std::vector<vec3>& in_vertices);
 
+  /**
+   * @brief Replaces all elements of the mesh with elements that were built in bulk.
+   *
+   * Meant for meshers that compute the topology of the whole mesh at once. Nothing is looked up,
+   * so the caller guarantees that no element is duplicated, and the incident element lists are
+   * counted and filled by all worker threads. Every list holds its elements in increasing order, as
+   * after inserting them one by one, for any number of threads.
+   *
+   * @param in_vertices The vertex positions.
+   * @param in_hedges The half-edges, moved into the mesh.
+   * @param in_hfaces The half-faces, moved into the mesh.
+   * @param in_cells The cells, moved into the mesh.
+   * @return True if all elements reference existing elements, otherwise false and the mesh is left unchanged.
+   */
+  bool assignTopology(const std::vector<vec3>& in_vertices,
+                      GridVector<HalfEdge>&& in_hedges,
+                      GridVector<HalfFaceType>&& in_hfaces,
+                      GridVector<CellType>&& in_cells);
+
   /**
    * @brief Inserts a half-edge into the mesh if it does not already exist.
    *
@@ -241,7 +265,7 @@ private:
   mutable std::mutex cells_mutex_;
 
   /// Vector of all cells in the mesh.
-  std::vector<CellType> cells_;
+  GridVector<CellType> cells_;
 
   /// Incident cells per half-face.
   std::vector<std::vector<uint32_t>> incident_cells_per_hface_;
@@ -250,7 +274,7 @@ private:
   mutable std::mutex hfaces_mutex_;
 
   /// Vector of all half-faces in the mesh.
-  std::vector<HalfFaceType> hfaces_;
+  GridVector<HalfFaceType> hfaces_;
 
   /// Incident half-faces per half-edge.
   std::vector<std::vector<uint32_t>> incident_hfaces_per_hedge_;
@@ -259,7 +283,7 @@ private:
   mutable std::mutex hedges_mutex_;
 
   /// Vector of all half-edges in the mesh.
-  std::vector<HalfEdge> hedges_;
+  GridVector<HalfEdge> hedges_;
 
   /// Incident half-edges per vertex.
   std::vector<std::vector<uint32_t>> incident_hedges_per_vertex_;
@@ -268,7 +292,7 @@ private:
   mutable std::mutex vertices_mutex_;
 
   /// Vector of all vertices in the mesh.
-  std::vector<real_t> vertices_;
+  GridVector<real_t> vertices_;
 };
 
 #include "volmesh/volmesh.tpp"
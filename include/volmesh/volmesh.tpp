@@ -29,10 +29,13 @@ void VolMesh<kNumFacesPerCell, kNumEdgesPerFace, LayoutPolicy>::copyFrom(const V
 
 template <int kNumFacesPerCell, int kNumEdgesPerFace, template <int NumFacesPerCell, int NumEdgesPerFace> class LayoutPolicy>
 void VolMesh<kNumFacesPerCell, kNumEdgesPerFace, LayoutPolicy>::clear() {
-  //top-down clear
+  //top-down clear, including the incident lists so the find methods see no stale elements
   cells_.clear();
+  incident_cells_per_hface_.clear();
   hfaces_.clear();
+  incident_hfaces_per_hedge_.clear();
   hedges_.clear();
+  incident_hedges_per_vertex_.clear();
   vertices_.clear();
 }
 
@@ -163,6 +166,119 @@ bool VolMesh<kNumFacesPerCell, kNumEdgesPerFace, LayoutPolicy>::insertAllVertice
   }
 }
 
+template <int kNumFacesPerCell, int kNumEdgesPerFace, template <int NumFacesPerCell, int NumEdgesPerFace> class LayoutPolicy>
+bool VolMesh<kNumFacesPerCell, kNumEdgesPerFace, LayoutPolicy>::assignTopology(const std::vector<vec3>& in_vertices,
+                                                                               GridVector<HalfEdge>&& in_hedges,
+                                                                               GridVector<HalfFaceType>&& in_hfaces,
+                                                                               GridVector<CellType>&& in_cells) {
+  const uint64_t count_vertices = in_vertices.size();
+  const uint64_t count_hedges = in_hedges.size();
+  const uint64_t count_hfaces = in_hfaces.size();
+  if(count_vertices == 0 || std::max({count_vertices, count_hedges, count_hfaces, static_cast<uint64_t>(in_cells.size())}) >= kSentinelIndex) {
+    return false;
+  }
+
+  for(const HalfEdge& hedge : in_hedges) {
+    if(hedge.start().get() >= count_vertices || hedge.end().get() >= count_vertices) {
+      return false;
+    }
+  }
+
+  for(const HalfFaceType& hface : in_hfaces) {
+    for(int i=0; i < kNumEdgesPerFace; i++) {
+      if(hface.halfEdgeIndex(i).get() >= count_hedges) {
+        return false;
+      }
+    }
+  }
+
+  for(const CellType& cell : in_cells) {
+    for(int i=0; i < kNumFacesPerCell; i++) {
+      if(cell.halfFaceIndex(i).get() >= count_hfaces) {
+        return false;
+      }
+    }
+  }
+
+  clear();
+  insertAllVertices(in_vertices);
+
+  //rebuild the incident lists in the order of the elements, as the insert methods do. Every list is
+  //sized from the counts of its entries, filled by all threads at once and then sorted, so the lists
+  //are the same for any number of threads.
+  auto build_lists = [](std::vector<std::vector<uint32_t>>& lists,
+                        uint64_t count_lists,
+                        uint64_t count_elements,
+                        int count_entries_per_element,
+                        const auto& list_of_entry) {
+    const uint64_t kElementsPerTask = 1 << 12;
+    std::unique_ptr<std::atomic<uint32_t>[]> cursors(new std::atomic<uint32_t>[count_lists]);
+    ParallelFor(0, count_lists, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+        cursors[i].store(0, std::memory_order_relaxed);
+      }
+    }, kElementsPerTask);
+
+    ParallelFor(0, count_elements, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+        for(int k=0; k < count_entries_per_element; k++) {
+          cursors[list_of_entry(i, k)].fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }, kElementsPerTask);
+
+    lists.resize(0);
+    lists.resize(count_lists);
+    ParallelFor(0, count_lists, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+        lists[i].resize(cursors[i].load(std::memory_order_relaxed));
+        cursors[i].store(0, std::memory_order_relaxed);
+      }
+    }, kElementsPerTask);
+
+    ParallelFor(0, count_elements, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+        for(int k=0; k < count_entries_per_element; k++) {
+          const uint32_t list_id = list_of_entry(i, k);
+          lists[list_id][cursors[list_id].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(i);
+        }
+      }
+    }, kElementsPerTask);
+
+    ParallelFor(0, count_lists, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+        std::sort(lists[i].begin(), lists[i].end());
+      }
+    }, kElementsPerTask);
+  };
+
+  {
+    std::lock_guard<std::mutex> lck(hedges_mutex_);
+    hedges_ = std::move(in_hedges);
+    build_lists(incident_hedges_per_vertex_, count_vertices, count_hedges, 1, [this](uint64_t i, int) {
+      return hedges_[i].start().get();
+    });
+  }
+
+  {
+    std::lock_guard<std::mutex> lck(hfaces_mutex_);
+    hfaces_ = std::move(in_hfaces);
+    build_lists(incident_hfaces_per_hedge_, count_hedges, count_hfaces, kNumEdgesPerFace, [this](uint64_t i, int e) {
+      return hfaces_[i].halfEdgeIndex(e).get();
+    });
+  }
+
+  {
+    std::lock_guard<std::mutex> lck(cells_mutex_);
+    cells_ = std::move(in_cells);
+    build_lists(incident_cells_per_hface_, count_hfaces, cells_.size(), kNumFacesPerCell, [this](uint64_t i, int f) {
+      return cells_[i].halfFaceIndex(f).get();
+    });
+  }
+
+  return true;
+}
+
 template <int kNumFacesPerCell, int kNumEdgesPerFace, template <int NumFacesPerCell, int NumEdgesPerFace> class LayoutPolicy>
 HalfEdgeIndex VolMesh<kNumFacesPerCell, kNumEdgesPerFace, LayoutPolicy>::insertHalfEdgeIfNotExists(const HalfEdge& in_hedge) {
   HalfEdgeIndex hedge_index = HalfEdgeIndex::create(kSentinelIndex);
@@ -139,6 +139,26 @@ public:
   static Voxel CreateVoxel(const vec3& center,
                            const vec3& axis_lengths);
 
+  /**
+   * @brief Static lookup table for the grid offset of a vertex from the LBN vertex.
+   *
+   * @param vertex_id The ID of the vertex (0-7).
+   * @return A vec3i with the offset along each axis, either 0 or 1.
+   */
+  static vec3i vertexOffsetLut(const int vertex_id);
+
+  /**
+   * @brief Static lookup table for the vertex IDs of a fitting tetrahedron.
+   *
+   * The six tetrahedra fill the voxel and are positively oriented. The diagonals that split
+   * opposite faces of the voxel are parallel, so the tetrahedra of neighboring voxels agree on
+   * their shared faces.
+   *
+   * @param tet_id The ID of the tetrahedron (0-5).
+   * @return A vec4i containing the vertex IDs of the specified tetrahedron.
+   */
+  static vec4i fittingTetrahedraVertexIdsLut(const int tet_id);
+
 private:
   /// Array of vertices defining the voxel.
   VoxelVertexArray vertices_;
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetmeshstreamwriter.h"
+#include "volmesh/voxel.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Selects the voxels of a signed distance field that lie inside its zero level set.
+ *
+ * A voxel is selected when at least `min_inside_corners` of its corner grid points have a negative
+ * field value. The voxels are classified in parallel over z layers, reading the field through
+ * slice views.
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param min_inside_corners The number of inside corners of a selected voxel in [1, 8].
+ * @param out_voxel_mask One entry per voxel with x varying fastest, 1 for the selected voxels.
+ * @return The number of selected voxels.
+ */
+uint64_t ClassifyInteriorVoxels(const SignedDistanceField& in_sdf,
+                                int min_inside_corners,
+                                std::vector<uint8_t>& out_voxel_mask);
+
+/**
+ * @brief Splits the voxels inside the zero level set of a signed distance field into tetrahedra.
+ *
+ * Meant for coarse simulation proxies, the mesh follows the voxels of the field rather than the
+ * surface. The voxels are selected by `ClassifyInteriorVoxels` and split into the six tetrahedra of
+ * `Voxel::fittingTetrahedraVertexIdsLut` by `TetMesh::readFromVoxelGrid`, which builds the topology
+ * in bulk. Only the grid points used by the selected voxels become vertices.
+ *
+ * The voxels are classified by the sign of the field, so the grid points outside the narrow band
+ * must be signed too, as with `SignedDistanceField::kSignModeScanlineParity`.
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param out_mesh The tetrahedral mesh.
+ * @param min_inside_corners The number of inside corners of a selected voxel in [1, 8] (default is all of them).
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool MeshInteriorVoxels(const SignedDistanceField& in_sdf,
+                        TetMesh& out_mesh,
+                        int min_inside_corners = Voxel::kNumVerticesPerCell);
+
+/**
+ * @brief Splits the voxels inside the zero level set of a signed distance field into tetrahedra and streams them to a file.
+ *
+ * Produces the mesh of `MeshInteriorVoxels` without building a `TetMesh` or a mask of the whole
+ * grid. The voxels are classified one z layer at a time, and the used grid points of every layer
+ * and the tetrahedra of every voxel layer are passed to the writer as soon as they are known, so
+ * only three layers of the grid are held in memory. The vertices and cells come in the order of
+ * `TetMesh::readFromVoxelGrid`, so the file matches `TetMesh::exportToVTK` of `MeshInteriorVoxels`,
+ * and every voxel layer is one chunk for `TetMeshStreamWriter::extractBoundary`.
+ *
+ * @param in_sdf The signed distance field, negative inside and signed outside the narrow band.
+ * @param inout_writer An open stream writer, closed by the caller.
+ * @param min_inside_corners The number of inside corners of a selected voxel in [1, 8] (default is all of them).
+ * @return True if a non-empty mesh was written, otherwise false.
+ */
+bool StreamInteriorVoxels(const SignedDistanceField& in_sdf,
+                          TetMeshStreamWriter& inout_writer,
+                          int min_inside_corners = Voxel::kNumVerticesPerCell);
+
+/**
+ * @brief Selects the voxels inside the union of several signed distance fields and labels them by material.
+ *
+ * A voxel is selected when at least `min_inside_corners` of its corner grid points are inside any of
+ * the fields, so voxels straddling the interface of two materials are kept and the materials share
+ * their interfaces. Every voxel is labeled with the field that has the most of its corners inside,
+ * where earlier fields take precedence on ties. The fields must share one grid, see
+ * `SignedDistanceField::resample`.
+ *
+ * @param in_sdfs The signed distance fields, one per material label.
+ * @param min_inside_corners The number of inside corners of a selected voxel in [1, 8].
+ * @param out_voxel_mask One entry per voxel with x varying fastest, 1 for the selected voxels.
+ * @param out_voxel_labels One material label per voxel with x varying fastest.
+ * @return The number of selected voxels.
+ */
+uint64_t ClassifyMaterialVoxels(const std::vector<const SignedDistanceField*>& in_sdfs,
+                                int min_inside_corners,
+                                std::vector<uint8_t>& out_voxel_mask,
+                                std::vector<uint32_t>& out_voxel_labels);
+
+/**
+ * @brief Splits the voxels inside several signed distance fields into one tetrahedral mesh labeled by material.
+ *
+ * The voxels are selected and labeled by `ClassifyMaterialVoxels` and meshed together like
+ * `MeshInteriorVoxels`, so the mesh is conforming across the interfaces of the materials. Every
+ * cell gets the label of its voxel while the mesh is built, see `TetMesh::cellLabels`.
+ *
+ * @param in_sdfs The signed distance fields on one grid, one per material label, negative inside and signed outside the narrow band.
+ * @param out_mesh The tetrahedral mesh with a material label per cell.
+ * @param min_inside_corners The number of inside corners of a selected voxel in [1, 8] (default is all of them).
+ * @return True if a non-empty mesh was generated, otherwise false.
+ */
+bool MeshMaterialVoxels(const std::vector<const SignedDistanceField*>& in_sdfs,
+                        TetMesh& out_mesh,
+                        int min_inside_corners = Voxel::kNumVerticesPerCell);
+
+}
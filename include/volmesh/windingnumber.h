@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/trianglemesh.h"
+
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @class WindingNumberTree
+ * @brief A bounding volume hierarchy for fast generalized winding number queries.
+ *
+ * The generalized winding number of a point is the sum of the solid angles of all triangles
+ * divided by 4 * pi. It is close to one inside and close to zero outside of the surface, and
+ * it degrades gracefully for meshes with holes, cracks or duplicated faces.
+ *
+ * The tree stores the area weighted normal and the area weighted centroid of every node.
+ * Nodes that are far away from the query point are approximated by a single dipole term
+ * (Barnes-Hut), and only nearby leaves evaluate the exact solid angle per triangle. A query
+ * therefore costs O(log T) for a mesh with T triangles.
+ *
+ * @ref Barill, G., Dickson, N. G., Schmidt, R., Levin, D. I. W., Jacobson, A. (2018).
+ * Fast winding numbers for soups and clouds. ACM Transactions on Graphics, 37(4).
+ */
+class WindingNumberTree {
+public:
+  /**
+   * @brief The default accuracy parameter (beta) for the far field approximation.
+   *
+   * A node is approximated when the query point is farther than beta times the node
+   * radius from the node centroid.
+   */
+  static constexpr const real_t kDefaultAccuracy = 2.0;
+
+  /**
+   * @brief The maximum number of triangles stored in a leaf node.
+   */
+  static const uint32_t kMaxTrianglesPerLeaf = 8;
+
+  /**
+   * @brief Default constructor.
+   *
+   * Initializes an empty tree.
+   */
+  WindingNumberTree();
+
+  /**
+   * @brief Destructor.
+   */
+  ~WindingNumberTree();
+
+  /**
+   * @brief Builds the tree over all faces of a triangle mesh.
+   *
+   * The triangle vertices are copied into the tree, so the mesh is not referenced after this call.
+   *
+   * @param in_mesh The input triangle mesh.
+   * @return True if the tree was built successfully, otherwise false.
+   */
+  bool build(const TriangleMesh& in_mesh);
+
+  /**
+   * @brief Builds the tree over a triangle soup.
+   *
+   * @param in_triangle_vertices Three consecutive vertices per triangle.
+   * @return True if the tree was built successfully, otherwise false.
+   */
+  bool build(const std::vector<vec3>& in_triangle_vertices);
+
+  /**
+   * @brief Removes all nodes and triangles from the tree.
+   */
+  void clear();
+
+  /**
+   * @brief Returns the number of nodes in the tree.
+   */
+  uint32_t countNodes() const;
+
+  /**
+   * @brief Returns the number of triangles stored in the tree.
+   */
+  uint32_t countTriangles() const;
+
+  /**
+   * @brief Computes the generalized winding number at a point using the hierarchical approximation.
+   *
+   * @param p The query point.
+   * @param accuracy The far field accuracy parameter (beta). Larger values are more accurate.
+   * @return The approximate winding number at p.
+   */
+  real_t windingNumber(const vec3& p, real_t accuracy = kDefaultAccuracy) const;
+
+  /**
+   * @brief Computes the generalized winding number at a point by visiting all triangles.
+   *
+   * This is the reference O(T) evaluation used for validating the hierarchical approximation.
+   *
+   * @param p The query point.
+   * @return The exact winding number at p.
+   */
+  real_t exactWindingNumber(const vec3& p) const;
+
+private:
+  /**
+   * @brief A node of the tree. Leaves have no children and reference a range of triangles.
+   */
+  struct Node {
+    vec3 centroid = vec3::Zero(); /**< Area weighted centroid of all triangles in the node. */
+    vec3 dipole = vec3::Zero(); /**< Sum of the area weighted normals of all triangles in the node. */
+    real_t radius = 0.0; /**< Distance from the centroid to the farthest triangle vertex in the node. */
+    uint32_t first_triangle = 0; /**< Index of the first triangle in the node. */
+    uint32_t count_triangles = 0; /**< Number of triangles in the node. */
+    uint32_t children[2] = {0, 0}; /**< Child node indices, both zero for leaves. */
+
+    bool isLeaf() const { return children[0] == 0; }
+  };
+
+  uint32_t buildRecursive(std::vector<uint32_t>& order, uint32_t first, uint32_t count);
+
+  real_t triangleSolidAngle(uint32_t tri, const vec3& p) const;
+
+private:
+  std::vector<Node> nodes_; /**< Tree nodes, the root is at index zero. */
+  std::vector<vec3> triangle_vertices_; /**< Three consecutive vertices per triangle, in tree order. */
+  std::vector<vec3> triangle_centroids_; /**< Centroid per triangle, in tree order. */
+  std::vector<vec3> triangle_area_normals_; /**< Area weighted normal per triangle, in tree order. */
+};
+
+}
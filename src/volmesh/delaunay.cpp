@@ -0,0 +1,869 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/delaunay.h"
+#include "volmesh/logger.h"
+#include "volmesh/parallel.h"
+#include "volmesh/predicates.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief Checks whether three points lie on a line, by the orientations of their projections on the axis planes.
+     */
+    bool AreCollinear(const vec3& a, const vec3& b, const vec3& c) {
+      for(int axis = 0; axis < 3; axis++) {
+        const int u = (axis + 1) % 3;
+        const int v = (axis + 2) % 3;
+        if(Orient2d(vec2(a[u], a[v]), vec2(b[u], b[v]), vec2(c[u], c[v])) != 0) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    /**
+     * @brief The index of a point along a Hilbert curve through a cube of 2^bits cells per axis.
+     *
+     * @ref Skilling, J. (2004). Programming the Hilbert curve. AIP Conference Proceedings, 707, 381-387.
+     */
+    uint64_t HilbertIndex(std::array<uint32_t, 3> x, int bits) {
+      const uint32_t m = 1u << (bits - 1);
+      for(uint32_t q = m; q > 1; q >>= 1) {
+        const uint32_t p = q - 1;
+        for(int i = 0; i < 3; i++) {
+          if(x[i] & q) {
+            x[0] ^= p;
+          } else {
+            const uint32_t t = (x[0] ^ x[i]) & p;
+            x[0] ^= t;
+            x[i] ^= t;
+          }
+        }
+      }
+
+      for(int i = 1; i < 3; i++) {
+        x[i] ^= x[i - 1];
+      }
+      uint32_t t = 0;
+      for(uint32_t q = m; q > 1; q >>= 1) {
+        if(x[2] & q) {
+          t ^= q - 1;
+        }
+      }
+      for(int i = 0; i < 3; i++) {
+        x[i] ^= t;
+      }
+
+      uint64_t index = 0;
+      for(int bit = bits - 1; bit >= 0; bit--) {
+        for(int i = 0; i < 3; i++) {
+          index = (index << 1) | ((x[i] >> bit) & 1u);
+        }
+      }
+      return index;
+    }
+
+    /**
+     * @brief Orders points for insertion with BRIO, rounds of doubling size each sorted along a Hilbert curve.
+     */
+    void ComputeInsertionOrder(const std::vector<vec3>& in_points, std::vector<uint32_t>& inout_point_ids) {
+      static const int kHilbertBits = 21;
+      static const size_t kMinRoundSize = 64;
+
+      if(inout_point_ids.empty()) {
+        return;
+      }
+
+      vec3 lower = in_points[inout_point_ids.front()];
+      vec3 upper = lower;
+      for(uint32_t id : inout_point_ids) {
+        lower = lower.cwiseMin(in_points[id]);
+        upper = upper.cwiseMax(in_points[id]);
+      }
+      const real_t extent = std::max<real_t>((upper - lower).maxCoeff(), std::numeric_limits<real_t>::min());
+      const real_t scale = static_cast<real_t>((1u << kHilbertBits) - 1) / extent;
+
+      std::mt19937_64 generator(0x5eed);
+      std::shuffle(inout_point_ids.begin(), inout_point_ids.end(), generator);
+
+      std::vector<std::pair<uint64_t, uint32_t>> keys(inout_point_ids.size());
+      ParallelFor(0, keys.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for(uint64_t i = chunk_begin; i < chunk_end; i++) {
+          const vec3 cell = (in_points[inout_point_ids[i]] - lower) * scale;
+          keys[i] = std::make_pair(HilbertIndex({static_cast<uint32_t>(cell.x()), static_cast<uint32_t>(cell.y()), static_cast<uint32_t>(cell.z())}, kHilbertBits),
+                                   inout_point_ids[i]);
+        }
+      }, 1 << 14);
+
+      // the last round holds half of the points, the one before a quarter, and so on
+      size_t round_end = keys.size();
+      while(round_end > 0) {
+        const size_t round_begin = (round_end > kMinRoundSize) ? round_end / 2 : 0;
+        std::sort(keys.begin() + round_begin, keys.begin() + round_end);
+        round_end = round_begin;
+      }
+
+      for(size_t i = 0; i < keys.size(); i++) {
+        inout_point_ids[i] = keys[i].second;
+      }
+    }
+
+    /**
+     * @brief The id of the vertex at infinity shared by the ghost tetrahedra outside the convex hull.
+     */
+    static const int32_t kInfiniteVertex = -1;
+
+    /**
+     * @brief Marks the slot of a removed tetrahedron.
+     */
+    static const int32_t kRemovedVertex = -2;
+
+    struct DelaunayTet {
+      std::array<int32_t, 4> vertices; /**< The point ids, or kInfiniteVertex for ghosts. */
+      std::array<int32_t, 4> neighbors; /**< The tetrahedron across the face opposite each vertex. */
+    };
+
+    /**
+     * @brief A Delaunay tetrahedralization with ghost tetrahedra, built by Bowyer-Watson insertion.
+     *
+     * A tetrahedron is positively oriented when `Orient3d` of its vertices is positive. A ghost
+     * tetrahedron is positively oriented when replacing its vertex at infinity by a point beyond
+     * its hull face makes it so.
+     */
+    class DelaunayTriangulation {
+    public:
+      explicit DelaunayTriangulation(const std::vector<vec3>& in_points) : points_(in_points) {}
+
+      /**
+       * @brief Tetrahedralizes the points in the given insertion order.
+       */
+      bool build(const std::vector<uint32_t>& in_order) {
+        tets_.clear();
+        marks_.clear();
+        free_tets_.clear();
+        stamp_ = 0;
+
+        // the first four points that span a volume
+        std::array<size_t, 4> seeds;
+        size_t found = 0;
+        for(size_t i = 0; i < in_order.size() && found < 4; i++) {
+          const vec3& p = points_[in_order[i]];
+          bool is_seed = false;
+          switch(found) {
+          case 0: is_seed = true; break;
+          case 1: is_seed = (p != points_[in_order[seeds[0]]]); break;
+          case 2: is_seed = !AreCollinear(points_[in_order[seeds[0]]], points_[in_order[seeds[1]]], p); break;
+          default: is_seed = Orient3d(points_[in_order[seeds[0]]], points_[in_order[seeds[1]]], points_[in_order[seeds[2]]], p) != 0; break;
+          }
+
+          if(is_seed) {
+            seeds[found++] = i;
+          }
+        }
+
+        if(found < 4) {
+          return false;
+        }
+
+        std::array<int32_t, 4> first = {static_cast<int32_t>(in_order[seeds[0]]), static_cast<int32_t>(in_order[seeds[1]]),
+                                        static_cast<int32_t>(in_order[seeds[2]]), static_cast<int32_t>(in_order[seeds[3]])};
+        if(Orient3d(points_[first[0]], points_[first[1]], points_[first[2]], points_[first[3]]) < 0) {
+          std::swap(first[0], first[1]);
+        }
+        createFirstTetrahedra(first);
+
+        for(size_t i = 0; i < in_order.size(); i++) {
+          if(i != seeds[0] && i != seeds[1] && i != seeds[2] && i != seeds[3]) {
+            insert(static_cast<int32_t>(in_order[i]));
+          }
+        }
+
+        return true;
+      }
+
+      const std::vector<DelaunayTet>& tets() const {
+        return tets_;
+      }
+
+      const vec3& point(int32_t id) const {
+        return points_[id];
+      }
+
+      static bool IsGhost(const DelaunayTet& tet) {
+        return tet.vertices[0] == kInfiniteVertex || tet.vertices[1] == kInfiniteVertex ||
+               tet.vertices[2] == kInfiniteVertex || tet.vertices[3] == kInfiniteVertex;
+      }
+
+      static bool IsRemoved(const DelaunayTet& tet) {
+        return tet.vertices[0] == kRemovedVertex;
+      }
+
+      static int InfiniteIndex(const DelaunayTet& tet) {
+        for(int i = 0; i < 4; i++) {
+          if(tet.vertices[i] == kInfiniteVertex) {
+            return i;
+          }
+        }
+        return -1;
+      }
+
+      /**
+       * @brief The orientation of a finite tetrahedron with one vertex replaced by a point.
+       */
+      int orientWith(const DelaunayTet& tet, int i, const vec3& p) const {
+        const vec3& a = (i == 0) ? p : points_[tet.vertices[0]];
+        const vec3& b = (i == 1) ? p : points_[tet.vertices[1]];
+        const vec3& c = (i == 2) ? p : points_[tet.vertices[2]];
+        const vec3& d = (i == 3) ? p : points_[tet.vertices[3]];
+        return Orient3d(a, b, c, d);
+      }
+
+      int inSphere(const DelaunayTet& tet, const vec3& p) const {
+        return InSphere(points_[tet.vertices[0]], points_[tet.vertices[1]], points_[tet.vertices[2]], points_[tet.vertices[3]], p);
+      }
+
+    private:
+      struct BoundaryFace {
+        std::array<int32_t, 4> vertices; /**< The vertices of the new tetrahedron. */
+        int face; /**< The face of the new tetrahedron on the cavity boundary. */
+        int32_t outside; /**< The tetrahedron outside the cavity. */
+        int outside_face; /**< The face of the outside tetrahedron on the cavity boundary. */
+      };
+
+      struct EdgeSlot {
+        uint64_t key;
+        int32_t tet;
+        int face;
+      };
+
+      static const uint64_t kEmptyEdgeKey = ~0ull;
+
+      int32_t allocateTet() {
+        if(!free_tets_.empty()) {
+          const int32_t id = free_tets_.back();
+          free_tets_.pop_back();
+          return id;
+        }
+
+        tets_.push_back(DelaunayTet());
+        marks_.push_back(0);
+        return static_cast<int32_t>(tets_.size() - 1);
+      }
+
+      void createFirstTetrahedra(const std::array<int32_t, 4>& first) {
+        const int32_t finite = allocateTet();
+        tets_[finite].vertices = first;
+        for(int i = 0; i < 4; i++) {
+          // the vertex at infinity beyond the face opposite vertex i
+          DelaunayTet ghost;
+          ghost.vertices = first;
+          ghost.vertices[i] = kInfiniteVertex;
+          std::swap(ghost.vertices[(i + 1) % 4], ghost.vertices[(i + 2) % 4]);
+          ghost.neighbors.fill(-1);
+          ghost.neighbors[i] = finite;
+
+          const int32_t id = allocateTet();
+          tets_[id] = ghost;
+          tets_[finite].neighbors[i] = id;
+        }
+
+        // the ghosts meet along the edges of the first tetrahedron
+        for(int32_t t = 1; t < 5; t++) {
+          for(int32_t u = t + 1; u < 5; u++) {
+            for(int i = 0; i < 4; i++) {
+              for(int j = 0; j < 4; j++) {
+                if(sharesFace(tets_[t], i, tets_[u], j)) {
+                  tets_[t].neighbors[i] = u;
+                  tets_[u].neighbors[j] = t;
+                }
+              }
+            }
+          }
+        }
+
+        hint_ = finite;
+      }
+
+      static bool sharesFace(const DelaunayTet& a, int i, const DelaunayTet& b, int j) {
+        std::array<int32_t, 3> fa, fb;
+        for(int k = 0, m = 0; k < 4; k++) {
+          if(k != i) {
+            fa[m++] = a.vertices[k];
+          }
+        }
+        for(int k = 0, m = 0; k < 4; k++) {
+          if(k != j) {
+            fb[m++] = b.vertices[k];
+          }
+        }
+        std::sort(fa.begin(), fa.end());
+        std::sort(fb.begin(), fb.end());
+        return fa == fb;
+      }
+
+      /**
+       * @brief Walks from the hint to the finite tetrahedron holding a point, or to the ghost beyond whose hull face it lies.
+       */
+      int32_t locate(const vec3& p) {
+        int32_t t = hint_;
+        if(IsGhost(tets_[t])) {
+          t = tets_[t].neighbors[InfiniteIndex(tets_[t])];
+        }
+
+        int32_t previous = -1;
+        while(true) {
+          const DelaunayTet& tet = tets_[t];
+          const int start = static_cast<int>((random_state_ = random_state_ * 6364136223846793005ull + 1442695040888963407ull) >> 62);
+          int32_t next = -1;
+          for(int k = 0; k < 4; k++) {
+            const int i = (start + k) & 3;
+            if(tet.neighbors[i] == previous) {
+              continue;
+            }
+
+            if(orientWith(tet, i, p) < 0) {
+              next = tet.neighbors[i];
+              break;
+            }
+          }
+
+          if(next < 0) {
+            return t;
+          }
+
+          previous = t;
+          t = next;
+          if(IsGhost(tets_[t])) {
+            return t;
+          }
+        }
+      }
+
+      bool isConflict(int32_t t, const vec3& p) const {
+        const DelaunayTet& tet = tets_[t];
+        const int k = InfiniteIndex(tet);
+        if(k < 0) {
+          return inSphere(tet, p) > 0;
+        }
+
+        // beyond the hull face, or on its plane and inside the circumsphere of the tetrahedron behind it
+        const int orientation = orientWith(tet, k, p);
+        if(orientation != 0) {
+          return orientation > 0;
+        }
+
+        return inSphere(tets_[tet.neighbors[k]], p) > 0;
+      }
+
+      void insert(int32_t point_id) {
+        const vec3& p = points_[point_id];
+        const int32_t start = locate(p);
+        if(IsGhost(tets_[start]) == false) {
+          for(int32_t v : tets_[start].vertices) {
+            if(points_[v] == p) {
+              return;
+            }
+          }
+        }
+
+        // the cavity of the tetrahedra in conflict with the point
+        stamp_ += 2;
+        const uint32_t conflict_mark = stamp_;
+        const uint32_t outside_mark = stamp_ + 1;
+        cavity_.clear();
+        boundary_.clear();
+        cavity_.push_back(start);
+        marks_[start] = conflict_mark;
+        for(size_t c = 0; c < cavity_.size(); c++) {
+          const int32_t t = cavity_[c];
+          for(int i = 0; i < 4; i++) {
+            const int32_t neighbor = tets_[t].neighbors[i];
+            if(marks_[neighbor] == conflict_mark) {
+              continue;
+            }
+
+            if(marks_[neighbor] != outside_mark && isConflict(neighbor, p)) {
+              marks_[neighbor] = conflict_mark;
+              cavity_.push_back(neighbor);
+              continue;
+            }
+
+            marks_[neighbor] = outside_mark;
+            BoundaryFace face;
+            face.vertices = tets_[t].vertices;
+            face.vertices[i] = point_id;
+            face.face = i;
+            face.outside = neighbor;
+            face.outside_face = 0;
+            while(tets_[neighbor].neighbors[face.outside_face] != t) {
+              face.outside_face++;
+            }
+            boundary_.push_back(face);
+          }
+        }
+
+        // the cavity slots are reused by the new tetrahedra
+        for(int32_t t : cavity_) {
+          tets_[t].vertices[0] = kRemovedVertex;
+          free_tets_.push_back(t);
+        }
+
+        // make room for the three edges of every boundary face in the edge table
+        const size_t min_slots = 4 * boundary_.size();
+        if(edge_slots_.size() < min_slots) {
+          size_t count_slots = 64;
+          while(count_slots < min_slots) {
+            count_slots *= 2;
+          }
+          edge_slots_.assign(count_slots, EdgeSlot({kEmptyEdgeKey, -1, -1}));
+        }
+        const uint64_t mask = edge_slots_.size() - 1;
+
+        used_slots_.clear();
+        for(const BoundaryFace& face : boundary_) {
+          const int32_t id = allocateTet();
+          DelaunayTet& tet = tets_[id];
+          tet.vertices = face.vertices;
+          tet.neighbors[face.face] = face.outside;
+          tets_[face.outside].neighbors[face.outside_face] = id;
+
+          // the other faces hold the point and an edge of the boundary face, shared with another new tetrahedron
+          for(int j = 0; j < 4; j++) {
+            if(j == face.face) {
+              continue;
+            }
+
+            std::array<int32_t, 2> edge;
+            for(int k = 0, m = 0; k < 4; k++) {
+              if(k != j && k != face.face) {
+                edge[m++] = tet.vertices[k];
+              }
+            }
+            if(edge[0] > edge[1]) {
+              std::swap(edge[0], edge[1]);
+            }
+
+            const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(edge[0] + 1)) << 32) | static_cast<uint32_t>(edge[1] + 1);
+            uint64_t slot_id = ((key ^ (key >> 29)) * 0x9e3779b97f4a7c15ull) & mask;
+            while(true) {
+              EdgeSlot& slot = edge_slots_[slot_id];
+              if(slot.key == kEmptyEdgeKey) {
+                slot = EdgeSlot({key, id, j});
+                used_slots_.push_back(slot_id);
+                break;
+              }
+
+              if(slot.key == key) {
+                tet.neighbors[j] = slot.tet;
+                tets_[slot.tet].neighbors[slot.face] = id;
+                break;
+              }
+
+              slot_id = (slot_id + 1) & mask;
+            }
+          }
+
+          hint_ = id;
+        }
+
+        for(uint64_t slot_id : used_slots_) {
+          edge_slots_[slot_id].key = kEmptyEdgeKey;
+        }
+      }
+
+    private:
+      const std::vector<vec3>& points_;
+      std::vector<DelaunayTet> tets_;
+      std::vector<uint32_t> marks_;
+      std::vector<int32_t> free_tets_;
+      std::vector<int32_t> cavity_;
+      std::vector<BoundaryFace> boundary_;
+      std::vector<EdgeSlot> edge_slots_;
+      std::vector<uint64_t> used_slots_;
+      uint32_t stamp_ = 0;
+      int32_t hint_ = 0;
+      uint64_t random_state_ = 0x853c49e6748fea9bull;
+    };
+
+    /**
+     * @brief The smallest number of points per slab of the parallel tetrahedralization.
+     */
+    static const size_t kMinPointsPerSlab = 2048;
+
+    /**
+     * @brief A face of a tetrahedron by its sorted vertex ids, and the side of the face the tetrahedron lies on.
+     */
+    struct OrientedFace {
+      std::array<int32_t, 3> vertices;
+      int side;
+    };
+
+    OrientedFace MakeOrientedFace(const DelaunayTet& tet, int i) {
+      OrientedFace face;
+      for(int k = 0, m = 0; k < 4; k++) {
+        if(k != i) {
+          face.vertices[m++] = tet.vertices[k];
+        }
+      }
+
+      // moving the opposite vertex last and sorting the face vertices both flip the orientation per swap
+      int parity = (3 - i) % 2;
+      for(int k = 0; k < 2; k++) {
+        for(int m = 0; m < 2 - k; m++) {
+          if(face.vertices[m] > face.vertices[m + 1]) {
+            std::swap(face.vertices[m], face.vertices[m + 1]);
+            parity ^= 1;
+          }
+        }
+      }
+      face.side = (parity == 0) ? 1 : 2;
+      return face;
+    }
+
+    bool Tetrahedralize(const std::vector<vec3>& in_points,
+                        std::vector<uint32_t> point_ids,
+                        DelaunayTriangulation& out_triangulation) {
+      ComputeInsertionOrder(in_points, point_ids);
+      return out_triangulation.build(point_ids);
+    }
+
+    /**
+     * @brief Checks whether the circumsphere of a tetrahedron lies strictly between two bounds along an axis.
+     *
+     * The circumcenter is rounded, so nearly flat tetrahedra fail and the radius gets a margin.
+     */
+    bool IsCircumsphereWithin(const DelaunayTriangulation& triangulation,
+                              const DelaunayTet& tet,
+                              int axis,
+                              real_t lower_bound,
+                              real_t upper_bound) {
+      const vec3& a = triangulation.point(tet.vertices[0]);
+      const vec3 u = triangulation.point(tet.vertices[1]) - a;
+      const vec3 v = triangulation.point(tet.vertices[2]) - a;
+      const vec3 w = triangulation.point(tet.vertices[3]) - a;
+      const real_t det = u.dot(v.cross(w));
+      if(std::abs(det) <= 1e-8 * u.norm() * v.norm() * w.norm()) {
+        return false;
+      }
+
+      const vec3 offset = (u.squaredNorm() * v.cross(w) + v.squaredNorm() * w.cross(u) + w.squaredNorm() * u.cross(v)) / (2.0 * det);
+      const real_t radius = offset.norm() * (1.0 + 1e-6);
+      const real_t center = a[axis] + offset[axis];
+      return (center - radius > lower_bound) && (center + radius < upper_bound);
+    }
+
+    /**
+     * @brief Selects the tetrahedra of a slab that belong to a Delaunay tetrahedralization of all points.
+     *
+     * The tetrahedra sharing a circumsphere tile one cell of the Delaunay subdivision, and are found
+     * by crossing the faces whose opposite vertices are cospherical. A cell is kept when its
+     * circumsphere lies strictly between the nearest points of the neighboring slabs along the axis,
+     * since no point of another slab can then be inside or on it.
+     */
+    void SelectFinalTets(const DelaunayTriangulation& triangulation,
+                         int axis,
+                         real_t lower_bound,
+                         real_t upper_bound,
+                         std::vector<uint8_t>& out_is_final) {
+      const std::vector<DelaunayTet>& tets = triangulation.tets();
+      out_is_final.assign(tets.size(), 0);
+
+      std::vector<uint8_t> is_visited(tets.size(), 0);
+      std::vector<int32_t> cell;
+      for(size_t seed = 0; seed < tets.size(); seed++) {
+        if(is_visited[seed] != 0 || DelaunayTriangulation::IsRemoved(tets[seed]) || DelaunayTriangulation::IsGhost(tets[seed])) {
+          continue;
+        }
+
+        cell.assign(1, static_cast<int32_t>(seed));
+        is_visited[seed] = 1;
+        bool is_final = true;
+        for(size_t c = 0; c < cell.size(); c++) {
+          const DelaunayTet& tet = tets[cell[c]];
+          is_final &= IsCircumsphereWithin(triangulation, tet, axis, lower_bound, upper_bound);
+          for(int i = 0; i < 4; i++) {
+            const int32_t neighbor_id = tet.neighbors[i];
+            const DelaunayTet& neighbor = tets[neighbor_id];
+            if(is_visited[neighbor_id] != 0 || DelaunayTriangulation::IsGhost(neighbor)) {
+              continue;
+            }
+
+            int j = 0;
+            while(neighbor.neighbors[j] != cell[c]) {
+              j++;
+            }
+            if(triangulation.inSphere(tet, triangulation.point(neighbor.vertices[j])) == 0) {
+              is_visited[neighbor_id] = 1;
+              cell.push_back(neighbor_id);
+            }
+          }
+        }
+
+        if(is_final) {
+          for(int32_t t : cell) {
+            out_is_final[t] = 1;
+          }
+        }
+      }
+    }
+
+    void AppendFiniteTets(const DelaunayTriangulation& triangulation,
+                          const std::vector<uint8_t>& in_skip,
+                          std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+      const std::vector<DelaunayTet>& tets = triangulation.tets();
+      for(size_t t = 0; t < tets.size(); t++) {
+        if(DelaunayTriangulation::IsRemoved(tets[t]) || DelaunayTriangulation::IsGhost(tets[t]) || (!in_skip.empty() && in_skip[t] != 0)) {
+          continue;
+        }
+
+        out_tet_cells_by_vertex_ids.push_back(vec4i(tets[t].vertices[0], tets[t].vertices[1], tets[t].vertices[2], tets[t].vertices[3]));
+      }
+    }
+
+  }
+
+  bool TetrahedralizeDelaunay(const std::vector<vec3>& in_points,
+                              std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+    out_tet_cells_by_vertex_ids.clear();
+    if(in_points.size() < 4 || in_points.size() >= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+      SPDLOG_ERROR("Can not tetrahedralize [{}] points", in_points.size());
+      return false;
+    }
+
+    std::vector<uint32_t> point_ids(in_points.size());
+    for(size_t i = 0; i < point_ids.size(); i++) {
+      point_ids[i] = static_cast<uint32_t>(i);
+    }
+
+    DelaunayTriangulation triangulation(in_points);
+    if(Tetrahedralize(in_points, point_ids, triangulation) == false) {
+      SPDLOG_ERROR("The [{}] points do not span a volume", in_points.size());
+      return false;
+    }
+
+    AppendFiniteTets(triangulation, std::vector<uint8_t>(), out_tet_cells_by_vertex_ids);
+    return true;
+  }
+
+  bool TetrahedralizeDelaunayParallel(const std::vector<vec3>& in_points,
+                                      std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+    out_tet_cells_by_vertex_ids.clear();
+    const size_t count_slabs = std::min<size_t>(CountWorkerThreads(), in_points.size() / kMinPointsPerSlab);
+    if(count_slabs < 2 || in_points.size() >= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+      return TetrahedralizeDelaunay(in_points, out_tet_cells_by_vertex_ids);
+    }
+
+    vec3 lower = in_points.front();
+    vec3 upper = lower;
+    for(const vec3& p : in_points) {
+      lower = lower.cwiseMin(p);
+      upper = upper.cwiseMax(p);
+    }
+    int axis = 0;
+    (upper - lower).maxCoeff(&axis);
+
+    // sort along the axis and drop duplicates, which could otherwise fall into two slabs
+    std::vector<uint32_t> sorted_ids(in_points.size());
+    for(size_t i = 0; i < sorted_ids.size(); i++) {
+      sorted_ids[i] = static_cast<uint32_t>(i);
+    }
+    std::sort(sorted_ids.begin(), sorted_ids.end(), [&](uint32_t lhs, uint32_t rhs) {
+      const vec3& a = in_points[lhs];
+      const vec3& b = in_points[rhs];
+      if(a[axis] != b[axis]) {
+        return a[axis] < b[axis];
+      }
+      for(int k = 0; k < 3; k++) {
+        if(a[k] != b[k]) {
+          return a[k] < b[k];
+        }
+      }
+      return lhs < rhs;
+    });
+    sorted_ids.erase(std::unique(sorted_ids.begin(), sorted_ids.end(), [&](uint32_t lhs, uint32_t rhs) {
+      return in_points[lhs] == in_points[rhs];
+    }), sorted_ids.end());
+
+    // tetrahedralize the slabs and keep the tetrahedra that no other slab can invalidate
+    std::vector<size_t> slab_begin(count_slabs + 1);
+    for(size_t k = 0; k <= count_slabs; k++) {
+      slab_begin[k] = (sorted_ids.size() * k) / count_slabs;
+    }
+
+    std::vector<uint8_t> is_hull_or_seam(in_points.size(), 0);
+    std::vector<std::vector<vec4i>> slab_final_tets(count_slabs);
+    std::vector<std::vector<OrientedFace>> slab_frontier_faces(count_slabs);
+    std::atomic<bool> is_valid(true);
+    ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t k = chunk_begin; k < chunk_end; k++) {
+        const std::vector<uint32_t> slab_ids(sorted_ids.begin() + slab_begin[k], sorted_ids.begin() + slab_begin[k + 1]);
+        DelaunayTriangulation triangulation(in_points);
+        if(Tetrahedralize(in_points, slab_ids, triangulation) == false) {
+          is_valid = false;
+          continue;
+        }
+
+        const real_t lower_bound = (k > 0) ? in_points[sorted_ids[slab_begin[k] - 1]][axis] : -std::numeric_limits<real_t>::infinity();
+        const real_t upper_bound = (k + 1 < count_slabs) ? in_points[sorted_ids[slab_begin[k + 1]]][axis] : std::numeric_limits<real_t>::infinity();
+
+        const std::vector<DelaunayTet>& tets = triangulation.tets();
+        std::vector<uint8_t> is_final;
+        SelectFinalTets(triangulation, axis, lower_bound, upper_bound, is_final);
+
+        for(size_t t = 0; t < tets.size(); t++) {
+          if(DelaunayTriangulation::IsRemoved(tets[t])) {
+            continue;
+          }
+
+          if(is_final[t] == 0) {
+            for(int32_t v : tets[t].vertices) {
+              if(v != kInfiniteVertex) {
+                is_hull_or_seam[v] = 1;
+              }
+            }
+            continue;
+          }
+
+          for(int i = 0; i < 4; i++) {
+            if(is_final[tets[t].neighbors[i]] == 0) {
+              slab_frontier_faces[k].push_back(MakeOrientedFace(tets[t], i));
+            }
+          }
+        }
+
+        std::vector<uint8_t> is_not_final(is_final.size());
+        for(size_t t = 0; t < is_final.size(); t++) {
+          is_not_final[t] = (is_final[t] != 0) ? 0 : 1;
+        }
+        AppendFiniteTets(triangulation, is_not_final, slab_final_tets[k]);
+      }
+    });
+
+    if(is_valid == false) {
+      return TetrahedralizeDelaunay(in_points, out_tet_cells_by_vertex_ids);
+    }
+
+    // the faces between the kept and the other tetrahedra, with the sides of the kept ones
+    std::vector<OrientedFace> frontier_faces;
+    for(const std::vector<OrientedFace>& faces : slab_frontier_faces) {
+      frontier_faces.insert(frontier_faces.end(), faces.begin(), faces.end());
+    }
+    std::sort(frontier_faces.begin(), frontier_faces.end(), [](const OrientedFace& lhs, const OrientedFace& rhs) {
+      return lhs.vertices < rhs.vertices;
+    });
+    size_t count_unique = 0;
+    for(size_t i = 0; i < frontier_faces.size(); i++) {
+      if(count_unique > 0 && frontier_faces[count_unique - 1].vertices == frontier_faces[i].vertices) {
+        frontier_faces[count_unique - 1].side |= frontier_faces[i].side;
+      } else {
+        frontier_faces[count_unique++] = frontier_faces[i];
+      }
+    }
+    frontier_faces.resize(count_unique);
+
+    auto find_frontier_face = [&frontier_faces](const std::array<int32_t, 3>& vertices) -> const OrientedFace* {
+      auto it = std::lower_bound(frontier_faces.begin(), frontier_faces.end(), vertices, [](const OrientedFace& lhs, const std::array<int32_t, 3>& rhs) {
+        return lhs.vertices < rhs;
+      });
+      return (it != frontier_faces.end() && it->vertices == vertices) ? &(*it) : nullptr;
+    };
+
+    // tetrahedralize the points of the other tetrahedra once more
+    std::vector<uint32_t> seam_ids;
+    for(uint32_t id : sorted_ids) {
+      if(is_hull_or_seam[id] != 0) {
+        seam_ids.push_back(id);
+      }
+    }
+
+    DelaunayTriangulation seam_triangulation(in_points);
+    if(Tetrahedralize(in_points, seam_ids, seam_triangulation) == false) {
+      return TetrahedralizeDelaunay(in_points, out_tet_cells_by_vertex_ids);
+    }
+
+    // flood the seam tetrahedra on the kept side of the frontier, they overlap the kept tetrahedra
+    const std::vector<DelaunayTet>& seam_tets = seam_triangulation.tets();
+    std::vector<uint8_t> is_covered(seam_tets.size(), 0);
+    std::vector<uint8_t> is_matched(frontier_faces.size(), 0);
+    std::vector<int32_t> queue;
+    for(size_t t = 0; t < seam_tets.size(); t++) {
+      if(DelaunayTriangulation::IsRemoved(seam_tets[t]) || DelaunayTriangulation::IsGhost(seam_tets[t])) {
+        continue;
+      }
+
+      for(int i = 0; i < 4; i++) {
+        const OrientedFace face = MakeOrientedFace(seam_tets[t], i);
+        const OrientedFace* frontier_face = find_frontier_face(face.vertices);
+        if(frontier_face == nullptr) {
+          continue;
+        }
+
+        is_matched[frontier_face - frontier_faces.data()] = 1;
+        if((frontier_face->side & face.side) != 0 && is_covered[t] == 0) {
+          is_covered[t] = 1;
+          queue.push_back(static_cast<int32_t>(t));
+        }
+      }
+    }
+
+    // cospherical points may be split differently along the frontier, then the pieces do not meet
+    const size_t count_unmatched = std::count(is_matched.begin(), is_matched.end(), 0);
+    if(count_unmatched > 0) {
+      SPDLOG_WARN("The seam does not match [{}] of [{}] frontier faces, tetrahedralizing all points at once",
+                  count_unmatched, frontier_faces.size());
+      return TetrahedralizeDelaunay(in_points, out_tet_cells_by_vertex_ids);
+    }
+
+    for(size_t q = 0; q < queue.size(); q++) {
+      const DelaunayTet& tet = seam_tets[queue[q]];
+      for(int i = 0; i < 4; i++) {
+        const int32_t neighbor = tet.neighbors[i];
+        if(is_covered[neighbor] != 0 || DelaunayTriangulation::IsGhost(seam_tets[neighbor])) {
+          continue;
+        }
+
+        if(find_frontier_face(MakeOrientedFace(tet, i).vertices) == nullptr) {
+          is_covered[neighbor] = 1;
+          queue.push_back(neighbor);
+        }
+      }
+    }
+
+    size_t count_final = 0;
+    for(const std::vector<vec4i>& tets : slab_final_tets) {
+      out_tet_cells_by_vertex_ids.insert(out_tet_cells_by_vertex_ids.end(), tets.begin(), tets.end());
+      count_final += tets.size();
+    }
+    AppendFiniteTets(seam_triangulation, is_covered, out_tet_cells_by_vertex_ids);
+
+    SPDLOG_INFO("Kept [{}] tetrahedra of [{}] slabs and tetrahedralized [{}] of [{}] points once more",
+                count_final, count_slabs, seam_ids.size(), sorted_ids.size());
+    return true;
+  }
+
+  bool TetrahedralizeDelaunay(const std::vector<vec3>& in_points,
+                              TetMesh& out_mesh) {
+    std::vector<vec4i> cells;
+    if(TetrahedralizeDelaunayParallel(in_points, cells) == false) {
+      return false;
+    }
+
+    return out_mesh.readFromList(in_points, cells);
+  }
+
+}
@@ -0,0 +1,132 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/distancetransform.h"
+#include "volmesh/logger.h"
+#include "volmesh/parallel.h"
+
+#include <algorithm>
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief Scratch buffers for the 1D transform of a single line.
+     */
+    struct LineBuffers {
+      std::vector<real_t> f; /**< Input samples of the line. */
+      std::vector<int> v; /**< Locations of the parabolas in the lower envelope. */
+      std::vector<real_t> z; /**< Boundaries between the parabolas of the lower envelope. */
+
+      void resize(int n) {
+        f.resize(n);
+        v.resize(n);
+        z.resize(n + 1);
+      }
+    };
+
+    /**
+     * @brief 1D squared distance transform of n samples at data[0], data[stride], ...
+     */
+    void Transform1D(real_t* data, int n, uint64_t stride, LineBuffers& buffers) {
+      for (int q = 0; q < n; q++) {
+        buffers.f[q] = data[q * stride];
+      }
+
+      const real_t* f = buffers.f.data();
+      int* v = buffers.v.data();
+      real_t* z = buffers.z.data();
+
+      int k = 0;
+      v[0] = 0;
+      z[0] = -kDistanceTransformInfinity;
+      z[1] = kDistanceTransformInfinity;
+
+      auto intersection = [&](int q, int p) {
+        return ((f[q] + static_cast<real_t>(q) * q) - (f[p] + static_cast<real_t>(p) * p)) /
+               static_cast<real_t>(2 * q - 2 * p);
+      };
+
+      // z[0] is below any intersection since all samples are bounded by kDistanceTransformInfinity
+      for (int q = 1; q < n; q++) {
+        real_t s = intersection(q, v[k]);
+        while (s <= z[k]) {
+          k--;
+          s = intersection(q, v[k]);
+        }
+
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = kDistanceTransformInfinity;
+      }
+
+      k = 0;
+      for (int q = 0; q < n; q++) {
+        while (z[k + 1] < static_cast<real_t>(q)) {
+          k++;
+        }
+
+        const real_t d = static_cast<real_t>(q - v[k]);
+        data[q * stride] = std::min(kDistanceTransformInfinity, d * d + f[v[k]]);
+      }
+    }
+
+  }
+
+  bool SquaredDistanceTransform(const vec3i& dims, std::vector<real_t>& inout_values) {
+    const uint64_t nx = static_cast<uint64_t>(dims.x());
+    const uint64_t ny = static_cast<uint64_t>(dims.y());
+    const uint64_t nz = static_cast<uint64_t>(dims.z());
+
+    if (inout_values.size() != nx * ny * nz) {
+      SPDLOG_ERROR("The grid has [{}] values but [{} x {} x {}] grid points are expected",
+                   inout_values.size(), nx, ny, nz);
+      return false;
+    }
+
+    if (inout_values.empty()) {
+      return true;
+    }
+
+    real_t* values = inout_values.data();
+
+    // pass along x, one line per (y, z)
+    ParallelFor(0, ny * nz, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      LineBuffers buffers;
+      buffers.resize(dims.x());
+      for (uint64_t line = chunk_begin; line < chunk_end; line++) {
+        Transform1D(values + line * nx, dims.x(), 1, buffers);
+      }
+    }, 64);
+
+    // pass along y, one line per (x, z)
+    ParallelFor(0, nx * nz, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      LineBuffers buffers;
+      buffers.resize(dims.y());
+      for (uint64_t line = chunk_begin; line < chunk_end; line++) {
+        const uint64_t x = line % nx;
+        const uint64_t z = line / nx;
+        Transform1D(values + z * nx * ny + x, dims.y(), nx, buffers);
+      }
+    }, 64);
+
+    // pass along z, one line per (x, y)
+    ParallelFor(0, nx * ny, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      LineBuffers buffers;
+      buffers.resize(dims.z());
+      for (uint64_t line = chunk_begin; line < chunk_end; line++) {
+        Transform1D(values + line, dims.z(), nx * ny, buffers);
+      }
+    }, 64);
+
+    return true;
+  }
+
+}
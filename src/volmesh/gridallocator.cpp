@@ -0,0 +1,245 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/gridallocator.h"
+#include "volmesh/logger.h"
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief The size of a huge page on x86-64 and of the default huge page on arm64 Linux.
+     */
+    static const uint64_t kDefaultHugePageSizeInBytes = 2ull << 20;
+
+    static std::atomic<int> g_huge_pages_mode(kHugePagesTransparent);
+
+    /**
+     * @brief Returns the default huge page size of the system, read once from /proc/meminfo.
+     */
+    uint64_t HugePageSizeInBytes() {
+      static const uint64_t huge_page_size = []() {
+        std::ifstream meminfo("/proc/meminfo");
+        std::string line;
+        while (std::getline(meminfo, line)) {
+          if (line.compare(0, 13, "Hugepagesize:") == 0) {
+            const uint64_t size_kb = std::stoull(line.substr(13));
+            if (size_kb > 0) {
+              return size_kb << 10;
+            }
+          }
+        }
+
+        return kDefaultHugePageSizeInBytes;
+      }();
+
+      return huge_page_size;
+    }
+
+    /**
+     * @brief Rounds a size up to whole huge pages, the length of every grid mapping.
+     */
+    uint64_t RoundUpToHugePages(uint64_t size_in_bytes) {
+      const uint64_t huge_page_size = HugePageSizeInBytes();
+      return ((size_in_bytes + huge_page_size - 1) / huge_page_size) * huge_page_size;
+    }
+
+#if !defined(_WIN32)
+    /**
+     * @brief Maps length bytes of anonymous memory at a huge page aligned address.
+     */
+    void* MapAligned(uint64_t length) {
+      const uint64_t huge_page_size = HugePageSizeInBytes();
+      const uint64_t padded_length = length + huge_page_size;
+      void* mapped = ::mmap(nullptr, padded_length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapped == MAP_FAILED) {
+        return nullptr;
+      }
+
+      // trim the unaligned head and the tail
+      const uintptr_t start = reinterpret_cast<uintptr_t>(mapped);
+      const uintptr_t aligned = ((start + huge_page_size - 1) / huge_page_size) * huge_page_size;
+      const uint64_t head = aligned - start;
+      const uint64_t tail = padded_length - head - length;
+      if (head > 0) {
+        ::munmap(mapped, head);
+      }
+      if (tail > 0) {
+        ::munmap(reinterpret_cast<void*>(aligned + length), tail);
+      }
+
+      return reinterpret_cast<void*>(aligned);
+    }
+#endif
+
+  }
+
+  void SetHugePagesMode(HugePagesMode mode) {
+    g_huge_pages_mode.store(mode);
+  }
+
+  HugePagesMode GetHugePagesMode() {
+    return static_cast<HugePagesMode>(g_huge_pages_mode.load());
+  }
+
+  void* AllocateGridMemory(uint64_t size_in_bytes) {
+    if (size_in_bytes == 0) {
+      return nullptr;
+    }
+
+    const uint64_t length = RoundUpToHugePages(size_in_bytes);
+
+#if defined(_WIN32)
+    // without anonymous mappings the block is zero filled here and has no huge pages
+    void* address = ::operator new(length, std::align_val_t(HugePageSizeInBytes()), std::nothrow);
+    if (address == nullptr) {
+      SPDLOG_ERROR("Failed to allocate [{}] bytes for a grid", length);
+      return nullptr;
+    }
+
+    std::memset(address, 0, length);
+    return address;
+#else
+    const HugePagesMode mode = GetHugePagesMode();
+
+    void* address = nullptr;
+#if defined(MAP_HUGETLB)
+    if (mode == kHugePagesExplicit) {
+      void* mapped = ::mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+      if (mapped != MAP_FAILED) {
+        address = mapped;
+      } else {
+        SPDLOG_WARN("No explicit huge pages are available for [{}] bytes, using transparent huge pages", length);
+      }
+    }
+#endif
+
+    if (address == nullptr) {
+      address = MapAligned(length);
+      if (address == nullptr) {
+        SPDLOG_ERROR("Failed to map [{}] bytes for a grid", length);
+        return nullptr;
+      }
+
+#if defined(MADV_HUGEPAGE)
+      if (mode != kHugePagesNone) {
+        ::madvise(address, length, MADV_HUGEPAGE);
+      }
+#endif
+    }
+
+    // the pages are left untouched, every page lands on the node of the thread that writes it first
+    return address;
+#endif
+  }
+
+  void FreeGridMemory(void* address, uint64_t size_in_bytes) {
+    if (address == nullptr) {
+      return;
+    }
+
+#if defined(_WIN32)
+    (void)size_in_bytes;
+    ::operator delete(address, std::align_val_t(HugePageSizeInBytes()));
+#else
+    // the same length as mapped, in any huge pages mode
+    ::munmap(address, RoundUpToHugePages(size_in_bytes));
+#endif
+  }
+
+  bool QueryPagePlacement(const void* address,
+                          uint64_t size_in_bytes,
+                          std::map<int, uint64_t>& out_pages_per_node) {
+    out_pages_per_node.clear();
+
+#if defined(__linux__) && defined(SYS_move_pages)
+    const uint64_t page_size = static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+    const uintptr_t first = (reinterpret_cast<uintptr_t>(address) / page_size) * page_size;
+    const uintptr_t last = reinterpret_cast<uintptr_t>(address) + size_in_bytes;
+
+    static const uint64_t kBatchSize = 4096;
+    std::vector<void*> pages;
+    std::vector<int> status;
+    pages.reserve(kBatchSize);
+    for (uintptr_t batch = first; batch < last; batch += kBatchSize * page_size) {
+      pages.clear();
+      for (uintptr_t page = batch; page < last && pages.size() < kBatchSize; page += page_size) {
+        pages.push_back(reinterpret_cast<void*>(page));
+      }
+
+      // without target nodes move_pages only reports the node of every page
+      status.assign(pages.size(), 0);
+      if (::syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0) != 0) {
+        SPDLOG_ERROR("Failed to query the placement of the pages");
+        return false;
+      }
+
+      for (int node : status) {
+        out_pages_per_node[(node >= 0) ? node : -1]++;
+      }
+    }
+
+    return true;
+#else
+    (void)address;
+    (void)size_in_bytes;
+    return false;
+#endif
+  }
+
+  void LogPagePlacement(const char* label, const void* address, uint64_t size_in_bytes) {
+    std::map<int, uint64_t> pages_per_node;
+    if (QueryPagePlacement(address, size_in_bytes, pages_per_node) == false) {
+      SPDLOG_INFO("The page placement of [{}] is not available on this platform", label);
+      return;
+    }
+
+    std::stringstream ss;
+    for (const auto& [node, count] : pages_per_node) {
+      ss << ((node >= 0) ? "node " + std::to_string(node) : std::string("not resident")) << " = " << count << " ";
+    }
+
+    // the transparent huge pages of the mappings that overlap the block
+    uint64_t huge_pages_kb = 0;
+    std::ifstream smaps("/proc/self/smaps");
+    std::string line;
+    bool overlaps = false;
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(address);
+    const uintptr_t end = begin + size_in_bytes;
+    while (std::getline(smaps, line)) {
+      uintptr_t range_begin = 0;
+      uintptr_t range_end = 0;
+      char dash = 0;
+      std::istringstream header(line);
+      if (header >> std::hex >> range_begin >> dash >> range_end && dash == '-') {
+        overlaps = (range_begin < end && begin < range_end);
+      } else if (overlaps && line.compare(0, 14, "AnonHugePages:") == 0) {
+        huge_pages_kb += std::stoull(line.substr(14));
+      }
+    }
+
+    SPDLOG_INFO("Pages of [{}]: {}, transparent huge pages = [{}] KiB", label, ss.str().c_str(), huge_pages_kb);
+  }
+
+}
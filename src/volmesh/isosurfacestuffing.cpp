@@ -0,0 +1,879 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/isosurfacestuffing.h"
+#include "volmesh/gridallocator.h"
+#include "volmesh/logger.h"
+#include "volmesh/parallel.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace volmesh {
+
+  namespace {
+
+    typedef std::array<uint64_t, 4> TetKeys;
+
+    /**
+     * @brief Marks a lattice vertex that keeps its position.
+     */
+    static const uint8_t kNotSnapped = 0xFF;
+
+    /**
+     * @brief Number of lattice edges at every vertex, 6 long edges to the vertices of the same color and 8 short ones.
+     */
+    static const int kCountIncidentEdges = 14;
+
+    /**
+     * @brief Number of edge keys per lattice vertex, the long edges in the positive axis directions and,
+     * for the cube centers, the short edges to the 8 cube corners.
+     */
+    static const uint64_t kCountEdgeSlotsPerVertex = 16;
+
+    static const int kMaxCutIterations = 24;
+
+    /**
+     * @brief A body centered cubic lattice of black cube corners and red cube centers.
+     *
+     * Every lattice vertex and every lattice edge has a key. The black corners come first, then the
+     * red centers, then the edges grouped by the vertex they start from.
+     */
+    struct BccLattice {
+      vec3 lower;
+      real_t spacing = 0.0;
+      vec3i count_black; /**< Number of black vertices per axis, there is one cube less. */
+      uint64_t total_black = 0;
+      uint64_t total_red = 0;
+
+      uint64_t countVertices() const {
+        return total_black + total_red;
+      }
+
+      vec3i countCubes() const {
+        return count_black - vec3i(1, 1, 1);
+      }
+
+      uint64_t blackKey(const vec3i& coords) const {
+        return (static_cast<uint64_t>(coords.z()) * count_black.y() + coords.y()) * count_black.x() + coords.x();
+      }
+
+      uint64_t redKey(const vec3i& coords) const {
+        const vec3i count_cubes = countCubes();
+        return total_black + (static_cast<uint64_t>(coords.z()) * count_cubes.y() + coords.y()) * count_cubes.x() + coords.x();
+      }
+
+      bool isRed(uint64_t key) const {
+        return key >= total_black;
+      }
+
+      /**
+       * @brief The coordinates of a black vertex, or of the cube of a red vertex.
+       */
+      vec3i coords(uint64_t key) const {
+        const vec3i counts = isRed(key) ? countCubes() : count_black;
+        const uint64_t id = isRed(key) ? key - total_black : key;
+        return vec3i(static_cast<int>(id % counts.x()),
+                     static_cast<int>((id / counts.x()) % counts.y()),
+                     static_cast<int>(id / (static_cast<uint64_t>(counts.x()) * counts.y())));
+      }
+
+      vec3 position(uint64_t key) const {
+        const vec3 offset = isRed(key) ? vec3(0.5, 0.5, 0.5) : vec3(0.0, 0.0, 0.0);
+        return lower + spacing * (coords(key).cast<real_t>() + offset);
+      }
+
+      /**
+       * @brief Direction 0 to 2 is the long edge along that axis, 3 + c is the short edge from a cube
+       * center to corner c of its cube, with bit 0, 1 and 2 of c selecting the upper side along x, y and z.
+       */
+      uint64_t edgeKey(uint64_t owner, int direction) const {
+        return countVertices() + owner * kCountEdgeSlotsPerVertex + static_cast<uint64_t>(direction);
+      }
+
+      bool isEdge(uint64_t key) const {
+        return key >= countVertices();
+      }
+
+      void edgeEnds(uint64_t edge_key, uint64_t& out_owner, uint64_t& out_other, bool& out_is_long) const {
+        const uint64_t id = edge_key - countVertices();
+        out_owner = id / kCountEdgeSlotsPerVertex;
+        const int direction = static_cast<int>(id % kCountEdgeSlotsPerVertex);
+        const vec3i c = coords(out_owner);
+
+        out_is_long = direction < 3;
+        if (out_is_long) {
+          const vec3i next = c + vec3i::Unit(direction);
+          out_other = isRed(out_owner) ? redKey(next) : blackKey(next);
+        } else {
+          out_other = blackKey(c + CornerOffset(direction - 3));
+        }
+      }
+
+      /**
+       * @brief Retrieves the lattice edge at slot [0, 14) of a vertex and its other end.
+       *
+       * Slots 0 to 5 are the long edges along +x, +y, +z, -x, -y and -z, slots 6 to 13 the short edges.
+       *
+       * @return False if the edge leaves the lattice.
+       */
+      bool incidentEdge(uint64_t key, int slot, uint64_t& out_edge_key, uint64_t& out_other) const {
+        const vec3i c = coords(key);
+        const bool is_red = isRed(key);
+        const vec3i counts = is_red ? countCubes() : count_black;
+
+        if (slot < 3) {
+          if (c[slot] + 1 >= counts[slot]) {
+            return false;
+          }
+
+          const vec3i next = c + vec3i::Unit(slot);
+          out_other = is_red ? redKey(next) : blackKey(next);
+          out_edge_key = edgeKey(key, slot);
+          return true;
+        }
+
+        if (slot < 6) {
+          const int axis = slot - 3;
+          if (c[axis] == 0) {
+            return false;
+          }
+
+          const vec3i prev = c - vec3i::Unit(axis);
+          out_other = is_red ? redKey(prev) : blackKey(prev);
+          out_edge_key = edgeKey(out_other, axis);
+          return true;
+        }
+
+        const int corner = slot - 6;
+        if (is_red) {
+          out_other = blackKey(c + CornerOffset(corner));
+          out_edge_key = edgeKey(key, 3 + corner);
+          return true;
+        }
+
+        // the black vertex is corner c of the cube below it
+        const vec3i cube = c - CornerOffset(corner);
+        const vec3i count_cubes = countCubes();
+        for (int axis = 0; axis < 3; axis++) {
+          if (cube[axis] < 0 || cube[axis] >= count_cubes[axis]) {
+            return false;
+          }
+        }
+
+        out_other = redKey(cube);
+        out_edge_key = edgeKey(out_other, 3 + corner);
+        return true;
+      }
+
+      static vec3i CornerOffset(int corner) {
+        return vec3i(corner & 1, (corner >> 1) & 1, (corner >> 2) & 1);
+      }
+    };
+
+    /**
+     * @brief Finds where the field crosses zero on the segment from pa to pb with the Illinois variant of regula falsi.
+     *
+     * The field changes sign between the end points, so its magnitude at the ends can not exceed the
+     * segment length. Values outside the narrow band are clamped to it.
+     *
+     * @return The parameter of the crossing in (0, 1).
+     */
+    real_t FindCutParameter(const SignedDistanceField& in_sdf, const vec3& pa, const vec3& pb, real_t fa, real_t fb) {
+      const real_t length = (pb - pa).norm();
+      const real_t tolerance = length * 1e-9;
+      fa = std::clamp(fa, -length, length);
+      fb = std::clamp(fb, -length, length);
+
+      real_t t0 = 0.0;
+      real_t t1 = 1.0;
+      int side = 0;
+      for (int i = 0; i < kMaxCutIterations && (t1 - t0) * length > tolerance; i++) {
+        const real_t t = (t0 * fb - t1 * fa) / (fb - fa);
+        const real_t f = std::clamp(in_sdf.sampleFieldValue(pa + t * (pb - pa)), -length, length);
+        if (std::fabs(f) <= tolerance) {
+          return t;
+        }
+
+        // halve the value of the end that stays twice in a row
+        if ((f < 0.0) == (fa < 0.0)) {
+          t0 = t;
+          fa = f;
+          if (side == -1) {
+            fb *= 0.5;
+          }
+          side = -1;
+        } else {
+          t1 = t;
+          fb = f;
+          if (side == 1) {
+            fa *= 0.5;
+          }
+          side = 1;
+        }
+      }
+
+      return (t0 * fb - t1 * fa) / (fb - fa);
+    }
+
+    /**
+     * @brief Splits a pyramid by the diagonal of its base through the smallest key.
+     */
+    void EmitPyramid(uint64_t apex, const std::array<uint64_t, 4>& base, std::vector<TetKeys>& out_tets) {
+      const int smallest = static_cast<int>(std::min_element(base.begin(), base.end()) - base.begin());
+      const int d = smallest % 2;
+      out_tets.push_back({apex, base[d], base[d + 1], base[(d + 2) % 4]});
+      out_tets.push_back({apex, base[d], base[(d + 2) % 4], base[(d + 3) % 4]});
+    }
+
+    /**
+     * @brief Splits a triangular prism with the vertices of `a` above those of `b` into three tetrahedra.
+     *
+     * Every quadrilateral side is split by its diagonal through the smallest key, which always
+     * leaves a valid split of the prism.
+     *
+     * @ref Dompierre, J., Labbé, P., Vallet, M.-G., Camarero, R. (1999). How to subdivide pyramids,
+     * prisms and hexahedra into tetrahedra. 8th International Meshing Roundtable.
+     */
+    void EmitPrism(std::array<uint64_t, 3> a, std::array<uint64_t, 3> b, std::vector<TetKeys>& out_tets) {
+      if (*std::min_element(b.begin(), b.end()) < *std::min_element(a.begin(), a.end())) {
+        std::swap(a, b);
+      }
+
+      const int r = static_cast<int>(std::min_element(a.begin(), a.end()) - a.begin());
+      std::rotate(a.begin(), a.begin() + r, a.end());
+      std::rotate(b.begin(), b.begin() + r, b.end());
+
+      out_tets.push_back({a[0], b[0], b[1], b[2]});
+
+      const uint64_t smallest = std::min({a[1], a[2], b[1], b[2]});
+      if (smallest == a[1] || smallest == b[2]) {
+        out_tets.push_back({a[0], a[1], a[2], b[2]});
+        out_tets.push_back({a[0], a[1], b[2], b[1]});
+      } else {
+        out_tets.push_back({a[0], a[1], a[2], b[1]});
+        out_tets.push_back({a[0], a[2], b[2], b[1]});
+      }
+    }
+
+    /**
+     * @brief Fills the inside part of a lattice tetrahedron with the stencil of its vertex signs.
+     *
+     * @param keys The keys of the 4 vertices.
+     * @param signs The signs of the vertices after snapping, negative inside.
+     * @param edge_keys The keys of the lattice edges between the vertices.
+     */
+    void EmitStencil(const std::array<uint64_t, 4>& keys,
+                     const std::array<int8_t, 4>& signs,
+                     const std::array<std::array<uint64_t, 4>, 4>& edge_keys,
+                     std::vector<TetKeys>& out_tets) {
+      int inside[4];
+      int zero[4];
+      int outside[4];
+      int count_inside = 0;
+      int count_zero = 0;
+      int count_outside = 0;
+      for (int i = 0; i < 4; i++) {
+        if (signs[i] < 0) {
+          inside[count_inside++] = i;
+        } else if (signs[i] == 0) {
+          zero[count_zero++] = i;
+        } else {
+          outside[count_outside++] = i;
+        }
+      }
+
+      if (count_inside == 0) {
+        return;
+      }
+
+      if (count_outside == 0) {
+        out_tets.push_back(keys);
+        return;
+      }
+
+      if (count_inside == 1) {
+        TetKeys tet;
+        int count = 0;
+        tet[count++] = keys[inside[0]];
+        for (int i = 0; i < count_zero; i++) {
+          tet[count++] = keys[zero[i]];
+        }
+        for (int i = 0; i < count_outside; i++) {
+          tet[count++] = edge_keys[inside[0]][outside[i]];
+        }
+        out_tets.push_back(tet);
+        return;
+      }
+
+      if (count_inside == 2 && count_zero == 1) {
+        const int p1 = inside[0];
+        const int p2 = inside[1];
+        const int m = outside[0];
+        EmitPyramid(keys[zero[0]], {keys[p1], keys[p2], edge_keys[p2][m], edge_keys[p1][m]}, out_tets);
+        return;
+      }
+
+      if (count_inside == 2) {
+        const int p1 = inside[0];
+        const int p2 = inside[1];
+        const int m1 = outside[0];
+        const int m2 = outside[1];
+        EmitPrism({keys[p1], edge_keys[p1][m1], edge_keys[p1][m2]},
+                  {keys[p2], edge_keys[p2][m1], edge_keys[p2][m2]}, out_tets);
+        return;
+      }
+
+      const int m = outside[0];
+      EmitPrism({keys[inside[0]], keys[inside[1]], keys[inside[2]]},
+                {edge_keys[inside[0]][m], edge_keys[inside[1]][m], edge_keys[inside[2]][m]}, out_tets);
+    }
+
+    /**
+     * @brief Sets up a lattice that reaches one cube beyond the field, which is outside everywhere.
+     *
+     * @return False if the field has too few grid points or the spacing is not positive.
+     */
+    bool InitLattice(const SignedDistanceField& in_sdf, real_t lattice_spacing, BccLattice& out_lattice) {
+      if (in_sdf.gridPointsCount().minCoeff() < 2) {
+        SPDLOG_ERROR("The field needs at least two grid points along each axis to stuff its isosurface");
+        return false;
+      }
+
+      if (lattice_spacing <= 0.0) {
+        SPDLOG_ERROR("The lattice spacing must be positive. [{}]", lattice_spacing);
+        return false;
+      }
+
+      out_lattice.spacing = lattice_spacing;
+      out_lattice.lower = in_sdf.bounds().lower() - vec3::Constant(lattice_spacing);
+      const vec3 extent = in_sdf.bounds().extent();
+      for (int axis = 0; axis < 3; axis++) {
+        out_lattice.count_black[axis] = static_cast<int>(std::ceil(extent[axis] / lattice_spacing)) + 3;
+      }
+
+      const vec3i count_cubes = out_lattice.countCubes();
+      out_lattice.total_black = static_cast<uint64_t>(out_lattice.count_black.x()) * out_lattice.count_black.y() * out_lattice.count_black.z();
+      out_lattice.total_red = static_cast<uint64_t>(count_cubes.x()) * count_cubes.y() * count_cubes.z();
+
+      SPDLOG_INFO("BCC lattice of [{} x {} x {}] cubes", count_cubes.x(), count_cubes.y(), count_cubes.z());
+      return true;
+    }
+
+    /**
+     * @brief Finds the cut point on a lattice edge from the field values at its ends.
+     */
+    template <typename ValueFn>
+    vec3 EdgeCutPoint(const SignedDistanceField& in_sdf, const BccLattice& lattice, uint64_t edge_key, const ValueFn& value_of) {
+      uint64_t owner, other;
+      bool is_long;
+      lattice.edgeEnds(edge_key, owner, other, is_long);
+      const vec3 pa = lattice.position(owner);
+      const vec3 pb = lattice.position(other);
+      return vec3(pa + FindCutParameter(in_sdf, pa, pb, value_of(owner), value_of(other)) * (pb - pa));
+    }
+
+    /**
+     * @brief Finds the incident edge slot of a lattice vertex whose cut point is closest to it within the alpha fraction.
+     *
+     * @return The slot of the edge the vertex snaps to, or `kNotSnapped`.
+     */
+    template <typename ValueFn>
+    uint8_t FindSnappedSlot(const SignedDistanceField& in_sdf, const BccLattice& lattice, uint64_t key, const ValueFn& value_of) {
+      const real_t value = value_of(key);
+      uint8_t snapped_slot = kNotSnapped;
+      real_t closest = std::numeric_limits<real_t>::max();
+
+      for (int slot = 0; slot < kCountIncidentEdges && value != 0.0; slot++) {
+        uint64_t edge_key, other;
+        if (lattice.incidentEdge(key, slot, edge_key, other) == false) {
+          continue;
+        }
+
+        const real_t other_value = value_of(other);
+        if (other_value == 0.0 || (other_value < 0.0) == (value < 0.0)) {
+          continue;
+        }
+
+        // the cut parameter runs from the vertex that owns the edge
+        uint64_t owner, end;
+        bool is_long;
+        lattice.edgeEnds(edge_key, owner, end, is_long);
+        const real_t t = FindCutParameter(in_sdf, lattice.position(owner), lattice.position(end), value_of(owner), value_of(end));
+        const real_t fraction = (owner == key) ? t : 1.0 - t;
+        const real_t alpha = is_long ? kIsosurfaceStuffingAlphaLong : kIsosurfaceStuffingAlphaShort;
+        if (fraction < alpha && fraction < closest) {
+          closest = fraction;
+          snapped_slot = static_cast<uint8_t>(slot);
+        }
+      }
+
+      return snapped_slot;
+    }
+
+    /**
+     * @brief The sign of a lattice vertex after snapping, zero on the surface and negative inside.
+     */
+    int8_t SnappedSign(real_t value, uint8_t snapped_slot) {
+      return (value == 0.0 || snapped_slot != kNotSnapped) ? 0 : ((value < 0.0) ? -1 : 1);
+    }
+
+    /**
+     * @brief The position of an output vertex: a cut point, a snapped lattice vertex or a lattice vertex.
+     */
+    template <typename ValueFn, typename SnappedSlotFn>
+    vec3 OutputVertexPosition(const SignedDistanceField& in_sdf,
+                              const BccLattice& lattice,
+                              uint64_t key,
+                              const ValueFn& value_of,
+                              const SnappedSlotFn& snapped_slot_of) {
+      if (lattice.isEdge(key)) {
+        return EdgeCutPoint(in_sdf, lattice, key, value_of);
+      }
+
+      const uint8_t snapped_slot = snapped_slot_of(key);
+      if (snapped_slot != kNotSnapped) {
+        uint64_t edge_key, other;
+        lattice.incidentEdge(key, snapped_slot, edge_key, other);
+        return EdgeCutPoint(in_sdf, lattice, edge_key, value_of);
+      }
+
+      return lattice.position(key);
+    }
+
+    /**
+     * @brief Fills the lattice tetrahedra of a row of cubes along x, each cube owns the 4 tetrahedra
+     * around each of its faces towards +x, +y and +z.
+     */
+    template <typename SignFn>
+    void EmitCubeRow(const BccLattice& lattice, int y, int z, const SignFn& sign_of, std::vector<TetKeys>& out_tets) {
+      const vec3i count_cubes = lattice.countCubes();
+      for (int x = 0; x < count_cubes.x(); x++) {
+        const vec3i cube(x, y, z);
+        for (int axis = 0; axis < 3; axis++) {
+          const vec3i next_cube = cube + vec3i::Unit(axis);
+          if (next_cube[axis] >= count_cubes[axis]) {
+            continue;
+          }
+
+          const uint64_t red0 = lattice.redKey(cube);
+          const uint64_t red1 = lattice.redKey(next_cube);
+          const int u = (axis + 1) % 3;
+          const int w = (axis + 2) % 3;
+          const vec3i face_corners[4] = {next_cube,
+                                         next_cube + vec3i::Unit(u),
+                                         next_cube + vec3i::Unit(u) + vec3i::Unit(w),
+                                         next_cube + vec3i::Unit(w)};
+
+          for (int e = 0; e < 4; e++) {
+            vec3i black0 = face_corners[e];
+            vec3i black1 = face_corners[(e + 1) % 4];
+            if (lattice.blackKey(black1) < lattice.blackKey(black0)) {
+              std::swap(black0, black1);
+            }
+
+            const std::array<uint64_t, 4> keys = {lattice.blackKey(black0), lattice.blackKey(black1), red0, red1};
+            const std::array<int8_t, 4> tet_signs = {sign_of(keys[0]), sign_of(keys[1]), sign_of(keys[2]), sign_of(keys[3])};
+            if (tet_signs[0] >= 0 && tet_signs[1] >= 0 && tet_signs[2] >= 0 && tet_signs[3] >= 0) {
+              continue;
+            }
+
+            // corner ids of the black vertices in the two cubes
+            auto corner = [](const vec3i& black, const vec3i& c) {
+              const vec3i offset = black - c;
+              return offset.x() + 2 * offset.y() + 4 * offset.z();
+            };
+
+            int black_axis = 0;
+            while (black1[black_axis] == black0[black_axis]) {
+              black_axis++;
+            }
+
+            std::array<std::array<uint64_t, 4>, 4> edge_keys;
+            edge_keys[0][1] = lattice.edgeKey(keys[0], black_axis);
+            edge_keys[2][3] = lattice.edgeKey(red0, axis);
+            edge_keys[0][2] = lattice.edgeKey(red0, 3 + corner(black0, cube));
+            edge_keys[1][2] = lattice.edgeKey(red0, 3 + corner(black1, cube));
+            edge_keys[0][3] = lattice.edgeKey(red1, 3 + corner(black0, next_cube));
+            edge_keys[1][3] = lattice.edgeKey(red1, 3 + corner(black1, next_cube));
+            for (int i = 0; i < 4; i++) {
+              for (int j = 0; j < i; j++) {
+                edge_keys[i][j] = edge_keys[j][i];
+              }
+            }
+
+            EmitStencil(keys, tet_signs, edge_keys, out_tets);
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief Orients a tetrahedron like `TetMesh::insertVoxel` does.
+     */
+    void OrientCell(const vec3& a, const vec3& b, const vec3& c, const vec3& d, vec4i& inout_cell) {
+      if ((b - a).dot((c - a).cross(d - a)) > 0.0) {
+        std::swap(inout_cell[2], inout_cell[3]);
+      }
+    }
+
+    /**
+     * @brief The field values, snapped slots and signs of the lattice vertices in a window of consecutive z layers.
+     *
+     * Layer z holds the black vertices with z coordinate z, followed by the red vertices of the cubes
+     * in layer z. The slabs of cubes [z, z + 1) read the layers z - 1 to z + 2, the snapped vertices
+     * of the layers z and z + 1 reach one layer further along their cut edges.
+     */
+    struct LatticeWindow {
+      static const int kCountLayers = 4;
+
+      const BccLattice& lattice;
+      uint64_t layer_black = 0;
+      uint64_t layer_red = 0;
+      std::array<std::vector<real_t>, kCountLayers> values;
+      std::array<std::vector<uint8_t>, kCountLayers> snapped_slots;
+      std::array<std::vector<int8_t>, kCountLayers> signs;
+
+      explicit LatticeWindow(const BccLattice& in_lattice)
+        : lattice(in_lattice) {
+        const vec3i count_cubes = lattice.countCubes();
+        layer_black = static_cast<uint64_t>(lattice.count_black.x()) * lattice.count_black.y();
+        layer_red = static_cast<uint64_t>(count_cubes.x()) * count_cubes.y();
+      }
+
+      /**
+       * @brief The layer slot and the index within the layer of a lattice vertex.
+       */
+      uint64_t locate(uint64_t key, int& out_slot) const {
+        const int z = lattice.coords(key).z();
+        out_slot = z % kCountLayers;
+        if (lattice.isRed(key)) {
+          return layer_black + (key - lattice.total_black) - static_cast<uint64_t>(z) * layer_red;
+        }
+
+        return key - static_cast<uint64_t>(z) * layer_black;
+      }
+
+      real_t value(uint64_t key) const {
+        int slot;
+        const uint64_t i = locate(key, slot);
+        return values[slot][i];
+      }
+
+      uint8_t snappedSlot(uint64_t key) const {
+        int slot;
+        const uint64_t i = locate(key, slot);
+        return snapped_slots[slot][i];
+      }
+
+      int8_t sign(uint64_t key) const {
+        int slot;
+        const uint64_t i = locate(key, slot);
+        return signs[slot][i];
+      }
+
+      /**
+       * @brief The key of the vertex at index i of layer z.
+       */
+      uint64_t key(int z, uint64_t i) const {
+        if (i < layer_black) {
+          return static_cast<uint64_t>(z) * layer_black + i;
+        }
+
+        return lattice.total_black + static_cast<uint64_t>(z) * layer_red + (i - layer_black);
+      }
+
+      /**
+       * @brief Samples the field at the vertices of layer z, which replaces layer z - kCountLayers.
+       */
+      void sample(const SignedDistanceField& in_sdf, int z) {
+        const int slot = z % kCountLayers;
+        const uint64_t count = layer_black + ((z < lattice.countCubes().z()) ? layer_red : 0);
+        values[slot].resize(count);
+        ParallelFor(0, count, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+          for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+            values[slot][i] = in_sdf.sampleFieldValue(lattice.position(key(z, i)));
+          }
+        }, 4096);
+      }
+
+      /**
+       * @brief Snaps the vertices of layer z, the layers z - 1 and z + 1 must be sampled.
+       */
+      void snap(const SignedDistanceField& in_sdf, int z) {
+        const int slot = z % kCountLayers;
+        const uint64_t count = values[slot].size();
+        snapped_slots[slot].resize(count);
+        signs[slot].resize(count);
+        auto value_of = [this](uint64_t k) { return value(k); };
+        ParallelFor(0, count, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+          for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+            snapped_slots[slot][i] = FindSnappedSlot(in_sdf, lattice, key(z, i), value_of);
+            signs[slot][i] = SnappedSign(values[slot][i], snapped_slots[slot][i]);
+          }
+        }, 4096);
+      }
+    };
+
+  }
+
+  bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                       real_t lattice_spacing,
+                       std::vector<vec3>& out_vertices,
+                       std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+    out_vertices.clear();
+    out_tet_cells_by_vertex_ids.clear();
+
+    BccLattice lattice;
+    if (InitLattice(in_sdf, lattice_spacing, lattice) == false) {
+      return false;
+    }
+
+    const vec3i count_cubes = lattice.countCubes();
+    const uint64_t count_lattice_vertices = lattice.countVertices();
+
+    // sample the field at the lattice vertices
+    GridVector<real_t> values(count_lattice_vertices);
+    ParallelFor(0, count_lattice_vertices, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t key = chunk_begin; key < chunk_end; key++) {
+        values[key] = in_sdf.sampleFieldValue(lattice.position(key));
+      }
+    }, 4096);
+
+    auto value_of = [&values](uint64_t key) { return values[key]; };
+
+    // snap every vertex that violates a cut point to the closest one, its other cut points disappear
+    GridVector<uint8_t> snapped_slots(count_lattice_vertices);
+    GridVector<int8_t> signs(count_lattice_vertices);
+    ParallelFor(0, count_lattice_vertices, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t key = chunk_begin; key < chunk_end; key++) {
+        snapped_slots[key] = FindSnappedSlot(in_sdf, lattice, key, value_of);
+        signs[key] = SnappedSign(values[key], snapped_slots[key]);
+      }
+    }, 4096);
+
+    // fill the lattice tetrahedra of every slab of cubes
+    auto sign_of = [&signs](uint64_t key) { return signs[key]; };
+    const uint64_t count_slabs = static_cast<uint64_t>(count_cubes.z());
+    std::vector<std::vector<TetKeys>> slab_tets(count_slabs);
+    std::vector<std::vector<uint64_t>> slab_keys(count_slabs);
+    ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+        std::vector<TetKeys>& tets = slab_tets[z];
+        for (int y = 0; y < count_cubes.y(); y++) {
+          EmitCubeRow(lattice, y, static_cast<int>(z), sign_of, tets);
+        }
+
+        std::vector<uint64_t>& keys = slab_keys[z];
+        keys.reserve(tets.size() * 4);
+        for (const TetKeys& tet : tets) {
+          keys.insert(keys.end(), tet.begin(), tet.end());
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      }
+    });
+
+    // merge the keys of all slabs, their sorted order gives the vertex ids
+    std::vector<uint64_t> vertex_keys;
+    std::vector<uint64_t> slab_offsets(count_slabs + 1, 0);
+    for (uint64_t z = 0; z < count_slabs; z++) {
+      vertex_keys.insert(vertex_keys.end(), slab_keys[z].begin(), slab_keys[z].end());
+      slab_offsets[z + 1] = slab_offsets[z] + slab_tets[z].size();
+      slab_keys[z].clear();
+      slab_keys[z].shrink_to_fit();
+    }
+    std::sort(vertex_keys.begin(), vertex_keys.end());
+    vertex_keys.erase(std::unique(vertex_keys.begin(), vertex_keys.end()), vertex_keys.end());
+
+    if (slab_offsets[count_slabs] == 0) {
+      SPDLOG_ERROR("There are no lattice vertices inside the surface, the lattice spacing may be too large. [{}]", lattice_spacing);
+      return false;
+    }
+
+    if (vertex_keys.size() > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      SPDLOG_ERROR("Too many vertices for a tetrahedral mesh [{}]", vertex_keys.size());
+      return false;
+    }
+
+    auto snapped_slot_of = [&snapped_slots](uint64_t key) { return snapped_slots[key]; };
+    out_vertices.resize(vertex_keys.size());
+    ParallelFor(0, vertex_keys.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+        out_vertices[i] = OutputVertexPosition(in_sdf, lattice, vertex_keys[i], value_of, snapped_slot_of);
+      }
+    }, 1024);
+
+    // map the keys to vertex ids and orient the tetrahedra
+    out_tet_cells_by_vertex_ids.resize(slab_offsets[count_slabs]);
+    ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+        const std::vector<TetKeys>& tets = slab_tets[z];
+        for (uint64_t i = 0; i < tets.size(); i++) {
+          vec4i cell;
+          for (int k = 0; k < 4; k++) {
+            cell[k] = static_cast<int>(std::lower_bound(vertex_keys.begin(), vertex_keys.end(), tets[i][k]) - vertex_keys.begin());
+          }
+
+          OrientCell(out_vertices[cell[0]], out_vertices[cell[1]], out_vertices[cell[2]], out_vertices[cell[3]], cell);
+          out_tet_cells_by_vertex_ids[slab_offsets[z] + i] = cell;
+        }
+      }
+    });
+
+    SPDLOG_INFO("Stuffed the isosurface with [{}] tetrahedra and [{}] vertices",
+                out_tet_cells_by_vertex_ids.size(), out_vertices.size());
+    return true;
+  }
+
+  bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                       real_t lattice_spacing,
+                       TetMesh& out_mesh) {
+    std::vector<vec3> vertices;
+    std::vector<vec4i> cells;
+    if (StuffIsosurface(in_sdf, lattice_spacing, vertices, cells) == false) {
+      return false;
+    }
+
+    return out_mesh.readFromList(vertices, cells);
+  }
+
+  bool StuffIsosurface(const SignedDistanceField& in_sdf,
+                       real_t lattice_spacing,
+                       TetMeshStreamWriter& inout_writer) {
+    if (inout_writer.isOpen() == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    BccLattice lattice;
+    if (InitLattice(in_sdf, lattice_spacing, lattice) == false) {
+      return false;
+    }
+
+    const vec3i count_cubes = lattice.countCubes();
+    const int count_layers = lattice.count_black.z();
+
+    LatticeWindow window(lattice);
+    auto value_of = [&window](uint64_t key) { return window.value(key); };
+    auto snapped_slot_of = [&window](uint64_t key) { return window.snappedSlot(key); };
+    auto sign_of = [&window](uint64_t key) { return window.sign(key); };
+
+    window.sample(in_sdf, 0);
+    window.sample(in_sdf, 1);
+    window.snap(in_sdf, 0);
+
+    // the keys of the previous slab, the only ones the current slab can share, with their ids and positions
+    std::vector<uint64_t> prev_keys;
+    std::vector<int32_t> prev_ids;
+    std::vector<vec3> prev_positions;
+    std::vector<uint64_t> keys;
+    std::vector<int32_t> ids;
+    std::vector<vec3> positions;
+
+    std::vector<std::vector<TetKeys>> row_tets(count_cubes.y());
+    std::vector<TetKeys> tets;
+    std::vector<vec3> vertices;
+    std::vector<vec4i> cells;
+    int64_t count_vertices = 0;
+    uint64_t count_cells = 0;
+    for (int z = 0; z < count_cubes.z(); z++) {
+      if (z + 2 < count_layers) {
+        window.sample(in_sdf, z + 2);
+      }
+      window.snap(in_sdf, z + 1);
+
+      ParallelFor(0, count_cubes.y(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for (uint64_t y = chunk_begin; y < chunk_end; y++) {
+          row_tets[y].clear();
+          EmitCubeRow(lattice, static_cast<int>(y), z, sign_of, row_tets[y]);
+        }
+      });
+
+      tets.clear();
+      keys.clear();
+      for (const std::vector<TetKeys>& row : row_tets) {
+        tets.insert(tets.end(), row.begin(), row.end());
+        for (const TetKeys& tet : row) {
+          keys.insert(keys.end(), tet.begin(), tet.end());
+        }
+      }
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+      // the keys first seen in this slab are numbered in their sorted order
+      ids.resize(keys.size());
+      positions.resize(keys.size());
+      uint64_t count_new = 0;
+      for (uint64_t i = 0; i < keys.size(); i++) {
+        auto it = std::lower_bound(prev_keys.begin(), prev_keys.end(), keys[i]);
+        if (it != prev_keys.end() && *it == keys[i]) {
+          ids[i] = prev_ids[it - prev_keys.begin()];
+          positions[i] = prev_positions[it - prev_keys.begin()];
+        } else {
+          ids[i] = -1;
+          count_new++;
+        }
+      }
+
+      if (count_vertices + static_cast<int64_t>(count_new) > static_cast<int64_t>(std::numeric_limits<int>::max())) {
+        SPDLOG_ERROR("Too many vertices for a tetrahedral mesh [{}]", count_vertices + count_new);
+        return false;
+      }
+
+      ParallelFor(0, keys.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+          if (ids[i] < 0) {
+            positions[i] = OutputVertexPosition(in_sdf, lattice, keys[i], value_of, snapped_slot_of);
+          }
+        }
+      }, 1024);
+
+      vertices.clear();
+      for (uint64_t i = 0; i < keys.size(); i++) {
+        if (ids[i] < 0) {
+          ids[i] = static_cast<int32_t>(count_vertices++);
+          vertices.push_back(positions[i]);
+        }
+      }
+
+      cells.resize(tets.size());
+      ParallelFor(0, tets.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+          std::array<uint64_t, 4> local;
+          for (int k = 0; k < 4; k++) {
+            local[k] = static_cast<uint64_t>(std::lower_bound(keys.begin(), keys.end(), tets[i][k]) - keys.begin());
+            cells[i][k] = ids[local[k]];
+          }
+
+          OrientCell(positions[local[0]], positions[local[1]], positions[local[2]], positions[local[3]], cells[i]);
+        }
+      }, 1024);
+
+      if (inout_writer.writeVertices(vertices) == false || inout_writer.writeCells(cells) == false) {
+        return false;
+      }
+      count_cells += cells.size();
+
+      std::swap(prev_keys, keys);
+      std::swap(prev_ids, ids);
+      std::swap(prev_positions, positions);
+    }
+
+    if (count_cells == 0) {
+      SPDLOG_ERROR("There are no lattice vertices inside the surface, the lattice spacing may be too large. [{}]", lattice_spacing);
+      return false;
+    }
+
+    SPDLOG_INFO("Streamed the stuffed isosurface with [{}] tetrahedra and [{}] vertices", count_cells, count_vertices);
+    return true;
+  }
+
+}
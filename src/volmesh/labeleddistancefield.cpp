@@ -0,0 +1,510 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/labeleddistancefield.h"
+#include "volmesh/logger.h"
+#include "volmesh/mathutils.h"
+#include "volmesh/parallel.h"
+#include "volmesh/windingnumber.h"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+
+using namespace volmesh;
+
+namespace {
+
+  /**
+   * @brief A face of one of the input meshes, copied once since the mesh accessors lock a mutex per call.
+   */
+  struct FaceRecord {
+    std::array<vec3, 3> vertices;
+    uint32_t label = 0;
+
+    /**
+     * @brief The face normal, the pseudo normals of the edges AB, BC, CA and of the vertices A, B, C.
+     */
+    std::array<vec3, 7> pseudo_normals;
+  };
+
+  /**
+   * @brief Returns the pseudo normal of the closest feature of a face.
+   */
+  const vec3& FeaturePseudoNormal(const FaceRecord& face, ClosestTriangleFeature feature) {
+    switch(feature) {
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeAB): return face.pseudo_normals[1];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeBC): return face.pseudo_normals[2];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeCA): return face.pseudo_normals[3];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexA): return face.pseudo_normals[4];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexB): return face.pseudo_normals[5];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexC): return face.pseudo_normals[6];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureNone):
+      case(ClosestTriangleFeature::kClosestTriangleFeatureInside):
+        break;
+    }
+
+    return face.pseudo_normals[0];
+  }
+
+  /**
+   * @brief Number of z layers per unit of parallel work.
+   */
+  static const int kSlabDepth = 4;
+
+}
+
+LabeledDistanceField::LabeledDistanceField() {
+
+}
+
+LabeledDistanceField::~LabeledDistanceField() {
+
+}
+
+bool LabeledDistanceField::generate(const std::vector<const TriangleMesh*>& in_meshes,
+                                    const vec3& expansion,
+                                    real_t voxel_size,
+                                    bool keep_object_fields,
+                                    SignedDistanceField::SignMode sign_mode) {
+  if (in_meshes.empty()) {
+    SPDLOG_ERROR("No meshes were supplied.");
+    return false;
+  }
+
+  if (voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  if (sign_mode == SignedDistanceField::kSignModeScanlineParity) {
+    SPDLOG_ERROR("The scanline parity sign mode is not supported for labeled distance fields.");
+    return false;
+  }
+
+  const bool use_pseudo_normals = (sign_mode == SignedDistanceField::kSignModePseudoNormals);
+  for (size_t i = 0; i < in_meshes.size(); i++) {
+    if (in_meshes[i] == nullptr || in_meshes[i]->countFaces() == 0) {
+      SPDLOG_ERROR("The mesh with label [{}] does not have any faces.", i);
+      return false;
+    }
+
+    if (use_pseudo_normals &&
+        (in_meshes[i]->hasVertexPseudoNormals() == false ||
+         in_meshes[i]->hasHalfEdgePseudoNormals() == false)) {
+      SPDLOG_ERROR("The pseudo normals of the mesh with label [{}] must be computed before generating the field", i);
+      return false;
+    }
+  }
+
+  // the grid covers the union of all meshes
+  AABB bounds = in_meshes[0]->bounds();
+  for (const TriangleMesh* mesh : in_meshes) {
+    const AABB mesh_bounds = mesh->bounds();
+    bounds = AABB(bounds.lower().cwiseMin(mesh_bounds.lower()), bounds.upper().cwiseMax(mesh_bounds.upper()));
+  }
+  bounds.expand(expansion);
+
+  bounds_ = bounds;
+  voxel_size_ = voxel_size;
+  count_objects_ = static_cast<uint32_t>(in_meshes.size());
+
+  const vec3 extent = bounds_.extent();
+  gridpoints_count_ = vec3i(ComputeVoxelsCount(extent.x(), voxel_size_) + 1,
+                            ComputeVoxelsCount(extent.y(), voxel_size_) + 1,
+                            ComputeVoxelsCount(extent.z(), voxel_size_) + 1);
+
+  const int nx = gridpoints_count_.x();
+  const int ny = gridpoints_count_.y();
+  const int nz = gridpoints_count_.z();
+  const vec3 lower = bounds_.lower();
+  // same band as the signed distance field, the bounding box of a face grown by one voxel per side
+  const real_t band_width = voxel_size_;
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  // grid points [out_start, out_stop) within the given box expanded by the band width
+  auto compute_band = [&](const AABB& box, vec3i& out_start, vec3i& out_stop) {
+    const vec3 lower_local = (box.lower() - vec3(band_width, band_width, band_width) - lower) / voxel_size_;
+    const vec3 upper_local = (box.upper() + vec3(band_width, band_width, band_width) - lower) / voxel_size_;
+    for (int axis = 0; axis < 3; axis++) {
+      out_start[axis] = std::max(0, static_cast<int>(std::floor(lower_local[axis])));
+      out_stop[axis] = std::min(gridpoints_count_[axis], static_cast<int>(std::floor(upper_local[axis])) + 1);
+    }
+  };
+
+  // copy the faces of all meshes
+  uint64_t count_faces = 0;
+  for (const TriangleMesh* mesh : in_meshes) {
+    count_faces += mesh->countFaces();
+  }
+
+  std::vector<FaceRecord> faces(count_faces);
+  {
+    uint64_t iface = 0;
+    for (uint32_t label = 0; label < count_objects_; label++) {
+      const TriangleMesh& mesh = *in_meshes[label];
+      for (uint32_t i = 0; i < mesh.countFaces(); i++, iface++) {
+        const HalfFaceIndex hface_id = HalfFaceIndex::create(i);
+        FaceRecord& face = faces[iface];
+        face.vertices = mesh.halfFaceVertices(hface_id);
+        face.label = label;
+
+        if (use_pseudo_normals) {
+          const TriangleMesh::HalfFaceType hface = mesh.halfFace(hface_id);
+          face.pseudo_normals[0] = mesh.halfFaceNormal(hface_id);
+          for (uint32_t e = 0; e < 3; e++) {
+            face.pseudo_normals[1 + e] = mesh.halfEdgePseudoNormal(hface.halfEdgeIndex(e));
+            face.pseudo_normals[4 + e] = mesh.vertexPseudoNormal(VertexIndex::create(mesh.halfEdge(hface.halfEdgeIndex(e)).start()));
+          }
+        }
+      }
+    }
+  }
+
+  // bin the faces by the slabs overlapped by their bands
+  const int count_slabs = (nz + kSlabDepth - 1) / kSlabDepth;
+  std::vector<vec3i> face_starts(count_faces);
+  std::vector<vec3i> face_stops(count_faces);
+  std::vector<uint64_t> slab_offsets(count_slabs + 1, 0);
+  for (uint64_t iface = 0; iface < count_faces; iface++) {
+    compute_band(ComputeTriangleAABB(faces[iface].vertices), face_starts[iface], face_stops[iface]);
+    if (face_stops[iface].z() <= face_starts[iface].z()) {
+      continue;
+    }
+
+    for (int s = face_starts[iface].z() / kSlabDepth; s <= (face_stops[iface].z() - 1) / kSlabDepth; s++) {
+      slab_offsets[s + 1]++;
+    }
+  }
+
+  for (int s = 0; s < count_slabs; s++) {
+    slab_offsets[s + 1] += slab_offsets[s];
+  }
+
+  std::vector<uint64_t> slab_faces(slab_offsets[count_slabs]);
+  {
+    std::vector<uint64_t> cursor(slab_offsets.begin(), slab_offsets.end() - 1);
+    for (uint64_t iface = 0; iface < count_faces; iface++) {
+      if (face_stops[iface].z() <= face_starts[iface].z()) {
+        continue;
+      }
+
+      for (int s = face_starts[iface].z() / kSlabDepth; s <= (face_stops[iface].z() - 1) / kSlabDepth; s++) {
+        slab_faces[cursor[s]++] = iface;
+      }
+    }
+  }
+
+  const real_t kMaxValue = std::numeric_limits<real_t>::max();
+
+  // the magnitudes are computed first, the signs are applied at the end
+  ParallelAssign(field_values_, totalGridPointsCount(), kMaxValue);
+  ParallelAssign(labels_, totalGridPointsCount(), kNoLabel);
+  GridVector<real_t> signs;
+  ParallelAssign(signs, totalGridPointsCount(), static_cast<real_t>(0.0));
+
+  object_bands_.clear();
+  std::vector<std::vector<real_t>> object_signs;
+  if (keep_object_fields) {
+    object_bands_.resize(count_objects_);
+    object_signs.resize(count_objects_);
+    for (uint32_t label = 0; label < count_objects_; label++) {
+      ObjectBand& band = object_bands_[label];
+      vec3i stop;
+      compute_band(in_meshes[label]->bounds(), band.start, stop);
+      band.count = (stop - band.start).cwiseMax(vec3i(0, 0, 0));
+
+      const uint64_t band_size = static_cast<uint64_t>(band.count.x()) * band.count.y() * band.count.z();
+      band.values.assign(band_size, kMaxValue);
+      object_signs[label].assign(band_size, 0.0);
+    }
+  }
+
+  ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t s = chunk_begin; s < chunk_end; s++) {
+      const int z_begin = static_cast<int>(s) * kSlabDepth;
+      const int z_end = std::min(nz, z_begin + kSlabDepth);
+
+      for (uint64_t t = slab_offsets[s]; t < slab_offsets[s + 1]; t++) {
+        const uint64_t iface = slab_faces[t];
+        const FaceRecord& face = faces[iface];
+        const vec3i& start = face_starts[iface];
+        const vec3i& stop = face_stops[iface];
+
+        ObjectBand* band = keep_object_fields ? &object_bands_[face.label] : nullptr;
+        real_t* band_signs = keep_object_fields ? object_signs[face.label].data() : nullptr;
+
+        for (int z = std::max(z_begin, start.z()); z < std::min(z_end, stop.z()); z++) {
+          for (int y = start.y(); y < stop.y(); y++) {
+            for (int x = start.x(); x < stop.x(); x++) {
+              const vec3 p = lower + vec3(static_cast<real_t>(x) * voxel_size_,
+                                          static_cast<real_t>(y) * voxel_size_,
+                                          static_cast<real_t>(z) * voxel_size_);
+
+              vec3 q(0.0, 0.0, 0.0);
+              ClosestTriangleFeature closest_feature;
+              const real_t dist = PointTriangleDistance(p, face.vertices[0], face.vertices[1], face.vertices[2],
+                                                        q, closest_feature);
+
+              auto sign_term = [&]() {
+                return use_pseudo_normals ? (p - q).dot(FeaturePseudoNormal(face, closest_feature)) : 0.0;
+              };
+
+              // the nearest object over all meshes
+              const uint64_t id = (static_cast<uint64_t>(z) * ny + y) * nx + x;
+              if (dist < field_values_[id]) {
+                field_values_[id] = dist;
+                labels_[id] = face.label;
+                signs[id] = sign_term();
+              } else if (use_pseudo_normals && labels_[id] == face.label && FuzzyCompare(dist, field_values_[id])) {
+                signs[id] += sign_term();
+              }
+
+              // the object on its own
+              if (band != nullptr) {
+                const uint64_t band_id = (static_cast<uint64_t>(z - band->start.z()) * band->count.y() +
+                                          (y - band->start.y())) * band->count.x() + (x - band->start.x());
+                if (dist < band->values[band_id]) {
+                  band->values[band_id] = dist;
+                  band_signs[band_id] = sign_term();
+                } else if (use_pseudo_normals && FuzzyCompare(dist, band->values[band_id])) {
+                  band_signs[band_id] += sign_term();
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  });
+
+  if (sign_mode == SignedDistanceField::kSignModeWindingNumber) {
+    std::vector<std::unique_ptr<WindingNumberTree>> trees(count_objects_);
+    for (uint32_t label = 0; label < count_objects_; label++) {
+      trees[label] = std::make_unique<WindingNumberTree>();
+      if (trees[label]->build(*in_meshes[label]) == false) {
+        return false;
+      }
+    }
+
+    // the winding number of the nearest object only
+    ParallelFor(0, nz, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+        for (int y = 0; y < ny; y++) {
+          for (int x = 0; x < nx; x++) {
+            const uint64_t id = (z * ny + y) * nx + x;
+            if (labels_[id] == kNoLabel) {
+              continue;
+            }
+
+            const vec3 p = gridPointPosition(vec3i(x, y, static_cast<int>(z)));
+            signs[id] = static_cast<real_t>(0.5) - trees[labels_[id]]->windingNumber(p);
+          }
+        }
+      }
+    });
+
+    for (uint32_t label = 0; label < static_cast<uint32_t>(object_bands_.size()); label++) {
+      const ObjectBand& band = object_bands_[label];
+      ParallelFor(0, band.count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+          for (int y = 0; y < band.count.y(); y++) {
+            for (int x = 0; x < band.count.x(); x++) {
+              const uint64_t band_id = (z * band.count.y() + y) * band.count.x() + x;
+              if (band.values[band_id] == kMaxValue) {
+                continue;
+              }
+
+              const vec3 p = gridPointPosition(band.start + vec3i(x, y, static_cast<int>(z)));
+              object_signs[label][band_id] = static_cast<real_t>(0.5) - trees[label]->windingNumber(p);
+            }
+          }
+        }
+      });
+    }
+  }
+
+  // apply the signs to the magnitudes
+  for (uint64_t i = 0; i < field_values_.size(); i++) {
+    if (signs[i] < 0) {
+      field_values_[i] = -field_values_[i];
+    }
+  }
+
+  for (uint32_t label = 0; label < static_cast<uint32_t>(object_bands_.size()); label++) {
+    std::vector<real_t>& values = object_bands_[label].values;
+    for (uint64_t i = 0; i < values.size(); i++) {
+      if (object_signs[label][i] < 0) {
+        values[i] = -values[i];
+      }
+    }
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating the labeled distance field of [{}] objects = [{}.{:03}] seconds.",
+              count_objects_,
+              duration_milliseconds.count() / 1000,
+              duration_milliseconds.count() % 1000);
+
+  return true;
+}
+
+AABB LabeledDistanceField::bounds() const {
+  return bounds_;
+}
+
+real_t LabeledDistanceField::voxelSize() const {
+  return voxel_size_;
+}
+
+vec3i LabeledDistanceField::gridPointsCount() const {
+  return gridpoints_count_;
+}
+
+uint64_t LabeledDistanceField::totalGridPointsCount() const {
+  return static_cast<uint64_t>(gridpoints_count_.x()) *
+         static_cast<uint64_t>(gridpoints_count_.y()) *
+         static_cast<uint64_t>(gridpoints_count_.z());
+}
+
+uint64_t LabeledDistanceField::getTotalMemoryUsageInBytes() const {
+  uint64_t total = sizeof(voxel_size_) + sizeof(bounds_) +
+                   field_values_.size() * sizeof(real_t) + labels_.size() * sizeof(uint32_t);
+  for (const ObjectBand& band : object_bands_) {
+    total += band.values.size() * sizeof(real_t);
+  }
+
+  return total;
+}
+
+uint32_t LabeledDistanceField::countObjects() const {
+  return count_objects_;
+}
+
+vec3 LabeledDistanceField::gridPointPosition(const vec3i& coords) const {
+  assertGridPointCoords(coords);
+
+  return bounds_.lower() + vec3(static_cast<real_t>(coords.x()) * voxel_size_,
+                                static_cast<real_t>(coords.y()) * voxel_size_,
+                                static_cast<real_t>(coords.z()) * voxel_size_);
+}
+
+uint32_t LabeledDistanceField::label(const vec3i& coords) const {
+  return labels_[gridPointId(coords)];
+}
+
+real_t LabeledDistanceField::fieldValue(const vec3i& coords) const {
+  return field_values_[gridPointId(coords)];
+}
+
+bool LabeledDistanceField::hasObjectFields() const {
+  return object_bands_.empty() == false;
+}
+
+bool LabeledDistanceField::isInObjectBand(uint32_t in_label, const vec3i& coords) const {
+  if (in_label >= object_bands_.size()) {
+    return false;
+  }
+
+  const ObjectBand& band = object_bands_[in_label];
+  const vec3i local = coords - band.start;
+  return (local.array() >= 0).all() && (local.array() < band.count.array()).all();
+}
+
+real_t LabeledDistanceField::objectFieldValue(uint32_t in_label, const vec3i& coords) const {
+  assertGridPointCoords(coords);
+
+  if (isInObjectBand(in_label, coords) == false) {
+    return std::numeric_limits<real_t>::max();
+  }
+
+  const ObjectBand& band = object_bands_[in_label];
+  const vec3i local = coords - band.start;
+  return band.values[(static_cast<uint64_t>(local.z()) * band.count.y() + local.y()) * band.count.x() + local.x()];
+}
+
+bool LabeledDistanceField::saveAsVTI(const std::string& filepath) const {
+  if (field_values_.empty()) {
+    SPDLOG_ERROR("This instance is empty. Initialize before saving to disk");
+    return false;
+  }
+
+  if (std::filesystem::exists(filepath)) {
+    SPDLOG_WARN("Another file with the same name exists under [{}] and will be overwritten.", filepath.c_str());
+  }
+
+  std::ofstream file(filepath);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", filepath.c_str());
+    return false;
+  }
+
+  const int nx = gridpoints_count_.x();
+  const std::string extent = fmt::format("0 {} 0 {} 0 {}",
+                                         gridpoints_count_.x() - 1,
+                                         gridpoints_count_.y() - 1,
+                                         gridpoints_count_.z() - 1);
+
+  file << "<?xml version=\"1.0\"?>\n";
+  file << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+  file << "  <ImageData WholeExtent=\"" << extent \
+        << "\" Origin=\"" << bounds_.lower().x() << " " << bounds_.lower().y() << " " << bounds_.lower().z() \
+        << "\" Spacing=\"" << voxel_size_ << " " << voxel_size_ << " " << voxel_size_ << "\">\n";
+  file << "    <Piece Extent=\"" << extent << "\">\n";
+  file << "      <PointData Scalars=\"SignedDistanceField\">\n";
+
+  file << "        <DataArray type=\"Float32\" Name=\"SignedDistanceField\" format=\"ascii\">\n";
+  for (uint64_t i = 0; i < field_values_.size(); i++) {
+    file << static_cast<float>(field_values_[i]) << (((i + 1) % nx == 0) ? "\n" : " ");
+  }
+  file << "        </DataArray>\n";
+
+  file << "        <DataArray type=\"UInt32\" Name=\"Label\" format=\"ascii\">\n";
+  for (uint64_t i = 0; i < labels_.size(); i++) {
+    file << labels_[i] << (((i + 1) % nx == 0) ? "\n" : " ");
+  }
+  file << "        </DataArray>\n";
+
+  file << "      </PointData>\n";
+  file << "      <CellData>\n";
+  file << "      </CellData>\n";
+  file << "    </Piece>\n";
+  file << "  </ImageData>\n";
+  file << "</VTKFile>\n";
+
+  file.close();
+
+  return true;
+}
+
+uint64_t LabeledDistanceField::gridPointId(const vec3i& coords) const {
+  assertGridPointCoords(coords);
+
+  return (static_cast<uint64_t>(coords.z()) * gridpoints_count_.y() + coords.y()) * gridpoints_count_.x() + coords.x();
+}
+
+void LabeledDistanceField::assertGridPointCoords(const vec3i& coords) const {
+  if (coords.x() < 0 || coords.x() >= gridpoints_count_.x() ||
+      coords.y() < 0 || coords.y() >= gridpoints_count_.y() ||
+      coords.z() < 0 || coords.z() >= gridpoints_count_.z()) {
+    std::string message = fmt::format("The supplied grid point id [{}, {}, {}] is out of range, \
+                                       Correct values must be in range x = [{}, {}], y = [{}, {}], z = [{}, {}].",
+                                       coords.x(), coords.y(), coords.z(),
+                                       0, gridpoints_count_.x() - 1,
+                                       0, gridpoints_count_.y() - 1,
+                                       0, gridpoints_count_.z() - 1);
+    throw std::out_of_range(message);
+  }
+}
@@ -0,0 +1,154 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/marchingcubes.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+using namespace volmesh;
+
+namespace {
+
+  typedef std::array<int8_t, 3 * MarchingCubes::kMaxTrianglesPerCube + 1> TriangleEdges;
+
+  static const int kCornerOffsets[MarchingCubes::kCountCorners][3] = {
+    {0, 0, 0}, {1, 0, 0}, {1, 1, 0}, {0, 1, 0},
+    {0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}
+  };
+
+  static const int kEdgeCorners[MarchingCubes::kCountEdges][2] = {
+    {0, 1}, {1, 2}, {3, 2}, {0, 3},
+    {4, 5}, {5, 6}, {7, 6}, {4, 7},
+    {0, 4}, {1, 5}, {2, 6}, {3, 7}
+  };
+
+  static const int kEdgeAxes[MarchingCubes::kCountEdges] = {
+    0, 1, 0, 1,
+    0, 1, 0, 1,
+    2, 2, 2, 2
+  };
+
+  /**
+   * @brief The corners of each cube face, counter clockwise when seen from outside the cube.
+   */
+  static const int kFaceCorners[6][4] = {
+    {0, 3, 2, 1}, {4, 5, 6, 7},
+    {0, 1, 5, 4}, {3, 7, 6, 2},
+    {0, 4, 7, 3}, {1, 2, 6, 5}
+  };
+
+  struct Tables {
+    std::array<uint16_t, 256> edge_masks;
+    std::array<TriangleEdges, 256> triangle_edges;
+  };
+
+  int EdgeBetween(int corner_a, int corner_b) {
+    for (int e = 0; e < MarchingCubes::kCountEdges; e++) {
+      if ((kEdgeCorners[e][0] == corner_a && kEdgeCorners[e][1] == corner_b) ||
+          (kEdgeCorners[e][0] == corner_b && kEdgeCorners[e][1] == corner_a)) {
+        return e;
+      }
+    }
+
+    return -1;
+  }
+
+  Tables BuildTables() {
+    Tables tables;
+
+    for (int cube_index = 0; cube_index < 256; cube_index++) {
+      auto is_inside = [cube_index](int corner) { return (cube_index & (1 << corner)) != 0; };
+
+      uint16_t edge_mask = 0;
+      for (int e = 0; e < MarchingCubes::kCountEdges; e++) {
+        if (is_inside(kEdgeCorners[e][0]) != is_inside(kEdgeCorners[e][1])) {
+          edge_mask |= static_cast<uint16_t>(1 << e);
+        }
+      }
+
+      // every run of inside corners along a face boundary is cut off by one contour segment, which
+      // goes from the crossing where the run is left to the crossing where it is entered
+      int next_edge[MarchingCubes::kCountEdges];
+      std::fill(next_edge, next_edge + MarchingCubes::kCountEdges, -1);
+      for (int f = 0; f < 6; f++) {
+        const int* corners = kFaceCorners[f];
+        for (int i = 0; i < 4; i++) {
+          const int prev = corners[(i + 3) % 4];
+          if (is_inside(prev) || !is_inside(corners[i])) {
+            continue;
+          }
+
+          int j = i;
+          while (is_inside(corners[(j + 1) % 4])) {
+            j = (j + 1) % 4;
+          }
+
+          const int enter_edge = EdgeBetween(prev, corners[i]);
+          const int exit_edge = EdgeBetween(corners[j], corners[(j + 1) % 4]);
+          next_edge[exit_edge] = enter_edge;
+        }
+      }
+
+      // link the segments into closed loops and fan them, reversed so the normals face outside
+      TriangleEdges& triangle_edges = tables.triangle_edges[cube_index];
+      triangle_edges.fill(-1);
+      int count = 0;
+      bool visited[MarchingCubes::kCountEdges] = {false};
+      for (int e = 0; e < MarchingCubes::kCountEdges; e++) {
+        if (next_edge[e] < 0 || visited[e]) {
+          continue;
+        }
+
+        std::vector<int> loop;
+        for (int k = e; visited[k] == false; k = next_edge[k]) {
+          visited[k] = true;
+          loop.push_back(k);
+        }
+
+        for (size_t k = 1; k + 1 < loop.size(); k++) {
+          assert(count + 3 < static_cast<int>(triangle_edges.size()));
+          triangle_edges[count++] = static_cast<int8_t>(loop[0]);
+          triangle_edges[count++] = static_cast<int8_t>(loop[k + 1]);
+          triangle_edges[count++] = static_cast<int8_t>(loop[k]);
+        }
+      }
+
+      tables.edge_masks[cube_index] = edge_mask;
+    }
+
+    return tables;
+  }
+
+  const Tables& GetTables() {
+    static const Tables tables = BuildTables();
+    return tables;
+  }
+
+}
+
+vec3i MarchingCubes::cornerOffset(int corner) {
+  return vec3i(kCornerOffsets[corner][0], kCornerOffsets[corner][1], kCornerOffsets[corner][2]);
+}
+
+vec2i MarchingCubes::edgeCornerIds(int edge) {
+  return vec2i(kEdgeCorners[edge][0], kEdgeCorners[edge][1]);
+}
+
+int MarchingCubes::edgeAxis(int edge) {
+  return kEdgeAxes[edge];
+}
+
+uint16_t MarchingCubes::edgeMask(int cube_index) {
+  return GetTables().edge_masks[cube_index];
+}
+
+const std::array<int8_t, 3 * MarchingCubes::kMaxTrianglesPerCube + 1>& MarchingCubes::triangleEdges(int cube_index) {
+  return GetTables().triangle_edges[cube_index];
+}
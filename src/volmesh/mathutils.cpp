@@ -144,7 +144,7 @@ namespace volmesh {
     // pprime is inside the triangle if all barycentric coords are between 0 and 1 exclusive
     if ((u > 0 && u < 1)&&(v > 0 && v < 1)&&(w > 0 && w < 1)) {
       q = pprime;
-      shortest_distance = pprime_distance;
+      shortest_distance = std::fabs(pprime_distance);
       closest_feature = ClosestTriangleFeature::kClosestTriangleFeatureInside;
     } else {
       int count_zero_coords = FuzzyIsNull(u) + FuzzyIsNull(v) + FuzzyIsNull(w);
@@ -209,6 +209,27 @@ namespace volmesh {
     return shortest_distance;
   }
 
+  real_t TriangleSolidAngle(const vec3& p,
+                            const vec3& a,
+                            const vec3& b,
+                            const vec3& c) {
+    const vec3 pa = a - p;
+    const vec3 pb = b - p;
+    const vec3 pc = c - p;
+
+    const real_t la = pa.norm();
+    const real_t lb = pb.norm();
+    const real_t lc = pc.norm();
+
+    const real_t numerator = pa.dot(pb.cross(pc));
+    const real_t denominator = la * lb * lc +
+                               pa.dot(pb) * lc +
+                               pb.dot(pc) * la +
+                               pc.dot(pa) * lb;
+
+    return static_cast<real_t>(2.0) * std::atan2(numerator, denominator);
+  }
+
   AABB ComputeTriangleAABB(const std::array<vec3, 3>& vertices) {
 
     real_t lx = std::min<real_t>(vertices[0].x(), std::min<real_t>(vertices[1].x(), vertices[2].x()));
@@ -222,4 +243,16 @@ namespace volmesh {
     return AABB(vec3(lx, ly, lz), vec3(ux, uy, uz));
   }
 
-}
\ No newline at end of file
+  int ComputeVoxelsCount(real_t extent, real_t voxel_size) {
+    static const real_t kSnapTolerance = 1e-6;
+
+    const real_t count = extent / voxel_size;
+    const real_t nearest = std::round(count);
+    if (std::fabs(count - nearest) <= kSnapTolerance) {
+      return static_cast<int>(nearest);
+    }
+
+    return static_cast<int>(std::ceil(count));
+  }
+
+}
@@ -0,0 +1,346 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/occupancygrid.h"
+#include "volmesh/logger.h"
+#include "volmesh/mathutils.h"
+#include "volmesh/parallel.h"
+#include "volmesh/predicates.h"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+using namespace volmesh;
+
+namespace {
+
+  /**
+   * @brief Orientation of p relative to the directed edge a->b in the yz plane.
+   *
+   * The edge is always evaluated from its lexicographically smaller end point, so two triangles
+   * sharing an edge get bitwise identical values with opposite signs.
+   */
+  real_t EdgeFunctionYZ(const vec3& a, const vec3& b, real_t py, real_t pz) {
+    const bool swapped = (b.y() < a.y()) || (b.y() == a.y() && b.z() < a.z());
+    const vec3& s = swapped ? b : a;
+    const vec3& e = swapped ? a : b;
+    const real_t value = (e.y() - s.y()) * (pz - s.z()) - (e.z() - s.z()) * (py - s.y());
+    return swapped ? -value : value;
+  }
+
+  /**
+   * @brief Top-left rule for a counter-clockwise edge with direction (du, dv) in the yz plane.
+   */
+  bool IsTopLeftEdge(real_t du, real_t dv) {
+    return (dv > 0.0) || (dv == 0.0 && du < 0.0);
+  }
+
+  /**
+   * @brief Projects a point on the yz plane.
+   */
+  vec2 ProjectYZ(const vec3& v) {
+    return vec2(v.y(), v.z());
+  }
+
+  /**
+   * @brief Intersects the ray parallel to the x axis through (py, pz) with a triangle.
+   *
+   * The sides of the ray are decided by exact orientations, the edge functions only weigh the
+   * vertices for the crossing.
+   *
+   * @return True if the ray crosses the triangle, and the x coordinate of the crossing in out_x.
+   */
+  bool IntersectRayX(const vec3& v0, const vec3& v1, const vec3& v2,
+                     real_t py, real_t pz, real_t& out_x) {
+    const int area_sign = Orient2d(ProjectYZ(v0), ProjectYZ(v1), ProjectYZ(v2));
+    if (area_sign == 0) {
+      // the triangle is parallel to the ray
+      return false;
+    }
+
+    const real_t s = static_cast<real_t>(area_sign);
+    const vec3* v[3] = {&v0, &v1, &v2};
+    const vec2 p(py, pz);
+
+    real_t e[3];
+    for (int i = 0; i < 3; i++) {
+      const vec3& a = *v[i];
+      const vec3& b = *v[(i + 1) % 3];
+      const int side = area_sign * Orient2d(ProjectYZ(a), ProjectYZ(b), p);
+
+      if (side < 0) {
+        return false;
+      }
+
+      if (side == 0) {
+        // direction of the edge in counter-clockwise order
+        const real_t du = s * (b.y() - a.y());
+        const real_t dv = s * (b.z() - a.z());
+        if (IsTopLeftEdge(du, dv) == false) {
+          return false;
+        }
+      }
+
+      e[i] = std::max<real_t>(s * EdgeFunctionYZ(a, b, py, pz), 0.0);
+    }
+
+    // e[i] is the weight of the vertex opposite to edge i, a rounded sliver falls back to the centroid
+    const real_t sum = e[0] + e[1] + e[2];
+    out_x = (sum > 0.0) ? (e[0] * v2.x() + e[1] * v0.x() + e[2] * v1.x()) / sum : (v0.x() + v1.x() + v2.x()) / 3.0;
+    return true;
+  }
+
+}
+
+OccupancyGrid::OccupancyGrid() {
+
+}
+
+OccupancyGrid::~OccupancyGrid() {
+
+}
+
+bool OccupancyGrid::resize(const AABB& bounds, real_t voxel_size) {
+  if (voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  bounds_ = bounds;
+  voxel_size_ = voxel_size;
+
+  // same layout as the signed distance field
+  const vec3 extent = bounds_.extent();
+  gridpoints_count_ = vec3i(ComputeVoxelsCount(extent.x(), voxel_size_) + 1,
+                            ComputeVoxelsCount(extent.y(), voxel_size_) + 1,
+                            ComputeVoxelsCount(extent.z(), voxel_size_) + 1);
+
+  words_per_row_ = static_cast<uint32_t>((gridpoints_count_.x() + 63) / 64);
+
+  words_.assign(static_cast<uint64_t>(words_per_row_) *
+                static_cast<uint64_t>(gridpoints_count_.y()) *
+                static_cast<uint64_t>(gridpoints_count_.z()), 0);
+
+  return true;
+}
+
+bool OccupancyGrid::generate(const TriangleMesh& in_mesh,
+                             const vec3& expansion,
+                             real_t voxel_size) {
+  AABB bounds = in_mesh.bounds();
+  bounds.expand(expansion);
+  return generate(in_mesh, bounds, voxel_size);
+}
+
+bool OccupancyGrid::generate(const TriangleMesh& in_mesh,
+                             const AABB& bounds,
+                             real_t voxel_size) {
+  // copy the triangles once, the mesh accessors lock a mutex per call
+  const uint32_t count_faces = in_mesh.countFaces();
+  std::vector<vec3> triangle_vertices(count_faces * 3);
+  for (uint32_t i = 0; i < count_faces; i++) {
+    const auto v = in_mesh.halfFaceVertices(HalfFaceIndex::create(i));
+    triangle_vertices[i * 3 + 0] = v[0];
+    triangle_vertices[i * 3 + 1] = v[1];
+    triangle_vertices[i * 3 + 2] = v[2];
+  }
+
+  return generate(triangle_vertices, bounds, voxel_size);
+}
+
+bool OccupancyGrid::generate(const std::vector<vec3>& in_triangle_vertices,
+                             const AABB& bounds,
+                             real_t voxel_size) {
+  const uint32_t count_faces = static_cast<uint32_t>(in_triangle_vertices.size() / 3);
+  if (count_faces == 0) {
+    SPDLOG_ERROR("The supplied mesh does not have any faces.");
+    return false;
+  }
+
+  if (resize(bounds, voxel_size) == false) {
+    return false;
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  const vec3 lower = bounds_.lower();
+  const int nx = gridpoints_count_.x();
+  const int ny = gridpoints_count_.y();
+  const int nz = gridpoints_count_.z();
+
+  const std::vector<vec3>& triangle_vertices = in_triangle_vertices;
+  std::vector<vec2i> triangle_rows(count_faces);
+  std::vector<uint32_t> row_offsets(nz + 1, 0);
+
+  for (uint32_t i = 0; i < count_faces; i++) {
+    const std::array<vec3, 3> v = {triangle_vertices[i * 3 + 0],
+                                   triangle_vertices[i * 3 + 1],
+                                   triangle_vertices[i * 3 + 2]};
+
+    const AABB aabb = ComputeTriangleAABB(v);
+    // conservative by one row on each side, the exact test happens per ray
+    const int k0 = std::max(0, static_cast<int>(std::floor((aabb.lower().z() - lower.z()) / voxel_size_)));
+    const int k1 = std::min(nz - 1, static_cast<int>(std::floor((aabb.upper().z() - lower.z()) / voxel_size_)) + 1);
+    triangle_rows[i] = vec2i(k0, k1);
+
+    for (int k = k0; k <= k1; k++) {
+      row_offsets[k + 1]++;
+    }
+  }
+
+  // bin the triangles by the z rows they overlap
+  for (int k = 0; k < nz; k++) {
+    row_offsets[k + 1] += row_offsets[k];
+  }
+
+  std::vector<uint32_t> row_triangles(row_offsets[nz]);
+  {
+    std::vector<uint32_t> cursor(row_offsets.begin(), row_offsets.end() - 1);
+    for (uint32_t i = 0; i < count_faces; i++) {
+      for (int k = triangle_rows[i].x(); k <= triangle_rows[i].y(); k++) {
+        row_triangles[cursor[k]++] = i;
+      }
+    }
+  }
+
+  const uint64_t grain_size = std::max<uint64_t>(1, nz / (CountWorkerThreads() * 8));
+
+  ParallelFor(0, nz, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    std::vector<std::vector<real_t>> crossings(ny);
+
+    for (uint64_t k = chunk_begin; k < chunk_end; k++) {
+      const real_t pz = lower.z() + static_cast<real_t>(k) * voxel_size_;
+
+      for (auto& c : crossings) {
+        c.clear();
+      }
+
+      // collect the crossings of all rays in this z row
+      for (uint32_t t = row_offsets[k]; t < row_offsets[k + 1]; t++) {
+        const uint32_t tri = row_triangles[t];
+        const vec3& v0 = triangle_vertices[tri * 3 + 0];
+        const vec3& v1 = triangle_vertices[tri * 3 + 1];
+        const vec3& v2 = triangle_vertices[tri * 3 + 2];
+
+        const real_t ymin = std::min(v0.y(), std::min(v1.y(), v2.y()));
+        const real_t ymax = std::max(v0.y(), std::max(v1.y(), v2.y()));
+        const int j0 = std::max(0, static_cast<int>(std::floor((ymin - lower.y()) / voxel_size_)));
+        const int j1 = std::min(ny - 1, static_cast<int>(std::floor((ymax - lower.y()) / voxel_size_)) + 1);
+
+        for (int j = j0; j <= j1; j++) {
+          const real_t py = lower.y() + static_cast<real_t>(j) * voxel_size_;
+          real_t x = 0.0;
+          if (IntersectRayX(v0, v1, v2, py, pz, x)) {
+            crossings[j].push_back(x);
+          }
+        }
+      }
+
+      // fill by parity, a grid point is inside when an odd number of crossings precede it
+      for (int j = 0; j < ny; j++) {
+        auto& c = crossings[j];
+        if (c.size() < 2) {
+          continue;
+        }
+
+        std::sort(c.begin(), c.end());
+
+        uint64_t* row = rowWords(j, static_cast<int>(k));
+        for (size_t m = 0; m + 1 < c.size(); m += 2) {
+          const int i0 = std::max(0, static_cast<int>(std::floor((c[m] - lower.x()) / voxel_size_)) + 1);
+          const int i1 = std::min(nx - 1, static_cast<int>(std::floor((c[m + 1] - lower.x()) / voxel_size_)));
+
+          for (int i = i0; i <= i1; i++) {
+            row[i >> 6] |= (uint64_t(1) << (i & 63));
+          }
+        }
+      }
+    }
+  }, grain_size);
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_DEBUG("Voxelized [{}] triangles over [{} x {} x {}] grid points in [{}] ms",
+               count_faces, nx, ny, nz, duration_milliseconds.count());
+
+  return true;
+}
+
+AABB OccupancyGrid::bounds() const {
+  return bounds_;
+}
+
+real_t OccupancyGrid::voxelSize() const {
+  return voxel_size_;
+}
+
+vec3i OccupancyGrid::gridPointsCount() const {
+  return gridpoints_count_;
+}
+
+uint64_t OccupancyGrid::totalGridPointsCount() const {
+  return static_cast<uint64_t>(gridpoints_count_.x()) *
+         static_cast<uint64_t>(gridpoints_count_.y()) *
+         static_cast<uint64_t>(gridpoints_count_.z());
+}
+
+uint32_t OccupancyGrid::countWordsPerRow() const {
+  return words_per_row_;
+}
+
+uint64_t OccupancyGrid::getTotalMemoryUsageInBytes() const {
+  return sizeof(voxel_size_) + sizeof(bounds_) + words_.size() * sizeof(uint64_t);
+}
+
+bool OccupancyGrid::isOccupied(const vec3i& coords) const {
+  assertGridPointCoords(coords);
+  const uint64_t* row = rowWords(coords.y(), coords.z());
+  return (row[coords.x() >> 6] >> (coords.x() & 63)) & 1;
+}
+
+void OccupancyGrid::setOccupied(const vec3i& coords, bool occupied) {
+  assertGridPointCoords(coords);
+  uint64_t* row = rowWords(coords.y(), coords.z());
+  const uint64_t mask = uint64_t(1) << (coords.x() & 63);
+  if (occupied) {
+    row[coords.x() >> 6] |= mask;
+  } else {
+    row[coords.x() >> 6] &= ~mask;
+  }
+}
+
+uint64_t OccupancyGrid::countOccupied() const {
+  uint64_t count = 0;
+  for (const uint64_t w : words_) {
+    count += static_cast<uint64_t>(__builtin_popcountll(w));
+  }
+  return count;
+}
+
+const uint64_t* OccupancyGrid::rowWords(int y, int z) const {
+  return words_.data() + (static_cast<uint64_t>(z) * gridpoints_count_.y() + y) * words_per_row_;
+}
+
+uint64_t* OccupancyGrid::rowWords(int y, int z) {
+  return words_.data() + (static_cast<uint64_t>(z) * gridpoints_count_.y() + y) * words_per_row_;
+}
+
+void OccupancyGrid::assertGridPointCoords(const vec3i& coords) const {
+  if (coords.x() < 0 || coords.x() >= gridpoints_count_.x() ||
+      coords.y() < 0 || coords.y() >= gridpoints_count_.y() ||
+      coords.z() < 0 || coords.z() >= gridpoints_count_.z()) {
+    std::string message = fmt::format("The supplied grid point id [{}, {}, {}] is out of range, \
+                                       Correct values must be in range x = [{}, {}], y = [{}, {}], z = [{}, {}].",
+                                       coords.x(), coords.y(), coords.z(),
+                                       0, gridpoints_count_.x() - 1,
+                                       0, gridpoints_count_.y() - 1,
+                                       0, gridpoints_count_.z() - 1);
+    throw std::out_of_range(message);
+  }
+}
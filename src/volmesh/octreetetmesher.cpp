@@ -0,0 +1,604 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/octreetetmesher.h"
+#include "volmesh/gridallocator.h"
+#include "volmesh/logger.h"
+#include "volmesh/parallel.h"
+#include "volmesh/voxel.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace volmesh {
+
+  namespace {
+
+    typedef std::array<uint64_t, 4> TetKeys;
+
+    /**
+     * @brief Number of leaves meshed per task, the blocks keep the output independent of the threads.
+     */
+    static const uint64_t kLeavesPerBlock = 256;
+
+    /**
+     * @brief An octree over the voxels of a field, stored as the level of the leaf holding every voxel.
+     *
+     * A cell of level l has an edge length of 2^l voxels and its origin is a multiple of 2^l, so the
+     * leaf of a voxel is found from the voxel alone. Cells that would reach past the voxels are split.
+     */
+    struct Octree {
+      vec3i voxels_count;
+      int root_level = 0;
+      GridVector<uint8_t> leaf_levels;
+
+      /**
+       * @brief Per level, whether a cell contains a voxel crossed by the surface.
+       */
+      std::vector<GridVector<uint8_t>> crossed;
+      std::vector<vec3i> cells_count;
+
+      bool containsVoxel(const vec3i& v) const {
+        return (v.array() >= 0).all() && (v.array() < voxels_count.array()).all();
+      }
+
+      uint64_t voxelId(const vec3i& v) const {
+        return (static_cast<uint64_t>(v.z()) * voxels_count.y() + v.y()) * voxels_count.x() + v.x();
+      }
+
+      int leafLevel(const vec3i& v) const {
+        return leaf_levels[voxelId(v)];
+      }
+
+      bool isCrossed(const vec3i& origin, int level) const {
+        const vec3i c(origin.x() >> level, origin.y() >> level, origin.z() >> level);
+        const vec3i& count = cells_count[level];
+        return crossed[level][(static_cast<uint64_t>(c.z()) * count.y() + c.y()) * count.x() + c.x()] != 0;
+      }
+
+      static vec3i cellOrigin(const vec3i& v, int level) {
+        return vec3i((v.x() >> level) << level, (v.y() >> level) << level, (v.z() >> level) << level);
+      }
+
+      void setLeaf(const vec3i& origin, int level) {
+        const int size = 1 << level;
+        for (int z = origin.z(); z < origin.z() + size; z++) {
+          for (int y = origin.y(); y < origin.y() + size; y++) {
+            const uint64_t row = voxelId(vec3i(origin.x(), y, z));
+            std::fill(leaf_levels.begin() + row, leaf_levels.begin() + row + size, static_cast<uint8_t>(level));
+          }
+        }
+      }
+
+      /**
+       * @brief Checks whether a grid point is the corner of a leaf, i.e. a vertex of the octree.
+       */
+      bool isVertex(const vec3i& p) const {
+        for (int c = 0; c < 8; c++) {
+          const vec3i v = p - vec3i(c & 1, (c >> 1) & 1, (c >> 2) & 1);
+          if (containsVoxel(v) == false) {
+            continue;
+          }
+
+          const int level = leafLevel(v);
+          const vec3i origin = cellOrigin(v, level);
+          const int size = 1 << level;
+          bool is_corner = true;
+          for (int axis = 0; axis < 3; axis++) {
+            is_corner &= (p[axis] == origin[axis] || p[axis] == origin[axis] + size);
+          }
+
+          if (is_corner) {
+            return true;
+          }
+        }
+
+        return false;
+      }
+    };
+
+    /**
+     * @brief Marks the voxels with corners on both sides of the surface and builds their pyramid.
+     */
+    void ClassifyCrossedCells(const std::vector<SignedDistanceField::SliceView>& slices, Octree& octree) {
+      const vec3i& voxels_count = octree.voxels_count;
+      octree.crossed.resize(octree.root_level + 1);
+      octree.cells_count.resize(octree.root_level + 1);
+
+      octree.cells_count[0] = voxels_count;
+      GridVector<uint8_t>& voxels_crossed = octree.crossed[0];
+      voxels_crossed.resize(static_cast<uint64_t>(voxels_count.prod()));
+      ParallelFor(0, voxels_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        for (int z = static_cast<int>(chunk_begin); z < static_cast<int>(chunk_end); z++) {
+          for (int y = 0; y < voxels_count.y(); y++) {
+            for (int x = 0; x < voxels_count.x(); x++) {
+              int count_inside = 0;
+              for (int c = 0; c < 8; c++) {
+                count_inside += (slices[z + ((c >> 2) & 1)].at(x + (c & 1), y + ((c >> 1) & 1)) < 0.0) ? 1 : 0;
+              }
+
+              voxels_crossed[octree.voxelId(vec3i(x, y, z))] = (count_inside != 0 && count_inside != 8) ? 1 : 0;
+            }
+          }
+        }
+      });
+
+      for (int level = 1; level <= octree.root_level; level++) {
+        const vec3i& children_count = octree.cells_count[level - 1];
+        const vec3i count((children_count.x() + 1) / 2, (children_count.y() + 1) / 2, (children_count.z() + 1) / 2);
+        octree.cells_count[level] = count;
+
+        const GridVector<uint8_t>& children = octree.crossed[level - 1];
+        GridVector<uint8_t>& cells = octree.crossed[level];
+        cells.resize(static_cast<uint64_t>(count.prod()));
+        ParallelFor(0, count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+          for (int z = static_cast<int>(chunk_begin); z < static_cast<int>(chunk_end); z++) {
+            for (int y = 0; y < count.y(); y++) {
+              for (int x = 0; x < count.x(); x++) {
+                uint8_t is_crossed = 0;
+                for (int c = 0; c < 8; c++) {
+                  const vec3i child(2 * x + (c & 1), 2 * y + ((c >> 1) & 1), 2 * z + ((c >> 2) & 1));
+                  if ((child.array() < children_count.array()).all()) {
+                    is_crossed |= children[(static_cast<uint64_t>(child.z()) * children_count.y() + child.y()) * children_count.x() + child.x()];
+                  }
+                }
+
+                cells[(static_cast<uint64_t>(z) * count.y() + y) * count.x() + x] = is_crossed;
+              }
+            }
+          }
+        });
+      }
+    }
+
+    /**
+     * @brief Splits the cells top down and returns the leaves of every level.
+     */
+    std::vector<std::vector<vec3i>> RefineOctree(const SignedDistanceField& in_sdf,
+                                                 const OctreeSizeField& size_field,
+                                                 Octree& octree) {
+      const real_t voxel_size = in_sdf.voxelSize();
+      const vec3 lower = in_sdf.bounds().lower();
+      std::vector<std::vector<vec3i>> level_leaves(octree.root_level + 1);
+
+      std::vector<vec3i> cells = {vec3i(0, 0, 0)};
+      for (int level = octree.root_level; level >= 0 && cells.empty() == false; level--) {
+        const int size = 1 << level;
+        std::vector<uint8_t> is_split(cells.size(), 0);
+        ParallelFor(0, cells.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+          for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+            const vec3i& origin = cells[i];
+            if (level == 0) {
+              continue;
+            }
+
+            bool split = ((origin.array() + size) > octree.voxels_count.array()).any() || octree.isCrossed(origin, level);
+            if (split == false && size_field) {
+              const vec3 center = lower + (origin.cast<real_t>() + vec3::Constant(0.5 * size)) * voxel_size;
+              split = size_field(center) < size * voxel_size;
+            }
+
+            is_split[i] = split ? 1 : 0;
+          }
+        }, 64);
+
+        std::vector<vec3i> children;
+        for (uint64_t i = 0; i < cells.size(); i++) {
+          if (is_split[i] == 0) {
+            level_leaves[level].push_back(cells[i]);
+            continue;
+          }
+
+          for (int c = 0; c < 8; c++) {
+            const vec3i child = cells[i] + (size / 2) * vec3i(c & 1, (c >> 1) & 1, (c >> 2) & 1);
+            if ((child.array() < octree.voxels_count.array()).all()) {
+              children.push_back(child);
+            }
+          }
+        }
+
+        cells.swap(children);
+      }
+
+      for (int level = 0; level <= octree.root_level; level++) {
+        const std::vector<vec3i>& leaves = level_leaves[level];
+        ParallelFor(0, leaves.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+          for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+            octree.setLeaf(leaves[i], level);
+          }
+        }, 64);
+      }
+
+      return level_leaves;
+    }
+
+    /**
+     * @brief Splits leaves until leaves sharing a face, an edge or a corner differ by at most one level.
+     *
+     * The levels are visited from the finest up, so a split only creates leaves of levels that are
+     * still to be visited and the balance ripples outwards in a single pass.
+     */
+    void BalanceOctree(Octree& octree, std::vector<std::vector<vec3i>>& level_leaves) {
+      for (int level = 0; level < octree.root_level; level++) {
+        const int size = 1 << level;
+        for (uint64_t i = 0; i < level_leaves[level].size(); i++) {
+          const vec3i origin = level_leaves[level][i];
+          if (octree.leafLevel(origin) != level) {
+            continue;
+          }
+
+          for (int d = 0; d < 27; d++) {
+            const vec3i direction(d % 3 - 1, (d / 3) % 3 - 1, d / 9 - 1);
+            const vec3i neighbor = origin + size * direction;
+            if (d == 13 || octree.containsVoxel(neighbor) == false) {
+              continue;
+            }
+
+            for (int neighbor_level = octree.leafLevel(neighbor); neighbor_level > level + 1; neighbor_level--) {
+              const vec3i neighbor_origin = Octree::cellOrigin(neighbor, neighbor_level);
+              const int child_size = 1 << (neighbor_level - 1);
+              for (int c = 0; c < 8; c++) {
+                const vec3i child = neighbor_origin + child_size * vec3i(c & 1, (c >> 1) & 1, (c >> 2) & 1);
+                octree.setLeaf(child, neighbor_level - 1);
+                level_leaves[neighbor_level - 1].push_back(child);
+              }
+            }
+          }
+        }
+      }
+
+      // drop the leaves that were split
+      for (int level = 0; level <= octree.root_level; level++) {
+        std::vector<vec3i>& leaves = level_leaves[level];
+        leaves.erase(std::remove_if(leaves.begin(), leaves.end(), [&](const vec3i& origin) {
+          return octree.leafLevel(origin) != level;
+        }), leaves.end());
+      }
+    }
+
+    /**
+     * @enum FaceTemplate
+     * @brief The transition templates that triangulate the faces of the leaves.
+     */
+    enum FaceTemplate : int {
+      kFaceTemplatePlain = 0, /**< Split along the diagonal the faces of the voxel tetrahedra use. */
+      kFaceTemplateFiner = 1, /**< Split into the faces of the four finer leaves against it. */
+      kFaceTemplateFan = 2, /**< Fanned around its center, through the corners of finer leaves on its edges. */
+    };
+
+    /**
+     * @brief The corners and edge midpoints of a face in half steps, counter clockwise from its origin.
+     */
+    static const int kBoundarySteps[8][2] = {{0, 0}, {1, 0}, {2, 0}, {2, 1}, {2, 2}, {1, 2}, {0, 2}, {0, 1}};
+
+    /**
+     * @brief A point on a face of a leaf, in steps along the two axes spanning the face.
+     */
+    vec3i FacePoint(const vec3i& origin, int level, int axis, int side, int du, int dw, int step) {
+      vec3i p = origin;
+      p[axis] += side << level;
+      p[(axis + 1) % 3] += du * step;
+      p[(axis + 2) % 3] += dw * step;
+      return p;
+    }
+
+    /**
+     * @brief Selects the template of a face of a leaf and finds the vertices along its boundary.
+     *
+     * @param out_is_vertex For the corners and edge midpoints of the face, counter clockwise from its
+     * origin, whether they are vertices of the octree.
+     */
+    FaceTemplate ClassifyFace(const Octree& octree,
+                              const vec3i& origin,
+                              int level,
+                              int axis,
+                              int side,
+                              std::array<bool, 8>& out_is_vertex) {
+      out_is_vertex.fill(false);
+      for (int i = 0; i < 8; i += 2) {
+        out_is_vertex[i] = true;
+      }
+
+      if (level == 0) {
+        return kFaceTemplatePlain;
+      }
+
+      vec3i across = origin;
+      across[axis] = (side == 0) ? origin[axis] - 1 : origin[axis] + (1 << level);
+      if (octree.containsVoxel(across) && octree.leafLevel(across) < level) {
+        return kFaceTemplateFiner;
+      }
+
+      const int half = 1 << (level - 1);
+      bool has_edge_vertices = false;
+      for (int i = 1; i < 8; i += 2) {
+        out_is_vertex[i] = octree.isVertex(FacePoint(origin, level, axis, side, kBoundarySteps[i][0], kBoundarySteps[i][1], half));
+        has_edge_vertices |= out_is_vertex[i];
+      }
+
+      return has_edge_vertices ? kFaceTemplateFan : kFaceTemplatePlain;
+    }
+
+    /**
+     * @brief Splits a leaf into tetrahedra.
+     *
+     * A leaf whose faces are all plain is split like a voxel, otherwise the triangles of its faces are
+     * coned to its center. The points are in doubled grid coordinates so the centers of the voxels
+     * are integral.
+     */
+    void EmitLeafTetrahedra(const Octree& octree,
+                            const vec3i& origin,
+                            int level,
+                            const vec3i& keys_count,
+                            std::vector<TetKeys>& out_tets) {
+      auto key = [&keys_count](const vec3i& p) {
+        return (static_cast<uint64_t>(p.z()) * keys_count.y() + p.y()) * keys_count.x() + p.x();
+      };
+
+      // orient like TetMesh::insertVoxel, with a negative determinant
+      auto emit = [&](const vec3i& a, const vec3i& b, const vec3i& c, const vec3i& d) {
+        const vec3i pb = b - a;
+        const vec3i pc = c - a;
+        const vec3i pd = d - a;
+        const int64_t det = static_cast<int64_t>(pb.x()) * (static_cast<int64_t>(pc.y()) * pd.z() - static_cast<int64_t>(pc.z()) * pd.y()) -
+                            static_cast<int64_t>(pb.y()) * (static_cast<int64_t>(pc.x()) * pd.z() - static_cast<int64_t>(pc.z()) * pd.x()) +
+                            static_cast<int64_t>(pb.z()) * (static_cast<int64_t>(pc.x()) * pd.y() - static_cast<int64_t>(pc.y()) * pd.x());
+        if (det < 0) {
+          out_tets.push_back({key(a), key(b), key(c), key(d)});
+        } else {
+          out_tets.push_back({key(a), key(b), key(d), key(c)});
+        }
+      };
+
+      std::array<FaceTemplate, 6> templates;
+      std::array<std::array<bool, 8>, 6> is_vertex;
+      bool is_plain = true;
+      for (int f = 0; f < 6; f++) {
+        templates[f] = ClassifyFace(octree, origin, level, f / 2, f % 2, is_vertex[f]);
+        is_plain &= (templates[f] == kFaceTemplatePlain);
+      }
+
+      const int size = 1 << level;
+      if (is_plain) {
+        for (int t = 0; t < Voxel::kNumFittingTetrahedra; t++) {
+          const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+          emit(2 * (origin + size * Voxel::vertexOffsetLut(tet_lut[0])),
+               2 * (origin + size * Voxel::vertexOffsetLut(tet_lut[1])),
+               2 * (origin + size * Voxel::vertexOffsetLut(tet_lut[2])),
+               2 * (origin + size * Voxel::vertexOffsetLut(tet_lut[3])));
+        }
+        return;
+      }
+
+      const vec3i center = 2 * origin + vec3i::Constant(size);
+      for (int f = 0; f < 6; f++) {
+        const int axis = f / 2;
+        const int side = f % 2;
+        auto point = [&](int du, int dw, int step) {
+          return vec3i(2 * FacePoint(origin, level, axis, side, du, dw, step));
+        };
+
+        // the diagonal from (1, 0) to (0, 1) matches Voxel::fittingTetrahedraVertexIdsLut
+        auto emit_square = [&](int du, int dw, int step) {
+          emit(center, point(du + 1, dw, step), point(du, dw + 1, step), point(du, dw, step));
+          emit(center, point(du + 1, dw, step), point(du + 1, dw + 1, step), point(du, dw + 1, step));
+        };
+
+        const int half = size / 2;
+        if (templates[f] == kFaceTemplatePlain) {
+          emit_square(0, 0, size);
+        } else if (templates[f] == kFaceTemplateFiner) {
+          for (int s = 0; s < 4; s++) {
+            emit_square(s & 1, s >> 1, half);
+          }
+        } else {
+              const vec3i face_center = point(1, 1, half);
+          int previous = 0;
+          for (int i = 1; i <= 8; i++) {
+            if (is_vertex[f][i % 8]) {
+              emit(center, face_center,
+                   point(kBoundarySteps[previous][0], kBoundarySteps[previous][1], half),
+                   point(kBoundarySteps[i % 8][0], kBoundarySteps[i % 8][1], half));
+              previous = i % 8;
+            }
+          }
+        }
+      }
+    }
+
+    /**
+     * @brief The level of the smallest cell holding all voxels.
+     */
+    int RootLevel(const vec3i& voxels_count) {
+      int level = 0;
+      while ((1 << level) < voxels_count.maxCoeff()) {
+        level++;
+      }
+      return level;
+    }
+
+    bool IsLeafInside(const std::vector<SignedDistanceField::SliceView>& slices,
+                      const Octree& octree,
+                      const vec3i& origin,
+                      int level) {
+      if (level > 0 || octree.isCrossed(origin, 0) == false) {
+        return slices[origin.z()].at(origin.x(), origin.y()) < 0.0;
+      }
+
+      real_t sum = 0.0;
+      for (int c = 0; c < 8; c++) {
+        sum += slices[origin.z() + ((c >> 2) & 1)].at(origin.x() + (c & 1), origin.y() + ((c >> 1) & 1));
+      }
+      return sum < 0.0;
+    }
+
+  }
+
+  bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                        const OctreeSizeField& size_field,
+                        std::vector<vec3>& out_vertices,
+                        std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+    out_vertices.clear();
+    out_tet_cells_by_vertex_ids.clear();
+
+    Octree octree;
+    octree.voxels_count = in_sdf.voxelsCount();
+    if (octree.voxels_count.minCoeff() < 1) {
+      SPDLOG_ERROR("The field needs at least one voxel along each axis to build an octree");
+      return false;
+    }
+
+    octree.root_level = RootLevel(octree.voxels_count);
+
+    std::vector<SignedDistanceField::SliceView> slices(in_sdf.gridPointsCount().z());
+    for (int z = 0; z < static_cast<int>(slices.size()); z++) {
+      slices[z] = in_sdf.slice(SignedDistanceField::kSliceAxisZ, z);
+    }
+
+    octree.leaf_levels.resize(static_cast<uint64_t>(octree.voxels_count.prod()));
+    ClassifyCrossedCells(slices, octree);
+    std::vector<std::vector<vec3i>> level_leaves = RefineOctree(in_sdf, size_field, octree);
+    BalanceOctree(octree, level_leaves);
+
+    std::vector<std::pair<vec3i, int>> leaves;
+    for (int level = 0; level <= octree.root_level; level++) {
+      for (const vec3i& origin : level_leaves[level]) {
+        leaves.emplace_back(origin, level);
+      }
+    }
+
+    SPDLOG_INFO("Octree of [{}] levels with [{}] leaves", octree.root_level + 1, leaves.size());
+
+    // the points are keyed in doubled grid coordinates
+    const vec3i keys_count = 2 * octree.voxels_count + vec3i::Ones();
+
+    const uint64_t count_blocks = (leaves.size() + kLeavesPerBlock - 1) / kLeavesPerBlock;
+    std::vector<std::vector<TetKeys>> block_tets(count_blocks);
+    std::vector<std::vector<uint64_t>> block_keys(count_blocks);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t b = chunk_begin; b < chunk_end; b++) {
+        std::vector<TetKeys>& tets = block_tets[b];
+        const uint64_t end = std::min<uint64_t>(leaves.size(), (b + 1) * kLeavesPerBlock);
+        for (uint64_t i = b * kLeavesPerBlock; i < end; i++) {
+          const auto& [origin, level] = leaves[i];
+          if (IsLeafInside(slices, octree, origin, level) == false) {
+            continue;
+          }
+
+          EmitLeafTetrahedra(octree, origin, level, keys_count, tets);
+        }
+
+        std::vector<uint64_t>& keys = block_keys[b];
+        keys.reserve(tets.size() * 4);
+        for (const TetKeys& tet : tets) {
+          keys.insert(keys.end(), tet.begin(), tet.end());
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      }
+    });
+
+    // merge the keys of all blocks, their sorted order gives the vertex ids
+    std::vector<uint64_t> vertex_keys;
+    std::vector<uint64_t> block_offsets(count_blocks + 1, 0);
+    for (uint64_t b = 0; b < count_blocks; b++) {
+      vertex_keys.insert(vertex_keys.end(), block_keys[b].begin(), block_keys[b].end());
+      block_offsets[b + 1] = block_offsets[b] + block_tets[b].size();
+      block_keys[b].clear();
+      block_keys[b].shrink_to_fit();
+    }
+    std::sort(vertex_keys.begin(), vertex_keys.end());
+    vertex_keys.erase(std::unique(vertex_keys.begin(), vertex_keys.end()), vertex_keys.end());
+
+    if (block_offsets[count_blocks] == 0) {
+      SPDLOG_ERROR("There are no octree leaves inside the surface");
+      return false;
+    }
+
+    if (vertex_keys.size() > static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+      SPDLOG_ERROR("Too many vertices for a tetrahedral mesh [{}]", vertex_keys.size());
+      return false;
+    }
+
+    const vec3 lower = in_sdf.bounds().lower();
+    const real_t half_voxel_size = 0.5 * in_sdf.voxelSize();
+    out_vertices.resize(vertex_keys.size());
+    ParallelFor(0, vertex_keys.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+        const uint64_t k = vertex_keys[i];
+        const vec3i p(static_cast<int>(k % keys_count.x()),
+                      static_cast<int>((k / keys_count.x()) % keys_count.y()),
+                      static_cast<int>(k / (static_cast<uint64_t>(keys_count.x()) * keys_count.y())));
+        out_vertices[i] = lower + p.cast<real_t>() * half_voxel_size;
+      }
+    }, 1024);
+
+    out_tet_cells_by_vertex_ids.resize(block_offsets[count_blocks]);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t b = chunk_begin; b < chunk_end; b++) {
+        const std::vector<TetKeys>& tets = block_tets[b];
+        for (uint64_t i = 0; i < tets.size(); i++) {
+          vec4i cell;
+          for (int k = 0; k < 4; k++) {
+            cell[k] = static_cast<int>(std::lower_bound(vertex_keys.begin(), vertex_keys.end(), tets[i][k]) - vertex_keys.begin());
+          }
+          out_tet_cells_by_vertex_ids[block_offsets[b] + i] = cell;
+        }
+      }
+    });
+
+    SPDLOG_INFO("Meshed the octree with [{}] tetrahedra and [{}] vertices",
+                out_tet_cells_by_vertex_ids.size(), out_vertices.size());
+    return true;
+  }
+
+  bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                        uint64_t target_cells_count,
+                        std::vector<vec3>& out_vertices,
+                        std::vector<vec4i>& out_tet_cells_by_vertex_ids) {
+    // start without a limit, the coarsest mesh the surface allows
+    if (MeshGradedOctree(in_sdf, OctreeSizeField(), out_vertices, out_tet_cells_by_vertex_ids) == false) {
+      return false;
+    }
+
+    if (out_tet_cells_by_vertex_ids.size() > target_cells_count) {
+      SPDLOG_WARN("The coarsest octree mesh has [{}] tetrahedra, more than the target [{}]",
+                  out_tet_cells_by_vertex_ids.size(), target_cells_count);
+      return true;
+    }
+
+    std::vector<vec3> vertices;
+    std::vector<vec4i> cells;
+    for (int level = RootLevel(in_sdf.voxelsCount()) - 1; level >= 0; level--) {
+      const real_t max_size = static_cast<real_t>(1 << level) * in_sdf.voxelSize();
+      if (MeshGradedOctree(in_sdf, [max_size](const vec3&) { return max_size; }, vertices, cells) == false ||
+          cells.size() > target_cells_count) {
+        break;
+      }
+
+      out_vertices.swap(vertices);
+      out_tet_cells_by_vertex_ids.swap(cells);
+    }
+
+    return true;
+  }
+
+  bool MeshGradedOctree(const SignedDistanceField& in_sdf,
+                        const OctreeSizeField& size_field,
+                        TetMesh& out_mesh) {
+    std::vector<vec3> vertices;
+    std::vector<vec4i> cells;
+    if (MeshGradedOctree(in_sdf, size_field, vertices, cells) == false) {
+      return false;
+    }
+
+    return out_mesh.readFromList(vertices, cells);
+  }
+
+}
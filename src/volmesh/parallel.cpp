@@ -0,0 +1,128 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace volmesh {
+
+  static std::atomic<uint32_t> g_max_threads_count(0);
+
+  static thread_local bool t_inside_parallel_for = false;
+
+  namespace {
+
+    /**
+     * @brief Marks the current thread as running chunks of `ParallelFor` for its lifetime.
+     */
+    class ParallelForScope {
+    public:
+      ParallelForScope(): was_inside_(t_inside_parallel_for) {
+        t_inside_parallel_for = true;
+      }
+
+      ~ParallelForScope() {
+        t_inside_parallel_for = was_inside_;
+      }
+
+    private:
+      bool was_inside_;
+    };
+
+  }
+
+  uint32_t CountWorkerThreads() {
+    const uint32_t max_threads = g_max_threads_count.load();
+    if (max_threads > 0) {
+      return max_threads;
+    }
+
+    return std::max<uint32_t>(1, std::thread::hardware_concurrency());
+  }
+
+  void SetMaxThreadsCount(uint32_t in_max_threads) {
+    g_max_threads_count.store(in_max_threads);
+  }
+
+  bool IsInsideParallelFor() {
+    return t_inside_parallel_for;
+  }
+
+  void ParallelFor(uint64_t begin,
+                   uint64_t end,
+                   const std::function<void(uint64_t chunk_begin, uint64_t chunk_end)>& fn,
+                   uint64_t grain_size) {
+    if (end <= begin) {
+      return;
+    }
+
+    grain_size = std::max<uint64_t>(1, grain_size);
+
+    const uint64_t count_chunks = (end - begin + grain_size - 1) / grain_size;
+    const uint32_t count_threads = static_cast<uint32_t>(std::min<uint64_t>(CountWorkerThreads(), count_chunks));
+
+    if (count_threads <= 1) {
+      ParallelForScope scope;
+      fn(begin, end);
+      return;
+    }
+
+    std::atomic<uint64_t> next_chunk(0);
+    std::exception_ptr first_exception;
+    std::mutex exception_mutex;
+
+    auto worker = [&]() {
+      ParallelForScope scope;
+      while (true) {
+        const uint64_t chunk = next_chunk.fetch_add(1);
+        if (chunk >= count_chunks) {
+          break;
+        }
+
+        const uint64_t chunk_begin = begin + chunk * grain_size;
+        const uint64_t chunk_end = std::min(end, chunk_begin + grain_size);
+
+        try {
+          fn(chunk_begin, chunk_end);
+        } catch (...) {
+          std::lock_guard<std::mutex> lk(exception_mutex);
+          if (!first_exception) {
+            first_exception = std::current_exception();
+          }
+
+          // stop handing out work
+          next_chunk.store(count_chunks);
+        }
+      }
+    };
+
+    // the calling thread takes part in the work
+    std::vector<std::thread> threads;
+    threads.reserve(count_threads - 1);
+    for (uint32_t i = 0; i < count_threads - 1; i++) {
+      threads.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& t : threads) {
+      t.join();
+    }
+
+    if (first_exception) {
+      std::rethrow_exception(first_exception);
+    }
+  }
+
+}
@@ -0,0 +1,369 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/pointcloudserializer.h"
+#include "volmesh/logger.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief A scalar property of a PLY element.
+     */
+    struct PlyProperty {
+      std::string name;
+      std::string type;
+      uint32_t size = 0; /**< Size of the property in bytes, zero for list properties. */
+    };
+
+    /**
+     * @brief An element of a PLY file with its properties in the order they are stored.
+     */
+    struct PlyElement {
+      std::string name;
+      uint64_t count = 0;
+      std::vector<PlyProperty> properties;
+    };
+
+    uint32_t PlyTypeSize(const std::string& type) {
+      if (type == "char" || type == "uchar" || type == "int8" || type == "uint8") {
+        return 1;
+      } else if (type == "short" || type == "ushort" || type == "int16" || type == "uint16") {
+        return 2;
+      } else if (type == "int" || type == "uint" || type == "int32" || type == "uint32" ||
+                 type == "float" || type == "float32") {
+        return 4;
+      } else if (type == "double" || type == "float64") {
+        return 8;
+      }
+
+      return 0;
+    }
+
+    bool IsLittleEndianHost() {
+      const uint16_t value = 1;
+      uint8_t first_byte = 0;
+      std::memcpy(&first_byte, &value, 1);
+      return first_byte == 1;
+    }
+
+    /**
+     * @brief Decodes a binary PLY scalar of the given type as a real number.
+     */
+    real_t DecodePlyScalar(const char* data, const std::string& type, bool swap_bytes) {
+      std::array<char, 8> bytes;
+      const uint32_t size = PlyTypeSize(type);
+      std::memcpy(bytes.data(), data, size);
+      if (swap_bytes) {
+        std::reverse(bytes.begin(), bytes.begin() + size);
+      }
+
+      if (type == "float" || type == "float32") {
+        float value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "double" || type == "float64") {
+        double value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "char" || type == "int8") {
+        int8_t value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "uchar" || type == "uint8") {
+        uint8_t value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "short" || type == "int16") {
+        int16_t value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "ushort" || type == "uint16") {
+        uint16_t value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      } else if (type == "int" || type == "int32") {
+        int32_t value;
+        std::memcpy(&value, bytes.data(), sizeof(value));
+        return static_cast<real_t>(value);
+      }
+
+      uint32_t value;
+      std::memcpy(&value, bytes.data(), sizeof(value));
+      return static_cast<real_t>(value);
+    }
+
+    /**
+     * @brief Normalizes the normals and drops the points without a normal.
+     */
+    void NormalizePointNormals(std::vector<vec3>& inout_positions, std::vector<vec3>& inout_normals) {
+      uint64_t count = 0;
+      for (uint64_t i = 0; i < inout_positions.size(); i++) {
+        const real_t length = inout_normals[i].norm();
+        if (length == 0.0) {
+          continue;
+        }
+
+        inout_positions[count] = inout_positions[i];
+        inout_normals[count] = inout_normals[i] / length;
+        count++;
+      }
+
+      if (count < inout_positions.size()) {
+        SPDLOG_WARN("Dropped [{}] points without a normal", inout_positions.size() - count);
+      }
+
+      inout_positions.resize(count);
+      inout_normals.resize(count);
+    }
+
+  }
+
+  bool ReadPointCloud(const std::string& in_filepath,
+                      std::vector<vec3>& out_positions,
+                      std::vector<vec3>& out_normals) {
+    std::string extension = std::filesystem::path(in_filepath).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c){ return std::tolower(c); });
+
+    bool result = false;
+    if (extension == ".xyz") {
+      result = ReadXYZ(in_filepath, out_positions, out_normals);
+    } else if (extension == ".ply") {
+      result = ReadPLY(in_filepath, out_positions, out_normals);
+    } else {
+      SPDLOG_ERROR("Unsupported point cloud format [{}]", extension.c_str());
+      return false;
+    }
+
+    if (result == false) {
+      return false;
+    }
+
+    NormalizePointNormals(out_positions, out_normals);
+    if (out_positions.empty()) {
+      SPDLOG_ERROR("The point cloud [{}] does not have any oriented points.", in_filepath.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
+  bool ReadXYZ(const std::string& in_filepath,
+               std::vector<vec3>& out_positions,
+               std::vector<vec3>& out_normals) {
+    std::ifstream file(in_filepath);
+    if (!file.is_open()) {
+      SPDLOG_ERROR("Failed to open file [{}] for reading", in_filepath.c_str());
+      return false;
+    }
+
+    out_positions.clear();
+    out_normals.clear();
+
+    std::string line;
+    uint64_t line_number = 0;
+    while (std::getline(file, line)) {
+      line_number++;
+      std::replace(line.begin(), line.end(), ',', ' ');
+
+      const size_t first = line.find_first_not_of(" \t\r");
+      if (first == std::string::npos || line[first] == '#') {
+        continue;
+      }
+
+      std::istringstream ss(line);
+      real_t values[6];
+      for (int i = 0; i < 6; i++) {
+        if (!(ss >> values[i])) {
+          SPDLOG_ERROR("Line [{}] of [{}] does not hold a position and a normal", line_number, in_filepath.c_str());
+          return false;
+        }
+      }
+
+      out_positions.emplace_back(values[0], values[1], values[2]);
+      out_normals.emplace_back(values[3], values[4], values[5]);
+    }
+
+    return true;
+  }
+
+  bool ReadPLY(const std::string& in_filepath,
+               std::vector<vec3>& out_positions,
+               std::vector<vec3>& out_normals) {
+    std::ifstream file(in_filepath, std::ios::binary);
+    if (!file.is_open()) {
+      SPDLOG_ERROR("Failed to open file [{}] for reading", in_filepath.c_str());
+      return false;
+    }
+
+    out_positions.clear();
+    out_normals.clear();
+
+    // parse the header
+    std::string line;
+    std::getline(file, line);
+    if (line.compare(0, 3, "ply") != 0) {
+      SPDLOG_ERROR("The file [{}] is not a PLY file", in_filepath.c_str());
+      return false;
+    }
+
+    std::string format;
+    std::vector<PlyElement> elements;
+    while (std::getline(file, line)) {
+      if (!line.empty() && line.back() == '\r') {
+        line.pop_back();
+      }
+
+      std::istringstream ss(line);
+      std::string keyword;
+      ss >> keyword;
+      if (keyword == "format") {
+        ss >> format;
+      } else if (keyword == "element") {
+        PlyElement element;
+        ss >> element.name >> element.count;
+        elements.push_back(element);
+      } else if (keyword == "property") {
+        if (elements.empty()) {
+          SPDLOG_ERROR("A PLY property precedes all elements in [{}]", in_filepath.c_str());
+          return false;
+        }
+
+        PlyProperty property;
+        ss >> property.type;
+        if (property.type == "list") {
+          std::string count_type, item_type;
+          ss >> count_type >> item_type;
+        } else {
+          property.size = PlyTypeSize(property.type);
+          if (property.size == 0) {
+            SPDLOG_ERROR("Unknown PLY property type [{}]", property.type.c_str());
+            return false;
+          }
+        }
+
+        ss >> property.name;
+        elements.back().properties.push_back(property);
+      } else if (keyword == "end_header") {
+        break;
+      }
+    }
+
+    if (format != "ascii" && format != "binary_little_endian" && format != "binary_big_endian") {
+      SPDLOG_ERROR("Unsupported PLY format [{}]", format.c_str());
+      return false;
+    }
+
+    const bool is_ascii = (format == "ascii");
+    const bool swap_bytes = (format == "binary_little_endian") != IsLittleEndianHost();
+
+    // skip the elements before the vertices
+    auto it_vertex = std::find_if(elements.begin(), elements.end(),
+                                  [](const PlyElement& e) { return e.name == "vertex"; });
+    if (it_vertex == elements.end()) {
+      SPDLOG_ERROR("The PLY file [{}] does not have any vertices", in_filepath.c_str());
+      return false;
+    }
+
+    for (auto it = elements.begin(); it != it_vertex; it++) {
+      uint64_t stride = 0;
+      for (const PlyProperty& property : it->properties) {
+        if (property.size == 0 && is_ascii == false) {
+          SPDLOG_ERROR("Can not skip the binary PLY element [{}] with list properties", it->name.c_str());
+          return false;
+        }
+
+        stride += property.size;
+      }
+
+      if (is_ascii) {
+        for (uint64_t i = 0; i < it->count; i++) {
+          std::getline(file, line);
+        }
+      } else {
+        file.seekg(static_cast<std::streamoff>(stride * it->count), std::ios::cur);
+      }
+    }
+
+    // locate the position and normal properties
+    const std::array<std::string, 6> names = {"x", "y", "z", "nx", "ny", "nz"};
+    std::array<int, 6> property_ids;
+    property_ids.fill(-1);
+
+    std::vector<uint64_t> offsets(it_vertex->properties.size(), 0);
+    uint64_t stride = 0;
+    for (size_t p = 0; p < it_vertex->properties.size(); p++) {
+      const PlyProperty& property = it_vertex->properties[p];
+      if (property.size == 0) {
+        SPDLOG_ERROR("The PLY vertex element can not have list properties");
+        return false;
+      }
+
+      offsets[p] = stride;
+      stride += property.size;
+      for (size_t k = 0; k < names.size(); k++) {
+        if (property.name == names[k]) {
+          property_ids[k] = static_cast<int>(p);
+        }
+      }
+    }
+
+    if (std::find(property_ids.begin(), property_ids.end(), -1) != property_ids.end()) {
+      SPDLOG_ERROR("The PLY vertices in [{}] must have the x, y, z, nx, ny and nz properties", in_filepath.c_str());
+      return false;
+    }
+
+    const uint64_t count_vertices = it_vertex->count;
+    out_positions.resize(count_vertices);
+    out_normals.resize(count_vertices);
+
+    std::vector<real_t> values(it_vertex->properties.size());
+    std::vector<char> record(stride);
+    for (uint64_t i = 0; i < count_vertices; i++) {
+      if (is_ascii) {
+        if (!std::getline(file, line)) {
+          SPDLOG_ERROR("The PLY file [{}] ends after [{}] of [{}] vertices", in_filepath.c_str(), i, count_vertices);
+          return false;
+        }
+
+        std::istringstream ss(line);
+        for (size_t p = 0; p < values.size(); p++) {
+          if (!(ss >> values[p])) {
+            SPDLOG_ERROR("The PLY vertex [{}] in [{}] is incomplete", i, in_filepath.c_str());
+            return false;
+          }
+        }
+      } else {
+        if (!file.read(record.data(), static_cast<std::streamsize>(stride))) {
+          SPDLOG_ERROR("The PLY file [{}] ends after [{}] of [{}] vertices", in_filepath.c_str(), i, count_vertices);
+          return false;
+        }
+
+        for (size_t k = 0; k < names.size(); k++) {
+          const int p = property_ids[k];
+          values[p] = DecodePlyScalar(record.data() + offsets[p], it_vertex->properties[p].type, swap_bytes);
+        }
+      }
+
+      out_positions[i] = vec3(values[property_ids[0]], values[property_ids[1]], values[property_ids[2]]);
+      out_normals[i] = vec3(values[property_ids[3]], values[property_ids[4]], values[property_ids[5]]);
+    }
+
+    return true;
+  }
+
+}
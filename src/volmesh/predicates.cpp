@@ -0,0 +1,655 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/predicates.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace volmesh {
+
+  namespace {
+
+    static const double kEpsilon = std::numeric_limits<double>::epsilon() * 0.5;
+    static const double kSplitter = 134217729.0;
+    static const double kOrient2dErrorBound = (3.0 + 16.0 * kEpsilon) * kEpsilon;
+    static const double kOrient3dErrorBound = (7.0 + 56.0 * kEpsilon) * kEpsilon;
+    static const double kInSphereErrorBound = (16.0 + 224.0 * kEpsilon) * kEpsilon;
+
+    /**
+     * @brief Covers the rounding of the coordinate differences and of the bounds of the static and semi-static filters.
+     */
+    static const double kBoundMargin = 1.0 + 64.0 * kEpsilon;
+
+    /**
+     * @brief A static filter bound that accepts no value, for the predicates without a bounding box.
+     */
+    static const double kNoStaticBound = std::numeric_limits<double>::infinity();
+
+    inline void TwoSum(double a, double b, double& x, double& y) {
+      x = a + b;
+      const double b_virtual = x - a;
+      const double a_virtual = x - b_virtual;
+      y = (a - a_virtual) + (b - b_virtual);
+    }
+
+    inline void FastTwoSum(double a, double b, double& x, double& y) {
+      x = a + b;
+      y = b - (x - a);
+    }
+
+    inline void Split(double a, double& hi, double& lo) {
+      const double c = kSplitter * a;
+      hi = c - (c - a);
+      lo = a - hi;
+    }
+
+    inline void TwoProduct(double a, double b, double& x, double& y) {
+      x = a * b;
+      double a_hi, a_lo, b_hi, b_lo;
+      Split(a, a_hi, a_lo);
+      Split(b, b_hi, b_lo);
+      y = a_lo * b_lo - (((x - a_hi * b_hi) - a_lo * b_hi) - a_hi * b_lo);
+    }
+
+    /**
+     * @brief The exact sum of two floating point expansions.
+     *
+     * An expansion is an array of non-overlapping terms of increasing magnitude. The terms of both
+     * inputs are merged by magnitude and accumulated in a single pass, zero terms are dropped and a
+     * zero expansion has a single zero term. Both inputs have at least one term, the output has room
+     * for the terms of both.
+     *
+     * @return The number of terms of the sum.
+     */
+    int ExpansionSum(int e_count, const double* e, int f_count, const double* f, double* h) {
+      int e_index = 0;
+      int f_index = 0;
+      double e_now = e[0];
+      double f_now = f[0];
+      auto next_e = [&]() { e_now = (++e_index < e_count) ? e[e_index] : 0.0; };
+      auto next_f = [&]() { f_now = (++f_index < f_count) ? f[f_index] : 0.0; };
+
+      double q;
+      if((f_now > e_now) == (f_now > -e_now)) {
+        q = e_now;
+        next_e();
+      } else {
+        q = f_now;
+        next_f();
+      }
+
+      int h_index = 0;
+      double q_new, error;
+      if(e_index < e_count && f_index < f_count) {
+        if((f_now > e_now) == (f_now > -e_now)) {
+          FastTwoSum(e_now, q, q_new, error);
+          next_e();
+        } else {
+          FastTwoSum(f_now, q, q_new, error);
+          next_f();
+        }
+        q = q_new;
+        if(error != 0.0) {
+          h[h_index++] = error;
+        }
+
+        while(e_index < e_count && f_index < f_count) {
+          if((f_now > e_now) == (f_now > -e_now)) {
+            TwoSum(q, e_now, q_new, error);
+            next_e();
+          } else {
+            TwoSum(q, f_now, q_new, error);
+            next_f();
+          }
+          q = q_new;
+          if(error != 0.0) {
+            h[h_index++] = error;
+          }
+        }
+      }
+
+      while(e_index < e_count) {
+        TwoSum(q, e_now, q_new, error);
+        next_e();
+        q = q_new;
+        if(error != 0.0) {
+          h[h_index++] = error;
+        }
+      }
+
+      while(f_index < f_count) {
+        TwoSum(q, f_now, q_new, error);
+        next_f();
+        q = q_new;
+        if(error != 0.0) {
+          h[h_index++] = error;
+        }
+      }
+
+      if(q != 0.0 || h_index == 0) {
+        h[h_index++] = q;
+      }
+      return h_index;
+    }
+
+    /**
+     * @brief The exact product of a floating point expansion and a double, without zero terms.
+     *
+     * @return The number of terms of the product, at most twice the terms of the expansion.
+     */
+    int ScaleExpansion(int e_count, const double* e, double b, double* h) {
+      int h_index = 0;
+      double q, error;
+      TwoProduct(e[0], b, q, error);
+      if(error != 0.0) {
+        h[h_index++] = error;
+      }
+      for(int i = 1; i < e_count; i++) {
+        double product_hi, product_lo, sum;
+        TwoProduct(e[i], b, product_hi, product_lo);
+        TwoSum(q, product_lo, sum, error);
+        if(error != 0.0) {
+          h[h_index++] = error;
+        }
+        FastTwoSum(product_hi, sum, q, error);
+        if(error != 0.0) {
+          h[h_index++] = error;
+        }
+      }
+      if(q != 0.0 || h_index == 0) {
+        h[h_index++] = q;
+      }
+      return h_index;
+    }
+
+    inline void Negate(int e_count, double* e) {
+      for(int i = 0; i < e_count; i++) {
+        e[i] = -e[i];
+      }
+    }
+
+    /**
+     * @brief The exact value of p.x * q.y - q.x * p.y as an expansion of four terms, possibly zero.
+     */
+    template <typename Point>
+    inline void CrossXY(const Point& p, const Point& q, double out[4]) {
+      double a_hi, a_lo, b_hi, b_lo;
+      TwoProduct(static_cast<double>(p.x()), static_cast<double>(q.y()), a_hi, a_lo);
+      TwoProduct(static_cast<double>(q.x()), static_cast<double>(p.y()), b_hi, b_lo);
+
+      double i, j, k;
+      TwoSum(a_lo, -b_lo, i, out[0]);
+      TwoSum(a_hi, i, j, k);
+      TwoSum(k, -b_hi, i, out[1]);
+      TwoSum(j, i, out[3], out[2]);
+    }
+
+    /**
+     * @brief The exact value of pq * pq_scale + rs * rs_scale + tu * tu_scale for three expansions of four terms.
+     *
+     * @return The number of terms, at most 24.
+     */
+    int ScaledSum3(const double pq[4], double pq_scale,
+                   const double rs[4], double rs_scale,
+                   const double tu[4], double tu_scale,
+                   double out[24]) {
+      double terms_a[8], terms_b[8], sum[16];
+      const int count_a = ScaleExpansion(4, pq, pq_scale, terms_a);
+      const int count_b = ScaleExpansion(4, rs, rs_scale, terms_b);
+      const int count_sum = ExpansionSum(count_a, terms_a, count_b, terms_b, sum);
+      const int count_c = ScaleExpansion(4, tu, tu_scale, terms_a);
+      return ExpansionSum(count_c, terms_a, count_sum, sum, out);
+    }
+
+    inline int Sign(double d) {
+      return (d > 0.0) ? 1 : ((d < 0.0) ? -1 : 0);
+    }
+
+    /**
+     * @brief The sign of an expansion, the sign of its largest non-zero term.
+     */
+    inline int Sign(int e_count, const double* e) {
+      for(int i = e_count - 1; i >= 0; i--) {
+        if(e[i] != 0.0) {
+          return Sign(e[i]);
+        }
+      }
+      return 0;
+    }
+
+    /**
+     * @brief Rounds the coordinate differences p - q and tells whether the rounding is exact.
+     *
+     * Shewchuk's adaptive predicates evaluate the determinant of the rounded differences in exact
+     * arithmetic first, which decides the sign whenever no difference is rounded, as for the close
+     * points of a lattice. The much larger expansions of the raw coordinates are the last resort.
+     */
+    template <typename Point>
+    inline bool ExactDifference(const Point& p, const Point& q, Point& out_difference) {
+      bool is_exact = true;
+      for(int k = 0; k < static_cast<int>(Point::RowsAtCompileTime); k++) {
+        double tail;
+        TwoSum(p[k], -q[k], out_difference[k], tail);
+        is_exact &= (tail == 0.0);
+      }
+      return is_exact;
+    }
+
+    /**
+     * @brief The exact product of an expansion of up to kMaxTerms terms and the squared length of a point.
+     *
+     * @return The number of terms, at most 12 * kMaxTerms.
+     */
+    template <int kMaxTerms>
+    int Lift(int e_count, const double* e, const vec3& p, double* out) {
+      double scaled[2 * kMaxTerms], lifted[3][4 * kMaxTerms];
+      int count_lifted[3];
+      for(int k = 0; k < 3; k++) {
+        const int count_scaled = ScaleExpansion(e_count, e, p[k], scaled);
+        count_lifted[k] = ScaleExpansion(count_scaled, scaled, p[k], lifted[k]);
+      }
+
+      double lifted_xy[8 * kMaxTerms];
+      const int count_xy = ExpansionSum(count_lifted[0], lifted[0], count_lifted[1], lifted[1], lifted_xy);
+      return ExpansionSum(count_xy, lifted_xy, count_lifted[2], lifted[2], out);
+    }
+
+    /**
+     * @brief The exact sign of the orientation of three points.
+     *
+     * Without exact differences the determinant is expanded into ab + bc + ca of the exact 2d cross
+     * products of the raw coordinates.
+     */
+    int Orient2dExact(const vec2& a, const vec2& b, const vec2& c) {
+      vec2 a_c, b_c;
+      if(ExactDifference(a, c, a_c) && ExactDifference(b, c, b_c)) {
+        double det[4];
+        CrossXY(a_c, b_c, det);
+        return Sign(4, det);
+      }
+
+      double ab_xy[4], bc_xy[4], ca_xy[4];
+      CrossXY(a, b, ab_xy);
+      CrossXY(b, c, bc_xy);
+      CrossXY(c, a, ca_xy);
+
+      double sum[8], det[12];
+      const int count_sum = ExpansionSum(4, ab_xy, 4, bc_xy, sum);
+      const int count_det = ExpansionSum(count_sum, sum, 4, ca_xy, det);
+      return Sign(count_det, det);
+    }
+
+    /**
+     * @brief The exact sign of the orientation of four points, from the cofactors of the lifted 4x4 determinant.
+     */
+    int Orient3dExact(const vec3& a, const vec3& b, const vec3& c, const vec3& d) {
+      vec3 a_d, b_d, c_d;
+      if(ExactDifference(a, d, a_d) && ExactDifference(b, d, b_d) && ExactDifference(c, d, c_d)) {
+        double bc_xy[4], ca_xy[4], ab_xy[4], det[24];
+        CrossXY(b_d, c_d, bc_xy);
+        CrossXY(c_d, a_d, ca_xy);
+        CrossXY(a_d, b_d, ab_xy);
+        const int count_det = ScaledSum3(bc_xy, a_d.z(), ca_xy, b_d.z(), ab_xy, c_d.z(), det);
+        return Sign(count_det, det);
+      }
+
+      double ab[4], bc[4], cd[4], da[4], ac[4], bd[4];
+      CrossXY(a, b, ab);
+      CrossXY(b, c, bc);
+      CrossXY(c, d, cd);
+      CrossXY(d, a, da);
+      CrossXY(a, c, ac);
+      CrossXY(b, d, bd);
+
+      double temp[8];
+      double abc[12], bcd[12], cda[12], dab[12];
+      int count_temp = ExpansionSum(4, cd, 4, da, temp);
+      const int count_cda = ExpansionSum(count_temp, temp, 4, ac, cda);
+      count_temp = ExpansionSum(4, da, 4, ab, temp);
+      const int count_dab = ExpansionSum(count_temp, temp, 4, bd, dab);
+      Negate(4, bd);
+      Negate(4, ac);
+      count_temp = ExpansionSum(4, ab, 4, bc, temp);
+      const int count_abc = ExpansionSum(count_temp, temp, 4, ac, abc);
+      count_temp = ExpansionSum(4, bc, 4, cd, temp);
+      const int count_bcd = ExpansionSum(count_temp, temp, 4, bd, bcd);
+
+      double adet[24], bdet[24], cdet[24], ddet[24];
+      const int count_a = ScaleExpansion(count_bcd, bcd, a.z(), adet);
+      const int count_b = ScaleExpansion(count_cda, cda, -b.z(), bdet);
+      const int count_c = ScaleExpansion(count_dab, dab, c.z(), cdet);
+      const int count_d = ScaleExpansion(count_abc, abc, -d.z(), ddet);
+
+      double abdet[48], cddet[48], det[96];
+      const int count_ab = ExpansionSum(count_a, adet, count_b, bdet, abdet);
+      const int count_cd = ExpansionSum(count_c, cdet, count_d, ddet, cddet);
+      const int count_det = ExpansionSum(count_ab, abdet, count_cd, cddet, det);
+      return Sign(count_det, det);
+    }
+
+    /**
+     * @brief The exact lifted cofactor (pos_a + pos_b - neg_a - neg_b) * |p|^2 of one point of the in-sphere determinant.
+     *
+     * @return The number of terms, at most 1152.
+     */
+    int LiftedCofactor(int count_pos_a, const double* pos_a, int count_pos_b, const double* pos_b,
+                       int count_neg_a, const double* neg_a, int count_neg_b, const double* neg_b,
+                       const vec3& p, double out[1152]) {
+      double pos[48], neg[48], cofactor[96];
+      const int count_pos = ExpansionSum(count_pos_a, pos_a, count_pos_b, pos_b, pos);
+      const int count_neg = ExpansionSum(count_neg_a, neg_a, count_neg_b, neg_b, neg);
+      Negate(count_neg, neg);
+      const int count_cofactor = ExpansionSum(count_pos, pos, count_neg, neg, cofactor);
+
+      return Lift<96>(count_cofactor, cofactor, p, out);
+    }
+
+    /**
+     * @brief The exact sign of the in-sphere test, from the cofactors of the lifted 5x5 determinant.
+     *
+     * The cofactors of the lifting column are built from the exact 2d cross products and the 3x3
+     * minors of the raw coordinates, as in Shewchuk's insphereexact. All expansions live in fixed
+     * size arrays on the stack.
+     */
+    int InSphereExact(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e) {
+      vec3 a_e, b_e, c_e, d_e;
+      if(ExactDifference(a, e, a_e) && ExactDifference(b, e, b_e) && ExactDifference(c, e, c_e) && ExactDifference(d, e, d_e)) {
+        // (dlift * abc - clift * dab) + (blift * cda - alift * bcd), as in the filters
+        double ab_xy[4], bc_xy[4], cd_xy[4], da_xy[4], ac_xy[4], bd_xy[4];
+        CrossXY(a_e, b_e, ab_xy);
+        CrossXY(b_e, c_e, bc_xy);
+        CrossXY(c_e, d_e, cd_xy);
+        CrossXY(d_e, a_e, da_xy);
+        CrossXY(a_e, c_e, ac_xy);
+        CrossXY(b_e, d_e, bd_xy);
+
+        double abc[24], bcd[24], cda[24], dab[24];
+        const int count_abc = ScaledSum3(bc_xy, a_e.z(), ac_xy, -b_e.z(), ab_xy, c_e.z(), abc);
+        const int count_bcd = ScaledSum3(cd_xy, b_e.z(), bd_xy, -c_e.z(), bc_xy, d_e.z(), bcd);
+        const int count_cda = ScaledSum3(da_xy, c_e.z(), ac_xy, d_e.z(), cd_xy, a_e.z(), cda);
+        const int count_dab = ScaledSum3(ab_xy, d_e.z(), bd_xy, a_e.z(), da_xy, b_e.z(), dab);
+        Negate(count_dab, dab);
+        Negate(count_bcd, bcd);
+
+        double adet[288], bdet[288], cdet[288], ddet[288];
+        const int count_a = Lift<24>(count_bcd, bcd, a_e, adet);
+        const int count_b = Lift<24>(count_cda, cda, b_e, bdet);
+        const int count_c = Lift<24>(count_dab, dab, c_e, cdet);
+        const int count_d = Lift<24>(count_abc, abc, d_e, ddet);
+
+        double abdet[576], cddet[576], det[1152];
+        const int count_ab = ExpansionSum(count_a, adet, count_b, bdet, abdet);
+        const int count_cd = ExpansionSum(count_c, cdet, count_d, ddet, cddet);
+        const int count_det = ExpansionSum(count_ab, abdet, count_cd, cddet, det);
+        return Sign(count_det, det);
+      }
+
+      double ab[4], bc[4], cd[4], de[4], ea[4], ac[4], bd[4], ce[4], da[4], eb[4];
+      CrossXY(a, b, ab);
+      CrossXY(b, c, bc);
+      CrossXY(c, d, cd);
+      CrossXY(d, e, de);
+      CrossXY(e, a, ea);
+      CrossXY(a, c, ac);
+      CrossXY(b, d, bd);
+      CrossXY(c, e, ce);
+      CrossXY(d, a, da);
+      CrossXY(e, b, eb);
+
+      double abc[24], bcd[24], cde[24], dea[24], eab[24], abd[24], bce[24], cda[24], deb[24], eac[24];
+      const int count_abc = ScaledSum3(bc, a.z(), ac, -b.z(), ab, c.z(), abc);
+      const int count_bcd = ScaledSum3(cd, b.z(), bd, -c.z(), bc, d.z(), bcd);
+      const int count_cde = ScaledSum3(de, c.z(), ce, -d.z(), cd, e.z(), cde);
+      const int count_dea = ScaledSum3(ea, d.z(), da, -e.z(), de, a.z(), dea);
+      const int count_eab = ScaledSum3(ab, e.z(), eb, -a.z(), ea, b.z(), eab);
+      const int count_abd = ScaledSum3(bd, a.z(), da, b.z(), ab, d.z(), abd);
+      const int count_bce = ScaledSum3(ce, b.z(), eb, c.z(), bc, e.z(), bce);
+      const int count_cda = ScaledSum3(da, c.z(), ac, d.z(), cd, a.z(), cda);
+      const int count_deb = ScaledSum3(eb, d.z(), bd, e.z(), de, b.z(), deb);
+      const int count_eac = ScaledSum3(ac, e.z(), ce, a.z(), ea, c.z(), eac);
+
+      double adet[1152], bdet[1152], cdet[1152], ddet[1152], edet[1152];
+      const int count_a = LiftedCofactor(count_cde, cde, count_bce, bce, count_deb, deb, count_bcd, bcd, a, adet);
+      const int count_b = LiftedCofactor(count_dea, dea, count_cda, cda, count_eac, eac, count_cde, cde, b, bdet);
+      const int count_c = LiftedCofactor(count_eab, eab, count_deb, deb, count_abd, abd, count_dea, dea, c, cdet);
+      const int count_d = LiftedCofactor(count_abc, abc, count_eac, eac, count_bce, bce, count_eab, eab, d, ddet);
+      const int count_e = LiftedCofactor(count_bcd, bcd, count_abd, abd, count_cda, cda, count_abc, abc, e, edet);
+
+      double abdet[2304], cddet[2304], cdedet[3456], det[5760];
+      const int count_ab = ExpansionSum(count_a, adet, count_b, bdet, abdet);
+      const int count_cd = ExpansionSum(count_c, cdet, count_d, ddet, cddet);
+      const int count_cde_det = ExpansionSum(count_cd, cddet, count_e, edet, cdedet);
+      const int count_det = ExpansionSum(count_ab, abdet, count_cde_det, cdedet, det);
+      return Sign(count_det, det);
+    }
+
+    inline int Decide(double det, uint64_t PredicateStatistics::* counter, PredicateStatistics* inout_stats) {
+      if(inout_stats != nullptr) {
+        (inout_stats->*counter)++;
+      }
+      return Sign(det);
+    }
+
+    inline double MaxAbs(double a, double b) {
+      return std::max(std::abs(a), std::abs(b));
+    }
+
+    inline double MaxAbs(double a, double b, double c) {
+      return std::max(MaxAbs(a, b), std::abs(c));
+    }
+
+    inline double MaxAbs(double a, double b, double c, double d) {
+      return std::max(MaxAbs(a, b), MaxAbs(c, d));
+    }
+
+    int Orient2dFiltered(const vec2& a, const vec2& b, const vec2& c, double static_bound, PredicateStatistics* inout_stats) {
+      const double acx = static_cast<double>(a.x()) - c.x();
+      const double bcx = static_cast<double>(b.x()) - c.x();
+      const double acy = static_cast<double>(a.y()) - c.y();
+      const double bcy = static_cast<double>(b.y()) - c.y();
+
+      const double det_left = acx * bcy;
+      const double det_right = acy * bcx;
+      const double det = det_left - det_right;
+      if(std::abs(det) > static_bound) {
+        return Decide(det, &PredicateStatistics::count_static, inout_stats);
+      }
+
+      const double semi_static_bound = kOrient2dErrorBound * kBoundMargin * 2.0 * MaxAbs(acx, bcx) * MaxAbs(acy, bcy);
+      if(std::abs(det) > semi_static_bound) {
+        return Decide(det, &PredicateStatistics::count_semi_static, inout_stats);
+      }
+
+      const double dynamic_bound = kOrient2dErrorBound * (std::abs(det_left) + std::abs(det_right));
+      if(std::abs(det) > dynamic_bound) {
+        return Decide(det, &PredicateStatistics::count_dynamic, inout_stats);
+      }
+
+      if(inout_stats != nullptr) {
+        inout_stats->count_exact++;
+      }
+      return Orient2dExact(a, b, c);
+    }
+
+    int Orient3dFiltered(const vec3& a, const vec3& b, const vec3& c, const vec3& d, double static_bound, PredicateStatistics* inout_stats) {
+      const double adx = static_cast<double>(a.x()) - d.x();
+      const double bdx = static_cast<double>(b.x()) - d.x();
+      const double cdx = static_cast<double>(c.x()) - d.x();
+      const double ady = static_cast<double>(a.y()) - d.y();
+      const double bdy = static_cast<double>(b.y()) - d.y();
+      const double cdy = static_cast<double>(c.y()) - d.y();
+      const double adz = static_cast<double>(a.z()) - d.z();
+      const double bdz = static_cast<double>(b.z()) - d.z();
+      const double cdz = static_cast<double>(c.z()) - d.z();
+
+      const double bdxcdy = bdx * cdy;
+      const double cdxbdy = cdx * bdy;
+      const double cdxady = cdx * ady;
+      const double adxcdy = adx * cdy;
+      const double adxbdy = adx * bdy;
+      const double bdxady = bdx * ady;
+
+      const double det = adz * (bdxcdy - cdxbdy) + bdz * (cdxady - adxcdy) + cdz * (adxbdy - bdxady);
+      if(std::abs(det) > static_bound) {
+        return Decide(det, &PredicateStatistics::count_static, inout_stats);
+      }
+
+      const double semi_static_bound = kOrient3dErrorBound * kBoundMargin * 6.0 *
+                                       MaxAbs(adx, bdx, cdx) * MaxAbs(ady, bdy, cdy) * MaxAbs(adz, bdz, cdz);
+      if(std::abs(det) > semi_static_bound) {
+        return Decide(det, &PredicateStatistics::count_semi_static, inout_stats);
+      }
+
+      const double permanent = (std::abs(bdxcdy) + std::abs(cdxbdy)) * std::abs(adz) +
+                               (std::abs(cdxady) + std::abs(adxcdy)) * std::abs(bdz) +
+                               (std::abs(adxbdy) + std::abs(bdxady)) * std::abs(cdz);
+      if(std::abs(det) > kOrient3dErrorBound * permanent) {
+        return Decide(det, &PredicateStatistics::count_dynamic, inout_stats);
+      }
+
+      if(inout_stats != nullptr) {
+        inout_stats->count_exact++;
+      }
+
+      return Orient3dExact(a, b, c, d);
+    }
+
+    int InSphereFiltered(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e, double static_bound, PredicateStatistics* inout_stats) {
+      const double aex = static_cast<double>(a.x()) - e.x();
+      const double bex = static_cast<double>(b.x()) - e.x();
+      const double cex = static_cast<double>(c.x()) - e.x();
+      const double dex = static_cast<double>(d.x()) - e.x();
+      const double aey = static_cast<double>(a.y()) - e.y();
+      const double bey = static_cast<double>(b.y()) - e.y();
+      const double cey = static_cast<double>(c.y()) - e.y();
+      const double dey = static_cast<double>(d.y()) - e.y();
+      const double aez = static_cast<double>(a.z()) - e.z();
+      const double bez = static_cast<double>(b.z()) - e.z();
+      const double cez = static_cast<double>(c.z()) - e.z();
+      const double dez = static_cast<double>(d.z()) - e.z();
+
+      const double aexbey = aex * bey;
+      const double bexaey = bex * aey;
+      const double ab = aexbey - bexaey;
+      const double bexcey = bex * cey;
+      const double cexbey = cex * bey;
+      const double bc = bexcey - cexbey;
+      const double cexdey = cex * dey;
+      const double dexcey = dex * cey;
+      const double cd = cexdey - dexcey;
+      const double dexaey = dex * aey;
+      const double aexdey = aex * dey;
+      const double da = dexaey - aexdey;
+      const double aexcey = aex * cey;
+      const double cexaey = cex * aey;
+      const double ac = aexcey - cexaey;
+      const double bexdey = bex * dey;
+      const double dexbey = dex * bey;
+      const double bd = bexdey - dexbey;
+
+      const double abc = aez * bc - bez * ac + cez * ab;
+      const double bcd = bez * cd - cez * bd + dez * bc;
+      const double cda = cez * da + dez * ac + aez * cd;
+      const double dab = dez * ab + aez * bd + bez * da;
+
+      const double alift = aex * aex + aey * aey + aez * aez;
+      const double blift = bex * bex + bey * bey + bez * bez;
+      const double clift = cex * cex + cey * cey + cez * cez;
+      const double dlift = dex * dex + dey * dey + dez * dez;
+
+      const double det = (dlift * abc - clift * dab) + (blift * cda - alift * bcd);
+      if(std::abs(det) > static_bound) {
+        return Decide(det, &PredicateStatistics::count_static, inout_stats);
+      }
+
+      const double max_x = MaxAbs(aex, bex, cex, dex);
+      const double max_y = MaxAbs(aey, bey, cey, dey);
+      const double max_z = MaxAbs(aez, bez, cez, dez);
+      const double semi_static_bound = kInSphereErrorBound * kBoundMargin * 24.0 *
+                                       max_x * max_y * max_z * (max_x * max_x + max_y * max_y + max_z * max_z);
+      if(std::abs(det) > semi_static_bound) {
+        return Decide(det, &PredicateStatistics::count_semi_static, inout_stats);
+      }
+
+      const double permanent =
+        ((std::abs(cexdey) + std::abs(dexcey)) * std::abs(bez) + (std::abs(dexbey) + std::abs(bexdey)) * std::abs(cez) +
+         (std::abs(bexcey) + std::abs(cexbey)) * std::abs(dez)) * alift +
+        ((std::abs(dexaey) + std::abs(aexdey)) * std::abs(cez) + (std::abs(aexcey) + std::abs(cexaey)) * std::abs(dez) +
+         (std::abs(cexdey) + std::abs(dexcey)) * std::abs(aez)) * blift +
+        ((std::abs(aexbey) + std::abs(bexaey)) * std::abs(dez) + (std::abs(bexdey) + std::abs(dexbey)) * std::abs(aez) +
+         (std::abs(dexaey) + std::abs(aexdey)) * std::abs(bez)) * clift +
+        ((std::abs(bexcey) + std::abs(cexbey)) * std::abs(aez) + (std::abs(cexaey) + std::abs(aexcey)) * std::abs(bez) +
+         (std::abs(aexbey) + std::abs(bexaey)) * std::abs(cez)) * dlift;
+      if(std::abs(det) > kInSphereErrorBound * permanent) {
+        return Decide(det, &PredicateStatistics::count_dynamic, inout_stats);
+      }
+
+      if(inout_stats != nullptr) {
+        inout_stats->count_exact++;
+      }
+
+      return InSphereExact(a, b, c, d, e);
+    }
+
+  }
+
+  uint64_t PredicateStatistics::count() const {
+    return count_static + count_semi_static + count_dynamic + count_exact;
+  }
+
+  real_t PredicateStatistics::filterHitRate() const {
+    const uint64_t total = count();
+    return (total == 0) ? 1.0 : static_cast<real_t>(total - count_exact) / static_cast<real_t>(total);
+  }
+
+  PredicateStatistics& PredicateStatistics::operator+=(const PredicateStatistics& rhs) {
+    count_static += rhs.count_static;
+    count_semi_static += rhs.count_semi_static;
+    count_dynamic += rhs.count_dynamic;
+    count_exact += rhs.count_exact;
+    return *this;
+  }
+
+  int Orient2d(const vec2& a, const vec2& b, const vec2& c, PredicateStatistics* inout_stats) {
+    return Orient2dFiltered(a, b, c, kNoStaticBound, inout_stats);
+  }
+
+  int Orient3d(const vec3& a, const vec3& b, const vec3& c, const vec3& d, PredicateStatistics* inout_stats) {
+    return Orient3dFiltered(a, b, c, d, kNoStaticBound, inout_stats);
+  }
+
+  int InSphere(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e, PredicateStatistics* inout_stats) {
+    return InSphereFiltered(a, b, c, d, e, kNoStaticBound, inout_stats);
+  }
+
+  StaticPredicateFilter::StaticPredicateFilter(const AABB& bounds) {
+    // the coordinate differences of points inside the box are at most its extent
+    const double extent_x = static_cast<double>(bounds.upper().x()) - bounds.lower().x();
+    const double extent_y = static_cast<double>(bounds.upper().y()) - bounds.lower().y();
+    const double extent_z = static_cast<double>(bounds.upper().z()) - bounds.lower().z();
+    orient2d_bound_ = kOrient2dErrorBound * kBoundMargin * 2.0 * extent_x * extent_y;
+    orient3d_bound_ = kOrient3dErrorBound * kBoundMargin * 6.0 * extent_x * extent_y * extent_z;
+    insphere_bound_ = kInSphereErrorBound * kBoundMargin * 24.0 * extent_x * extent_y * extent_z *
+                      (extent_x * extent_x + extent_y * extent_y + extent_z * extent_z);
+  }
+
+  int StaticPredicateFilter::orient2d(const vec2& a, const vec2& b, const vec2& c, PredicateStatistics* inout_stats) const {
+    return Orient2dFiltered(a, b, c, orient2d_bound_, inout_stats);
+  }
+
+  int StaticPredicateFilter::orient3d(const vec3& a, const vec3& b, const vec3& c, const vec3& d, PredicateStatistics* inout_stats) const {
+    return Orient3dFiltered(a, b, c, d, orient3d_bound_, inout_stats);
+  }
+
+  int StaticPredicateFilter::inSphere(const vec3& a, const vec3& b, const vec3& c, const vec3& d, const vec3& e, PredicateStatistics* inout_stats) const {
+    return InSphereFiltered(a, b, c, d, e, insphere_bound_, inout_stats);
+  }
+
+}
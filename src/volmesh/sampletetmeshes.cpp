@@ -59,61 +59,15 @@ namespace volmesh {
       throw std::invalid_argument(fmt::format("Invalid grid dimension supplied [{} {} {}]", nx, ny, nz));
     }
 
-    if(cellsize == (real_t)0.0) {
-      throw std::invalid_argument(fmt::format("requested cellsize can not be zero [{}]", cellsize));
+    if(cellsize <= (real_t)0.0) {
+      throw std::invalid_argument(fmt::format("requested cellsize must be positive [{}]", cellsize));
     }
 
-    std::vector<vec3> vertex_list;
-    std::vector<vec4i> tetcells_list;
-
-    vec3 start = vec3(- static_cast<real_t>(nx)/2.0f, 0.0f, - static_cast<real_t>(nz)/2.0f) * cellsize;
-
-    //add all nodes
-    for(int i=0; i < nx; i++) {
-      for(int j=0; j < ny; j++) {
-        for(int k=0; k < nz; k++) {
-          vec3 v = start + vec3(i, j, k) * cellsize;
-          vertex_list.push_back(v);
-        }
-      }
-    }
-
-    int voxel_indices[8];
-
-    //add all elements
-    const int total_voxels = (nx - 1) * (ny - 1) * (nz - 1);
-    tetcells_list.resize(total_voxels * 6);
-
-    int voxel_id = 0;
-    for(int i=0; i < nx-1; i++) {
-      for(int j=0; j < ny-1; j++) {
-        for(int k=0; k < nz-1; k++) {
-          //compute voxel elements
-          voxel_indices[Voxel::VertexLocationId::LBN] = i * ny * nz + j * nz + k;
-          voxel_indices[Voxel::VertexLocationId::LBF] = i * ny * nz + j * nz + k + 1;
-
-          voxel_indices[Voxel::VertexLocationId::LTN] = i * ny * nz + (j+1) * nz + k;
-          voxel_indices[Voxel::VertexLocationId::LTF] = i * ny * nz + (j+1) * nz + k + 1;
-
-          voxel_indices[Voxel::VertexLocationId::RBN] = (i+1) * ny * nz + j * nz + k;
-          voxel_indices[Voxel::VertexLocationId::RBF] = (i+1) * ny * nz + j * nz + k + 1;
-
-          voxel_indices[Voxel::VertexLocationId::RTN] = (i+1) * ny * nz + (j+1) * nz + k;
-          voxel_indices[Voxel::VertexLocationId::RTF] = (i+1) * ny * nz + (j+1) * nz + k + 1;
-
-          tetcells_list[voxel_id * 6]     = vec4i(voxel_indices[Voxel::VertexLocationId::LBN], voxel_indices[Voxel::VertexLocationId::LTN], voxel_indices[Voxel::VertexLocationId::RBN], voxel_indices[Voxel::VertexLocationId::LBF]);
-          tetcells_list[voxel_id * 6 + 1] = vec4i(voxel_indices[Voxel::VertexLocationId::RTN], voxel_indices[Voxel::VertexLocationId::LTN], voxel_indices[Voxel::VertexLocationId::LBF], voxel_indices[Voxel::VertexLocationId::RBN]);
-          tetcells_list[voxel_id * 6 + 2] = vec4i(voxel_indices[Voxel::VertexLocationId::RTN], voxel_indices[Voxel::VertexLocationId::LTN], voxel_indices[Voxel::VertexLocationId::LTF], voxel_indices[Voxel::VertexLocationId::LBF]);
-          tetcells_list[voxel_id * 6 + 3] = vec4i(voxel_indices[Voxel::VertexLocationId::RTN], voxel_indices[Voxel::VertexLocationId::RBN], voxel_indices[Voxel::VertexLocationId::LBF], voxel_indices[Voxel::VertexLocationId::RBF]);
-          tetcells_list[voxel_id * 6 + 4] = vec4i(voxel_indices[Voxel::VertexLocationId::RTN], voxel_indices[Voxel::VertexLocationId::LBF], voxel_indices[Voxel::VertexLocationId::LTF], voxel_indices[Voxel::VertexLocationId::RBF]);
-          tetcells_list[voxel_id * 6 + 5] = vec4i(voxel_indices[Voxel::VertexLocationId::RTN], voxel_indices[Voxel::VertexLocationId::LTF], voxel_indices[Voxel::VertexLocationId::RTF], voxel_indices[Voxel::VertexLocationId::RBF]);
-
-          voxel_id ++;
-        }
-      }
-    }
-
-    return inout_mesh.readFromList(vertex_list, tetcells_list);
+    //the vertex ids grow with (i, j, k) and k varies fastest, as do the six tetrahedra of every voxel
+    const vec3 start = vec3(- static_cast<real_t>(nx)/2.0f, 0.0f, - static_cast<real_t>(nz)/2.0f) * cellsize;
+    const vec3i voxels_count(nx - 1, ny - 1, nz - 1);
+    const std::vector<uint8_t> voxel_mask(static_cast<size_t>(voxels_count.x()) * voxels_count.y() * voxels_count.z(), 1);
+    return inout_mesh.readFromVoxelGrid(start, cellsize, voxels_count, voxel_mask, vec3i(0, 1, 2));
   }
 
   bool createSphericalShell(TetMesh& inout_mesh,
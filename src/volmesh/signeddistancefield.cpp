@@ -7,16 +7,481 @@
 //-----------------------------------------------------------------------------
 
 #include "volmesh/signeddistancefield.h"
+#include "volmesh/distancetransform.h"
 #include "volmesh/logger.h"
+#include "volmesh/marchingcubes.h"
 #include "volmesh/mathutils.h"
+#include "volmesh/occupancygrid.h"
+#include "volmesh/parallel.h"
+#include "volmesh/stlserializer.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/windingnumber.h"
 
+#include <algorithm>
 #include <fstream>
 #include <filesystem>
 #include <chrono>
+#include <cstring>
+#include <numeric>
 #include <tinyxml2.h>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 using namespace volmesh;
 
+namespace {
+
+  /**
+   * @brief Fixed part of the binary SDF file header, padded to kBinaryHeaderSizeInBytes on disk.
+   */
+  struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t real_size;
+    int32_t gridpoints_count[3];
+    uint32_t reserved;
+    double voxel_size;
+    double lower[3];
+    double upper[3];
+  };
+
+  static const char kBinaryMagic[8] = {'V', 'M', 'S', 'D', 'F', 'B', 'I', 'N'};
+  static const uint64_t kBinaryHeaderSizeInBytes = 128;
+
+  static_assert(sizeof(BinaryHeader) <= kBinaryHeaderSizeInBytes, "binary SDF header does not fit");
+
+  static const char kNpyMagic[6] = {'\x93', 'N', 'U', 'M', 'P', 'Y'};
+
+  /**
+   * @brief Alignment of the values in a NPY file, as written by NumPy itself.
+   */
+  static const uint64_t kNpyAlignmentInBytes = 64;
+
+  /**
+   * @brief Number of grid points along each side of a brick in the point cloud generation.
+   */
+  static const int kPointCloudBrickSize = 8;
+
+  /**
+   * @brief Polynomial smooth minimum, equal to the minimum when a and b differ by at least k.
+   */
+  real_t SmoothMin(real_t a, real_t b, real_t k) {
+    if (k <= 0.0 || std::fabs(a - b) >= k) {
+      return std::min(a, b);
+    }
+
+    const real_t h = static_cast<real_t>(0.5) + static_cast<real_t>(0.5) * (b - a) / k;
+    return b + (a - b) * h - k * h * (static_cast<real_t>(1.0) - h);
+  }
+
+  real_t CombineValues(real_t a, real_t b, SignedDistanceField::CsgOperation op, real_t blend_radius) {
+    switch (op) {
+      case SignedDistanceField::kCsgUnion:
+        return SmoothMin(a, b, blend_radius);
+      case SignedDistanceField::kCsgIntersection:
+        return -SmoothMin(-a, -b, blend_radius);
+      case SignedDistanceField::kCsgDifference:
+        return -SmoothMin(-a, b, blend_radius);
+    }
+
+    return a;
+  }
+
+  /**
+   * @brief Signs the grid points off the narrow band of a slab, row by row along x.
+   *
+   * The band covers every grid point within two voxels of the surface, so a run of off band grid
+   * points along a row does not cross the surface and lies on the same side as the band values at
+   * its ends. A run is inside when the band values at its ends are negative, and a row with no band
+   * values is outside.
+   *
+   * @param gridpoints_count The number of grid points along each axis.
+   * @param count_layers The number of z layers in the slab.
+   * @param values The field values of the slab, with x varying fastest.
+   */
+  void SignOffBandRows(const vec3i& gridpoints_count, int count_layers, real_t* values) {
+    const real_t kOffBandValue = std::numeric_limits<real_t>::max();
+    const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+    const uint64_t count_rows = static_cast<uint64_t>(gridpoints_count.y()) * static_cast<uint64_t>(count_layers);
+
+    ParallelFor(0, count_rows, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t row = chunk_begin; row < chunk_end; row++) {
+        real_t* row_values = values + row * nx;
+
+        uint64_t x = 0;
+        while (x < nx) {
+          if (row_values[x] != kOffBandValue) {
+            x++;
+            continue;
+          }
+
+          uint64_t run_end = x;
+          while (run_end < nx && row_values[run_end] == kOffBandValue) {
+            run_end++;
+          }
+
+          const bool has_band_end = (x > 0) || (run_end < nx);
+          const bool inside_before = (x == 0) || (row_values[x - 1] < 0.0);
+          const bool inside_after = (run_end == nx) || (row_values[run_end] < 0.0);
+          if (has_band_end && inside_before && inside_after) {
+            std::fill(row_values + x, row_values + run_end, -kOffBandValue);
+          }
+
+          x = run_end;
+        }
+      }
+    }, 16);
+  }
+
+  /**
+   * @brief Returns the pseudo normal of the closest feature, from the face normal, the pseudo
+   * normals of the edges AB, BC, CA and of the vertices A, B, C.
+   */
+  const vec3& FeaturePseudoNormal(const std::array<vec3, 7>& normals, ClosestTriangleFeature feature) {
+    switch(feature) {
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeAB): return normals[1];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeBC): return normals[2];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeCA): return normals[3];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexA): return normals[4];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexB): return normals[5];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureVertexC): return normals[6];
+      case(ClosestTriangleFeature::kClosestTriangleFeatureNone):
+      case(ClosestTriangleFeature::kClosestTriangleFeatureInside):
+        break;
+    }
+
+    return normals[0];
+  }
+
+  /**
+   * @brief Surface adapter over the faces of a triangle mesh and its pseudo normals.
+   */
+  class TriangleMeshSurface {
+  public:
+    explicit TriangleMeshSurface(const TriangleMesh& in_mesh): mesh_(in_mesh) {}
+
+    std::array<vec3, 3> faceVertices(uint32_t face_id) const {
+      return mesh_.halfFaceVertices(HalfFaceIndex::create(face_id));
+    }
+
+    void facePseudoNormals(uint32_t face_id, std::array<vec3, 7>& out_normals) const {
+      const HalfFaceIndex hface_id = HalfFaceIndex::create(face_id);
+      const TriangleMesh::HalfFaceType hface = mesh_.halfFace(hface_id);
+
+      out_normals[0] = mesh_.halfFaceNormal(hface_id);
+      for(uint32_t i=0; i < 3; i++) {
+        out_normals[1 + i] = mesh_.halfEdgePseudoNormal(hface.halfEdgeIndex(i));
+        out_normals[4 + i] = mesh_.vertexPseudoNormal(VertexIndex::create(mesh_.halfEdge(hface.halfEdgeIndex(i)).start()));
+      }
+    }
+
+  private:
+    const TriangleMesh& mesh_;
+  };
+
+  /**
+   * @brief Surface adapter over the boundary half-faces of a tetrahedral mesh.
+   *
+   * The faces are copied once, since the mesh accessors lock a mutex per call. The pseudo normals
+   * are accumulated over the boundary faces, per vertex of the tetrahedral mesh and per edge,
+   * where the edge of a half-edge is its id without the lowest bit, shared with its twin `hedge ^ 1`.
+   */
+  class TetMeshBoundarySurface {
+  public:
+    bool build(const TetMesh& in_mesh) {
+      std::vector<HalfFaceIndex> boundary_hfaces;
+      if(in_mesh.getBoundaryHalfFaces(boundary_hfaces) == 0) {
+        SPDLOG_ERROR("The supplied tetrahedral mesh does not have any boundary faces.");
+        return false;
+      }
+
+      const uint32_t count_faces = static_cast<uint32_t>(boundary_hfaces.size());
+      hface_ids_.resize(count_faces);
+      triangle_vertices_.resize(count_faces * 3);
+      face_normals_.resize(count_faces);
+      face_vertex_ids_.resize(count_faces);
+      face_edge_ids_.resize(count_faces);
+      vertex_pseudo_normals_.assign(in_mesh.countVertices(), vec3(0.0, 0.0, 0.0));
+      edge_pseudo_normals_.clear();
+
+      std::vector<uint32_t> edge_ids(in_mesh.countHalfEdges() / 2, kSentinelIndex);
+      for(uint32_t i=0; i < count_faces; i++) {
+        hface_ids_[i] = boundary_hfaces[i].get();
+
+        // the triangle vertices are the start vertices of the half-edges, see extractBoundaryTriangleMesh
+        const TetMesh::HalfFaceType hface = in_mesh.halfFace(boundary_hfaces[i]);
+        std::array<HalfEdge, 3> hedges = {in_mesh.halfEdge(hface.halfEdgeIndex(0)),
+                                          in_mesh.halfEdge(hface.halfEdgeIndex(1)),
+                                          in_mesh.halfEdge(hface.halfEdgeIndex(2))};
+        for(int j=0; j < 3; j++) {
+          face_vertex_ids_[i][j] = hedges[j].start();
+          triangle_vertices_[i * 3 + j] = in_mesh.vertex(VertexIndex::create(hedges[j].start()));
+        }
+
+        const vec3* v = &triangle_vertices_[i * 3];
+        face_normals_[i] = (v[1] - v[0]).cross(v[2] - v[0]).normalized();
+
+        // angle weighted vertex pseudo normals
+        for(int j=0; j < 3; j++) {
+          const vec3 e1 = (v[(j + 1) % 3] - v[j]).normalized();
+          const vec3 e2 = (v[(j + 2) % 3] - v[j]).normalized();
+          const real_t angle = std::acos(std::max<real_t>(-1.0, std::min<real_t>(1.0, e1.dot(e2))));
+          vertex_pseudo_normals_[face_vertex_ids_[i][j]] += angle * face_normals_[i];
+        }
+
+        // the half-edges of a boundary half-face are shared with the cell face, the edge AB is the one with the vertices A and B
+        for(int j=0; j < 3; j++) {
+          const uint32_t a = face_vertex_ids_[i][j];
+          const uint32_t b = face_vertex_ids_[i][(j + 1) % 3];
+          int k = 0;
+          while(k < 2 && !((hedges[k].start() == a && hedges[k].end() == b) ||
+                           (hedges[k].start() == b && hedges[k].end() == a))) {
+            k++;
+          }
+
+          uint32_t& edge_id = edge_ids[hface.halfEdgeIndex(k).get() >> 1];
+          if(edge_id == kSentinelIndex) {
+            edge_id = static_cast<uint32_t>(edge_pseudo_normals_.size());
+            edge_pseudo_normals_.push_back(vec3(0.0, 0.0, 0.0));
+          }
+
+          face_edge_ids_[i][j] = edge_id;
+          edge_pseudo_normals_[edge_id] += face_normals_[i];
+        }
+      }
+
+      // the pseudo normals are only used for their direction
+      for(auto& n : vertex_pseudo_normals_) {
+        n.normalize();
+      }
+
+      for(auto& n : edge_pseudo_normals_) {
+        n.normalize();
+      }
+
+      bounds_ = AABB(triangle_vertices_[0], triangle_vertices_[0]);
+      for(const vec3& v : triangle_vertices_) {
+        bounds_ = AABB(bounds_.lower().cwiseMin(v), bounds_.upper().cwiseMax(v));
+      }
+
+      return true;
+    }
+
+    uint32_t countFaces() const {
+      return static_cast<uint32_t>(hface_ids_.size());
+    }
+
+    uint32_t halfFaceId(uint32_t face_id) const {
+      return hface_ids_[face_id];
+    }
+
+    AABB bounds() const {
+      return bounds_;
+    }
+
+    const std::vector<vec3>& triangleVertices() const {
+      return triangle_vertices_;
+    }
+
+    std::array<vec3, 3> faceVertices(uint32_t face_id) const {
+      return {triangle_vertices_[face_id * 3 + 0],
+              triangle_vertices_[face_id * 3 + 1],
+              triangle_vertices_[face_id * 3 + 2]};
+    }
+
+    void facePseudoNormals(uint32_t face_id, std::array<vec3, 7>& out_normals) const {
+      out_normals[0] = face_normals_[face_id];
+      for(int i=0; i < 3; i++) {
+        out_normals[1 + i] = edge_pseudo_normals_[face_edge_ids_[face_id][i]];
+        out_normals[4 + i] = vertex_pseudo_normals_[face_vertex_ids_[face_id][i]];
+      }
+    }
+
+  private:
+    std::vector<uint32_t> hface_ids_; /**< The half-face id in the tetrahedral mesh per face. */
+    std::vector<vec3> triangle_vertices_; /**< Three consecutive vertices per face. */
+    std::vector<vec3> face_normals_; /**< The unit normal per face. */
+    std::vector<std::array<uint32_t, 3>> face_vertex_ids_; /**< The tetrahedral mesh vertex ids of A, B, C per face. */
+    std::vector<std::array<uint32_t, 3>> face_edge_ids_; /**< The edge pseudo normal ids of AB, BC, CA per face. */
+    std::vector<vec3> vertex_pseudo_normals_; /**< The pseudo normal per vertex of the tetrahedral mesh. */
+    std::vector<vec3> edge_pseudo_normals_; /**< The pseudo normal per boundary edge. */
+    AABB bounds_; /**< The bounding box of the boundary. */
+  };
+
+  /**
+   * @brief Number of cell layers per slab in the marching cubes extraction.
+   */
+  static const int kMarchingCubesSlabLayers = 8;
+
+  static const uint32_t kInvalidVertexId = 0xFFFFFFFF;
+
+  /**
+   * @brief Marks a face corner whose vertex lies on the top layer of a slab and is owned by the next slab.
+   */
+  static const uint64_t kForeignVertexFlag = 1ull << 63;
+
+  /**
+   * @brief Marks a face corner that holds a global vertex id after stitching.
+   */
+  static const uint64_t kGlobalVertexFlag = 1ull << 62;
+
+  /**
+   * @brief The output of one slab of the marching cubes extraction.
+   */
+  struct MarchingCubesSlab {
+    std::vector<vec3> vertices; /**< The vertices owned by the slab. */
+    std::vector<uint64_t> face_refs; /**< Three vertex references per triangle, local ids unless flagged. */
+    std::vector<uint64_t> foreign_refs; /**< Positions in face_refs of the references to the next slab. */
+    std::vector<uint32_t> bottom_edges; /**< The vertex id per x and y edge of the first layer, keyed by axis * nx * ny + y * nx + x. */
+  };
+
+  /**
+   * @brief Interpolates the crossing of the iso value along the grid edge leaving a grid point in the given axis.
+   */
+  vec3 InterpolateGridEdge(const real_t* values,
+                           const vec3i& gridpoints_count,
+                           const vec3& lower,
+                           real_t voxel_size,
+                           const vec3i& coords,
+                           int axis,
+                           real_t iso_value) {
+    const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+    const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+    const uint64_t strides[3] = {1, nx, nx * ny};
+    const uint64_t id0 = (static_cast<uint64_t>(coords.z()) * ny + static_cast<uint64_t>(coords.y())) * nx + static_cast<uint64_t>(coords.x());
+    const real_t v0 = values[id0];
+    const real_t v1 = values[id0 + strides[axis]];
+    const real_t t = std::clamp((iso_value - v0) / (v1 - v0), static_cast<real_t>(0.0), static_cast<real_t>(1.0));
+
+    vec3 p = lower + voxel_size * coords.cast<real_t>();
+    p[axis] += t * voxel_size;
+    return p;
+  }
+
+  /**
+   * @brief Runs marching cubes over the cell layers [z_begin, z_end).
+   *
+   * Unless the slab owns its top layer, the vertices on the x and y edges of layer z_end are
+   * referenced by their edge key and resolved against the bottom edges of the next slab.
+   */
+  void ExtractMarchingCubesSlab(const real_t* values,
+                                const vec3i& gridpoints_count,
+                                const vec3& lower,
+                                real_t voxel_size,
+                                real_t iso_value,
+                                int z_begin,
+                                int z_end,
+                                bool owns_top_layer,
+                                MarchingCubesSlab& out_slab) {
+    const real_t kMaxValue = std::numeric_limits<real_t>::max();
+    const int nx = gridpoints_count.x();
+    const int ny = gridpoints_count.y();
+    const uint64_t layer_size = static_cast<uint64_t>(nx) * static_cast<uint64_t>(ny);
+
+    std::array<uint64_t, MarchingCubes::kCountCorners> corner_offsets;
+    for (int c = 0; c < MarchingCubes::kCountCorners; c++) {
+      const vec3i offset = MarchingCubes::cornerOffset(c);
+      corner_offsets[c] = (static_cast<uint64_t>(offset.z()) * ny + static_cast<uint64_t>(offset.y())) * nx + static_cast<uint64_t>(offset.x());
+    }
+
+    // rolling caches of the x and y edges below and above the current cell layer, and of its z edges
+    std::vector<uint32_t> lower_edges(2 * layer_size, kInvalidVertexId);
+    std::vector<uint32_t> upper_edges(2 * layer_size, kInvalidVertexId);
+    std::vector<uint32_t> z_edges(layer_size, kInvalidVertexId);
+
+    for (int z = z_begin; z < z_end; z++) {
+      const bool foreign_top = (z + 1 == z_end) && (owns_top_layer == false);
+
+      for (int y = 0; y + 1 < ny; y++) {
+        for (int x = 0; x + 1 < nx; x++) {
+          const uint64_t base = (static_cast<uint64_t>(z) * ny + static_cast<uint64_t>(y)) * nx + static_cast<uint64_t>(x);
+
+          int cube_index = 0;
+          bool in_band = true;
+          for (int c = 0; c < MarchingCubes::kCountCorners && in_band; c++) {
+            const real_t v = values[base + corner_offsets[c]];
+            in_band = (std::fabs(v) != kMaxValue);
+            cube_index |= (v < iso_value) ? (1 << c) : 0;
+          }
+
+          if (in_band == false || cube_index == 0 || cube_index == 255) {
+            continue;
+          }
+
+          const auto& triangle_edges = MarchingCubes::triangleEdges(cube_index);
+          for (int k = 0; triangle_edges[k] >= 0; k++) {
+            const int edge = triangle_edges[k];
+            const int axis = MarchingCubes::edgeAxis(edge);
+            const vec3i offset = MarchingCubes::cornerOffset(MarchingCubes::edgeCornerIds(edge)[0]);
+            const uint64_t key = static_cast<uint64_t>(y + offset.y()) * nx + static_cast<uint64_t>(x + offset.x());
+
+            uint32_t* cached = nullptr;
+            if (axis == 2) {
+              cached = &z_edges[key];
+            } else if (offset.z() == 0) {
+              cached = &lower_edges[axis * layer_size + key];
+            } else if (foreign_top) {
+              out_slab.foreign_refs.push_back(out_slab.face_refs.size());
+              out_slab.face_refs.push_back(kForeignVertexFlag | (axis * layer_size + key));
+              continue;
+            } else {
+              cached = &upper_edges[axis * layer_size + key];
+            }
+
+            if (*cached == kInvalidVertexId) {
+              *cached = static_cast<uint32_t>(out_slab.vertices.size());
+              const vec3i coords(x + offset.x(), y + offset.y(), z + offset.z());
+              out_slab.vertices.push_back(InterpolateGridEdge(values, gridpoints_count, lower, voxel_size, coords, axis, iso_value));
+            }
+
+            out_slab.face_refs.push_back(*cached);
+          }
+        }
+      }
+
+      if (z == z_begin) {
+        out_slab.bottom_edges = lower_edges;
+      }
+
+      std::swap(lower_edges, upper_edges);
+      std::fill(upper_edges.begin(), upper_edges.end(), kInvalidVertexId);
+      std::fill(z_edges.begin(), z_edges.end(), kInvalidVertexId);
+    }
+  }
+
+  /**
+   * @brief The active cells of one cell layer in the surface nets extraction.
+   */
+  struct SurfaceNetsLayer {
+    std::vector<uint64_t> cell_keys; /**< The key y * (nx - 1) + x of each active cell, in increasing order. */
+    std::vector<vec3> vertices; /**< The vertex of each active cell. */
+    std::vector<vec3i> faces; /**< The triangles of the crossed grid edges that start on this grid layer. */
+  };
+
+  /**
+   * @brief Replaces the content of a triangle mesh with an indexed triangle list.
+   */
+  void FillTriangleMesh(const std::vector<vec3>& in_vertices,
+                        const std::vector<vec3i>& in_faces,
+                        TriangleMesh& out_mesh) {
+    out_mesh.clear();
+    if (in_vertices.empty()) {
+      return;
+    }
+
+    out_mesh.insertAllVertices(in_vertices);
+    for (const vec3i& face : in_faces) {
+      out_mesh.insertTriangle(face);
+    }
+  }
+
+}
+
 SignedDistanceField::SignedDistanceField() {
 
 }
@@ -26,15 +491,25 @@ SignedDistanceField::SignedDistanceField(const SignedDistanceField& rhs) {
 }
 
 SignedDistanceField::~SignedDistanceField() {
-
+  releaseMapping();
 }
 
 void SignedDistanceField::copyFrom(const SignedDistanceField& rhs) {
+  if (this == &rhs) {
+    return;
+  }
+
   voxel_size_ = rhs.voxel_size_;
   bounds_ = rhs.bounds_;
 
+  // a mapped field is copied into memory
   std::lock_guard<std::mutex> lk(field_values_mutex_);
-  field_values_ = rhs.field_values_;
+  releaseMapping();
+  const real_t* rhs_values = rhs.fieldValuesData();
+  field_values_.assign(rhs_values, rhs_values + rhs.countFieldValues());
+  closest_feature_storage_ = rhs.closest_feature_storage_;
+  closest_face_ids_ = rhs.closest_face_ids_;
+  closest_point_offsets_ = rhs.closest_point_offsets_;
 }
 
 AABB SignedDistanceField::bounds() const {
@@ -47,9 +522,9 @@ real_t SignedDistanceField::voxelSize() const {
 
 vec3i SignedDistanceField::voxelsCount() const {
   const vec3 extent = bounds_.extent();
-  const int nx = static_cast<int>(std::ceil(extent.x() / voxel_size_));
-  const int ny = static_cast<int>(std::ceil(extent.y() / voxel_size_));
-  const int nz = static_cast<int>(std::ceil(extent.z() / voxel_size_));
+  const int nx = ComputeVoxelsCount(extent.x(), voxel_size_);
+  const int ny = ComputeVoxelsCount(extent.y(), voxel_size_);
+  const int nz = ComputeVoxelsCount(extent.z(), voxel_size_);
   return vec3i(nx, ny, nz);
 }
 
@@ -60,23 +535,60 @@ vec3i SignedDistanceField::gridPointsCount() const {
 
 uint64_t SignedDistanceField::totalGridPointsCount() const {
   const vec3i gpc = gridPointsCount();
-  return static_cast<uint32_t>(gpc.x()) * static_cast<uint32_t>(gpc.y()) * static_cast<uint32_t>(gpc.z());
+  return static_cast<uint64_t>(gpc.x()) * static_cast<uint64_t>(gpc.y()) * static_cast<uint64_t>(gpc.z());
 }
 
 uint64_t SignedDistanceField::getTotalMemoryUsageInBytes() const {
-  return sizeof(voxel_size_) + sizeof(bounds_) + totalGridPointsCount() * 2 * sizeof(real_t);
+  return sizeof(voxel_size_) + sizeof(bounds_) + totalGridPointsCount() * 2 * sizeof(real_t) +
+         closest_face_ids_.size() * sizeof(uint32_t) + closest_point_offsets_.size() * sizeof(vec3);
+}
+
+void SignedDistanceField::setClosestFeatureStorage(ClosestFeatureStorage storage) {
+  closest_feature_storage_ = storage;
+}
+
+SignedDistanceField::ClosestFeatureStorage SignedDistanceField::closestFeatureStorage() const {
+  return closest_feature_storage_;
+}
+
+bool SignedDistanceField::hasClosestFaceIds() const {
+  return closest_face_ids_.empty() == false;
+}
+
+bool SignedDistanceField::hasClosestPointOffsets() const {
+  return closest_point_offsets_.empty() == false;
+}
+
+uint32_t SignedDistanceField::closestFaceId(const vec3i& coords) const {
+  // gridPointId will assert coords
+  const uint64_t gridpoint_id = gridPointId(coords);
+  if (closest_face_ids_.empty()) {
+    return kInvalidFaceId;
+  }
+
+  return closest_face_ids_[gridpoint_id];
+}
+
+vec3 SignedDistanceField::closestPointOffset(const vec3i& coords) const {
+  // gridPointId will assert coords
+  const uint64_t gridpoint_id = gridPointId(coords);
+  if (closest_point_offsets_.empty()) {
+    return vec3(0.0, 0.0, 0.0);
+  }
+
+  return closest_point_offsets_[gridpoint_id];
 }
 
 uint64_t SignedDistanceField::gridPointId(const vec3i& coords) const {
   assertGridPointCoords(coords);
 
+  // in 64 bits, the out-of-core and mapped grids have more than 2^32 grid points
   const vec3i gridpoints_count = gridPointsCount();
-  const uint32_t nx = static_cast<uint32_t>(gridpoints_count.x());
-  const uint32_t ny = static_cast<uint32_t>(gridpoints_count.y());
-  const uint32_t nz = static_cast<uint32_t>(gridpoints_count.z());
-  return static_cast<uint32_t>(coords.z()) * nx * ny +
-          static_cast<uint32_t>(coords.y()) * nx +
-          static_cast<uint32_t>(coords.x());
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  return static_cast<uint64_t>(coords.z()) * nx * ny +
+         static_cast<uint64_t>(coords.y()) * nx +
+         static_cast<uint64_t>(coords.x());
 }
 
 vec3 SignedDistanceField::gridPointPosition(const vec3i& coords) const {
@@ -96,7 +608,7 @@ vec4 SignedDistanceField::gridPointPositionAndFieldValue(const vec3i& coords) co
   real_t field_value = 0.0;
   {
     std::lock_guard<std::mutex> lk(field_values_mutex_);
-    field_value = field_values_[gridPointId(coords)];
+    field_value = fieldValuesData()[gridPointId(coords)];
   }
 
   return vec4(position.x(), position.y(), position.z(), field_value);
@@ -104,22 +616,13 @@ vec4 SignedDistanceField::gridPointPositionAndFieldValue(const vec3i& coords) co
 
 bool SignedDistanceField::generate(const TriangleMesh& in_mesh,
                                    const vec3& expansion,
-                                   real_t voxel_size) {
-  if(in_mesh.countFaces() == 0) {
-    SPDLOG_ERROR("The supplied mesh does not have any faces.");
-    return false;
-  }
-
-  if(in_mesh.hasVertexPseudoNormals() == false ||
-     in_mesh.hasHalfEdgePseudoNormals() == false) {
-    SPDLOG_ERROR("The pseudo normals for vertices and half-edges must be computed before generating the SDF");
+                                   real_t voxel_size,
+                                   SignMode sign_mode) {
+  if(validateGenerateArgs(in_mesh, voxel_size, sign_mode) == false) {
     return false;
   }
 
-  if(voxel_size == 0.0) {
-    SPDLOG_ERROR("Voxel size can not be zero.");
-    return false;
-  }
+  releaseMapping();
 
   // computes a bounding box that contains the triangle mesh
   bounds_ = in_mesh.bounds();
@@ -128,17 +631,7 @@ bool SignedDistanceField::generate(const TriangleMesh& in_mesh,
   // store requested voxel size
   voxel_size_ = voxel_size;
 
-  std::vector<real_t> magnitudes(totalGridPointsCount());
-  std::vector<real_t> signs(totalGridPointsCount());
-
-  // initialize the voxel grid by settings all values to +infinity
-  std::fill(magnitudes.begin(), magnitudes.end(), std::numeric_limits<real_t>::max());
-  std::fill(signs.begin(), signs.end(), 0.0);
-
-  // process all faces in the mesh
-  const uint32_t count_faces = in_mesh.countFaces();
   const vec3i gridpoints_count = gridPointsCount();
-
   const vec3i voxels_count = voxelsCount();
 
   // print some debug info
@@ -152,199 +645,1651 @@ bool SignedDistanceField::generate(const TriangleMesh& in_mesh,
   SPDLOG_DEBUG("Total grid points count = [{}]", totalGridPointsCount());
   SPDLOG_DEBUG("Total memory usage by SDF in bytes = [{}]", getTotalMemoryUsageInBytes());
 
-  static const int kProgressReportPeriodSeconds = 5;
-
   // start timer
   auto t1 = std::chrono::high_resolution_clock::now();
 
-  uint64_t last_report_timestamp_seconds = 0;
-
-  for(uint32_t iface = 0; iface < count_faces; iface++) {
-    auto tc = std::chrono::high_resolution_clock::now();
-    auto current_duration_seconds = std::chrono::duration_cast<std::chrono::seconds>(tc - t1);
-    if (current_duration_seconds.count() % kProgressReportPeriodSeconds == 0 &&
-        last_report_timestamp_seconds != current_duration_seconds.count()) {
-      const double progress = (static_cast<double>(iface + 1) * 100.0) / static_cast<double>(count_faces);
-      SPDLOG_INFO("progress [{} of {}], {:.2f} %", iface + 1, count_faces, progress);
-      last_report_timestamp_seconds = current_duration_seconds.count();
-    }
-
-    const HalfFaceIndex hface_id = HalfFaceIndex::create(iface);
-
-    const TriangleMesh::HalfFaceType hface = in_mesh.halfFace(hface_id);
-    const auto hface_vertices = in_mesh.halfFaceVertices(hface_id);
-
-    // compute face bounding box and extend it by the width of the transition region
-    AABB face_aabb = ComputeTriangleAABB(hface_vertices);
-    face_aabb.expand(vec3(2.0 * voxel_size_, 2.0 * voxel_size_, 2.0 * voxel_size_));
+  std::unique_ptr<WindingNumberTree> tree;
+  std::unique_ptr<OccupancyGrid> occupancy;
+  if(prepareSignEvaluation(in_mesh, sign_mode, tree, occupancy) == false) {
+    return false;
+  }
 
-    const vec3 face_aabb_lower_local = (face_aabb.lower() - bounds_.lower()) / voxel_size_;
+  // the in-core generation is a single slab over all faces
+  std::vector<uint32_t> face_ids(in_mesh.countFaces());
+  std::iota(face_ids.begin(), face_ids.end(), 0);
 
-    const int start_x = std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.x())));
-    const int start_y = std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.y())));
-    const int start_z = std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.z())));
+  GridVector<real_t> values;
+  GridVector<uint32_t> closest_face_ids;
+  GridVector<vec3> closest_point_offsets;
+  generateSlab(TriangleMeshSurface(in_mesh), face_ids, 0, gridpoints_count.z(), sign_mode, tree.get(), occupancy.get(), values,
+               (closest_feature_storage_ != kClosestFeatureNone) ? &closest_face_ids : nullptr,
+               (closest_feature_storage_ == kClosestFeatureFaceIdsAndOffsets) ? &closest_point_offsets : nullptr);
 
-    const vec3 face_aabb_voxels_extent = face_aabb.extent() / voxel_size_;
-    const int stop_x = std::min(gridpoints_count.x(), start_x + static_cast<int>(std::ceil(face_aabb_voxels_extent.x())));
-    const int stop_y = std::min(gridpoints_count.y(), start_y + static_cast<int>(std::ceil(face_aabb_voxels_extent.y())));
-    const int stop_z = std::min(gridpoints_count.z(), start_z + static_cast<int>(std::ceil(face_aabb_voxels_extent.z())));
+  // save the final field values
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    field_values_.swap(values);
+    closest_face_ids_.swap(closest_face_ids);
+    closest_point_offsets_.swap(closest_point_offsets);
+  }
 
-    std::array<uint32_t, 3> face_vertex_ids;
-    for(uint32_t i=0; i < 3; i++) {
-      face_vertex_ids[i] = in_mesh.halfEdge(hface.halfEdgeIndex(i)).start();
-    }
+  auto t2 = std::chrono::high_resolution_clock::now();
 
-    // loop over all voxels and compute the distance to all voxel points
-    for(int z = start_z; z < stop_z; z++) {
-      for(int y = start_y; y < stop_y; y++) {
-        for(int x = start_x; x < stop_x; x++) {
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating SDF = [{}.{}] seconds.",
+               duration_milliseconds.count() / 1000,
+               duration_milliseconds.count() % 1000);
 
-          const vec3i coords = vec3i(x, y, z);
-          const vec3 p = gridPointPosition(coords);
-          const real_t prev_dist = magnitudes[gridPointId(coords)];
+  return true;
+}
 
-          vec3 q(0.0, 0.0, 0.0);
+bool SignedDistanceField::generate(const TetMesh& in_mesh,
+                                   const vec3& expansion,
+                                   real_t voxel_size,
+                                   SignMode sign_mode) {
+  if(voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
 
-          ClosestTriangleFeature closest_feature;
+  // start timer
+  auto t1 = std::chrono::high_resolution_clock::now();
 
-          const real_t dist = PointTriangleDistance(p,
-                                                    hface_vertices[0],
-                                                    hface_vertices[1],
-                                                    hface_vertices[2],
-                                                    q,
-                                                    closest_feature);
+  // walk the boundary half-faces of the tetrahedral mesh
+  TetMeshBoundarySurface surface;
+  if(surface.build(in_mesh) == false) {
+    return false;
+  }
 
-          if ((dist < prev_dist) || FuzzyCompare(dist, prev_dist) == true) {
-            // compute distance sign
-            vec3 pseudo_normal = in_mesh.halfFaceNormal(hface_id);
+  releaseMapping();
 
-            // fetch normal at the closest feature to q
-            switch(closest_feature) {
-              case(ClosestTriangleFeature::kClosestTriangleFeatureVertexA): {
-                pseudo_normal = in_mesh.vertexPseudoNormal(VertexIndex::create(face_vertex_ids[0]));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureVertexB): {
-                pseudo_normal = in_mesh.vertexPseudoNormal(VertexIndex::create(face_vertex_ids[1]));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureVertexC): {
-                pseudo_normal = in_mesh.vertexPseudoNormal(VertexIndex::create(face_vertex_ids[2]));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeAB): {
-                pseudo_normal = in_mesh.halfEdgePseudoNormal(hface.halfEdgeIndex(0));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeBC): {
-                pseudo_normal = in_mesh.halfEdgePseudoNormal(hface.halfEdgeIndex(1));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureEdgeCA): {
-                pseudo_normal = in_mesh.halfEdgePseudoNormal(hface.halfEdgeIndex(2));
-                break;
-              }
-              case(ClosestTriangleFeature::kClosestTriangleFeatureNone):
-              case(ClosestTriangleFeature::kClosestTriangleFeatureInside): {
-                // no changes
-              }
-            }
+  bounds_ = surface.bounds();
+  bounds_.expand(expansion);
+  voxel_size_ = voxel_size;
 
-            // directional vector from the intersection point q on the triangle, and the grid point p
-            const vec3 dir_vec_qp = p - q;
+  SPDLOG_DEBUG("Tetrahedral mesh cells = [{}], boundary faces = [{}]", in_mesh.countCells(), surface.countFaces());
 
-            const uint64_t gridpoint_id = gridPointId(coords);
+  std::unique_ptr<WindingNumberTree> tree;
+  std::unique_ptr<OccupancyGrid> occupancy;
+  if(prepareSignEvaluation(surface.triangleVertices(), sign_mode, tree, occupancy) == false) {
+    return false;
+  }
 
-            if (dist < prev_dist) {
-              magnitudes[gridpoint_id] = dist;
+  std::vector<uint32_t> face_ids(surface.countFaces());
+  std::iota(face_ids.begin(), face_ids.end(), 0);
 
-              // replace sign
-              signs[gridpoint_id] = dir_vec_qp.dot(pseudo_normal);
-            } else if (FuzzyCompare(dist, prev_dist) == true) {
-              magnitudes[gridpoint_id] = dist;
+  GridVector<real_t> values;
+  GridVector<uint32_t> closest_face_ids;
+  GridVector<vec3> closest_point_offsets;
+  generateSlab(surface, face_ids, 0, gridPointsCount().z(), sign_mode, tree.get(), occupancy.get(), values,
+               (closest_feature_storage_ != kClosestFeatureNone) ? &closest_face_ids : nullptr,
+               (closest_feature_storage_ == kClosestFeatureFaceIdsAndOffsets) ? &closest_point_offsets : nullptr);
 
-              // accumulate sign
-              signs[gridpoint_id] += dir_vec_qp.dot(pseudo_normal);
-            }
-          } // if dist
-        }
-      }
+  // the closest faces are reported as the half-faces of the tetrahedral mesh
+  for(auto& face_id : closest_face_ids) {
+    if(face_id != kInvalidFaceId) {
+      face_id = surface.halfFaceId(face_id);
     }
-  } // end for face
+  }
 
-  // save the final field values
   {
     std::lock_guard<std::mutex> lk(field_values_mutex_);
-    field_values_.resize(totalGridPointsCount());
-
-    for (size_t i=0; i < field_values_.size(); ++i) {
-      field_values_[i] = (signs[i] >= 0) ? magnitudes[i] : - magnitudes[i];
-    }
+    field_values_.swap(values);
+    closest_face_ids_.swap(closest_face_ids);
+    closest_point_offsets_.swap(closest_point_offsets);
   }
 
   auto t2 = std::chrono::high_resolution_clock::now();
 
   auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
-  SPDLOG_INFO("Total time spent in generating SDF = [{}.{}] seconds.",
+  SPDLOG_INFO("Total time spent in generating SDF from the tetrahedral mesh boundary = [{}.{:03}] seconds.",
                duration_milliseconds.count() / 1000,
                duration_milliseconds.count() % 1000);
 
   return true;
 }
 
-real_t SignedDistanceField::fieldValue(const vec3& p) const {
-  // field is zero outside the bounding box
-  if (bounds_.contains(p) == false) {
-    return 0.0;
+bool SignedDistanceField::generateOutOfCore(const TriangleMesh& in_mesh,
+                                            const vec3& expansion,
+                                            real_t voxel_size,
+                                            const std::string& filepath,
+                                            uint64_t memory_budget_bytes,
+                                            SignMode sign_mode) {
+  if(validateGenerateArgs(in_mesh, voxel_size, sign_mode) == false) {
+    return false;
   }
 
-  // find voxel coordinates
+  // the slabs are generated on a staged grid, the field keeps its values until the file is mapped
+  SignedDistanceField grid;
+  grid.bounds_ = in_mesh.bounds();
+  grid.bounds_.expand(expansion);
+  grid.voxel_size_ = voxel_size;
+
+  const vec3i gridpoints_count = grid.gridPointsCount();
+  const uint64_t count_faces = in_mesh.countFaces();
+
+  // a slab layer holds the magnitudes and the signs of one xy plane
+  const uint64_t layer_bytes = static_cast<uint64_t>(gridpoints_count.x()) *
+                               static_cast<uint64_t>(gridpoints_count.y()) * 2 * sizeof(real_t);
+  if(memory_budget_bytes < layer_bytes) {
+    SPDLOG_ERROR("The memory budget of [{}] bytes can not hold a single slab layer of [{}] bytes.",
+                 memory_budget_bytes, layer_bytes);
+    return false;
+  }
 
-  // map p to the local coordinate system of the voxel grid
-  vec3 q = (p - bounds_.lower()) / voxel_size_;
+  auto t1 = std::chrono::high_resolution_clock::now();
 
-  // voxel coords
-  const int ix = static_cast<int>(std::floor(q.x()));
-  const int iy = static_cast<int>(std::floor(q.y()));
-  const int iz = static_cast<int>(std::floor(q.z()));
+  std::unique_ptr<WindingNumberTree> tree;
+  std::unique_ptr<OccupancyGrid> occupancy;
+  if(grid.prepareSignEvaluation(in_mesh, sign_mode, tree, occupancy) == false) {
+    return false;
+  }
 
-  // setup interpolators
-  const real_t tx = q.x() - static_cast<real_t>(ix);
-  const real_t ty = q.y() - static_cast<real_t>(iy);
-  const real_t tz = q.z() - static_cast<real_t>(iz);
+  // the occupancy grid is shared by all slabs and counts against the budget
+  const uint64_t shared_bytes = (occupancy != nullptr) ? occupancy->getTotalMemoryUsageInBytes() : 0;
+  if(memory_budget_bytes <= shared_bytes ||
+     (memory_budget_bytes - shared_bytes) < layer_bytes) {
+    SPDLOG_ERROR("The memory budget of [{}] bytes can not hold a single slab layer of [{}] bytes.",
+                 memory_budget_bytes, layer_bytes + shared_bytes);
+    return false;
+  }
 
-  //vXYZ
-  const real_t v000 = fieldValue(vec3i(ix, iy, iz));
-  const real_t v001 = fieldValue(vec3i(ix, iy, iz + 1));
-  const real_t v010 = fieldValue(vec3i(ix, iy + 1, iz));
-  const real_t v011 = fieldValue(vec3i(ix, iy + 1, iz + 1));
-  const real_t v100 = fieldValue(vec3i(ix + 1, iy, iz));
-  const real_t v101 = fieldValue(vec3i(ix + 1, iy, iz + 1));
-  const real_t v110 = fieldValue(vec3i(ix + 1, iy + 1, iz));
-  const real_t v111 = fieldValue(vec3i(ix + 1, iy + 1, iz + 1));
+  const int slab_depth = static_cast<int>(std::min<uint64_t>(gridpoints_count.z(),
+                                                             (memory_budget_bytes - shared_bytes) / layer_bytes));
+  const int count_slabs = (gridpoints_count.z() + slab_depth - 1) / slab_depth;
 
-  real_t result = (1 - tz) * ((1 - ty) * (v000 * (1 - tx) + v100 * tx) +
-                                   ty  * (v010 * (1 - tx) + v110 * tx)) +
-                  tz * ((1 - ty) * (v001 * (1 - tx) + v101 * tx) +
-                        ty  * (v011 * (1 - tx) + v111 * tx));
+  SPDLOG_INFO("Out-of-core generation with [{}] slabs of [{}] layers each", count_slabs, slab_depth);
 
-  return result;
-}
+  // pre-bin the faces to the slabs overlapped by their bands
+  std::vector<uint32_t> slab_offsets(count_slabs + 1, 0);
+  std::vector<vec2i> face_slabs(count_faces);
+  for(uint32_t iface = 0; iface < count_faces; iface++) {
+    vec3i start, stop;
+    grid.computeFaceBand(in_mesh.halfFaceVertices(HalfFaceIndex::create(iface)), start, stop);
 
-real_t SignedDistanceField::fieldValue(const vec3i& coords) const {
-  // gridPointId will assert coords
-  const uint64_t gridpoint_id = gridPointId(coords);
+    if (stop.z() <= start.z()) {
+      face_slabs[iface] = vec2i(0, -1);
+      continue;
+    }
+
+    face_slabs[iface] = vec2i(start.z() / slab_depth, (stop.z() - 1) / slab_depth);
+    for(int s = face_slabs[iface].x(); s <= face_slabs[iface].y(); s++) {
+      slab_offsets[s + 1]++;
+    }
+  }
+
+  for(int s = 0; s < count_slabs; s++) {
+    slab_offsets[s + 1] += slab_offsets[s];
+  }
+
+  std::vector<uint32_t> slab_faces(slab_offsets[count_slabs]);
+  {
+    std::vector<uint32_t> cursor(slab_offsets.begin(), slab_offsets.end() - 1);
+    for(uint32_t iface = 0; iface < count_faces; iface++) {
+      for(int s = face_slabs[iface].x(); s <= face_slabs[iface].y(); s++) {
+        slab_faces[cursor[s]++] = iface;
+      }
+    }
+  }
+
+  // the slabs go to a partial file that replaces the output only once it is complete, so a file
+  // mapped by this field is not truncated under it
+  const std::string partial_filepath = filepath + ".partial";
+  std::ofstream file(partial_filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", partial_filepath.c_str());
+    return false;
+  }
+
+  auto discard_partial_file = [&]() {
+    file.close();
+    std::error_code ec;
+    std::filesystem::remove(partial_filepath, ec);
+  };
+
+  if (grid.writeBinaryHeader(file) == false) {
+    SPDLOG_ERROR("Failed when writing the header to [{}]", partial_filepath.c_str());
+    discard_partial_file();
+    return false;
+  }
+
+  std::vector<uint32_t> face_ids;
+  GridVector<real_t> values;
+  for(int s = 0; s < count_slabs; s++) {
+    const int z_begin = s * slab_depth;
+    const int z_end = std::min(gridpoints_count.z(), z_begin + slab_depth);
+
+    face_ids.assign(slab_faces.begin() + slab_offsets[s], slab_faces.begin() + slab_offsets[s + 1]);
+    grid.generateSlab(TriangleMeshSurface(in_mesh), face_ids, z_begin, z_end, sign_mode, tree.get(), occupancy.get(), values);
+
+    file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(real_t));
+    if (!file.good()) {
+      SPDLOG_ERROR("Failed when writing slab [{}] to [{}]", s, partial_filepath.c_str());
+      discard_partial_file();
+      return false;
+    }
+
+    SPDLOG_DEBUG("Slab [{} of {}] with [{}] faces written", s + 1, count_slabs, face_ids.size());
+  }
+
+  file.close();
+  if (file.fail()) {
+    SPDLOG_ERROR("Failed when closing [{}]", partial_filepath.c_str());
+    discard_partial_file();
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::rename(partial_filepath, filepath, ec);
+  if (ec) {
+    SPDLOG_ERROR("Failed to move [{}] to [{}]: {}", partial_filepath.c_str(), filepath.c_str(), ec.message().c_str());
+    discard_partial_file();
+    return false;
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating out-of-core SDF = [{}.{:03}] seconds.",
+               duration_milliseconds.count() / 1000,
+               duration_milliseconds.count() % 1000);
+
+  // serve the queries from the file
+  return mapBinary(filepath);
+}
+
+bool SignedDistanceField::ComputeShardBounds(const AABB& global_bounds,
+                                             real_t voxel_size,
+                                             uint32_t shard_index,
+                                             uint32_t shard_count,
+                                             AABB& out_shard_bounds) {
+  if (voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  if (shard_index >= shard_count) {
+    SPDLOG_ERROR("The shard index [{}] must be less than the shards count [{}].", shard_index, shard_count);
+    return false;
+  }
+
+  const uint64_t count_layers = static_cast<uint64_t>(ComputeVoxelsCount(global_bounds.extent().z(), voxel_size)) + 1;
+  if (count_layers < shard_count) {
+    SPDLOG_ERROR("The grid has [{}] z layers and can not be split into [{}] shards.", count_layers, shard_count);
+    return false;
+  }
+
+  const int z_begin = static_cast<int>(count_layers * shard_index / shard_count);
+  const int z_end = static_cast<int>(count_layers * (shard_index + 1) / shard_count);
+
+  // same arithmetic as gridPointPosition so the shard grid points match the global ones
+  const vec3 lower = global_bounds.lower() + vec3(0.0, 0.0, static_cast<real_t>(z_begin) * voxel_size);
+
+  // every shard except the last one overlaps the first layer of the next shard
+  vec3 upper = global_bounds.upper();
+  if (shard_index + 1 < shard_count) {
+    upper.z() = global_bounds.lower().z() + static_cast<real_t>(z_end) * voxel_size;
+  }
+
+  out_shard_bounds = AABB(lower, upper);
+  return true;
+}
+
+bool SignedDistanceField::generateShard(const TriangleMesh& in_mesh,
+                                        const vec3& expansion,
+                                        real_t voxel_size,
+                                        uint32_t shard_index,
+                                        uint32_t shard_count,
+                                        SignMode sign_mode) {
+  if(validateGenerateArgs(in_mesh, voxel_size, sign_mode) == false) {
+    return false;
+  }
+
+  AABB global_bounds = in_mesh.bounds();
+  global_bounds.expand(expansion);
+
+  AABB shard_bounds;
+  if(ComputeShardBounds(global_bounds, voxel_size, shard_index, shard_count, shard_bounds) == false) {
+    return false;
+  }
+
+  // the shard is computed on a staged global grid, so its values match the in-core generation
+  // exactly, and the field keeps its values until the shard is complete
+  SignedDistanceField grid;
+  grid.bounds_ = global_bounds;
+  grid.voxel_size_ = voxel_size;
+
+  const int z_begin = static_cast<int>(std::round((shard_bounds.lower().z() - global_bounds.lower().z()) / voxel_size));
+  const int z_end = z_begin + ComputeVoxelsCount(shard_bounds.extent().z(), voxel_size) + 1;
+
+  SPDLOG_INFO("Shard [{} of {}] covers the z layers [{}, {})", shard_index + 1, shard_count, z_begin, z_end);
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  // the halo of the shard, all faces whose bands reach into its layers
+  std::vector<uint32_t> face_ids;
+  for(uint32_t iface = 0; iface < in_mesh.countFaces(); iface++) {
+    vec3i start, stop;
+    grid.computeFaceBand(in_mesh.halfFaceVertices(HalfFaceIndex::create(iface)), start, stop);
+    if (start.z() < z_end && stop.z() > z_begin) {
+      face_ids.push_back(iface);
+    }
+  }
+
+  SPDLOG_DEBUG("Shard [{} of {}] has [{}] faces in its halo", shard_index + 1, shard_count, face_ids.size());
+
+  // the scanlines run along x, so the occupancy grid of the shard layers alone is exact
+  SignedDistanceField layers;
+  layers.bounds_ = shard_bounds;
+  layers.voxel_size_ = voxel_size;
+
+  std::unique_ptr<WindingNumberTree> tree;
+  std::unique_ptr<OccupancyGrid> occupancy;
+  if(layers.prepareSignEvaluation(in_mesh, sign_mode, tree, occupancy) == false) {
+    return false;
+  }
+
+  GridVector<real_t> values;
+  grid.generateSlab(TriangleMeshSurface(in_mesh), face_ids, z_begin, z_end, sign_mode, tree.get(), occupancy.get(), values);
+
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    releaseMapping();
+    clearClosestFeatures();
+    bounds_ = shard_bounds;
+    voxel_size_ = voxel_size;
+    field_values_.swap(values);
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating SDF shard = [{}.{:03}] seconds.",
+               duration_milliseconds.count() / 1000,
+               duration_milliseconds.count() % 1000);
+
+  return true;
+}
+
+bool SignedDistanceField::validateGenerateArgs(const TriangleMesh& in_mesh,
+                                               real_t voxel_size,
+                                               SignMode sign_mode) const {
+  if(in_mesh.countFaces() == 0) {
+    SPDLOG_ERROR("The supplied mesh does not have any faces.");
+    return false;
+  }
+
+  if(sign_mode == kSignModePseudoNormals &&
+     (in_mesh.hasVertexPseudoNormals() == false ||
+      in_mesh.hasHalfEdgePseudoNormals() == false)) {
+    SPDLOG_ERROR("The pseudo normals for vertices and half-edges must be computed before generating the SDF");
+    return false;
+  }
+
+  if(voxel_size == 0.0) {
+    SPDLOG_ERROR("Voxel size can not be zero.");
+    return false;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::prepareSignEvaluation(const TriangleMesh& in_mesh,
+                                                SignMode sign_mode,
+                                                std::unique_ptr<WindingNumberTree>& out_tree,
+                                                std::unique_ptr<OccupancyGrid>& out_occupancy) const {
+  if (sign_mode == kSignModeWindingNumber) {
+    out_tree = std::make_unique<WindingNumberTree>();
+    if (out_tree->build(in_mesh) == false) {
+      return false;
+    }
+  } else if (sign_mode == kSignModeScanlineParity) {
+    out_occupancy = std::make_unique<OccupancyGrid>();
+    if (out_occupancy->generate(in_mesh, bounds_, voxel_size_) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::prepareSignEvaluation(const std::vector<vec3>& in_triangle_vertices,
+                                                SignMode sign_mode,
+                                                std::unique_ptr<WindingNumberTree>& out_tree,
+                                                std::unique_ptr<OccupancyGrid>& out_occupancy) const {
+  if (sign_mode == kSignModeWindingNumber) {
+    out_tree = std::make_unique<WindingNumberTree>();
+    if (out_tree->build(in_triangle_vertices) == false) {
+      return false;
+    }
+  } else if (sign_mode == kSignModeScanlineParity) {
+    out_occupancy = std::make_unique<OccupancyGrid>();
+    if (out_occupancy->generate(in_triangle_vertices, bounds_, voxel_size_) == false) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void SignedDistanceField::computeFaceBand(const std::array<vec3, 3>& in_face_vertices,
+                                          vec3i& out_start,
+                                          vec3i& out_stop) const {
+  const vec3i gridpoints_count = gridPointsCount();
+
+  // compute face bounding box and extend it by the width of the transition region
+  AABB face_aabb = ComputeTriangleAABB(in_face_vertices);
+  face_aabb.expand(vec3(2.0 * voxel_size_, 2.0 * voxel_size_, 2.0 * voxel_size_));
+
+  const vec3 face_aabb_lower_local = (face_aabb.lower() - bounds_.lower()) / voxel_size_;
+
+  out_start = vec3i(std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.x()))),
+                    std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.y()))),
+                    std::max(0, static_cast<int>(std::floor(face_aabb_lower_local.z()))));
+
+  // the band includes the grid points on both sides of the expanded face bounding box
+  const vec3 face_aabb_upper_local = (face_aabb.upper() - bounds_.lower()) / voxel_size_;
+  out_stop = vec3i(std::min(gridpoints_count.x(), static_cast<int>(std::floor(face_aabb_upper_local.x())) + 1),
+                   std::min(gridpoints_count.y(), static_cast<int>(std::floor(face_aabb_upper_local.y())) + 1),
+                   std::min(gridpoints_count.z(), static_cast<int>(std::floor(face_aabb_upper_local.z())) + 1));
+}
+
+template <typename SurfaceT>
+void SignedDistanceField::generateSlab(const SurfaceT& in_surface,
+                                       const std::vector<uint32_t>& in_face_ids,
+                                       int z_begin,
+                                       int z_end,
+                                       SignMode sign_mode,
+                                       const WindingNumberTree* tree,
+                                       const OccupancyGrid* occupancy,
+                                       GridVector<real_t>& out_values,
+                                       GridVector<uint32_t>* out_closest_face_ids,
+                                       GridVector<vec3>* out_closest_point_offsets) const {
+  const vec3i gridpoints_count = gridPointsCount();
+  const uint64_t slab_offset = static_cast<uint64_t>(z_begin) * gridpoints_count.x() * gridpoints_count.y();
+  const uint64_t slab_size = static_cast<uint64_t>(z_end - z_begin) * gridpoints_count.x() * gridpoints_count.y();
+
+  // the magnitudes are computed in place of the output values
+  GridVector<real_t>& magnitudes = out_values;
+  GridVector<real_t> signs;
+
+  // initialize the voxel grid by settings all values to +infinity, in parallel so the pages are
+  // not all written by one thread
+  ParallelAssign(magnitudes, slab_size, std::numeric_limits<real_t>::max());
+  ParallelAssign(signs, slab_size, static_cast<real_t>(0.0));
+
+  if (out_closest_face_ids != nullptr) {
+    ParallelAssign(*out_closest_face_ids, slab_size, kInvalidFaceId);
+  }
+
+  if (out_closest_point_offsets != nullptr) {
+    ParallelAssign(*out_closest_point_offsets, slab_size, vec3(0.0, 0.0, 0.0));
+  }
+
+  const uint32_t count_faces = static_cast<uint32_t>(in_face_ids.size());
+
+  static const int kProgressReportPeriodSeconds = 5;
+
+  // start timer
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  uint64_t last_report_timestamp_seconds = 0;
+
+  for(uint32_t iface = 0; iface < count_faces; iface++) {
+    auto tc = std::chrono::high_resolution_clock::now();
+    auto current_duration_seconds = std::chrono::duration_cast<std::chrono::seconds>(tc - t1);
+    if (current_duration_seconds.count() % kProgressReportPeriodSeconds == 0 &&
+        last_report_timestamp_seconds != current_duration_seconds.count()) {
+      const double progress = (static_cast<double>(iface + 1) * 100.0) / static_cast<double>(count_faces);
+      SPDLOG_INFO("progress [{} of {}], {:.2f} %", iface + 1, count_faces, progress);
+      last_report_timestamp_seconds = current_duration_seconds.count();
+    }
+
+    const auto hface_vertices = in_surface.faceVertices(in_face_ids[iface]);
+
+    vec3i start, stop;
+    computeFaceBand(hface_vertices, start, stop);
+
+    // clip the band to the slab
+    const int start_x = start.x();
+    const int start_y = start.y();
+    const int start_z = std::max(z_begin, start.z());
+    const int stop_x = stop.x();
+    const int stop_y = stop.y();
+    const int stop_z = std::min(z_end, stop.z());
+
+    // the face normal and the pseudo normals of the edges and the vertices of the face
+    std::array<vec3, 7> pseudo_normals;
+    if (sign_mode == kSignModePseudoNormals) {
+      in_surface.facePseudoNormals(in_face_ids[iface], pseudo_normals);
+    }
+
+    // loop over all voxels and compute the distance to all voxel points
+    for(int z = start_z; z < stop_z; z++) {
+      for(int y = start_y; y < stop_y; y++) {
+        for(int x = start_x; x < stop_x; x++) {
+
+          const vec3i coords = vec3i(x, y, z);
+          const vec3 p = gridPointPosition(coords);
+          const uint64_t gridpoint_id = gridPointId(coords) - slab_offset;
+          const real_t prev_dist = magnitudes[gridpoint_id];
+
+          vec3 q(0.0, 0.0, 0.0);
+
+          ClosestTriangleFeature closest_feature;
+
+          const real_t dist = PointTriangleDistance(p,
+                                                    hface_vertices[0],
+                                                    hface_vertices[1],
+                                                    hface_vertices[2],
+                                                    q,
+                                                    closest_feature);
+
+          // the first face at the smallest distance is the closest one
+          if (dist < prev_dist) {
+            if (out_closest_face_ids != nullptr) {
+              (*out_closest_face_ids)[gridpoint_id] = in_face_ids[iface];
+            }
+
+            if (out_closest_point_offsets != nullptr) {
+              (*out_closest_point_offsets)[gridpoint_id] = q - p;
+            }
+          }
+
+          if (sign_mode != kSignModePseudoNormals) {
+            // the sign is evaluated after the distance pass
+            if (dist < prev_dist) {
+              magnitudes[gridpoint_id] = dist;
+            }
+          } else if ((dist < prev_dist) || FuzzyCompare(dist, prev_dist) == true) {
+            // fetch normal at the closest feature to q
+            const vec3& pseudo_normal = FeaturePseudoNormal(pseudo_normals, closest_feature);
+
+            // directional vector from the intersection point q on the triangle, and the grid point p
+            const vec3 dir_vec_qp = p - q;
+
+            if (dist < prev_dist) {
+              magnitudes[gridpoint_id] = dist;
+
+              // replace sign
+              signs[gridpoint_id] = dir_vec_qp.dot(pseudo_normal);
+            } else if (FuzzyCompare(dist, prev_dist) == true) {
+              magnitudes[gridpoint_id] = dist;
+
+              // accumulate sign
+              signs[gridpoint_id] += dir_vec_qp.dot(pseudo_normal);
+            }
+          } // if dist
+        }
+      }
+    }
+  } // end for face
+
+  if (tree != nullptr) {
+    // only the grid points inside the band have been touched by the distance pass
+    for(int z = z_begin; z < z_end; z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords = vec3i(x, y, z);
+          const uint64_t gridpoint_id = gridPointId(coords) - slab_offset;
+          if (magnitudes[gridpoint_id] == std::numeric_limits<real_t>::max()) {
+            continue;
+          }
+
+          const real_t w = tree->windingNumber(gridPointPosition(coords));
+          signs[gridpoint_id] = static_cast<real_t>(0.5) - w;
+        }
+      }
+    }
+  }
+
+  if (occupancy != nullptr) {
+    // the occupancy grid may start at a later z layer, when it only covers the layers of a shard
+    const int occupancy_z_offset = static_cast<int>(std::round((occupancy->bounds().lower().z() - bounds_.lower().z()) / voxel_size_));
+    for(int z = z_begin; z < z_end; z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords = vec3i(x, y, z);
+          signs[gridPointId(coords) - slab_offset] = occupancy->isOccupied(vec3i(x, y, z - occupancy_z_offset)) ? -1.0 : 1.0;
+        }
+      }
+    }
+  }
+
+  // apply the signs to the magnitudes
+  for (uint64_t i=0; i < slab_size; ++i) {
+    if (signs[i] < 0) {
+      magnitudes[i] = - magnitudes[i];
+    }
+  }
+
+  // the scanline parity already signs the grid points off the band
+  if (occupancy == nullptr) {
+    SignOffBandRows(gridpoints_count, z_end - z_begin, magnitudes.data());
+  }
+}
+
+bool SignedDistanceField::generateByDistanceTransform(const TriangleMesh& in_mesh,
+                                                      const vec3& expansion,
+                                                      real_t voxel_size) {
+  if(in_mesh.countFaces() == 0) {
+    SPDLOG_ERROR("The supplied mesh does not have any faces.");
+    return false;
+  }
+
+  if(voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  // computes a bounding box that contains the triangle mesh, the field takes it only on success
+  AABB bounds = in_mesh.bounds();
+  bounds.expand(expansion);
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  OccupancyGrid occupancy;
+  if (occupancy.generate(in_mesh, bounds, voxel_size) == false) {
+    return false;
+  }
+
+  const uint64_t count_gridpoints = occupancy.totalGridPointsCount();
+  const uint64_t count_occupied = occupancy.countOccupied();
+  if (count_occupied == 0 || count_occupied == count_gridpoints) {
+    SPDLOG_ERROR("The voxelized mesh has no inside or no outside grid points. Check that the mesh is closed.");
+    return false;
+  }
+
+  const vec3i gridpoints_count = occupancy.gridPointsCount();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+
+  // outside points measure the distance to the inside points and vice versa
+  std::vector<real_t> outside_sq_dist(count_gridpoints);
+  std::vector<real_t> inside_sq_dist(count_gridpoints);
+
+  ParallelFor(0, gridpoints_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+      for (uint64_t y = 0; y < ny; y++) {
+        for (uint64_t x = 0; x < nx; x++) {
+          const uint64_t id = z * nx * ny + y * nx + x;
+          const bool inside = occupancy.isOccupied(vec3i(x, y, z));
+          outside_sq_dist[id] = inside ? 0.0 : kDistanceTransformInfinity;
+          inside_sq_dist[id] = inside ? kDistanceTransformInfinity : 0.0;
+        }
+      }
+    }
+  });
+
+  if (SquaredDistanceTransform(gridpoints_count, outside_sq_dist) == false ||
+      SquaredDistanceTransform(gridpoints_count, inside_sq_dist) == false) {
+    SPDLOG_ERROR("The distance transform of the voxelized mesh failed.");
+    return false;
+  }
+
+  GridVector<real_t> values;
+  values.resize(count_gridpoints);
+  const real_t half_voxel = static_cast<real_t>(0.5) * voxel_size;
+  ParallelFor(0, count_gridpoints, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+      if (inside_sq_dist[i] == 0.0) {
+        values[i] = std::sqrt(outside_sq_dist[i]) * voxel_size - half_voxel;
+      } else {
+        values[i] = half_voxel - std::sqrt(inside_sq_dist[i]) * voxel_size;
+      }
+    }
+  }, 4096);
+
+  // save the grid and the final field values
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    releaseMapping();
+    clearClosestFeatures();
+    bounds_ = bounds;
+    voxel_size_ = voxel_size;
+    field_values_.swap(values);
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating SDF by distance transform = [{}.{:03}] seconds.",
+               duration_milliseconds.count() / 1000,
+               duration_milliseconds.count() % 1000);
+
+  return true;
+}
+
+bool SignedDistanceField::generateFromPointCloud(const std::vector<vec3>& in_positions,
+                                                 const std::vector<vec3>& in_normals,
+                                                 const vec3& expansion,
+                                                 real_t voxel_size,
+                                                 real_t smoothing_radius) {
+  if (in_positions.empty() || in_positions.size() != in_normals.size()) {
+    SPDLOG_ERROR("The point cloud has [{}] positions and [{}] normals.", in_positions.size(), in_normals.size());
+    return false;
+  }
+
+  if (voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  const real_t radius = (smoothing_radius > 0.0) ? smoothing_radius : 2.0 * voxel_size;
+  const uint32_t count_points = static_cast<uint32_t>(in_positions.size());
+
+  // the field takes the grid only on success
+  AABB bounds(in_positions[0], in_positions[0]);
+  for (const vec3& x : in_positions) {
+    bounds = AABB(bounds.lower().cwiseMin(x), bounds.upper().cwiseMax(x));
+  }
+  bounds.expand(expansion);
+
+  // the cell coordinates are packed in 21 bits per axis
+  if ((bounds.extent() / radius).maxCoeff() >= static_cast<real_t>(1 << 21)) {
+    SPDLOG_ERROR("The smoothing radius [{}] is too small for the extent of the point cloud.", radius);
+    return false;
+  }
+
+  const vec3 extent = bounds.extent();
+  const vec3i gridpoints_count(ComputeVoxelsCount(extent.x(), voxel_size) + 1,
+                               ComputeVoxelsCount(extent.y(), voxel_size) + 1,
+                               ComputeVoxelsCount(extent.z(), voxel_size) + 1);
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  const vec3 lower = bounds.lower();
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  // hash the points into a uniform grid of cells as large as the smoothing radius
+  auto cell_coords = [&](const vec3& x) {
+    const vec3 local = (x - lower) / radius;
+    return vec3i(static_cast<int>(std::floor(local.x())),
+                 static_cast<int>(std::floor(local.y())),
+                 static_cast<int>(std::floor(local.z())));
+  };
+
+  auto cell_key = [](const vec3i& c) {
+    return (static_cast<uint64_t>(c.z()) << 42) | (static_cast<uint64_t>(c.y()) << 21) | static_cast<uint64_t>(c.x());
+  };
+
+  std::vector<std::pair<uint64_t, uint32_t>> keyed_points(count_points);
+  for (uint32_t i = 0; i < count_points; i++) {
+    keyed_points[i] = std::make_pair(cell_key(cell_coords(in_positions[i])), i);
+  }
+  std::sort(keyed_points.begin(), keyed_points.end());
+
+  std::vector<vec3> positions(count_points);
+  std::vector<vec3> normals(count_points);
+  std::vector<uint64_t> cell_keys;
+  std::vector<uint32_t> cell_offsets;
+  for (uint32_t i = 0; i < count_points; i++) {
+    positions[i] = in_positions[keyed_points[i].second];
+    normals[i] = in_normals[keyed_points[i].second];
+    if (cell_keys.empty() || cell_keys.back() != keyed_points[i].first) {
+      cell_keys.push_back(keyed_points[i].first);
+      cell_offsets.push_back(i);
+    }
+  }
+  cell_offsets.push_back(count_points);
+  keyed_points.clear();
+  keyed_points.shrink_to_fit();
+
+  // mark the bricks within the smoothing radius of any point
+  const vec3i bricks_count = (gridpoints_count + vec3i(kPointCloudBrickSize - 1, kPointCloudBrickSize - 1, kPointCloudBrickSize - 1)) / kPointCloudBrickSize;
+  std::vector<uint8_t> active_bricks(static_cast<uint64_t>(bricks_count.x()) * bricks_count.y() * bricks_count.z(), 0);
+  for (uint32_t i = 0; i < count_points; i++) {
+    const vec3 lower_local = (positions[i] - vec3(radius, radius, radius) - lower) / voxel_size;
+    const vec3 upper_local = (positions[i] + vec3(radius, radius, radius) - lower) / voxel_size;
+
+    vec3i brick_start, brick_stop;
+    for (int axis = 0; axis < 3; axis++) {
+      const int start = std::max(0, static_cast<int>(std::floor(lower_local[axis])));
+      const int stop = std::min(gridpoints_count[axis] - 1, static_cast<int>(std::floor(upper_local[axis])) + 1);
+      brick_start[axis] = start / kPointCloudBrickSize;
+      brick_stop[axis] = stop / kPointCloudBrickSize;
+    }
+
+    for (int bz = brick_start.z(); bz <= brick_stop.z(); bz++) {
+      for (int by = brick_start.y(); by <= brick_stop.y(); by++) {
+        for (int bx = brick_start.x(); bx <= brick_stop.x(); bx++) {
+          active_bricks[(static_cast<uint64_t>(bz) * bricks_count.y() + by) * bricks_count.x() + bx] = 1;
+        }
+      }
+    }
+  }
+
+  std::vector<uint64_t> brick_ids;
+  for (uint64_t b = 0; b < active_bricks.size(); b++) {
+    if (active_bricks[b] != 0) {
+      brick_ids.push_back(b);
+    }
+  }
+
+  SPDLOG_DEBUG("Point cloud of [{}] points in [{}] cells touches [{}] of [{}] bricks",
+               count_points, cell_keys.size(), brick_ids.size(), active_bricks.size());
+
+  GridVector<real_t> values;
+  ParallelAssign(values, nx * ny * static_cast<uint64_t>(gridpoints_count.z()), std::numeric_limits<real_t>::max());
+
+  ParallelFor(0, brick_ids.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t b = chunk_begin; b < chunk_end; b++) {
+      const uint64_t brick_id = brick_ids[b];
+      const vec3i brick(static_cast<int>(brick_id % bricks_count.x()),
+                        static_cast<int>((brick_id / bricks_count.x()) % bricks_count.y()),
+                        static_cast<int>(brick_id / (static_cast<uint64_t>(bricks_count.x()) * bricks_count.y())));
+      const vec3i start = brick * kPointCloudBrickSize;
+      const vec3i stop = (start + vec3i(kPointCloudBrickSize, kPointCloudBrickSize, kPointCloudBrickSize)).cwiseMin(gridpoints_count);
+
+      for (int z = start.z(); z < stop.z(); z++) {
+        for (int y = start.y(); y < stop.y(); y++) {
+          for (int x = start.x(); x < stop.x(); x++) {
+            // same arithmetic as gridPointPosition and gridPointId
+            const vec3 p = lower + vec3(static_cast<real_t>(x) * voxel_size,
+                                        static_cast<real_t>(y) * voxel_size,
+                                        static_cast<real_t>(z) * voxel_size);
+            const vec3i cell = cell_coords(p);
+
+            // Wendland weighted average of the distances to the tangent planes of the neighbors
+            real_t sum_weights = 0.0;
+            real_t sum_distances = 0.0;
+            for (int dz = -1; dz <= 1; dz++) {
+              for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                  const vec3i neighbor = cell + vec3i(dx, dy, dz);
+                  if (neighbor.minCoeff() < 0) {
+                    continue;
+                  }
+
+                  auto it = std::lower_bound(cell_keys.begin(), cell_keys.end(), cell_key(neighbor));
+                  if (it == cell_keys.end() || *it != cell_key(neighbor)) {
+                    continue;
+                  }
+
+                  const uint64_t c = static_cast<uint64_t>(it - cell_keys.begin());
+                  for (uint32_t i = cell_offsets[c]; i < cell_offsets[c + 1]; i++) {
+                    const vec3 d = p - positions[i];
+                    const real_t t = d.norm() / radius;
+                    if (t >= 1.0) {
+                      continue;
+                    }
+
+                    const real_t w = std::pow(1.0 - t, 4) * (4.0 * t + 1.0);
+                    sum_weights += w;
+                    sum_distances += w * normals[i].dot(d);
+                  }
+                }
+              }
+            }
+
+            if (sum_weights > 0.0) {
+              values[(static_cast<uint64_t>(z) * ny + y) * nx + x] = sum_distances / sum_weights;
+            }
+          }
+        }
+      }
+    }
+  });
+
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    releaseMapping();
+    clearClosestFeatures();
+    bounds_ = bounds;
+    voxel_size_ = voxel_size;
+    field_values_.swap(values);
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Total time spent in generating SDF from [{}] points = [{}.{:03}] seconds.",
+               count_points,
+               duration_milliseconds.count() / 1000,
+               duration_milliseconds.count() % 1000);
+
+  return true;
+}
+
+real_t SignedDistanceField::fieldValue(const vec3& p) const {
+  // field is zero outside the bounding box
+  if (bounds_.contains(p) == false) {
+    return 0.0;
+  }
+
+  // find voxel coordinates
+
+  // map p to the local coordinate system of the voxel grid
+  vec3 q = (p - bounds_.lower()) / voxel_size_;
+
+  // voxel coords
+  const int ix = static_cast<int>(std::floor(q.x()));
+  const int iy = static_cast<int>(std::floor(q.y()));
+  const int iz = static_cast<int>(std::floor(q.z()));
+
+  // setup interpolators
+  const real_t tx = q.x() - static_cast<real_t>(ix);
+  const real_t ty = q.y() - static_cast<real_t>(iy);
+  const real_t tz = q.z() - static_cast<real_t>(iz);
+
+  //vXYZ
+  const real_t v000 = fieldValue(vec3i(ix, iy, iz));
+  const real_t v001 = fieldValue(vec3i(ix, iy, iz + 1));
+  const real_t v010 = fieldValue(vec3i(ix, iy + 1, iz));
+  const real_t v011 = fieldValue(vec3i(ix, iy + 1, iz + 1));
+  const real_t v100 = fieldValue(vec3i(ix + 1, iy, iz));
+  const real_t v101 = fieldValue(vec3i(ix + 1, iy, iz + 1));
+  const real_t v110 = fieldValue(vec3i(ix + 1, iy + 1, iz));
+  const real_t v111 = fieldValue(vec3i(ix + 1, iy + 1, iz + 1));
+
+  real_t result = (1 - tz) * ((1 - ty) * (v000 * (1 - tx) + v100 * tx) +
+                                   ty  * (v010 * (1 - tx) + v110 * tx)) +
+                  tz * ((1 - ty) * (v001 * (1 - tx) + v101 * tx) +
+                        ty  * (v011 * (1 - tx) + v111 * tx));
+
+  return result;
+}
+
+real_t SignedDistanceField::sampleFieldValue(const vec3& p) const {
+  return interpolateTrilinear(p, std::numeric_limits<real_t>::max());
+}
+
+bool SignedDistanceField::combine(const SignedDistanceField& rhs,
+                                  CsgOperation op,
+                                  real_t blend_radius) {
+  if (countFieldValues() == 0 || rhs.countFieldValues() == 0) {
+    SPDLOG_ERROR("Both fields must be initialized before combining them.");
+    return false;
+  }
+
+  if (blend_radius < 0.0) {
+    SPDLOG_ERROR("The blend radius can not be negative.");
+    return false;
+  }
+
+  // combining a field with itself reads each value before it is overwritten
+  std::unique_lock<std::mutex> lk(field_values_mutex_, std::defer_lock);
+  std::unique_lock<std::mutex> rhs_lk(rhs.field_values_mutex_, std::defer_lock);
+  if (this == &rhs) {
+    lk.lock();
+  } else {
+    std::lock(lk, rhs_lk);
+  }
+
+  // the closest faces of the combined field are unknown
+  clearClosestFeatures();
+
+  // the values are overwritten in place
+  if (mapped_address_ != nullptr) {
+    const real_t* mapped_values = fieldValuesData();
+    field_values_.assign(mapped_values, mapped_values + countFieldValues());
+    releaseMapping();
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  const vec3i gridpoints_count = gridPointsCount();
+  const vec3i rhs_gridpoints_count = rhs.gridPointsCount();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  const uint64_t rhs_nx = static_cast<uint64_t>(rhs_gridpoints_count.x());
+  const uint64_t rhs_ny = static_cast<uint64_t>(rhs_gridpoints_count.y());
+
+  // the grid points coincide when the voxel sizes match and the grids are shifted by whole voxels
+  const vec3 offset_local = (bounds_.lower() - rhs.bounds_.lower()) / rhs.voxel_size_;
+  const vec3i offset(static_cast<int>(std::round(offset_local.x())),
+                     static_cast<int>(std::round(offset_local.y())),
+                     static_cast<int>(std::round(offset_local.z())));
+  const bool aligned = FuzzyCompare(voxel_size_, rhs.voxel_size_) &&
+                       (offset_local - offset.cast<real_t>()).cwiseAbs().maxCoeff() <= 1e-6;
+
+  SPDLOG_DEBUG("Combining fields of [{}] and [{}] grid points, aligned = [{}]",
+               totalGridPointsCount(), rhs.totalGridPointsCount(), aligned);
+
+  const real_t kOutsideValue = std::numeric_limits<real_t>::max();
+  const real_t* rhs_values = rhs.fieldValuesData();
+  real_t* values = field_values_.data();
+
+  ParallelFor(0, gridpoints_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+      for (uint64_t y = 0; y < ny; y++) {
+        for (uint64_t x = 0; x < nx; x++) {
+          const uint64_t id = (z * ny + y) * nx + x;
+
+          real_t rhs_value = kOutsideValue;
+          if (aligned) {
+            const vec3i rhs_coords = vec3i(x, y, z) + offset;
+            if (isValidGridPointCoords(rhs_coords, rhs_gridpoints_count)) {
+              rhs_value = rhs_values[(rhs_coords.z() * rhs_ny + rhs_coords.y()) * rhs_nx + rhs_coords.x()];
+            }
+          } else {
+            const vec3 p = bounds_.lower() + voxel_size_ * vec3(static_cast<real_t>(x),
+                                                                static_cast<real_t>(y),
+                                                                static_cast<real_t>(z));
+            rhs_value = rhs.interpolateTrilinear(p, kOutsideValue);
+          }
+
+          values[id] = CombineValues(values[id], rhs_value, op, blend_radius);
+        }
+      }
+    }
+  });
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_DEBUG("Combined the fields in [{}] ms", duration_milliseconds.count());
+
+  return true;
+}
+
+real_t SignedDistanceField::interpolateTrilinear(const vec3& p, real_t outside_value) const {
+  vec3i cell;
+  vec3 t;
+  if (locateCell(p, cell, t) == false) {
+    return outside_value;
+  }
+
+  const vec3i gridpoints_count = gridPointsCount();
+  int i0[3];
+  int i1[3];
+  for (int axis = 0; axis < 3; axis++) {
+    i0[axis] = cell[axis];
+    i1[axis] = std::min(cell[axis] + 1, gridpoints_count[axis] - 1);
+  }
+
+  const real_t* values = fieldValuesData();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  auto value = [&](int x, int y, int z) {
+    return values[(static_cast<uint64_t>(z) * ny + static_cast<uint64_t>(y)) * nx + static_cast<uint64_t>(x)];
+  };
+
+  // grid points outside the band hold the largest value, only the corners inside the band are blended
+  const real_t kMaxValue = std::numeric_limits<real_t>::max();
+
+  real_t sum_weights = 0.0;
+  real_t sum_values = 0.0;
+  real_t max_weight = -1.0;
+  real_t dominant_value = 0.0;
+  for (int corner = 0; corner < 8; corner++) {
+    const int cx = (corner & 1) ? i1[0] : i0[0];
+    const int cy = (corner & 2) ? i1[1] : i0[1];
+    const int cz = (corner & 4) ? i1[2] : i0[2];
+    const real_t weight = ((corner & 1) ? t[0] : 1 - t[0]) *
+                          ((corner & 2) ? t[1] : 1 - t[1]) *
+                          ((corner & 4) ? t[2] : 1 - t[2]);
+    const real_t v = value(cx, cy, cz);
+
+    if (weight > max_weight) {
+      max_weight = weight;
+      dominant_value = v;
+    }
+
+    if (std::fabs(v) < kMaxValue) {
+      sum_weights += weight;
+      sum_values += weight * v;
+    }
+  }
+
+  if (sum_weights <= 0.0) {
+    return dominant_value;
+  }
+
+  return sum_values / sum_weights;
+}
+
+real_t SignedDistanceField::interpolateTricubic(const vec3& p, real_t outside_value) const {
+  vec3i cell;
+  vec3 t;
+  if (locateCell(p, cell, t) == false) {
+    return outside_value;
+  }
+
+  // Catmull-Rom weights and the clamped indices of the 4 grid points along each axis
+  const vec3i gridpoints_count = gridPointsCount();
+  real_t weights[3][4];
+  int indices[3][4];
+  for (int axis = 0; axis < 3; axis++) {
+    const real_t s = t[axis];
+    const real_t s2 = s * s;
+    const real_t s3 = s2 * s;
+    weights[axis][0] = static_cast<real_t>(0.5) * (-s3 + 2 * s2 - s);
+    weights[axis][1] = static_cast<real_t>(0.5) * (3 * s3 - 5 * s2 + 2);
+    weights[axis][2] = static_cast<real_t>(0.5) * (-3 * s3 + 4 * s2 + s);
+    weights[axis][3] = static_cast<real_t>(0.5) * (s3 - s2);
+
+    for (int k = 0; k < 4; k++) {
+      indices[axis][k] = std::clamp(cell[axis] - 1 + k, 0, gridpoints_count[axis] - 1);
+    }
+  }
+
+  const real_t* values = fieldValuesData();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  const real_t kMaxValue = std::numeric_limits<real_t>::max();
+
+  real_t result = 0.0;
+  for (int k = 0; k < 4; k++) {
+    for (int j = 0; j < 4; j++) {
+      const uint64_t row = (static_cast<uint64_t>(indices[2][k]) * ny + static_cast<uint64_t>(indices[1][j])) * nx;
+      const real_t wjk = weights[1][j] * weights[2][k];
+      for (int i = 0; i < 4; i++) {
+        const real_t v = values[row + static_cast<uint64_t>(indices[0][i])];
+
+        // the spline overshoots next to grid points outside the band
+        if (std::fabs(v) == kMaxValue) {
+          return interpolateTrilinear(p, outside_value);
+        }
+
+        result += weights[0][i] * wjk * v;
+      }
+    }
+  }
+
+  return result;
+}
+
+bool SignedDistanceField::locateCell(const vec3& p, vec3i& out_cell, vec3& out_t) const {
+  static const real_t kTolerance = 1e-6;
+
+  const vec3i gridpoints_count = gridPointsCount();
+  const vec3 q = (p - bounds_.lower()) / voxel_size_;
+
+  for (int axis = 0; axis < 3; axis++) {
+    const int n = gridpoints_count[axis];
+    if (q[axis] < -kTolerance || q[axis] > static_cast<real_t>(n - 1) + kTolerance) {
+      return false;
+    }
+
+    // the last cell also serves the grid points on the upper face
+    out_cell[axis] = std::clamp(static_cast<int>(std::floor(q[axis])), 0, std::max(0, n - 2));
+    out_t[axis] = std::clamp(q[axis] - static_cast<real_t>(out_cell[axis]), static_cast<real_t>(0.0), static_cast<real_t>(1.0));
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::resample(const SignedDistanceField& source,
+                                   const AABB& bounds,
+                                   real_t voxel_size,
+                                   Interpolation interpolation,
+                                   const mat4& transform) {
+  if (source.countFieldValues() == 0) {
+    SPDLOG_ERROR("The source field must be initialized before resampling it.");
+    return false;
+  }
+
+  if (voxel_size <= 0.0) {
+    SPDLOG_ERROR("Voxel size must be positive.");
+    return false;
+  }
+
+  // a rigid transform preserves the distances
+  const Eigen::Matrix<real_t, 3, 3> rotation = transform.block<3, 3>(0, 0);
+  const vec3 translation = transform.block<3, 1>(0, 3);
+  if ((rotation.transpose() * rotation - Eigen::Matrix<real_t, 3, 3>::Identity()).cwiseAbs().maxCoeff() > 1e-6 ||
+      rotation.determinant() < 0.0 ||
+      transform.row(3).transpose().isApprox(vec4(0.0, 0.0, 0.0, 1.0)) == false) {
+    SPDLOG_ERROR("The resampling transform must be rigid.");
+    return false;
+  }
+
+  // resampling a field onto itself reads from a snapshot
+  if (this == &source) {
+    const SignedDistanceField snapshot(source);
+    return resample(snapshot, bounds, voxel_size, interpolation, transform);
+  }
+
+  SignedDistanceField target;
+  target.bounds_ = bounds;
+  target.voxel_size_ = voxel_size;
+
+  const vec3i gridpoints_count = target.gridPointsCount();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  const uint64_t nz = static_cast<uint64_t>(gridpoints_count.z());
+
+  GridVector<real_t> values(target.totalGridPointsCount());
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  {
+    std::lock_guard<std::mutex> lk(source.field_values_mutex_);
+
+    // cubic tiles keep the source grid points of a tile in cache
+    static const uint64_t kTileSize = 16;
+    const uint64_t tiles_x = (nx + kTileSize - 1) / kTileSize;
+    const uint64_t tiles_y = (ny + kTileSize - 1) / kTileSize;
+    const uint64_t tiles_z = (nz + kTileSize - 1) / kTileSize;
+
+    const real_t kOutsideValue = std::numeric_limits<real_t>::max();
+    const vec3 lower = bounds.lower();
+
+    ParallelFor(0, tiles_x * tiles_y * tiles_z, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for (uint64_t tile = chunk_begin; tile < chunk_end; tile++) {
+        const uint64_t x0 = (tile % tiles_x) * kTileSize;
+        const uint64_t y0 = ((tile / tiles_x) % tiles_y) * kTileSize;
+        const uint64_t z0 = (tile / (tiles_x * tiles_y)) * kTileSize;
+
+        for (uint64_t z = z0; z < std::min(nz, z0 + kTileSize); z++) {
+          for (uint64_t y = y0; y < std::min(ny, y0 + kTileSize); y++) {
+            for (uint64_t x = x0; x < std::min(nx, x0 + kTileSize); x++) {
+              const vec3 p = lower + voxel_size * vec3(static_cast<real_t>(x),
+                                                       static_cast<real_t>(y),
+                                                       static_cast<real_t>(z));
+              const vec3 source_p = rotation * p + translation;
+
+              values[(z * ny + y) * nx + x] = (interpolation == kInterpolationTricubic) ?
+                                              source.interpolateTricubic(source_p, kOutsideValue) :
+                                              source.interpolateTrilinear(source_p, kOutsideValue);
+            }
+          }
+        }
+      }
+    });
+  }
+
+  releaseMapping();
+  clearClosestFeatures();
+
+  bounds_ = bounds;
+  voxel_size_ = voxel_size;
+
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    field_values_.swap(values);
+  }
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Resampled [{}] grid points in [{}] ms", totalGridPointsCount(), duration_milliseconds.count());
+
+  return true;
+}
+
+real_t SignedDistanceField::fieldValue(const vec3i& coords) const {
+  // gridPointId will assert coords
+  const uint64_t gridpoint_id = gridPointId(coords);
 
   real_t field_value = 0.0;
 
   {
     std::lock_guard<std::mutex> lk(field_values_mutex_);
-    field_value = field_values_[gridpoint_id];
+    field_value = fieldValuesData()[gridpoint_id];
   }
 
   return field_value;
 }
 
+bool SignedDistanceField::extractIsoSurface(std::vector<vec3>& out_vertices,
+                                            std::vector<vec3i>& out_faces,
+                                            real_t iso_value) const {
+  out_vertices.clear();
+  out_faces.clear();
+
+  const vec3i gridpoints_count = gridPointsCount();
+  if (gridpoints_count.minCoeff() < 2) {
+    SPDLOG_ERROR("The field needs at least two grid points along each axis to extract a surface");
+    return false;
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  const real_t* values = fieldValuesData();
+  const vec3 lower = bounds_.lower();
+
+  const int count_layers = gridpoints_count.z() - 1;
+  const int count_slabs = (count_layers + kMarchingCubesSlabLayers - 1) / kMarchingCubesSlabLayers;
+  std::vector<MarchingCubesSlab> slabs(count_slabs);
+  ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t s = chunk_begin; s < chunk_end; s++) {
+      const int z_begin = static_cast<int>(s) * kMarchingCubesSlabLayers;
+      const int z_end = std::min(z_begin + kMarchingCubesSlabLayers, count_layers);
+      ExtractMarchingCubesSlab(values, gridpoints_count, lower, voxel_size_, iso_value,
+                               z_begin, z_end, s + 1 == static_cast<uint64_t>(count_slabs), slabs[s]);
+    }
+  });
+
+  // the vertices of each slab follow those of the slabs below it
+  std::vector<uint64_t> vertex_offsets(count_slabs + 1, 0);
+  std::vector<uint64_t> face_offsets(count_slabs + 1, 0);
+  for (int s = 0; s < count_slabs; s++) {
+    vertex_offsets[s + 1] = vertex_offsets[s] + slabs[s].vertices.size();
+    face_offsets[s + 1] = face_offsets[s] + slabs[s].face_refs.size() / 3;
+  }
+
+  // stitch the top layer of every slab to the bottom layer of the next one, creating the vertices
+  // that only the lower slab uses
+  std::vector<vec3> stitched_vertices;
+  for (int s = 0; s + 1 < count_slabs; s++) {
+    const int z_top = (s + 1) * kMarchingCubesSlabLayers;
+    const uint64_t layer_size = static_cast<uint64_t>(gridpoints_count.x()) * static_cast<uint64_t>(gridpoints_count.y());
+    std::vector<uint32_t>& next_bottom_edges = slabs[s + 1].bottom_edges;
+    for (uint64_t position : slabs[s].foreign_refs) {
+      uint64_t& ref = slabs[s].face_refs[position];
+      const uint64_t key = ref & ~kForeignVertexFlag;
+      uint64_t vertex_id = 0;
+      if (next_bottom_edges[key] != kInvalidVertexId) {
+        vertex_id = vertex_offsets[s + 1] + next_bottom_edges[key];
+      } else {
+        vertex_id = vertex_offsets[count_slabs] + stitched_vertices.size();
+        next_bottom_edges[key] = static_cast<uint32_t>(vertex_id - vertex_offsets[s + 1]);
+        const int axis = static_cast<int>(key / layer_size);
+        const uint64_t xy = key % layer_size;
+        const vec3i coords(static_cast<int>(xy % gridpoints_count.x()), static_cast<int>(xy / gridpoints_count.x()), z_top);
+        stitched_vertices.push_back(InterpolateGridEdge(values, gridpoints_count, lower, voxel_size_, coords, axis, iso_value));
+      }
+
+      ref = kGlobalVertexFlag | vertex_id;
+    }
+  }
+
+  if (vertex_offsets[count_slabs] + stitched_vertices.size() >= kInvalidVertexId) {
+    SPDLOG_ERROR("The iso surface has too many vertices [{}]", vertex_offsets[count_slabs] + stitched_vertices.size());
+    return false;
+  }
+
+  out_vertices.resize(vertex_offsets[count_slabs] + stitched_vertices.size());
+  out_faces.resize(face_offsets[count_slabs]);
+  ParallelFor(0, count_slabs, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t s = chunk_begin; s < chunk_end; s++) {
+      const MarchingCubesSlab& slab = slabs[s];
+      std::copy(slab.vertices.begin(), slab.vertices.end(), out_vertices.begin() + vertex_offsets[s]);
+
+      for (uint64_t f = 0; f < slab.face_refs.size() / 3; f++) {
+        vec3i& face = out_faces[face_offsets[s] + f];
+        for (int k = 0; k < 3; k++) {
+          const uint64_t ref = slab.face_refs[3 * f + k];
+          const uint64_t vertex_id = (ref & kGlobalVertexFlag) ? (ref & ~kGlobalVertexFlag) : (vertex_offsets[s] + ref);
+          face[k] = static_cast<int>(vertex_id);
+        }
+      }
+    }
+  });
+  std::copy(stitched_vertices.begin(), stitched_vertices.end(), out_vertices.begin() + vertex_offsets[count_slabs]);
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Extracted [{}] vertices and [{}] triangles in [{}] ms", out_vertices.size(), out_faces.size(), duration_milliseconds.count());
+
+  return true;
+}
+
+bool SignedDistanceField::extractIsoSurface(TriangleMesh& out_mesh,
+                                            real_t iso_value) const {
+  std::vector<vec3> vertices;
+  std::vector<vec3i> faces;
+  if (extractIsoSurface(vertices, faces, iso_value) == false) {
+    return false;
+  }
+
+  FillTriangleMesh(vertices, faces, out_mesh);
+  return true;
+}
+
+bool SignedDistanceField::extractSurfaceNets(std::vector<vec3>& out_vertices,
+                                             std::vector<vec3i>& out_faces,
+                                             real_t iso_value) const {
+  out_vertices.clear();
+  out_faces.clear();
+
+  const vec3i gridpoints_count = gridPointsCount();
+  if (gridpoints_count.minCoeff() < 2) {
+    SPDLOG_ERROR("The field needs at least two grid points along each axis to extract a surface");
+    return false;
+  }
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  const real_t* values = fieldValuesData();
+  const real_t kMaxValue = std::numeric_limits<real_t>::max();
+  const bool has_offsets = !closest_point_offsets_.empty();
+  const vec3 lower = bounds_.lower();
+  const uint64_t nx = static_cast<uint64_t>(gridpoints_count.x());
+  const uint64_t ny = static_cast<uint64_t>(gridpoints_count.y());
+  const uint64_t strides[3] = {1, nx, nx * ny};
+  const vec3i cells_count = gridpoints_count - vec3i(1, 1, 1);
+
+  std::array<uint64_t, MarchingCubes::kCountCorners> corner_offsets;
+  for (int c = 0; c < MarchingCubes::kCountCorners; c++) {
+    const vec3i offset = MarchingCubes::cornerOffset(c);
+    corner_offsets[c] = offset.z() * strides[2] + offset.y() * strides[1] + offset.x();
+  }
+
+  // one vertex per active cell
+  std::vector<SurfaceNetsLayer> layers(gridpoints_count.z());
+  ParallelFor(0, cells_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+      SurfaceNetsLayer& layer = layers[z];
+      for (int y = 0; y < cells_count.y(); y++) {
+        for (int x = 0; x < cells_count.x(); x++) {
+          const uint64_t base = z * strides[2] + y * strides[1] + x;
+
+          std::array<real_t, MarchingCubes::kCountCorners> corner_values;
+          int cube_index = 0;
+          bool in_band = true;
+          for (int c = 0; c < MarchingCubes::kCountCorners && in_band; c++) {
+            corner_values[c] = values[base + corner_offsets[c]];
+            in_band = (std::fabs(corner_values[c]) != kMaxValue);
+            cube_index |= (corner_values[c] < iso_value) ? (1 << c) : 0;
+          }
+
+          if (in_band == false || cube_index == 0 || cube_index == 255) {
+            continue;
+          }
+
+          const vec3 cell_lower = lower + voxel_size_ * vec3(x, y, static_cast<real_t>(z));
+          vec3 p = vec3::Zero();
+          if (has_offsets) {
+            for (int c = 0; c < MarchingCubes::kCountCorners; c++) {
+              p += voxel_size_ * MarchingCubes::cornerOffset(c).cast<real_t>() + closest_point_offsets_[base + corner_offsets[c]];
+            }
+            p /= static_cast<real_t>(MarchingCubes::kCountCorners);
+          } else {
+            // mass point of the edge crossings in the unit cell
+            const uint16_t edge_mask = MarchingCubes::edgeMask(cube_index);
+            int count_crossings = 0;
+            for (int e = 0; e < MarchingCubes::kCountEdges; e++) {
+              if ((edge_mask & (1 << e)) == 0) {
+                continue;
+              }
+
+              const vec2i corners = MarchingCubes::edgeCornerIds(e);
+              const real_t t = (iso_value - corner_values[corners[0]]) / (corner_values[corners[1]] - corner_values[corners[0]]);
+              p += MarchingCubes::cornerOffset(corners[0]).cast<real_t>() + t * vec3::Unit(MarchingCubes::edgeAxis(e));
+              count_crossings++;
+            }
+            p /= static_cast<real_t>(count_crossings);
+
+            // one gradient step of the trilinear field towards the surface
+            real_t f = 0.0;
+            vec3 gradient = vec3::Zero();
+            for (int c = 0; c < MarchingCubes::kCountCorners; c++) {
+              const vec3i offset = MarchingCubes::cornerOffset(c);
+              vec3 w;
+              vec3 dw;
+              for (int axis = 0; axis < 3; axis++) {
+                w[axis] = offset[axis] ? p[axis] : (1.0 - p[axis]);
+                dw[axis] = offset[axis] ? 1.0 : -1.0;
+              }
+
+              f += corner_values[c] * w.x() * w.y() * w.z();
+              gradient += corner_values[c] * vec3(dw.x() * w.y() * w.z(), w.x() * dw.y() * w.z(), w.x() * w.y() * dw.z());
+            }
+
+            const real_t gradient_norm2 = gradient.squaredNorm();
+            if (gradient_norm2 > 0.0) {
+              p -= ((f - iso_value) / gradient_norm2) * gradient;
+            }
+            p *= voxel_size_;
+          }
+
+          p = p.cwiseMax(vec3::Zero()).cwiseMin(vec3::Constant(voxel_size_));
+          layer.cell_keys.push_back(static_cast<uint64_t>(y) * cells_count.x() + x);
+          layer.vertices.push_back(cell_lower + p);
+        }
+      }
+    }
+  });
+
+  std::vector<uint64_t> vertex_offsets(layers.size() + 1, 0);
+  for (size_t z = 0; z < layers.size(); z++) {
+    vertex_offsets[z + 1] = vertex_offsets[z] + layers[z].vertices.size();
+  }
+
+  if (vertex_offsets.back() >= kInvalidVertexId) {
+    SPDLOG_ERROR("The iso surface has too many vertices [{}]", vertex_offsets.back());
+    return false;
+  }
+
+  auto find_cell_vertex = [&](const vec3i& cell, uint32_t& out_vertex_id, vec3& out_position) -> bool {
+    if ((cell.array() < 0).any() || (cell.array() >= cells_count.array()).any()) {
+      return false;
+    }
+
+    const SurfaceNetsLayer& layer = layers[cell.z()];
+    const uint64_t key = static_cast<uint64_t>(cell.y()) * cells_count.x() + cell.x();
+    auto it = std::lower_bound(layer.cell_keys.begin(), layer.cell_keys.end(), key);
+    if (it == layer.cell_keys.end() || *it != key) {
+      return false;
+    }
+
+    const uint64_t index = static_cast<uint64_t>(it - layer.cell_keys.begin());
+    out_vertex_id = static_cast<uint32_t>(vertex_offsets[cell.z()] + index);
+    out_position = layer.vertices[index];
+    return true;
+  };
+
+  // one quad per crossed grid edge, around it counter clockwise in the plane of the other two axes
+  ParallelFor(0, gridpoints_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+      SurfaceNetsLayer& layer = layers[z];
+      for (int y = 0; y < gridpoints_count.y(); y++) {
+        for (int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords(x, y, static_cast<int>(z));
+          const uint64_t id0 = z * strides[2] + y * strides[1] + x;
+          const real_t v0 = values[id0];
+          if (std::fabs(v0) == kMaxValue) {
+            continue;
+          }
+
+          for (int axis = 0; axis < 3; axis++) {
+            if (coords[axis] + 1 >= gridpoints_count[axis]) {
+              continue;
+            }
+
+            const real_t v1 = values[id0 + strides[axis]];
+            if (std::fabs(v1) == kMaxValue || (v0 < iso_value) == (v1 < iso_value)) {
+              continue;
+            }
+
+            const vec3i du = vec3i::Unit((axis + 1) % 3);
+            const vec3i dv = vec3i::Unit((axis + 2) % 3);
+            const std::array<vec3i, 4> cells = { coords - du - dv, coords - dv, coords, coords - du };
+
+            std::array<uint32_t, 4> quad;
+            std::array<vec3, 4> positions;
+            bool complete = true;
+            for (int k = 0; k < 4 && complete; k++) {
+              complete = find_cell_vertex(cells[k], quad[k], positions[k]);
+            }
+
+            if (complete == false) {
+              continue;
+            }
+
+            // the quad faces along the axis when the edge leaves the inside
+            if (v0 >= iso_value) {
+              std::reverse(quad.begin(), quad.end());
+              std::reverse(positions.begin(), positions.end());
+            }
+
+            if ((positions[0] - positions[2]).squaredNorm() <= (positions[1] - positions[3]).squaredNorm()) {
+              layer.faces.push_back(vec3i(quad[0], quad[1], quad[2]));
+              layer.faces.push_back(vec3i(quad[0], quad[2], quad[3]));
+            } else {
+              layer.faces.push_back(vec3i(quad[1], quad[2], quad[3]));
+              layer.faces.push_back(vec3i(quad[1], quad[3], quad[0]));
+            }
+          }
+        }
+      }
+    }
+  });
+
+  std::vector<uint64_t> face_offsets(layers.size() + 1, 0);
+  for (size_t z = 0; z < layers.size(); z++) {
+    face_offsets[z + 1] = face_offsets[z] + layers[z].faces.size();
+  }
+
+  out_vertices.resize(vertex_offsets.back());
+  out_faces.resize(face_offsets.back());
+  ParallelFor(0, layers.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t z = chunk_begin; z < chunk_end; z++) {
+      std::copy(layers[z].vertices.begin(), layers[z].vertices.end(), out_vertices.begin() + vertex_offsets[z]);
+      std::copy(layers[z].faces.begin(), layers[z].faces.end(), out_faces.begin() + face_offsets[z]);
+    }
+  });
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+  auto duration_milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1);
+  SPDLOG_INFO("Extracted [{}] vertices and [{}] triangles with surface nets in [{}] ms", out_vertices.size(), out_faces.size(), duration_milliseconds.count());
+
+  return true;
+}
+
+bool SignedDistanceField::extractSurfaceNets(TriangleMesh& out_mesh,
+                                             real_t iso_value) const {
+  std::vector<vec3> vertices;
+  std::vector<vec3i> faces;
+  if (extractSurfaceNets(vertices, faces, iso_value) == false) {
+    return false;
+  }
+
+  FillTriangleMesh(vertices, faces, out_mesh);
+  return true;
+}
+
+bool SignedDistanceField::saveIsoSurfaceAsSTL(const std::string& filepath,
+                                              real_t iso_value) const {
+  std::vector<vec3> vertices;
+  std::vector<vec3i> faces;
+  if (extractIsoSurface(vertices, faces, iso_value) == false) {
+    return false;
+  }
+
+  return WriteBinarySTL(filepath, vertices, faces);
+}
+
+SignedDistanceField::SliceView SignedDistanceField::slice(SliceAxis axis, int index) const {
+  const vec3i gridpoints_count = gridPointsCount();
+  if (index < 0 || index >= gridpoints_count[axis]) {
+    std::string message = fmt::format("The supplied slice index [{}] is out of range, \
+                                       Correct values must be in range [{}, {}].",
+                                       index, 0, gridpoints_count[axis] - 1);
+    throw std::out_of_range(message);
+  }
+
+  const int64_t strides[3] = {
+    1,
+    static_cast<int64_t>(gridpoints_count.x()),
+    static_cast<int64_t>(gridpoints_count.x()) * static_cast<int64_t>(gridpoints_count.y())
+  };
+  const int axis_u = (axis == kSliceAxisX) ? 1 : 0;
+  const int axis_v = (axis == kSliceAxisZ) ? 1 : 2;
+
+  SliceView view;
+  view.data = fieldValuesData() + index * strides[axis];
+  view.size = vec2i(gridpoints_count[axis_u], gridpoints_count[axis_v]);
+  view.stride_u = strides[axis_u];
+  view.stride_v = strides[axis_v];
+  return view;
+}
+
 bool SignedDistanceField::saveAsVTI(const std::string& filepath) const {
   if (totalGridPointsCount() == 0) {
     SPDLOG_ERROR("This instance is empty. Initialize before saving to disk");
@@ -355,6 +2300,10 @@ bool SignedDistanceField::saveAsVTI(const std::string& filepath) const {
     SPDLOG_WARN("Another file with the same name exists under [{}] and will be overwritten.", filepath.c_str());
   }
 
+  return writeVTI(filepath, vec3i(0, 0, 0));
+}
+
+bool SignedDistanceField::writeVTI(const std::string& filepath, const vec3i& extent_offset) const {
   std::ofstream file(filepath);
   if (!file.is_open()) {
     SPDLOG_ERROR("Failed to open file [{}] for writing", filepath.c_str());
@@ -363,13 +2312,23 @@ bool SignedDistanceField::saveAsVTI(const std::string& filepath) const {
 
   const vec3i gridpoints_count = gridPointsCount();
 
+  // the origin of the grid that the extents refer to
+  const vec3 origin = bounds_.lower() - voxel_size_ * vec3(static_cast<real_t>(extent_offset.x()),
+                                                           static_cast<real_t>(extent_offset.y()),
+                                                           static_cast<real_t>(extent_offset.z()));
+  const vec3i extent_end = extent_offset + gridpoints_count - vec3i(1, 1, 1);
+  const std::string extent = fmt::format("{} {} {} {} {} {}",
+                                         extent_offset.x(), extent_end.x(),
+                                         extent_offset.y(), extent_end.y(),
+                                         extent_offset.z(), extent_end.z());
+
   // Write the VTI XML header
   file << "<?xml version=\"1.0\"?>\n";
   file << "<VTKFile type=\"ImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
-  file << "  <ImageData WholeExtent=\"0 " << gridpoints_count.x() - 1 << " 0 " << gridpoints_count.y() - 1 << " 0 " << gridpoints_count.z() - 1 \
-        << "\" Origin=\"" << bounds_.lower().x() << " " << bounds_.lower().y() << " " << bounds_.lower().z() \
+  file << "  <ImageData WholeExtent=\"" << extent \
+        << "\" Origin=\"" << origin.x() << " " << origin.y() << " " << origin.z() \
         << "\" Spacing=\"" << voxel_size_ << " " << voxel_size_ << " " << voxel_size_ << "\">\n";
-  file << "    <Piece Extent=\"0 " << gridpoints_count.x() - 1 << " 0 " << gridpoints_count.y() - 1 << " 0 " << gridpoints_count.z() - 1 << "\">\n";
+  file << "    <Piece Extent=\"" << extent << "\">\n";
   file << "      <PointData Scalars=\"SignedDistanceField\">\n";
   file << "        <DataArray type=\"Float32\" Name=\"SignedDistanceField\" format=\"ascii\">\n";
 
@@ -385,8 +2344,27 @@ bool SignedDistanceField::saveAsVTI(const std::string& filepath) const {
     }
   }
 
+  file << "        </DataArray>\n";
+
+  if (closest_face_ids_.empty() == false) {
+    file << "        <DataArray type=\"UInt32\" Name=\"ClosestFaceId\" format=\"ascii\">\n";
+    for(uint64_t i = 0; i < closest_face_ids_.size(); i++) {
+      file << closest_face_ids_[i] << (((i + 1) % gridpoints_count.x() == 0) ? "\n" : " ");
+    }
+    file << "        </DataArray>\n";
+  }
+
+  if (closest_point_offsets_.empty() == false) {
+    file << "        <DataArray type=\"Float32\" Name=\"ClosestPointOffset\" NumberOfComponents=\"3\" format=\"ascii\">\n";
+    for(uint64_t i = 0; i < closest_point_offsets_.size(); i++) {
+      const vec3& offset = closest_point_offsets_[i];
+      file << static_cast<float>(offset.x()) << " " << static_cast<float>(offset.y()) << " " << static_cast<float>(offset.z())
+           << (((i + 1) % gridpoints_count.x() == 0) ? "\n" : " ");
+    }
+    file << "        </DataArray>\n";
+  }
+
   // Close the XML tags
-  file << "        </DataArray>\n";
   file << "      </PointData>\n";
   file << "      <CellData>\n";
   file << "      </CellData>\n";
@@ -516,6 +2494,9 @@ bool SignedDistanceField::loadAsVTI(const std::string& filepath) {
     return false;
   }
 
+  releaseMapping();
+  clearClosestFeatures();
+
   voxel_size_ = image_data.spacing[0];
 
   const vec3 origin(image_data.origin[0], image_data.origin[1], image_data.origin[2]);
@@ -530,6 +2511,7 @@ bool SignedDistanceField::loadAsVTI(const std::string& filepath) {
 
   {
     std::lock_guard<std::mutex> lock(field_values_mutex_);
+    field_values_.clear();
     field_values_.reserve(image_data.gridpoints_count[0] * image_data.gridpoints_count[1] * image_data.gridpoints_count[2]);
     result = parseAsciiValues(image_data.scalar_data, field_values_);
   }
@@ -537,9 +2519,548 @@ bool SignedDistanceField::loadAsVTI(const std::string& filepath) {
   return result;
 }
 
+bool SignedDistanceField::saveAsBinary(const std::string& filepath) const {
+  if (totalGridPointsCount() == 0) {
+    SPDLOG_ERROR("This instance is empty. Initialize before saving to disk");
+    return false;
+  }
+
+  if (std::filesystem::exists(filepath)) {
+    SPDLOG_WARN("Another file with the same name exists under [{}] and will be overwritten.", filepath.c_str());
+  }
+
+  std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", filepath.c_str());
+    return false;
+  }
+
+  if (writeBinaryHeader(file) == false) {
+    SPDLOG_ERROR("Failed when writing the header to [{}]", filepath.c_str());
+    return false;
+  }
+
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    file.write(reinterpret_cast<const char*>(fieldValuesData()), countFieldValues() * sizeof(real_t));
+  }
+
+  if (!file.good()) {
+    SPDLOG_ERROR("Failed when writing the field values to [{}]", filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::saveAsNpy(const std::string& filepath) const {
+  if (totalGridPointsCount() == 0) {
+    SPDLOG_ERROR("This instance is empty. Initialize before saving to disk");
+    return false;
+  }
+
+  if (std::filesystem::exists(filepath)) {
+    SPDLOG_WARN("Another file with the same name exists under [{}] and will be overwritten.", filepath.c_str());
+  }
+
+  std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", filepath.c_str());
+    return false;
+  }
+
+  // version 1.0 header: magic, version, little endian header length, then a python dict literal
+  // padded with spaces and terminated by a newline
+  const uint16_t endian_probe = 1;
+  const bool little_endian = (*reinterpret_cast<const uint8_t*>(&endian_probe) == 1);
+  const vec3i gridpoints_count = gridPointsCount();
+  std::string header = fmt::format("{{'descr': '{}f{}', 'fortran_order': False, 'shape': ({}, {}, {}), }}",
+                                   little_endian ? '<' : '>', sizeof(real_t),
+                                   gridpoints_count.z(), gridpoints_count.y(), gridpoints_count.x());
+  const uint64_t preamble_size = sizeof(kNpyMagic) + 4;
+  const uint64_t padded_size = ((preamble_size + header.size() + 1 + kNpyAlignmentInBytes - 1) / kNpyAlignmentInBytes) * kNpyAlignmentInBytes;
+  header.append(padded_size - preamble_size - header.size() - 1, ' ');
+  header.push_back('\n');
+
+  const uint16_t header_size = static_cast<uint16_t>(header.size());
+  const uint8_t preamble[4] = {
+    1, 0, static_cast<uint8_t>(header_size & 0xFF), static_cast<uint8_t>(header_size >> 8)
+  };
+  file.write(kNpyMagic, sizeof(kNpyMagic));
+  file.write(reinterpret_cast<const char*>(preamble), sizeof(preamble));
+  file.write(header.data(), header.size());
+
+  {
+    std::lock_guard<std::mutex> lk(field_values_mutex_);
+    file.write(reinterpret_cast<const char*>(fieldValuesData()), countFieldValues() * sizeof(real_t));
+  }
+
+  if (!file.good()) {
+    SPDLOG_ERROR("Failed when writing the field values to [{}]", filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::saveSliceAsPGM(const std::string& filepath,
+                                         SliceAxis axis,
+                                         int index,
+                                         real_t range) const {
+  if (totalGridPointsCount() == 0) {
+    SPDLOG_ERROR("This instance is empty. Initialize before saving to disk");
+    return false;
+  }
+
+  if (index < 0 || index >= gridPointsCount()[axis]) {
+    SPDLOG_ERROR("The slice index [{}] is outside the grid", index);
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  const SliceView view = slice(axis, index);
+  const int width = view.size.x();
+  const int height = view.size.y();
+
+  if (range <= 0.0) {
+    for(int v = 0; v < height; v++) {
+      for(int u = 0; u < width; u++) {
+        const real_t value = std::fabs(view.at(u, v));
+        if (value < std::numeric_limits<real_t>::max()) {
+          range = std::max(range, value);
+        }
+      }
+    }
+
+    if (range <= 0.0) {
+      range = voxel_size_;
+    }
+  }
+
+  std::vector<uint8_t> pixels(static_cast<uint64_t>(width) * static_cast<uint64_t>(height));
+  for(int v = 0; v < height; v++) {
+    const uint64_t row = static_cast<uint64_t>(height - 1 - v) * static_cast<uint64_t>(width);
+    for(int u = 0; u < width; u++) {
+      const real_t t = std::clamp((view.at(u, v) + range) / (2.0 * range), static_cast<real_t>(0.0), static_cast<real_t>(1.0));
+      pixels[row + u] = static_cast<uint8_t>(std::lround(t * 255.0));
+    }
+  }
+
+  std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", filepath.c_str());
+    return false;
+  }
+
+  const std::string header = fmt::format("P5\n{} {}\n255\n", width, height);
+  file.write(header.data(), header.size());
+  file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+
+  if (!file.good()) {
+    SPDLOG_ERROR("Failed when writing the slice image to [{}]", filepath.c_str());
+    return false;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::loadAsBinary(const std::string& filepath) {
+  std::ifstream file(filepath, std::ios::binary);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for reading", filepath.c_str());
+    return false;
+  }
+
+  // the field is only changed once the whole file has been read
+  AABB bounds;
+  real_t voxel_size = 0.0;
+  uint64_t count_values = 0;
+  if (readBinaryHeader(file, bounds, voxel_size, count_values) == false) {
+    SPDLOG_ERROR("Invalid binary SDF file [{}]", filepath.c_str());
+    return false;
+  }
+
+  GridVector<real_t> values;
+  values.resize(count_values);
+  file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(real_t));
+  if (!file.good()) {
+    SPDLOG_ERROR("The binary SDF file [{}] is truncated", filepath.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  releaseMapping();
+  clearClosestFeatures();
+  bounds_ = bounds;
+  voxel_size_ = voxel_size;
+  field_values_.swap(values);
+
+  return true;
+}
+
+bool SignedDistanceField::mapBinary(const std::string& filepath) {
+#if defined(_WIN32)
+  SPDLOG_ERROR("Mapping binary SDF files is not supported on this platform.");
+  return false;
+#else
+  std::ifstream header_file(filepath, std::ios::binary);
+  if (!header_file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for reading", filepath.c_str());
+    return false;
+  }
+
+  // the field is only changed once the file has been mapped
+  AABB bounds;
+  real_t voxel_size = 0.0;
+  uint64_t count_values = 0;
+  if (readBinaryHeader(header_file, bounds, voxel_size, count_values) == false) {
+    SPDLOG_ERROR("Invalid binary SDF file [{}]", filepath.c_str());
+    return false;
+  }
+  header_file.close();
+
+  const uint64_t expected_length = kBinaryHeaderSizeInBytes + count_values * sizeof(real_t);
+
+  const int fd = ::open(filepath.c_str(), O_RDONLY);
+  if (fd < 0) {
+    SPDLOG_ERROR("Failed to open file [{}] for mapping", filepath.c_str());
+    return false;
+  }
+
+  struct stat file_stat;
+  if (::fstat(fd, &file_stat) != 0 || static_cast<uint64_t>(file_stat.st_size) < expected_length) {
+    SPDLOG_ERROR("The binary SDF file [{}] is truncated", filepath.c_str());
+    ::close(fd);
+    return false;
+  }
+
+  void* address = ::mmap(nullptr, expected_length, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd);
+
+  if (address == MAP_FAILED) {
+    SPDLOG_ERROR("Failed to map the binary SDF file [{}]", filepath.c_str());
+    return false;
+  }
+
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  releaseMapping();
+  clearClosestFeatures();
+  field_values_.clear();
+  field_values_.shrink_to_fit();
+  bounds_ = bounds;
+  voxel_size_ = voxel_size;
+  mapped_address_ = address;
+  mapped_length_ = expected_length;
+
+  return true;
+#endif
+}
+
+void SignedDistanceField::logPagePlacement() const {
+  std::lock_guard<std::mutex> lk(field_values_mutex_);
+  LogPagePlacement("field values", fieldValuesData(), countFieldValues() * sizeof(real_t));
+  if (closest_face_ids_.empty() == false) {
+    LogPagePlacement("closest face ids", closest_face_ids_.data(), closest_face_ids_.size() * sizeof(uint32_t));
+  }
+
+  if (closest_point_offsets_.empty() == false) {
+    LogPagePlacement("closest point offsets", closest_point_offsets_.data(), closest_point_offsets_.size() * sizeof(vec3));
+  }
+}
+
+bool SignedDistanceField::isMapped() const {
+  return mapped_address_ != nullptr;
+}
+
+bool SignedDistanceField::MergeBinaryShards(const std::vector<std::string>& in_shard_filepaths,
+                                            const std::string& out_filepath) {
+  std::vector<std::unique_ptr<SignedDistanceField>> shards;
+  std::vector<int> z_offsets;
+  if (MapShards(in_shard_filepaths, shards, z_offsets) == false) {
+    return false;
+  }
+
+  const SignedDistanceField& first = *shards.front();
+  const SignedDistanceField& last = *shards.back();
+
+  SignedDistanceField merged;
+  merged.voxel_size_ = first.voxel_size_;
+  merged.bounds_ = AABB(first.bounds_.lower(),
+                        vec3(first.bounds_.upper().x(), first.bounds_.upper().y(), last.bounds_.upper().z()));
+
+  const vec3i gridpoints_count = merged.gridPointsCount();
+  if (gridpoints_count.z() != z_offsets.back() + last.gridPointsCount().z()) {
+    SPDLOG_ERROR("The merged grid has [{}] z layers but the shards cover [{}] layers.",
+                 gridpoints_count.z(), z_offsets.back() + last.gridPointsCount().z());
+    return false;
+  }
+
+  std::ofstream file(out_filepath, std::ios::binary | std::ios::trunc);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", out_filepath.c_str());
+    return false;
+  }
+
+  if (merged.writeBinaryHeader(file) == false) {
+    SPDLOG_ERROR("Failed when writing the header to [{}]", out_filepath.c_str());
+    return false;
+  }
+
+  // copy the layers that the previous shards did not cover
+  const uint64_t layer_size = static_cast<uint64_t>(gridpoints_count.x()) * static_cast<uint64_t>(gridpoints_count.y());
+  int z_written = 0;
+  for (size_t i = 0; i < shards.size(); i++) {
+    const int z_end = z_offsets[i] + shards[i]->gridPointsCount().z();
+    const uint64_t first_layer = static_cast<uint64_t>(z_written - z_offsets[i]);
+    const uint64_t count_layers = static_cast<uint64_t>(z_end - z_written);
+
+    file.write(reinterpret_cast<const char*>(shards[i]->fieldValuesData() + first_layer * layer_size),
+               count_layers * layer_size * sizeof(real_t));
+    if (!file.good()) {
+      SPDLOG_ERROR("Failed when writing shard [{}] to [{}]", in_shard_filepaths[i].c_str(), out_filepath.c_str());
+      return false;
+    }
+
+    z_written = z_end;
+  }
+
+  SPDLOG_INFO("Merged [{}] shards into [{}] grid points", shards.size(), merged.totalGridPointsCount());
+  return true;
+}
+
+bool SignedDistanceField::SaveShardsAsPVTI(const std::vector<std::string>& in_shard_filepaths,
+                                           const std::string& out_filepath) {
+  std::vector<std::unique_ptr<SignedDistanceField>> shards;
+  std::vector<int> z_offsets;
+  if (MapShards(in_shard_filepaths, shards, z_offsets) == false) {
+    return false;
+  }
+
+  const SignedDistanceField& first = *shards.front();
+  const vec3i gridpoints_count = first.gridPointsCount();
+  const int count_layers = z_offsets.back() + shards.back()->gridPointsCount().z();
+  const vec3 origin = first.bounds_.lower();
+  const real_t voxel_size = first.voxel_size_;
+
+  std::ofstream file(out_filepath);
+  if (!file.is_open()) {
+    SPDLOG_ERROR("Failed to open file [{}] for writing", out_filepath.c_str());
+    return false;
+  }
+
+  file << "<?xml version=\"1.0\"?>\n";
+  file << "<VTKFile type=\"PImageData\" version=\"0.1\" byte_order=\"LittleEndian\">\n";
+  file << "  <PImageData WholeExtent=\"0 " << gridpoints_count.x() - 1 << " 0 " << gridpoints_count.y() - 1 << " 0 " << count_layers - 1 \
+        << "\" GhostLevel=\"0\" Origin=\"" << origin.x() << " " << origin.y() << " " << origin.z() \
+        << "\" Spacing=\"" << voxel_size << " " << voxel_size << " " << voxel_size << "\">\n";
+  file << "    <PPointData Scalars=\"SignedDistanceField\">\n";
+  file << "      <PDataArray type=\"Float32\" Name=\"SignedDistanceField\"/>\n";
+  file << "    </PPointData>\n";
+
+  // the pieces are stored next to the collection and referenced by relative paths
+  const std::filesystem::path collection_path(out_filepath);
+  for (size_t i = 0; i < shards.size(); i++) {
+    const std::string piece_filename = fmt::format("{}_{}.vti", collection_path.stem().string(), i);
+    const std::filesystem::path piece_path = collection_path.parent_path() / piece_filename;
+
+    if (shards[i]->writeVTI(piece_path.string(), vec3i(0, 0, z_offsets[i])) == false) {
+      return false;
+    }
+
+    file << "    <Piece Extent=\"0 " << gridpoints_count.x() - 1 << " 0 " << gridpoints_count.y() - 1 \
+          << " " << z_offsets[i] << " " << z_offsets[i] + shards[i]->gridPointsCount().z() - 1 \
+          << "\" Source=\"" << piece_filename << "\"/>\n";
+  }
+
+  file << "  </PImageData>\n";
+  file << "</VTKFile>\n";
+
+  file.close();
+
+  return true;
+}
+
+bool SignedDistanceField::MapShards(const std::vector<std::string>& in_shard_filepaths,
+                                    std::vector<std::unique_ptr<SignedDistanceField>>& out_shards,
+                                    std::vector<int>& out_z_offsets) {
+  if (in_shard_filepaths.empty()) {
+    SPDLOG_ERROR("No shards were supplied.");
+    return false;
+  }
+
+  out_shards.clear();
+  for (const std::string& filepath : in_shard_filepaths) {
+    auto shard = std::make_unique<SignedDistanceField>();
+    if (shard->mapBinary(filepath) == false) {
+      SPDLOG_ERROR("Failed to map the shard [{}]", filepath.c_str());
+      return false;
+    }
+
+    out_shards.push_back(std::move(shard));
+  }
+
+  std::sort(out_shards.begin(), out_shards.end(), [](const auto& lhs, const auto& rhs) {
+    return lhs->bounds_.lower().z() < rhs->bounds_.lower().z();
+  });
+
+  const SignedDistanceField& first = *out_shards.front();
+  const real_t voxel_size = first.voxel_size_;
+  const real_t tolerance = 1e-6 * voxel_size;
+
+  out_z_offsets.assign(out_shards.size(), 0);
+  int z_covered = first.gridPointsCount().z();
+  for (size_t i = 1; i < out_shards.size(); i++) {
+    const SignedDistanceField& shard = *out_shards[i];
+
+    if (FuzzyCompare(shard.voxel_size_, voxel_size) == false ||
+        shard.gridPointsCount().x() != first.gridPointsCount().x() ||
+        shard.gridPointsCount().y() != first.gridPointsCount().y() ||
+        std::fabs(shard.bounds_.lower().x() - first.bounds_.lower().x()) > tolerance ||
+        std::fabs(shard.bounds_.lower().y() - first.bounds_.lower().y()) > tolerance) {
+      SPDLOG_ERROR("The shards do not belong to the same grid.");
+      return false;
+    }
+
+    const real_t offset = (shard.bounds_.lower().z() - first.bounds_.lower().z()) / voxel_size;
+    out_z_offsets[i] = static_cast<int>(std::round(offset));
+    if (std::fabs(offset - out_z_offsets[i]) > 1e-6) {
+      SPDLOG_ERROR("The shard at z = [{}] is not aligned with the grid.", shard.bounds_.lower().z());
+      return false;
+    }
+
+    const int z_end = out_z_offsets[i] + shard.gridPointsCount().z();
+    if (out_z_offsets[i] > z_covered) {
+      SPDLOG_ERROR("The z layers [{}, {}) are not covered by any shard.", z_covered, out_z_offsets[i]);
+      return false;
+    }
+
+    if (z_end <= z_covered) {
+      SPDLOG_ERROR("The shard at z = [{}] is covered by the other shards.", shard.bounds_.lower().z());
+      return false;
+    }
+
+    z_covered = z_end;
+  }
+
+  return true;
+}
+
+bool SignedDistanceField::writeBinaryHeader(std::ostream& out_stream) const {
+  BinaryHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, kBinaryMagic, sizeof(header.magic));
+  header.version = kBinaryFormatVersion;
+  header.real_size = sizeof(real_t);
+
+  const vec3i gridpoints_count = gridPointsCount();
+  for (int i = 0; i < 3; i++) {
+    header.gridpoints_count[i] = gridpoints_count[i];
+    header.lower[i] = static_cast<double>(bounds_.lower()[i]);
+    header.upper[i] = static_cast<double>(bounds_.upper()[i]);
+  }
+  header.voxel_size = static_cast<double>(voxel_size_);
+
+  out_stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // pad the header so that the values are aligned
+  const std::vector<char> padding(kBinaryHeaderSizeInBytes - sizeof(header), 0);
+  out_stream.write(padding.data(), padding.size());
+
+  return out_stream.good();
+}
+
+bool SignedDistanceField::readBinaryHeader(std::istream& in_stream,
+                                           AABB& out_bounds,
+                                           real_t& out_voxel_size,
+                                           uint64_t& out_count_values) const {
+  BinaryHeader header;
+  in_stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (!in_stream.good()) {
+    return false;
+  }
+
+  if (std::memcmp(header.magic, kBinaryMagic, sizeof(header.magic)) != 0) {
+    SPDLOG_ERROR("The file is not a binary SDF file.");
+    return false;
+  }
+
+  if (header.version != kBinaryFormatVersion) {
+    SPDLOG_ERROR("The binary SDF format version [{}] is not supported.", header.version);
+    return false;
+  }
+
+  if (header.real_size != sizeof(real_t)) {
+    SPDLOG_ERROR("The binary SDF file stores values of [{}] bytes but this build uses [{}] bytes.",
+                 header.real_size, sizeof(real_t));
+    return false;
+  }
+
+  const real_t voxel_size = static_cast<real_t>(header.voxel_size);
+  if (!(voxel_size > 0.0)) {
+    SPDLOG_ERROR("The binary SDF header has an invalid voxel size [{}].", voxel_size);
+    return false;
+  }
+
+  const AABB bounds(vec3(header.lower[0], header.lower[1], header.lower[2]),
+                    vec3(header.upper[0], header.upper[1], header.upper[2]));
+  const vec3 extent = bounds.extent();
+  const vec3i gridpoints_count(ComputeVoxelsCount(extent.x(), voxel_size) + 1,
+                               ComputeVoxelsCount(extent.y(), voxel_size) + 1,
+                               ComputeVoxelsCount(extent.z(), voxel_size) + 1);
+  if (gridpoints_count.minCoeff() < 1 ||
+      gridpoints_count != vec3i(header.gridpoints_count[0], header.gridpoints_count[1], header.gridpoints_count[2])) {
+    SPDLOG_ERROR("The grid points count in the binary SDF header does not match its bounds.");
+    return false;
+  }
+
+  in_stream.seekg(kBinaryHeaderSizeInBytes, std::ios::beg);
+  if (!in_stream.good()) {
+    return false;
+  }
+
+  out_bounds = bounds;
+  out_voxel_size = voxel_size;
+  out_count_values = static_cast<uint64_t>(gridpoints_count.x()) * gridpoints_count.y() * gridpoints_count.z();
+  return true;
+}
+
+const real_t* SignedDistanceField::fieldValuesData() const {
+  if (mapped_address_ != nullptr) {
+    return reinterpret_cast<const real_t*>(static_cast<const char*>(mapped_address_) + kBinaryHeaderSizeInBytes);
+  }
+
+  return field_values_.data();
+}
+
+uint64_t SignedDistanceField::countFieldValues() const {
+  if (mapped_address_ != nullptr) {
+    return (mapped_length_ - kBinaryHeaderSizeInBytes) / sizeof(real_t);
+  }
+
+  return field_values_.size();
+}
+
+void SignedDistanceField::clearClosestFeatures() {
+  closest_face_ids_.clear();
+  closest_face_ids_.shrink_to_fit();
+  closest_point_offsets_.clear();
+  closest_point_offsets_.shrink_to_fit();
+}
+
+void SignedDistanceField::releaseMapping() {
+#if !defined(_WIN32)
+  if (mapped_address_ != nullptr) {
+    ::munmap(mapped_address_, mapped_length_);
+  }
+#endif
+
+  mapped_address_ = nullptr;
+  mapped_length_ = 0;
+}
+
 // Function to parse ASCII values, including special cases like infinity
 bool SignedDistanceField::parseAsciiValues(const std::string& in_data_string,
-                                           std::vector<real_t>& out_data_values) {
+                                           GridVector<real_t>& out_data_values) {
     std::stringstream ss(in_data_string);
     std::string token;
 
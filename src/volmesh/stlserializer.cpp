@@ -11,6 +11,7 @@
 #include "volmesh/basetypes.h"
 #include "volmesh/logger.h"
 
+#include <cstring>
 #include <fstream>
 #include <filesystem>
 
@@ -284,5 +285,61 @@ namespace volmesh {
     return true;
   }
 
+  bool WriteBinarySTL(const std::string& in_mesh_filepath,
+                      const std::vector<vec3>& in_vertices,
+                      const std::vector<vec3i>& in_faces) {
+    if(in_faces.empty()) {
+      SPDLOG_ERROR("The supplied triangle list has zero faces");
+      return false;
+    }
+
+    if(std::filesystem::exists(std::filesystem::path(in_mesh_filepath)) == true) {
+      SPDLOG_WARN("Another file with the same name already exists under [{}]", in_mesh_filepath.c_str());
+    }
+
+    std::ofstream stlfile(in_mesh_filepath, std::ios::binary);
+    if(stlfile.is_open() == false) {
+      return false;
+    }
+
+    char header[80] = {0};
+    static const std::string header_msg = "volmesh";
+    strncpy(header, header_msg.data(), header_msg.length());
+    stlfile.write(header, 80);
+
+    uint32_t triangles_count = static_cast<uint32_t>(in_faces.size());
+    stlfile.write((char *)&triangles_count, sizeof(triangles_count));
+
+    //each record holds the normal, the three positions and the attribute
+    static const size_t kRecordSize = sizeof(float) * 12 + sizeof(uint16_t);
+    std::vector<char> records(in_faces.size() * kRecordSize);
+    for(size_t i = 0; i < in_faces.size(); i++) {
+      const vec3& a = in_vertices[in_faces[i][0]];
+      const vec3& b = in_vertices[in_faces[i][1]];
+      const vec3& c = in_vertices[in_faces[i][2]];
+      const vec3 normal = (b - a).cross(c - a).normalized();
+
+      float record_float32[12];
+      for(int k = 0; k < 3; k++) {
+        record_float32[k] = static_cast<float>(normal[k]);
+        record_float32[3 + k] = static_cast<float>(a[k]);
+        record_float32[6 + k] = static_cast<float>(b[k]);
+        record_float32[9 + k] = static_cast<float>(c[k]);
+      }
+
+      const uint16_t attr = 0;
+      memcpy(records.data() + i * kRecordSize, record_float32, sizeof(record_float32));
+      memcpy(records.data() + i * kRecordSize + sizeof(record_float32), &attr, sizeof(attr));
+    }
+
+    stlfile.write(records.data(), records.size());
+    if(stlfile.good() == false) {
+      SPDLOG_ERROR("Failed when writing the triangles to [{}]", in_mesh_filepath.c_str());
+      return false;
+    }
+
+    return true;
+  }
+
 }
 
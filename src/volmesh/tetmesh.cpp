@@ -8,13 +8,294 @@
 
 #include "volmesh/tetmesh.h"
 #include "volmesh/tetrahedra.h"
+#include "volmesh/parallel.h"
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <iostream>
 #include <fstream>
+#include <limits>
+#include <tuple>
 #include <spdlog/spdlog.h>
+#include <fmt/core.h>
 
 using namespace volmesh;
 
+namespace {
+
+  //the occurrences of the bulk topology build are split into fixed blocks and the leading keys into
+  //fixed ranges, so the work of every task does not depend on the number of threads
+  static const uint64_t kOccurrencesPerBlock = 1 << 16;
+  static const uint64_t kCountLeadRanges = 1024;
+  static const uint64_t kCellsPerTask = 1 << 12;
+
+  /**
+   * @brief Numbers the distinct keys of a list of occurrences in the order of their first occurrence.
+   *
+   * The occurrences are grouped by a counting sort on their leading key and every group is sorted by
+   * the rest of the key, so the first occurrence of every key is found without hashing or searching
+   * the incident element lists. The blocks of occurrences are first scattered to ranges of leading
+   * keys in parallel, every range is then sorted on its own, and the first occurrences are numbered
+   * by a prefix sum over the blocks, so the ids do not depend on the number of threads.
+   *
+   * @param count_leads One more than the largest leading key.
+   * @param in_leads The leading key of every occurrence.
+   * @param in_tails The rest of the key of every occurrence.
+   * @param out_ids The id of the key of every occurrence.
+   * @param out_first_occurrences The first occurrence of every key.
+   * @return The number of distinct keys.
+   */
+  template <typename Tail>
+  uint32_t NumberFirstOccurrences(uint32_t count_leads,
+                                  const std::vector<uint32_t>& in_leads,
+                                  const std::vector<Tail>& in_tails,
+                                  std::vector<uint32_t>& out_ids,
+                                  std::vector<uint32_t>& out_first_occurrences) {
+    const uint64_t count = in_leads.size();
+    const uint64_t count_blocks = (count + kOccurrencesPerBlock - 1) / kOccurrencesPerBlock;
+    const uint64_t leads_per_range = std::max<uint64_t>(1, (static_cast<uint64_t>(count_leads) + kCountLeadRanges - 1) / kCountLeadRanges);
+    const uint64_t count_ranges = (static_cast<uint64_t>(count_leads) + leads_per_range - 1) / leads_per_range;
+
+    //count the occurrences of every block per range and scatter them range by range, block by block
+    std::vector<uint32_t> block_cursors(count_blocks * count_ranges, 0);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t b = chunk_begin; b < chunk_end; b++) {
+        uint32_t* cursors = &block_cursors[b * count_ranges];
+        const uint64_t end = std::min(count, (b + 1) * kOccurrencesPerBlock);
+        for(uint64_t o = b * kOccurrencesPerBlock; o < end; o++) {
+          cursors[in_leads[o] / leads_per_range]++;
+        }
+      }
+    });
+
+    std::vector<uint32_t> range_offsets(count_ranges + 1, 0);
+    for(uint64_t r=0; r < count_ranges; r++) {
+      uint32_t offset = range_offsets[r];
+      for(uint64_t b=0; b < count_blocks; b++) {
+        const uint32_t count_block_range = block_cursors[b * count_ranges + r];
+        block_cursors[b * count_ranges + r] = offset;
+        offset += count_block_range;
+      }
+      range_offsets[r + 1] = offset;
+    }
+
+    std::vector<uint32_t> order(count);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t b = chunk_begin; b < chunk_end; b++) {
+        uint32_t* cursors = &block_cursors[b * count_ranges];
+        const uint64_t end = std::min(count, (b + 1) * kOccurrencesPerBlock);
+        for(uint64_t o = b * kOccurrencesPerBlock; o < end; o++) {
+          order[cursors[in_leads[o] / leads_per_range]++] = static_cast<uint32_t>(o);
+        }
+      }
+    });
+    block_cursors = std::vector<uint32_t>();
+
+    //every occurrence first refers to the first occurrence of its key
+    out_ids.resize(count);
+    std::vector<uint8_t> is_first(count, 0);
+    ParallelFor(0, count_ranges, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      std::vector<uint32_t> offsets(leads_per_range + 1);
+      std::vector<uint32_t> range_order;
+      for(uint64_t r = chunk_begin; r < chunk_end; r++) {
+        //a stable counting sort on the leading key keeps the occurrences in order within a group
+        const uint32_t first_lead = static_cast<uint32_t>(r * leads_per_range);
+        const auto range_begin = order.begin() + range_offsets[r];
+        const auto range_end = order.begin() + range_offsets[r + 1];
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for(auto it = range_begin; it != range_end; it++) {
+          offsets[in_leads[*it] - first_lead + 1]++;
+        }
+        for(uint64_t lead=0; lead < leads_per_range; lead++) {
+          offsets[lead + 1] += offsets[lead];
+        }
+
+        range_order.resize(range_end - range_begin);
+        {
+          std::vector<uint32_t> cursors(offsets.begin(), offsets.end() - 1);
+          for(auto it = range_begin; it != range_end; it++) {
+            range_order[cursors[in_leads[*it] - first_lead]++] = *it;
+          }
+        }
+
+        for(uint64_t lead=0; lead < leads_per_range; lead++) {
+          const auto begin = range_order.begin() + offsets[lead];
+          const auto end = range_order.begin() + offsets[lead + 1];
+          std::sort(begin, end, [&in_tails](uint32_t lhs, uint32_t rhs) {
+            return (in_tails[lhs] < in_tails[rhs]) || (in_tails[lhs] == in_tails[rhs] && lhs < rhs);
+          });
+
+          for(auto it = begin; it != end; it++) {
+            const bool is_repeated = (it != begin) && (in_tails[*(it - 1)] == in_tails[*it]);
+            out_ids[*it] = is_repeated ? out_ids[*(it - 1)] : *it;
+            is_first[*it] = is_repeated ? 0 : 1;
+          }
+        }
+      }
+    }, 1);
+    order = std::vector<uint32_t>();
+
+    //then the first occurrences are numbered in order, each block after the ones of the blocks before
+    std::vector<uint32_t> block_offsets(count_blocks + 1, 0);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t b = chunk_begin; b < chunk_end; b++) {
+        const uint64_t end = std::min(count, (b + 1) * kOccurrencesPerBlock);
+        block_offsets[b + 1] = static_cast<uint32_t>(std::count(is_first.begin() + b * kOccurrencesPerBlock, is_first.begin() + end, 1));
+      }
+    });
+    for(uint64_t b=0; b < count_blocks; b++) {
+      block_offsets[b + 1] += block_offsets[b];
+    }
+
+    const uint32_t count_keys = block_offsets[count_blocks];
+    out_first_occurrences.resize(count_keys);
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t b = chunk_begin; b < chunk_end; b++) {
+        uint32_t key = block_offsets[b];
+        const uint64_t end = std::min(count, (b + 1) * kOccurrencesPerBlock);
+        for(uint64_t o = b * kOccurrencesPerBlock; o < end; o++) {
+          if(is_first[o]) {
+            out_ids[o] = key;
+            out_first_occurrences[key++] = static_cast<uint32_t>(o);
+          }
+        }
+      }
+    });
+
+    //the repeated occurrences read the id from their first occurrence, which is not changed any more
+    ParallelFor(0, count_blocks, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      for(uint64_t b = chunk_begin; b < chunk_end; b++) {
+        const uint64_t end = std::min(count, (b + 1) * kOccurrencesPerBlock);
+        for(uint64_t o = b * kOccurrencesPerBlock; o < end; o++) {
+          if(is_first[o] == 0) {
+            out_ids[o] = out_ids[out_ids[o]];
+          }
+        }
+      }
+    });
+
+    return count_keys;
+  }
+
+  /**
+   * @brief The number of set bits of a mask below a bit.
+   */
+  int CountBitsBelow(uint8_t mask, int bit) {
+    int count = 0;
+    for(int i=0; i < bit; i++) {
+      count += (mask >> i) & 1;
+    }
+    return count;
+  }
+
+  /**
+   * @brief The edges and faces of the tetrahedra of a voxel as elements of the voxel grid.
+   *
+   * An edge or a face of the grid is keyed by the grid point it is anchored at, the smallest of its
+   * grid points, and by its type, its shape relative to that grid point. A face type also keeps the
+   * directions of its half-edges, which `TetMesh::readFromList` keys the faces by. Every type lists
+   * where it occurs in the tetrahedra of a voxel, so the first occurrence of an element in the cell
+   * order is found from the voxels around its anchor, without hashing or sorting.
+   */
+  struct VoxelGridElementLut {
+    /**
+     * @brief The element at slot `slot` of tetrahedron `tet` in the voxel at the anchor plus `voxel_offset`.
+     */
+    struct Occurrence {
+      vec3i voxel_offset;
+      int tet;
+      int slot;
+    };
+
+    template <int kCountSlots>
+    struct SlotTable {
+      std::array<std::array<vec3i, kCountSlots>, Voxel::kNumFittingTetrahedra> anchors; /**< Offset of the anchor in the voxel. */
+      std::array<std::array<int, kCountSlots>, Voxel::kNumFittingTetrahedra> types;
+      std::array<std::array<bool, kCountSlots>, Voxel::kNumFittingTetrahedra> is_canonical; /**< The edge starts at its anchor, the face has its smaller side half-edge first. */
+      std::vector<std::vector<Occurrence>> occurrences; /**< The occurrences of every type. */
+
+      template <typename Descriptor>
+      void insert(int tet, int slot, const vec3i& anchor, const Descriptor& descriptor,
+                  std::vector<Descriptor>& inout_descriptors) {
+        auto it = std::find(inout_descriptors.begin(), inout_descriptors.end(), descriptor);
+        const int type = static_cast<int>(it - inout_descriptors.begin());
+        if(it == inout_descriptors.end()) {
+          inout_descriptors.push_back(descriptor);
+          occurrences.emplace_back();
+        }
+
+        anchors[tet][slot] = anchor;
+        types[tet][slot] = type;
+        occurrences[type].push_back({-anchor, tet, slot});
+      }
+    };
+
+    SlotTable<Tetrahedra::kNumEdges> edges;
+    SlotTable<Tetrahedra::kNumFaces> faces;
+
+    static const VoxelGridElementLut& get() {
+      static const VoxelGridElementLut lut;
+      return lut;
+    }
+
+  private:
+    VoxelGridElementLut() {
+      auto is_less = [](const vec3i& a, const vec3i& b) {
+        return std::make_tuple(a.z(), a.y(), a.x()) < std::make_tuple(b.z(), b.y(), b.x());
+      };
+
+      //a half-edge of a tetrahedron by the offsets of its start and end in the voxel
+      typedef std::array<int, 6> DirectedEdge;
+      auto directed_edge = [](const vec3i& start, const vec3i& end, const vec3i& anchor) {
+        const vec3i a = start - anchor;
+        const vec3i b = end - anchor;
+        return DirectedEdge{a.x(), a.y(), a.z(), b.x(), b.y(), b.z()};
+      };
+
+      std::vector<std::array<int, 3>> edge_descriptors;
+      std::vector<std::array<DirectedEdge, 3>> face_descriptors;
+      for(int t=0; t < Voxel::kNumFittingTetrahedra; t++) {
+        const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+
+        std::array<vec3i, Tetrahedra::kNumEdges * 2> hedge_starts;
+        std::array<vec3i, Tetrahedra::kNumEdges * 2> hedge_ends;
+        for(int i=0; i < Tetrahedra::kNumEdges; i++) {
+          const vec2i edge_vertices_lut = Tetrahedra::edgeVertexIdsLut(i);
+          const vec3i a = Voxel::vertexOffsetLut(tet_lut[edge_vertices_lut[0]]);
+          const vec3i b = Voxel::vertexOffsetLut(tet_lut[edge_vertices_lut[1]]);
+          hedge_starts[i * 2] = a;
+          hedge_ends[i * 2] = b;
+          hedge_starts[i * 2 + 1] = b;
+          hedge_ends[i * 2 + 1] = a;
+
+          const vec3i anchor = is_less(b, a) ? b : a;
+          const vec3i delta = (is_less(b, a) ? a : b) - anchor;
+          edges.insert(t, i, anchor, std::array<int, 3>{delta.x(), delta.y(), delta.z()}, edge_descriptors);
+          edges.is_canonical[t][i] = (anchor == a);
+        }
+
+        for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+          const vec3i face_halfedges_lut = Tetrahedra::faceHalfEdgeIdsLut(i);
+          vec3i anchor = hedge_starts[face_halfedges_lut[0]];
+          for(int j=1; j < 3; j++) {
+            if(is_less(hedge_starts[face_halfedges_lut[j]], anchor)) {
+              anchor = hedge_starts[face_halfedges_lut[j]];
+            }
+          }
+
+          const DirectedEdge he0 = directed_edge(hedge_starts[face_halfedges_lut[0]], hedge_ends[face_halfedges_lut[0]], anchor);
+          const DirectedEdge he1 = directed_edge(hedge_starts[face_halfedges_lut[1]], hedge_ends[face_halfedges_lut[1]], anchor);
+          const DirectedEdge he2 = directed_edge(hedge_starts[face_halfedges_lut[2]], hedge_ends[face_halfedges_lut[2]], anchor);
+          faces.insert(t, i, anchor, std::array<DirectedEdge, 3>{he1, std::min(he0, he2), std::max(he0, he2)}, face_descriptors);
+          faces.is_canonical[t][i] = (he0 < he2);
+        }
+      }
+    }
+  };
+
+}
+
 TetMesh::TetMesh():VolMesh<kTetMeshNumFacesPerCell, kTetMeshNumEdgesPerFace, TetMeshLayout>() {
 
 }
@@ -84,17 +365,14 @@ CellIndex TetMesh::insertTetrahedra(const vec4i& in_tet_vertex_ids) {
 bool TetMesh::insertVoxel(const std::array<int, Voxel::kNumVerticesPerCell>& in_voxel_vertex_ids,
                           std::array<CellIndex, Voxel::kNumFittingTetrahedra>& out_tet_cell_ids) {
 
-  std::array<vec4i, Voxel::kNumFittingTetrahedra> tet_cells;
-  tet_cells[0] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::LBN], in_voxel_vertex_ids[Voxel::VertexLocationId::LTN], in_voxel_vertex_ids[Voxel::VertexLocationId::RBN], in_voxel_vertex_ids[Voxel::VertexLocationId::LBF]);
-  tet_cells[1] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::RTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LBF], in_voxel_vertex_ids[Voxel::VertexLocationId::RBN]);
-  tet_cells[2] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::RTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LTF], in_voxel_vertex_ids[Voxel::VertexLocationId::LBF]);
-  tet_cells[3] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::RTN], in_voxel_vertex_ids[Voxel::VertexLocationId::RBN], in_voxel_vertex_ids[Voxel::VertexLocationId::LBF], in_voxel_vertex_ids[Voxel::VertexLocationId::RBF]);
-  tet_cells[4] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::RTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LBF], in_voxel_vertex_ids[Voxel::VertexLocationId::LTF], in_voxel_vertex_ids[Voxel::VertexLocationId::RBF]);
-  tet_cells[5] = vec4i(in_voxel_vertex_ids[Voxel::VertexLocationId::RTN], in_voxel_vertex_ids[Voxel::VertexLocationId::LTF], in_voxel_vertex_ids[Voxel::VertexLocationId::RTF], in_voxel_vertex_ids[Voxel::VertexLocationId::RBF]);
-
   bool result = true;
   for(int i=0; i < Voxel::kNumFittingTetrahedra; i++) {
-    out_tet_cell_ids[i] = insertTetrahedra(tet_cells[i]);
+    const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(i);
+    const vec4i tet_cell(in_voxel_vertex_ids[tet_lut[0]],
+                         in_voxel_vertex_ids[tet_lut[1]],
+                         in_voxel_vertex_ids[tet_lut[2]],
+                         in_voxel_vertex_ids[tet_lut[3]]);
+    out_tet_cell_ids[i] = insertTetrahedra(tet_cell);
 
     result &= out_tet_cell_ids[i].valid();
   }
@@ -102,32 +380,475 @@ bool TetMesh::insertVoxel(const std::array<int, Voxel::kNumVerticesPerCell>& in_
   return result;
 }
 
-bool TetMesh::extractBoundaryTriangleMesh(volmesh::TriangleMesh& out_triangle_mesh) const {
-  if(countCells() == 0) {
+bool TetMesh::readFromVoxelGrid(const vec3& origin,
+                                real_t voxel_size,
+                                const vec3i& voxels_count,
+                                const std::vector<uint8_t>& in_voxel_mask) {
+  return readFromVoxelGrid(origin, voxel_size, voxels_count, in_voxel_mask, vec3i(2, 1, 0));
+}
+
+bool TetMesh::readFromVoxelGrid(const vec3& origin,
+                                real_t voxel_size,
+                                const vec3i& voxels_count,
+                                const std::vector<uint8_t>& in_voxel_mask,
+                                const vec3i& in_id_axes) {
+  if(voxels_count.minCoeff() <= 0 || voxel_size <= 0.0) {
+    SPDLOG_ERROR("Invalid voxel grid with [{}, {}, {}] voxels of size [{}]", voxels_count.x(), voxels_count.y(), voxels_count.z(), voxel_size);
+    return false;
+  }
+
+  if(in_id_axes.minCoeff() < 0 || in_id_axes.maxCoeff() > 2 ||
+     in_id_axes[0] == in_id_axes[1] || in_id_axes[1] == in_id_axes[2] || in_id_axes[0] == in_id_axes[2]) {
+    SPDLOG_ERROR("The id axes [{}, {}, {}] are not a permutation of the grid axes", in_id_axes[0], in_id_axes[1], in_id_axes[2]);
+    return false;
+  }
+
+  const int64_t vx = voxels_count.x();
+  const int64_t vy = voxels_count.y();
+  const int64_t vz = voxels_count.z();
+  if(static_cast<int64_t>(in_voxel_mask.size()) != vx * vy * vz) {
+    SPDLOG_ERROR("The voxel mask has [{}] entries for [{}] voxels", in_voxel_mask.size(), vx * vy * vz);
+    return false;
+  }
+
+  //the ids follow the slowest, middle and fastest axes, and the layers are along the slowest one
+  const int slow_axis = in_id_axes[0];
+  const int mid_axis = in_id_axes[1];
+  const int fast_axis = in_id_axes[2];
+  const vec3i points_count = voxels_count + vec3i::Ones();
+  const int64_t count_point_layers = points_count[slow_axis];
+  const int64_t count_voxel_layers = voxels_count[slow_axis];
+  const int64_t count_layer_gridpoints = static_cast<int64_t>(points_count[mid_axis]) * points_count[fast_axis];
+  const uint64_t count_gridpoints = static_cast<uint64_t>(count_point_layers * count_layer_gridpoints);
+  auto voxel_mask_id = [vx, vy](const vec3i& v) {
+    return (static_cast<int64_t>(v.z()) * vy + v.y()) * vx + v.x();
+  };
+  auto is_selected = [&](const vec3i& v) {
+    return v.x() >= 0 && v.x() < vx && v.y() >= 0 && v.y() < vy && v.z() >= 0 && v.z() < vz &&
+           in_voxel_mask[voxel_mask_id(v)] != 0;
+  };
+  auto gridpoint_id = [&](const vec3i& p) {
+    return static_cast<uint64_t>((static_cast<int64_t>(p[slow_axis]) * points_count[mid_axis] + p[mid_axis]) * points_count[fast_axis] + p[fast_axis]);
+  };
+  auto layer_point = [&](int slow, int mid, int fast) {
+    vec3i p;
+    p[slow_axis] = slow;
+    p[mid_axis] = mid;
+    p[fast_axis] = fast;
+    return p;
+  };
+
+  //count the used grid points and the cells of every layer
+  GridVector<uint32_t> vertex_ids;
+  vertex_ids.resize(count_gridpoints);
+  std::vector<uint64_t> layer_vertices(count_point_layers + 1, 0);
+  ParallelFor(0, count_point_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      for(int mid=0; mid < points_count[mid_axis]; mid++) {
+        for(int fast=0; fast < points_count[fast_axis]; fast++) {
+          const vec3i p = layer_point(layer, mid, fast);
+
+          bool is_used = false;
+          for(int c=0; c < Voxel::kNumVerticesPerCell && is_used == false; c++) {
+            is_used = is_selected(p - Voxel::vertexOffsetLut(c));
+          }
+
+          vertex_ids[gridpoint_id(p)] = is_used ? 0 : kSentinelIndex;
+          layer_vertices[layer + 1] += is_used ? 1 : 0;
+        }
+      }
+    }
+  });
+
+  std::vector<uint64_t> layer_cells(count_voxel_layers + 1, 0);
+  ParallelFor(0, count_voxel_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      for(int mid=0; mid < voxels_count[mid_axis]; mid++) {
+        for(int fast=0; fast < voxels_count[fast_axis]; fast++) {
+          if(in_voxel_mask[voxel_mask_id(layer_point(layer, mid, fast))] != 0) {
+            layer_cells[layer + 1] += Voxel::kNumFittingTetrahedra;
+          }
+        }
+      }
+    }
+  });
+
+  for(int64_t layer=0; layer < count_point_layers; layer++) {
+    layer_vertices[layer + 1] += layer_vertices[layer];
+  }
+  for(int64_t layer=0; layer < count_voxel_layers; layer++) {
+    layer_cells[layer + 1] += layer_cells[layer];
+  }
+
+  if(layer_cells[count_voxel_layers] == 0) {
+    SPDLOG_ERROR("No voxel is selected");
+    return false;
+  }
+
+  if(layer_vertices[count_point_layers] >= kSentinelIndex) {
+    SPDLOG_ERROR("The voxel grid has too many vertices for 32 bit indices");
+    return false;
+  }
+
+  //the used grid points are the vertices in grid order
+  std::vector<vec3> vertices(layer_vertices[count_point_layers]);
+  ParallelFor(0, count_point_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      uint32_t vertex_id = static_cast<uint32_t>(layer_vertices[layer]);
+      for(int mid=0; mid < points_count[mid_axis]; mid++) {
+        for(int fast=0; fast < points_count[fast_axis]; fast++) {
+          const vec3i p = layer_point(layer, mid, fast);
+          const uint64_t id = gridpoint_id(p);
+          if(vertex_ids[id] != kSentinelIndex) {
+            vertices[vertex_id] = origin + p.cast<real_t>() * voxel_size;
+            vertex_ids[id] = vertex_id++;
+          }
+        }
+      }
+    }
+  });
+
+  const uint64_t count_cells = layer_cells[count_voxel_layers];
+  if(count_cells * Tetrahedra::kNumEdges * 2 >= kSentinelIndex) {
+    SPDLOG_ERROR("The [{}] cells have too many elements for 32 bit indices", count_cells);
+    return false;
+  }
+
+  //the cells are the tetrahedra of the selected voxels in voxel order
+  GridVector<uint32_t> voxel_cells;
+  voxel_cells.resize(in_voxel_mask.size());
+  ParallelFor(0, count_voxel_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      uint32_t cell_id = static_cast<uint32_t>(layer_cells[layer]);
+      for(int mid=0; mid < voxels_count[mid_axis]; mid++) {
+        for(int fast=0; fast < voxels_count[fast_axis]; fast++) {
+          const int64_t id = voxel_mask_id(layer_point(layer, mid, fast));
+          voxel_cells[id] = (in_voxel_mask[id] != 0) ? cell_id : kSentinelIndex;
+          cell_id += (in_voxel_mask[id] != 0) ? Voxel::kNumFittingTetrahedra : 0;
+        }
+      }
+    }
+  });
+
+  //every edge and every face is numbered at its first occurrence in the cells, as readFromList does.
+  //The occurrences of every type are sorted in the cell order of the id axes, so the first one in a
+  //selected voxel is the first occurrence of the element.
+  const VoxelGridElementLut& lut = VoxelGridElementLut::get();
+  auto sort_occurrences = [slow_axis, mid_axis, fast_axis](std::vector<std::vector<VoxelGridElementLut::Occurrence>> occurrences) {
+    for(auto& type_occurrences : occurrences) {
+      std::sort(type_occurrences.begin(), type_occurrences.end(), [&](const VoxelGridElementLut::Occurrence& lhs,
+                                                                      const VoxelGridElementLut::Occurrence& rhs) {
+        return std::make_tuple(lhs.voxel_offset[slow_axis], lhs.voxel_offset[mid_axis], lhs.voxel_offset[fast_axis], lhs.tet, lhs.slot) <
+               std::make_tuple(rhs.voxel_offset[slow_axis], rhs.voxel_offset[mid_axis], rhs.voxel_offset[fast_axis], rhs.tet, rhs.slot);
+      });
+    }
+    return occurrences;
+  };
+  const std::vector<std::vector<VoxelGridElementLut::Occurrence>> edge_occurrences = sort_occurrences(lut.edges.occurrences);
+  const std::vector<std::vector<VoxelGridElementLut::Occurrence>> face_occurrences = sort_occurrences(lut.faces.occurrences);
+
+  auto first_occurrence = [&](const vec3i& anchor,
+                              const std::vector<VoxelGridElementLut::Occurrence>& occurrences,
+                              int count_slots,
+                              int& out_tet,
+                              int& out_slot) {
+    for(const VoxelGridElementLut::Occurrence& occurrence : occurrences) {
+      const vec3i v = anchor + occurrence.voxel_offset;
+      if(is_selected(v)) {
+        out_tet = occurrence.tet;
+        out_slot = occurrence.slot;
+        return (static_cast<uint64_t>(voxel_cells[voxel_mask_id(v)]) + occurrence.tet) * count_slots + occurrence.slot;
+      }
+    }
+
+    return std::numeric_limits<uint64_t>::max();
+  };
+
+  //find the first occurrence of the element at every slot of every cell, with the high bit set when
+  //the slot has the direction of the first occurrence, and count the first occurrences per layer
+  static const uint32_t kIsForwardBit = 1u << 31;
+  GridVector<uint32_t> edge_firsts;
+  GridVector<uint32_t> face_firsts;
+  GridVector<uint8_t> edge_masks;
+  GridVector<uint8_t> face_masks;
+  edge_firsts.resize(count_cells * Tetrahedra::kNumEdges);
+  face_firsts.resize(count_cells * Tetrahedra::kNumFaces);
+  edge_masks.resize(count_cells);
+  face_masks.resize(count_cells);
+  std::vector<uint64_t> layer_edges(count_voxel_layers + 1, 0);
+  std::vector<uint64_t> layer_faces(count_voxel_layers + 1, 0);
+  ParallelFor(0, count_voxel_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      for(int mid=0; mid < voxels_count[mid_axis]; mid++) {
+        for(int fast=0; fast < voxels_count[fast_axis]; fast++) {
+          const vec3i v = layer_point(layer, mid, fast);
+          const uint32_t first_cell = voxel_cells[voxel_mask_id(v)];
+          if(first_cell == kSentinelIndex) {
+            continue;
+          }
+
+          for(int t=0; t < Voxel::kNumFittingTetrahedra; t++) {
+            const uint64_t c = first_cell + t;
+            uint8_t edge_mask = 0;
+            for(int i=0; i < Tetrahedra::kNumEdges; i++) {
+              int first_t = 0;
+              int first_slot = 0;
+              const uint64_t first = first_occurrence(v + lut.edges.anchors[t][i], edge_occurrences[lut.edges.types[t][i]],
+                                                      Tetrahedra::kNumEdges, first_t, first_slot);
+              const bool is_forward = (lut.edges.is_canonical[t][i] == lut.edges.is_canonical[first_t][first_slot]);
+              edge_firsts[c * Tetrahedra::kNumEdges + i] = static_cast<uint32_t>(first) | (is_forward ? kIsForwardBit : 0);
+              edge_mask |= (first == c * Tetrahedra::kNumEdges + i) ? (1 << i) : 0;
+            }
+
+            uint8_t face_mask = 0;
+            for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+              int first_t = 0;
+              int first_slot = 0;
+              const uint64_t first = first_occurrence(v + lut.faces.anchors[t][i], face_occurrences[lut.faces.types[t][i]],
+                                                      Tetrahedra::kNumFaces, first_t, first_slot);
+              const bool is_forward = (lut.faces.is_canonical[t][i] == lut.faces.is_canonical[first_t][first_slot]);
+              face_firsts[c * Tetrahedra::kNumFaces + i] = static_cast<uint32_t>(first) | (is_forward ? kIsForwardBit : 0);
+              face_mask |= (first == c * Tetrahedra::kNumFaces + i) ? (1 << i) : 0;
+            }
+
+            edge_masks[c] = edge_mask;
+            face_masks[c] = face_mask;
+            layer_edges[layer + 1] += CountBitsBelow(edge_mask, Tetrahedra::kNumEdges);
+            layer_faces[layer + 1] += CountBitsBelow(face_mask, Tetrahedra::kNumFaces);
+          }
+        }
+      }
+    }
+  });
+  voxel_cells = GridVector<uint32_t>();
+
+  for(int64_t layer=0; layer < count_voxel_layers; layer++) {
+    layer_edges[layer + 1] += layer_edges[layer];
+    layer_faces[layer + 1] += layer_faces[layer];
+  }
+
+  //the id of the first edge and of the first face numbered in every cell
+  GridVector<uint32_t> cell_edge_ids;
+  GridVector<uint32_t> cell_face_ids;
+  cell_edge_ids.resize(count_cells);
+  cell_face_ids.resize(count_cells);
+  ParallelFor(0, count_voxel_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t layer = chunk_begin; layer < chunk_end; layer++) {
+      uint32_t edge_id = static_cast<uint32_t>(layer_edges[layer]);
+      uint32_t face_id = static_cast<uint32_t>(layer_faces[layer]);
+      for(uint64_t c = layer_cells[layer]; c < layer_cells[layer + 1]; c++) {
+        cell_edge_ids[c] = edge_id;
+        cell_face_ids[c] = face_id;
+        edge_id += CountBitsBelow(edge_masks[c], Tetrahedra::kNumEdges);
+        face_id += CountBitsBelow(face_masks[c], Tetrahedra::kNumFaces);
+      }
+    }
+  });
+
+  //every edge and face adds its two halves, the first one in the direction of its first occurrence
+  const uint64_t count_edges = layer_edges[count_voxel_layers];
+  const uint64_t count_faces = layer_faces[count_voxel_layers];
+  const HalfEdgeIndex sentinel_hedge_id = HalfEdgeIndex::create(kSentinelIndex);
+  const HalfFaceIndex sentinel_hface_id = HalfFaceIndex::create(kSentinelIndex);
+  GridVector<HalfEdge> hedges(count_edges * 2);
+  GridVector<TetMesh::Layout::HalfFaceType> hfaces(count_faces * 2, TetMesh::Layout::HalfFaceType(
+    TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({sentinel_hedge_id, sentinel_hedge_id, sentinel_hedge_id})));
+  GridVector<TetMesh::Layout::CellType> cells(count_cells, TetMesh::Layout::CellType(TetMesh::Layout::CellType::HalfFaceIndexArray({
+    sentinel_hface_id, sentinel_hface_id, sentinel_hface_id, sentinel_hface_id})));
+  ParallelFor(0, count_voxel_layers, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(int layer = static_cast<int>(chunk_begin); layer < static_cast<int>(chunk_end); layer++) {
+      uint64_t c = layer_cells[layer];
+      for(int mid=0; mid < voxels_count[mid_axis]; mid++) {
+        for(int fast=0; fast < voxels_count[fast_axis]; fast++) {
+          const vec3i v = layer_point(layer, mid, fast);
+          if(in_voxel_mask[voxel_mask_id(v)] == 0) {
+            continue;
+          }
+
+          std::array<uint32_t, Voxel::kNumVerticesPerCell> voxel_vertex_ids;
+          for(int k=0; k < Voxel::kNumVerticesPerCell; k++) {
+            voxel_vertex_ids[k] = vertex_ids[gridpoint_id(v + Voxel::vertexOffsetLut(k))];
+          }
+
+          for(int t=0; t < Voxel::kNumFittingTetrahedra; t++, c++) {
+            std::array<uint32_t, Tetrahedra::kNumEdges * 2> hedge_ids;
+            for(int i=0; i < Tetrahedra::kNumEdges; i++) {
+              const uint32_t first = edge_firsts[c * Tetrahedra::kNumEdges + i] & ~kIsForwardBit;
+              const bool is_forward = (edge_firsts[c * Tetrahedra::kNumEdges + i] & kIsForwardBit) != 0;
+              const uint64_t first_c = first / Tetrahedra::kNumEdges;
+              const uint32_t edge_id = cell_edge_ids[first_c] + CountBitsBelow(edge_masks[first_c], first % Tetrahedra::kNumEdges);
+              hedge_ids[i * 2] = edge_id * 2 + (is_forward ? 0 : 1);
+              hedge_ids[i * 2 + 1] = hedge_ids[i * 2] ^ 1;
+
+              if(first == c * Tetrahedra::kNumEdges + i) {
+                const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+                const vec2i edge_vertices_lut = Tetrahedra::edgeVertexIdsLut(i);
+                const VertexIndex a = VertexIndex::create(voxel_vertex_ids[tet_lut[edge_vertices_lut[0]]]);
+                const VertexIndex b = VertexIndex::create(voxel_vertex_ids[tet_lut[edge_vertices_lut[1]]]);
+                hedges[edge_id * 2] = HalfEdge(a, b);
+                hedges[edge_id * 2 + 1] = HalfEdge(b, a);
+              }
+            }
+
+            std::array<HalfFaceIndex, Tetrahedra::kNumFaces> hface_ids = {sentinel_hface_id, sentinel_hface_id, sentinel_hface_id, sentinel_hface_id};
+            for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+              const uint32_t first = face_firsts[c * Tetrahedra::kNumFaces + i] & ~kIsForwardBit;
+              const bool is_forward = (face_firsts[c * Tetrahedra::kNumFaces + i] & kIsForwardBit) != 0;
+              const uint64_t first_c = first / Tetrahedra::kNumFaces;
+              const uint32_t face_id = cell_face_ids[first_c] + CountBitsBelow(face_masks[first_c], first % Tetrahedra::kNumFaces);
+              hface_ids[i] = HalfFaceIndex::create(face_id * 2 + (is_forward ? 0 : 1));
+
+              if(first == c * Tetrahedra::kNumFaces + i) {
+                const vec3i face_halfedges_lut = Tetrahedra::faceHalfEdgeIdsLut(i);
+                const HalfEdgeIndex he0 = HalfEdgeIndex::create(hedge_ids[face_halfedges_lut[0]]);
+                const HalfEdgeIndex he1 = HalfEdgeIndex::create(hedge_ids[face_halfedges_lut[1]]);
+                const HalfEdgeIndex he2 = HalfEdgeIndex::create(hedge_ids[face_halfedges_lut[2]]);
+                hfaces[face_id * 2] = TetMesh::Layout::HalfFaceType(TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({he0, he1, he2}));
+                hfaces[face_id * 2 + 1] = TetMesh::Layout::HalfFaceType(TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({he2, he1, he0}));
+              }
+            }
+
+            cells[c] = TetMesh::Layout::CellType(TetMesh::Layout::CellType::HalfFaceIndexArray({hface_ids[0], hface_ids[1], hface_ids[2], hface_ids[3]}));
+          }
+        }
+      }
+    }
+  });
+  vertex_ids = GridVector<uint32_t>();
+
+  clear();
+  cell_labels_.clear();
+
+  bool result = assignTopology(vertices, std::move(hedges), std::move(hfaces), std::move(cells));
+  result &= (countCells() == count_cells);
+  return result;
+}
+
+bool TetMesh::setCellLabels(const std::vector<uint32_t>& in_cell_labels) {
+  if(in_cell_labels.size() != countCells()) {
+    SPDLOG_ERROR("There are [{}] labels for [{}] cells", in_cell_labels.size(), countCells());
     return false;
   }
 
-  //Loop over the list of half-faces and make a separate list of all half faces that are
-  //not references by any tetrahedra cells
-  std::vector<HalfFaceIndex> orphan_hfaces;
-  {
-    const uint32_t count_hfaces = countHalfFaces();
-    orphan_hfaces.reserve(count_hfaces / 2);
-    for(uint32_t i=0; i < count_hfaces; i++) {
-      const HalfFaceIndex hface_id = HalfFaceIndex::create(i);
-      if(countIncidentCellsPerHalfFace(hface_id) == 0) {
-        orphan_hfaces.push_back(hface_id);
+  cell_labels_ = in_cell_labels;
+  return true;
+}
+
+bool TetMesh::hasCellLabels() const {
+  return (countCells() > 0) && (cell_labels_.size() == countCells());
+}
+
+uint32_t TetMesh::cellLabel(const CellIndex& in_cell_id) const {
+  if(hasCellLabels() == false || in_cell_id.get() >= cell_labels_.size()) {
+    throw std::out_of_range(fmt::format("The cell id [{}] has no label, there are [{}] labels for [{}] cells",
+                                        in_cell_id.get(), cell_labels_.size(), countCells()));
+  }
+
+  return cell_labels_[in_cell_id.get()];
+}
+
+const std::vector<uint32_t>& TetMesh::cellLabels() const {
+  return cell_labels_;
+}
+
+uint32_t TetMesh::getBoundaryHalfFaces(std::vector<HalfFaceIndex>& out_boundary_hfaces) const {
+  out_boundary_hfaces.clear();
+
+  const uint64_t count_cells = countCells();
+  const uint32_t count_hedges = countHalfEdges();
+  const uint32_t count_hfaces = countHalfFaces();
+  if(count_cells == 0) {
+    return 0;
+  }
+
+  //the halves of an edge and of a face are stored next to each other, hedge ^ 1 and hface ^ 1 are their opposite halves
+  std::atomic<bool> has_paired_halves((count_hedges % 2 == 0) && (count_hfaces % 2 == 0));
+  ParallelFor(0, count_hedges / 2, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t k = chunk_begin; k < chunk_end; k++) {
+      const HalfEdge& forward_hedge = halfEdge(HalfEdgeIndex::create(static_cast<uint32_t>(k * 2)));
+      const HalfEdge& backward_hedge = halfEdge(HalfEdgeIndex::create(static_cast<uint32_t>(k * 2 + 1)));
+      if(forward_hedge.start().get() == forward_hedge.end().get() ||
+         forward_hedge.start().get() != backward_hedge.end().get() ||
+         forward_hedge.end().get() != backward_hedge.start().get()) {
+        has_paired_halves = false;
       }
     }
+  }, kCellsPerTask);
+
+  if(has_paired_halves.load() == false) {
+    SPDLOG_ERROR("The half-edges of the tetrahedral mesh are not stored as pairs of opposite halves");
+    return 0;
   }
 
-  SPDLOG_DEBUG("Found [{}] orphaned half faces.", orphan_hfaces.size());
+  //a face is keyed by the edges of its half-edges, so the two cells sharing it have the same key
+  std::vector<uint32_t> leads(count_cells * Tetrahedra::kNumFaces);
+  std::vector<std::array<uint32_t, 2>> tails(leads.size());
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      const CellType& tet = cell(CellIndex::create(static_cast<uint32_t>(c)));
+      for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+        const HalfFaceType& hface = halfFace(tet.halfFaceIndex(i));
+        std::array<uint32_t, 3> edge_ids = {hface.halfEdgeIndex(0).get() >> 1,
+                                            hface.halfEdgeIndex(1).get() >> 1,
+                                            hface.halfEdgeIndex(2).get() >> 1};
+        std::sort(edge_ids.begin(), edge_ids.end());
+        leads[c * Tetrahedra::kNumFaces + i] = edge_ids[0];
+        tails[c * Tetrahedra::kNumFaces + i] = {edge_ids[1], edge_ids[2]};
+      }
+    }
+  }, kCellsPerTask);
+
+  std::vector<uint32_t> ids;
+  std::vector<uint32_t> first_occurrences;
+  const uint32_t count_faces = NumberFirstOccurrences(count_hedges / 2, leads, tails, ids, first_occurrences);
+  tails = std::vector<std::array<uint32_t, 2>>();
+
+  std::vector<std::atomic<uint8_t>> is_shared(count_faces);
+  ParallelFor(0, leads.size(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t o = chunk_begin; o < chunk_end; o++) {
+      if(first_occurrences[ids[o]] != o) {
+        is_shared[ids[o]].store(1, std::memory_order_relaxed);
+      }
+    }
+  }, kOccurrencesPerBlock);
+
+  //a face of a single cell is on the boundary, its opposite half-face faces away from the cell
+  std::vector<uint8_t> is_boundary(count_hfaces, 0);
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      const CellType& tet = cell(CellIndex::create(static_cast<uint32_t>(c)));
+      for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+        if(is_shared[ids[c * Tetrahedra::kNumFaces + i]].load(std::memory_order_relaxed) == 0) {
+          is_boundary[tet.halfFaceIndex(i).get() ^ 1] = 1;
+        }
+      }
+    }
+  }, kCellsPerTask);
+
+  for(uint32_t i=0; i < count_hfaces; i++) {
+    if(is_boundary[i] != 0) {
+      out_boundary_hfaces.push_back(HalfFaceIndex::create(i));
+    }
+  }
+
+  return static_cast<uint32_t>(out_boundary_hfaces.size());
+}
+
+bool TetMesh::extractBoundaryTriangleMesh(volmesh::TriangleMesh& out_triangle_mesh) const {
+  if(countCells() == 0) {
+    return false;
+  }
 
-  std::vector<vec3> triangle_vertices(orphan_hfaces.size() * 3);
-  std::vector<vec3> triangle_normals(orphan_hfaces.size());
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  getBoundaryHalfFaces(boundary_hfaces);
 
-  for(size_t i=0; i < orphan_hfaces.size(); i++) {
-    const HalfFace hface = halfFace(orphan_hfaces[i]);
+  SPDLOG_DEBUG("Found [{}] boundary half faces.", boundary_hfaces.size());
+
+  std::vector<vec3> triangle_vertices(boundary_hfaces.size() * 3);
+  std::vector<vec3> triangle_normals(boundary_hfaces.size());
+
+  for(size_t i=0; i < boundary_hfaces.size(); i++) {
+    const HalfFace hface = halfFace(boundary_hfaces[i]);
     const HalfEdge hedge0 = halfEdge(hface.halfEdgeIndex(0));
     const HalfEdge hedge1 = halfEdge(hface.halfEdgeIndex(1));
     const HalfEdge hedge2 = halfEdge(hface.halfEdgeIndex(2));
@@ -136,7 +857,7 @@ bool TetMesh::extractBoundaryTriangleMesh(volmesh::TriangleMesh& out_triangle_me
     const uint32_t ib = hedge1.start();
     const uint32_t ic = hedge2.start();
 
-    SPDLOG_TRACE("Triangle {} of {} = [{}, {}, {}]", i + 1, orphan_hfaces.size(), ia, ib, ic);
+    SPDLOG_TRACE("Triangle {} of {} = [{}, {}, {}]", i + 1, boundary_hfaces.size(), ia, ib, ic);
 
     const vec3 a = vertex(hedge0.start());
     const vec3 b = vertex(hedge1.start());
@@ -159,14 +880,173 @@ bool TetMesh::readFromList(const std::vector<vec3>& in_vertices,
     return false;
   }
 
+  const int count_vertices = static_cast<int>(in_vertices.size());
+  const uint64_t count_cells = in_tet_cells_by_vertex_ids.size();
+  std::atomic<bool> has_repeated_vertices(false);
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    bool has_chunk_repeated_vertices = false;
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      const vec4i& tet_vertex_ids = in_tet_cells_by_vertex_ids[c];
+      if(tet_vertex_ids.minCoeff() < 0 || tet_vertex_ids.maxCoeff() >= count_vertices) {
+        throw std::out_of_range("Some of the vertex indices for the supplied cell are out of range");
+      }
+
+      for(int i=0; i < 4; i++) {
+        for(int j=i + 1; j < 4; j++) {
+          has_chunk_repeated_vertices |= (tet_vertex_ids[i] == tet_vertex_ids[j]);
+        }
+      }
+    }
+
+    if(has_chunk_repeated_vertices) {
+      has_repeated_vertices.store(true);
+    }
+  }, kCellsPerTask);
+
+  if(count_cells * Tetrahedra::kNumEdges * 2 >= kSentinelIndex) {
+    SPDLOG_ERROR("The [{}] cells have too many elements for 32 bit indices", count_cells);
+    return false;
+  }
+
   clear();
+  cell_labels_.clear();
 
-  bool result = insertAllVertices(in_vertices);
-  for(auto it = in_tet_cells_by_vertex_ids.begin(); it != in_tet_cells_by_vertex_ids.end(); it++) {
-    insertTetrahedra(*it);
+  //a cell with a repeated vertex has half-edges and half-faces that coincide, insert it as it is
+  if(has_repeated_vertices.load()) {
+    bool result = insertAllVertices(in_vertices);
+    for(auto it = in_tet_cells_by_vertex_ids.begin(); it != in_tet_cells_by_vertex_ids.end(); it++) {
+      insertTetrahedra(*it);
+    }
+
+    result &= (countCells() == count_cells);
+    return result;
   }
 
-  result &= (countCells() == in_tet_cells_by_vertex_ids.size());
+  //the elements are numbered in the order insertTetrahedra creates them, every edge and every face
+  //adds its two halves at its first occurrence, the first one in the direction of that occurrence.
+  //The keys of the cells are made in parallel and every element is made from its first occurrence,
+  //so the ids are the same for any number of threads.
+  std::vector<uint32_t> leads(count_cells * Tetrahedra::kNumEdges);
+  std::vector<uint32_t> edge_tails(leads.size());
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      for(int i=0; i < Tetrahedra::kNumEdges; i++) {
+        const vec2i edge_vertices_lut = Tetrahedra::edgeVertexIdsLut(i);
+        const uint32_t a = in_tet_cells_by_vertex_ids[c][edge_vertices_lut[0]];
+        const uint32_t b = in_tet_cells_by_vertex_ids[c][edge_vertices_lut[1]];
+        leads[c * Tetrahedra::kNumEdges + i] = std::min(a, b);
+        edge_tails[c * Tetrahedra::kNumEdges + i] = std::max(a, b);
+      }
+    }
+  }, kCellsPerTask);
+
+  std::vector<uint32_t> ids;
+  std::vector<uint32_t> first_occurrences;
+  const uint32_t count_edges = NumberFirstOccurrences(static_cast<uint32_t>(count_vertices), leads, edge_tails, ids, first_occurrences);
+  edge_tails = std::vector<uint32_t>();
+
+  GridVector<HalfEdge> hedges(static_cast<size_t>(count_edges) * 2);
+  ParallelFor(0, count_edges, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t k = chunk_begin; k < chunk_end; k++) {
+      const uint64_t c = first_occurrences[k] / Tetrahedra::kNumEdges;
+      const vec2i edge_vertices_lut = Tetrahedra::edgeVertexIdsLut(first_occurrences[k] % Tetrahedra::kNumEdges);
+      const VertexIndex a = VertexIndex::create(in_tet_cells_by_vertex_ids[c][edge_vertices_lut[0]]);
+      const VertexIndex b = VertexIndex::create(in_tet_cells_by_vertex_ids[c][edge_vertices_lut[1]]);
+      hedges[k * 2] = HalfEdge(a, b);
+      hedges[k * 2 + 1] = HalfEdge(b, a);
+    }
+  }, kCellsPerTask);
+
+  std::vector<uint32_t> cell_hedge_ids(count_cells * Tetrahedra::kNumEdges * 2);
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      for(int i=0; i < Tetrahedra::kNumEdges; i++) {
+        const vec2i edge_vertices_lut = Tetrahedra::edgeVertexIdsLut(i);
+        const uint32_t edge_id = ids[c * Tetrahedra::kNumEdges + i];
+        const bool is_forward = (hedges[edge_id * 2].start().get() == static_cast<uint32_t>(in_tet_cells_by_vertex_ids[c][edge_vertices_lut[0]]));
+        const uint32_t forward_hedge_id = edge_id * 2 + (is_forward ? 0 : 1);
+        cell_hedge_ids[(c * Tetrahedra::kNumEdges + i) * 2] = forward_hedge_id;
+        cell_hedge_ids[(c * Tetrahedra::kNumEdges + i) * 2 + 1] = forward_hedge_id ^ 1;
+      }
+    }
+  }, kCellsPerTask);
+
+  //a face is keyed by its half-edges in the order that starts with the smaller of its end ones
+  auto face_hedge_ids = [&cell_hedge_ids](uint64_t c, int i) {
+    const vec3i face_halfedges_lut = Tetrahedra::faceHalfEdgeIdsLut(i);
+    const uint32_t* hedge_ids = &cell_hedge_ids[c * Tetrahedra::kNumEdges * 2];
+    return std::array<uint32_t, 3>{hedge_ids[face_halfedges_lut[0]], hedge_ids[face_halfedges_lut[1]], hedge_ids[face_halfedges_lut[2]]};
+  };
+
+  leads.resize(count_cells * Tetrahedra::kNumFaces);
+  std::vector<std::array<uint32_t, 2>> face_tails(leads.size());
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+        const std::array<uint32_t, 3> he = face_hedge_ids(c, i);
+        leads[c * Tetrahedra::kNumFaces + i] = std::min(he[0], he[2]);
+        face_tails[c * Tetrahedra::kNumFaces + i] = {he[1], std::max(he[0], he[2])};
+      }
+    }
+  }, kCellsPerTask);
+
+  const uint32_t count_faces = NumberFirstOccurrences(static_cast<uint32_t>(hedges.size()), leads, face_tails, ids, first_occurrences);
+  face_tails = std::vector<std::array<uint32_t, 2>>();
+
+  const HalfEdgeIndex sentinel_hedge_id = HalfEdgeIndex::create(kSentinelIndex);
+  GridVector<TetMesh::Layout::HalfFaceType> hfaces(static_cast<size_t>(count_faces) * 2, TetMesh::Layout::HalfFaceType(
+    TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({sentinel_hedge_id, sentinel_hedge_id, sentinel_hedge_id})));
+  ParallelFor(0, count_faces, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t k = chunk_begin; k < chunk_end; k++) {
+      const std::array<uint32_t, 3> he = face_hedge_ids(first_occurrences[k] / Tetrahedra::kNumFaces,
+                                                        first_occurrences[k] % Tetrahedra::kNumFaces);
+      const HalfEdgeIndex he0 = HalfEdgeIndex::create(he[0]);
+      const HalfEdgeIndex he1 = HalfEdgeIndex::create(he[1]);
+      const HalfEdgeIndex he2 = HalfEdgeIndex::create(he[2]);
+      hfaces[k * 2] = TetMesh::Layout::HalfFaceType(TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({he0, he1, he2}));
+      hfaces[k * 2 + 1] = TetMesh::Layout::HalfFaceType(TetMesh::Layout::HalfFaceType::HalfEdgeIndexArray({he2, he1, he0}));
+    }
+  }, kCellsPerTask);
+
+  std::vector<uint32_t> cell_hface_ids(count_cells * Tetrahedra::kNumFaces);
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      for(int i=0; i < Tetrahedra::kNumFaces; i++) {
+        const uint32_t face_id = ids[c * Tetrahedra::kNumFaces + i];
+        const bool is_forward = (hfaces[face_id * 2].halfEdgeIndex(0).get() == face_hedge_ids(c, i)[0]);
+        cell_hface_ids[c * Tetrahedra::kNumFaces + i] = face_id * 2 + (is_forward ? 0 : 1);
+      }
+    }
+  }, kCellsPerTask);
+  cell_hedge_ids = std::vector<uint32_t>();
+
+  //a repeated cell is kept once, as insertCellIfNotExists does
+  leads.resize(count_cells);
+  std::vector<std::array<uint32_t, 3>> cell_tails(count_cells);
+  ParallelFor(0, count_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t c = chunk_begin; c < chunk_end; c++) {
+      leads[c] = cell_hface_ids[c * Tetrahedra::kNumFaces];
+      cell_tails[c] = {cell_hface_ids[c * Tetrahedra::kNumFaces + 1],
+                       cell_hface_ids[c * Tetrahedra::kNumFaces + 2],
+                       cell_hface_ids[c * Tetrahedra::kNumFaces + 3]};
+    }
+  }, kCellsPerTask);
+
+  const uint32_t count_unique_cells = NumberFirstOccurrences(static_cast<uint32_t>(hfaces.size()), leads, cell_tails, ids, first_occurrences);
+  const HalfFaceIndex sentinel_hface_id = HalfFaceIndex::create(kSentinelIndex);
+  GridVector<TetMesh::Layout::CellType> cells(count_unique_cells, TetMesh::Layout::CellType(TetMesh::Layout::CellType::HalfFaceIndexArray({
+    sentinel_hface_id, sentinel_hface_id, sentinel_hface_id, sentinel_hface_id})));
+  ParallelFor(0, count_unique_cells, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for(uint64_t k = chunk_begin; k < chunk_end; k++) {
+      const uint32_t* hface_ids = &cell_hface_ids[static_cast<uint64_t>(first_occurrences[k]) * Tetrahedra::kNumFaces];
+      cells[k] = TetMesh::Layout::CellType(TetMesh::Layout::CellType::HalfFaceIndexArray({
+        HalfFaceIndex::create(hface_ids[0]), HalfFaceIndex::create(hface_ids[1]),
+        HalfFaceIndex::create(hface_ids[2]), HalfFaceIndex::create(hface_ids[3])}));
+    }
+  }, kCellsPerTask);
+
+  bool result = assignTopology(in_vertices, std::move(hedges), std::move(hfaces), std::move(cells));
+  result &= (countCells() == count_cells);
   return result;
 }
 
@@ -191,29 +1071,24 @@ bool TetMesh::writeToList(std::vector<vec3>& out_vertices,
     TetMesh::CellType curr_cell = cell(CellIndex::create(i));
 
     //face0 of each tet cell references half-edges {0, 2, 4} which correspond to edges {0, 1, 2}
-    //edge 0 -> vertex {1, 2}
-    //edge 1 -> vertex {2, 3}
-    //edge 2 -> vertex {3, 1}
+    //half-edge 0 -> vertex 1 to 2
+    //half-edge 2 -> vertex 2 to 3
 
     //face2 of each tet cell references half-edges {9, 10, 5} which correspond to edges {4, 5, 2}
-    //edge 4 -> vertex {0, 3}
-    //edge 5 -> vertex {0, 1}
-    //edge 2 -> vertex {3, 1}
+    //half-edge 9 -> vertex 3 to 0
 
-    //each tet cell has 4 half-faces
+    //the half-edges keep their direction, so the vertices are read in the order of the cell
     TetMesh::HalfFaceType face0 = halfFace(curr_cell.halfFaceIndex(0));
-
-    //each half-face has 3 half-edges
-    volmesh::HalfEdge face0_hedge0 = halfEdge(face0.halfEdgeIndex(0)).sortedVertexIds();
-    volmesh::HalfEdge face0_hedge2 = halfEdge(face0.halfEdgeIndex(1)).sortedVertexIds();
+    const volmesh::HalfEdge& face0_hedge0 = halfEdge(face0.halfEdgeIndex(0));
+    const volmesh::HalfEdge& face0_hedge1 = halfEdge(face0.halfEdgeIndex(1));
 
     TetMesh::HalfFaceType face2 = halfFace(curr_cell.halfFaceIndex(2));
-    volmesh::HalfEdge face2_hedge0 = halfEdge(face2.halfEdgeIndex(0)).sortedVertexIds();
+    const volmesh::HalfEdge& face2_hedge0 = halfEdge(face2.halfEdgeIndex(0));
 
-    out_tet_cells_by_vertex_ids[i] = vec4i(face2_hedge0.start(),
+    out_tet_cells_by_vertex_ids[i] = vec4i(face2_hedge0.end(),
                                            face0_hedge0.start(),
                                            face0_hedge0.end(),
-                                           face0_hedge2.end());
+                                           face0_hedge1.end());
   }
 
   return true;
@@ -334,6 +1209,26 @@ bool TetMesh::exportToVTK(const std::string& filepath, const bool is_binary) {
     }
   }
 
+  //Write the material labels
+  if(hasCellLabels()) {
+    if(is_binary) {
+      file << std::endl;
+    }
+
+    file << "CELL_DATA " << total_cells_count << std::endl;
+    file << "SCALARS Material int 1" << std::endl;
+    file << "LOOKUP_TABLE default" << std::endl;
+    for (size_t i = 0; i < cell_labels_.size(); i++) {
+      int label = static_cast<int>(cell_labels_[i]);
+      if(is_binary) {
+        SwapEndianness(label);
+        file.write(reinterpret_cast<const char*>(&label), sizeof(int));
+      } else {
+        file << label << std::endl;
+      }
+    }
+  }
+
   file.close();
   return true;
 }
\ No newline at end of file
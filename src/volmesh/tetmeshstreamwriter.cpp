@@ -0,0 +1,444 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/tetmeshstreamwriter.h"
+#include "volmesh/logger.h"
+#include "volmesh/tetrahedra.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <limits>
+#include <map>
+#include <typeinfo>
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief The number of vertices or cells copied into the VTK file at once.
+     */
+    const uint64_t kCopyBlockSize = 1 << 16;
+
+    /**
+     * @brief Converts a value to the big endian byte order of the binary VTK format.
+     */
+    template <typename T>
+    void SwapEndianness(T& var) {
+      char* varArray = reinterpret_cast<char*>(&var);
+      for(long i = 0; i < static_cast<long>(sizeof(var)/2); i++) {
+        std::swap(varArray[sizeof(var) - 1 - i], varArray[i]);
+      }
+    }
+
+    /**
+     * @brief Reads a block of raw values written to a temporary file.
+     */
+    template <typename T>
+    bool ReadBlock(std::ifstream& file, uint64_t count, std::vector<T>& out_values) {
+      out_values.resize(count);
+      file.read(reinterpret_cast<char*>(out_values.data()), static_cast<std::streamsize>(count * sizeof(T)));
+      return static_cast<bool>(file);
+    }
+
+  }
+
+  TetMeshStreamWriter::TetMeshStreamWriter() {
+  }
+
+  TetMeshStreamWriter::~TetMeshStreamWriter() {
+    discard();
+  }
+
+  bool TetMeshStreamWriter::open(const std::string& filepath, bool is_binary) {
+    discard();
+
+    filepath_ = filepath;
+    is_binary_ = is_binary;
+    vertices_filepath_ = filepath + ".vertices.tmp";
+    cells_filepath_ = filepath + ".cells.tmp";
+    labels_filepath_ = filepath + ".labels.tmp";
+
+    vertices_file_.open(vertices_filepath_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    cells_file_.open(cells_filepath_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    labels_file_.open(labels_filepath_.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+    is_open_ = true;
+    if(!vertices_file_ || !cells_file_ || !labels_file_) {
+      SPDLOG_ERROR("Unable to create the temporary files of [{}]", filepath);
+      discard();
+      return false;
+    }
+
+    return true;
+  }
+
+  bool TetMeshStreamWriter::isOpen() const {
+    return is_open_;
+  }
+
+  bool TetMeshStreamWriter::writeVertices(const std::vector<vec3>& in_vertices) {
+    if(is_open_ == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    for(const vec3& p : in_vertices) {
+      const real_t xyz[3] = {p.x(), p.y(), p.z()};
+      vertices_file_.write(reinterpret_cast<const char*>(xyz), sizeof(xyz));
+    }
+
+    count_vertices_ += in_vertices.size();
+    if(!vertices_file_) {
+      SPDLOG_ERROR("Unable to write [{}] vertices of [{}]", in_vertices.size(), filepath_);
+      return false;
+    }
+
+    return true;
+  }
+
+  bool TetMeshStreamWriter::writeCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids) {
+    if(is_open_ && count_labels_ > 0) {
+      SPDLOG_ERROR("The cells of [{}] have material labels, the next cells need them too", filepath_);
+      return false;
+    }
+
+    return appendCells(in_tet_cells_by_vertex_ids);
+  }
+
+  bool TetMeshStreamWriter::writeCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids,
+                                       const std::vector<uint32_t>& in_cell_labels) {
+    if(in_cell_labels.size() != in_tet_cells_by_vertex_ids.size()) {
+      SPDLOG_ERROR("There are [{}] labels for [{}] cells", in_cell_labels.size(), in_tet_cells_by_vertex_ids.size());
+      return false;
+    }
+
+    if(is_open_ && count_labels_ != count_cells_) {
+      SPDLOG_ERROR("The cells of [{}] have no material labels, the next cells cannot have them", filepath_);
+      return false;
+    }
+
+    if(appendCells(in_tet_cells_by_vertex_ids) == false) {
+      return false;
+    }
+
+    labels_file_.write(reinterpret_cast<const char*>(in_cell_labels.data()),
+                       static_cast<std::streamsize>(in_cell_labels.size() * sizeof(uint32_t)));
+    count_labels_ += in_cell_labels.size();
+    if(!labels_file_) {
+      SPDLOG_ERROR("Unable to write [{}] labels of [{}]", in_cell_labels.size(), filepath_);
+      return false;
+    }
+
+    return true;
+  }
+
+  bool TetMeshStreamWriter::appendCells(const std::vector<vec4i>& in_tet_cells_by_vertex_ids) {
+    if(is_open_ == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    if(in_tet_cells_by_vertex_ids.empty()) {
+      return true;
+    }
+
+    CellChunk chunk = {in_tet_cells_by_vertex_ids.size(), std::numeric_limits<int32_t>::max()};
+    int64_t max_vertex_id = max_vertex_id_;
+    for(const vec4i& cell : in_tet_cells_by_vertex_ids) {
+      if(cell.minCoeff() < 0) {
+        SPDLOG_ERROR("The cell [{}, {}, {}, {}] has a negative vertex id", cell[0], cell[1], cell[2], cell[3]);
+        return false;
+      }
+
+      chunk.min_vertex_id = std::min<int32_t>(chunk.min_vertex_id, cell.minCoeff());
+      max_vertex_id = std::max<int64_t>(max_vertex_id, cell.maxCoeff());
+    }
+
+    for(const vec4i& cell : in_tet_cells_by_vertex_ids) {
+      const int32_t ids[4] = {cell[0], cell[1], cell[2], cell[3]};
+      cells_file_.write(reinterpret_cast<const char*>(ids), sizeof(ids));
+    }
+
+    max_vertex_id_ = max_vertex_id;
+    cell_chunks_.push_back(chunk);
+    count_cells_ += in_tet_cells_by_vertex_ids.size();
+    if(!cells_file_) {
+      SPDLOG_ERROR("Unable to write [{}] cells of [{}]", in_tet_cells_by_vertex_ids.size(), filepath_);
+      return false;
+    }
+
+    return true;
+  }
+
+  uint64_t TetMeshStreamWriter::countVertices() const {
+    return count_vertices_;
+  }
+
+  uint64_t TetMeshStreamWriter::countCells() const {
+    return count_cells_;
+  }
+
+  bool TetMeshStreamWriter::extractBoundary(std::vector<vec3>& out_vertices,
+                                            std::vector<vec3i>& out_faces) {
+    out_vertices.clear();
+    out_faces.clear();
+    if(is_open_ == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    if(max_vertex_id_ >= static_cast<int64_t>(count_vertices_)) {
+      SPDLOG_ERROR("The cells refer to vertex [{}] of [{}] written vertices", max_vertex_id_, count_vertices_);
+      return false;
+    }
+
+    vertices_file_.flush();
+    cells_file_.flush();
+    std::ifstream cells_file(cells_filepath_.c_str(), std::ios::in | std::ios::binary);
+    if(!cells_file) {
+      SPDLOG_ERROR("Unable to read the cells of [{}]", filepath_);
+      return false;
+    }
+
+    //no face of a later chunk starts below the smallest vertex id of the chunks after it
+    const size_t count_chunks = cell_chunks_.size();
+    std::vector<int32_t> later_min_vertex_ids(count_chunks + 1, std::numeric_limits<int32_t>::max());
+    for(size_t c = count_chunks; c > 0; c--) {
+      later_min_vertex_ids[c - 1] = std::min(later_min_vertex_ids[c], cell_chunks_[c - 1].min_vertex_id);
+    }
+
+    //the open faces by their sorted vertex ids, a face seen twice is interior
+    std::map<std::array<int32_t, 3>, vec3i> open_faces;
+    std::vector<int32_t> chunk_ids;
+    for(size_t c = 0; c < count_chunks; c++) {
+      if(ReadBlock(cells_file, cell_chunks_[c].count_cells * 4, chunk_ids) == false) {
+        SPDLOG_ERROR("Unable to read the cells of [{}]", filepath_);
+        return false;
+      }
+
+      for(size_t i = 0; i < chunk_ids.size(); i += 4) {
+        for(int f = 0; f < Tetrahedra::kNumFaces; f++) {
+          //the faces of a cell point inwards, their reverse is outwards
+          const vec3i lut = Tetrahedra::faceVertexIdsLut(f);
+          const vec3i face(chunk_ids[i + lut[0]], chunk_ids[i + lut[2]], chunk_ids[i + lut[1]]);
+          std::array<int32_t, 3> key = {face[0], face[1], face[2]};
+          std::sort(key.begin(), key.end());
+
+          auto it = open_faces.find(key);
+          if(it == open_faces.end()) {
+            open_faces.emplace(key, face);
+          } else {
+            open_faces.erase(it);
+          }
+        }
+      }
+
+      //the faces starting below the later chunks are settled
+      while(open_faces.empty() == false && open_faces.begin()->first[0] < later_min_vertex_ids[c + 1]) {
+        out_faces.push_back(open_faces.begin()->second);
+        open_faces.erase(open_faces.begin());
+      }
+    }
+
+    //read back the boundary vertices in the order of their ids
+    std::vector<int32_t> boundary_vertex_ids;
+    boundary_vertex_ids.reserve(out_faces.size() * 3);
+    for(const vec3i& face : out_faces) {
+      boundary_vertex_ids.insert(boundary_vertex_ids.end(), face.data(), face.data() + 3);
+    }
+    std::sort(boundary_vertex_ids.begin(), boundary_vertex_ids.end());
+    boundary_vertex_ids.erase(std::unique(boundary_vertex_ids.begin(), boundary_vertex_ids.end()), boundary_vertex_ids.end());
+
+    std::ifstream vertices_file(vertices_filepath_.c_str(), std::ios::in | std::ios::binary);
+    out_vertices.resize(boundary_vertex_ids.size());
+    for(size_t i = 0; i < boundary_vertex_ids.size() && vertices_file; i++) {
+      real_t xyz[3];
+      vertices_file.seekg(static_cast<std::streamoff>(boundary_vertex_ids[i]) * sizeof(xyz));
+      vertices_file.read(reinterpret_cast<char*>(xyz), sizeof(xyz));
+      out_vertices[i] = vec3(xyz[0], xyz[1], xyz[2]);
+    }
+
+    if(!vertices_file) {
+      SPDLOG_ERROR("Unable to read the boundary vertices of [{}]", filepath_);
+      out_vertices.clear();
+      out_faces.clear();
+      return false;
+    }
+
+    for(vec3i& face : out_faces) {
+      for(int i = 0; i < 3; i++) {
+        face[i] = static_cast<int>(std::lower_bound(boundary_vertex_ids.begin(), boundary_vertex_ids.end(), face[i]) - boundary_vertex_ids.begin());
+      }
+    }
+
+    SPDLOG_INFO("Extracted [{}] boundary faces of [{}] cells", out_faces.size(), count_cells_);
+    return true;
+  }
+
+  bool TetMeshStreamWriter::close() {
+    if(is_open_ == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    if(count_cells_ == 0) {
+      SPDLOG_ERROR("There are no cells to write to [{}]", filepath_);
+      discard();
+      return false;
+    }
+
+    if(max_vertex_id_ >= static_cast<int64_t>(count_vertices_)) {
+      SPDLOG_ERROR("The cells refer to vertex [{}] of [{}] written vertices", max_vertex_id_, count_vertices_);
+      discard();
+      return false;
+    }
+
+    vertices_file_.close();
+    cells_file_.close();
+    labels_file_.close();
+
+    std::ofstream file;
+    if(is_binary_) {
+      file.open(filepath_.c_str(), std::ios::out | std::ios::binary);
+    } else {
+      file.open(filepath_.c_str());
+    }
+
+    std::ifstream vertices_file(vertices_filepath_.c_str(), std::ios::in | std::ios::binary);
+    std::ifstream cells_file(cells_filepath_.c_str(), std::ios::in | std::ios::binary);
+    std::ifstream labels_file(labels_filepath_.c_str(), std::ios::in | std::ios::binary);
+    if(!file || !vertices_file || !cells_file || !labels_file) {
+      SPDLOG_ERROR("Unable to write [{}]", filepath_);
+      discard();
+      return false;
+    }
+
+    //the same layout as TetMesh::exportToVTK
+    file << "# vtk DataFile Version 3.0\n";
+    file << "volmesh exported Tetrahedral Mesh\n";
+    file << (is_binary_ ? "BINARY\n" : "ASCII\n");
+    file << "DATASET UNSTRUCTURED_GRID\n";
+
+    const std::string datatype_str = (typeid(real_t) == typeid(double)) ? "double" : "float";
+    file << "POINTS " << count_vertices_ << " " << datatype_str << "\n";
+
+    bool result = true;
+    std::vector<real_t> coords;
+    for(uint64_t begin = 0; begin < count_vertices_ && result; begin += kCopyBlockSize) {
+      const uint64_t count = std::min(kCopyBlockSize, count_vertices_ - begin);
+      result = ReadBlock(vertices_file, count * 3, coords);
+      for(size_t i = 0; i < coords.size() && result; i += 3) {
+        if(is_binary_) {
+          real_t xyz[3] = {coords[i], coords[i + 1], coords[i + 2]};
+          for(real_t& v : xyz) {
+            SwapEndianness(v);
+          }
+          file.write(reinterpret_cast<const char*>(xyz), sizeof(xyz));
+        } else {
+          file << coords[i] << " " << coords[i + 1] << " " << coords[i + 2] << "\n";
+        }
+      }
+    }
+
+    if(is_binary_) {
+      file << "\n";
+    }
+
+    //4 vertices per cell and 1 for the number of vertices in each cell
+    file << "CELLS " << count_cells_ << " " << count_cells_ * 5 << "\n";
+
+    std::vector<int32_t> ids;
+    for(uint64_t begin = 0; begin < count_cells_ && result; begin += kCopyBlockSize) {
+      const uint64_t count = std::min(kCopyBlockSize, count_cells_ - begin);
+      result = ReadBlock(cells_file, count * 4, ids);
+      for(size_t i = 0; i < ids.size() && result; i += 4) {
+        if(is_binary_) {
+          int32_t row[5] = {4, ids[i], ids[i + 1], ids[i + 2], ids[i + 3]};
+          for(int32_t& v : row) {
+            SwapEndianness(v);
+          }
+          file.write(reinterpret_cast<const char*>(row), sizeof(row));
+        } else {
+          file << "4 " << ids[i] << " " << ids[i + 1] << " " << ids[i + 2] << " " << ids[i + 3] << "\n";
+        }
+      }
+    }
+
+    //VTK_TETRA
+    file << "CELL_TYPES " << count_cells_ << "\n";
+    int32_t vtk_tetrahedra_celltype = 10;
+    SwapEndianness(vtk_tetrahedra_celltype);
+    for(uint64_t i = 0; i < count_cells_; i++) {
+      if(is_binary_) {
+        file.write(reinterpret_cast<const char*>(&vtk_tetrahedra_celltype), sizeof(int32_t));
+      } else {
+        file << "10\n";
+      }
+    }
+
+    //the material labels
+    if(count_labels_ > 0) {
+      if(is_binary_) {
+        file << "\n";
+      }
+
+      file << "CELL_DATA " << count_cells_ << "\n";
+      file << "SCALARS Material int 1\n";
+      file << "LOOKUP_TABLE default\n";
+
+      std::vector<uint32_t> labels;
+      for(uint64_t begin = 0; begin < count_labels_ && result; begin += kCopyBlockSize) {
+        const uint64_t count = std::min(kCopyBlockSize, count_labels_ - begin);
+        result = ReadBlock(labels_file, count, labels);
+        for(size_t i = 0; i < labels.size() && result; i++) {
+          int32_t label = static_cast<int32_t>(labels[i]);
+          if(is_binary_) {
+            SwapEndianness(label);
+            file.write(reinterpret_cast<const char*>(&label), sizeof(int32_t));
+          } else {
+            file << label << "\n";
+          }
+        }
+      }
+    }
+
+    vertices_file.close();
+    cells_file.close();
+    labels_file.close();
+    file.close();
+    result &= static_cast<bool>(file);
+    if(result == false) {
+      SPDLOG_ERROR("Unable to write [{}]", filepath_);
+    } else {
+      SPDLOG_INFO("Streamed [{}] vertices and [{}] cells to [{}]", count_vertices_, count_cells_, filepath_);
+    }
+
+    discard();
+    return result;
+  }
+
+  void TetMeshStreamWriter::discard() {
+    if(is_open_) {
+      vertices_file_.close();
+      cells_file_.close();
+      labels_file_.close();
+      std::remove(vertices_filepath_.c_str());
+      std::remove(cells_filepath_.c_str());
+      std::remove(labels_filepath_.c_str());
+    }
+
+    is_open_ = false;
+    count_vertices_ = 0;
+    count_cells_ = 0;
+    count_labels_ = 0;
+    max_vertex_id_ = -1;
+    cell_chunks_.clear();
+  }
+
+}
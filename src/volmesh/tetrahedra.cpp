@@ -7,7 +7,10 @@
 //-----------------------------------------------------------------------------
 
 #include "volmesh/tetrahedra.h"
+#include "volmesh/predicates.h"
 
+#include <algorithm>
+#include <cmath>
 #include <fmt/core.h>
 
 using namespace volmesh;
@@ -147,6 +150,38 @@ real_t Tetrahedra::aspectRatio() const {
   return circumradius() / (3.0 * inradius());
 }
 
+std::array<real_t, Tetrahedra::kNumEdges> Tetrahedra::dihedralAngles() const {
+  //unit normal of the face opposite to each vertex, pointing away from it
+  std::array<vec3, kNumVerticesPerCell> normals;
+  for(int i=0; i < kNumVerticesPerCell; i++) {
+    const vec3i face = faceVertexIdsLut(i);
+    const vec3 a = vertices_.col(face.x());
+    vec3 n = (vertices_.col(face.y()) - a).cross(vertices_.col(face.z()) - a);
+    if(n.dot(vertices_.col(i) - a) > 0.0) {
+      n = -n;
+    }
+    normals[i] = n.normalized();
+  }
+
+  //the two faces of an edge are opposite to the two vertices that are not on it
+  std::array<real_t, kNumEdges> angles;
+  for(int e=0; e < kNumEdges; e++) {
+    const vec2i edge = edgeVertexIdsLut(e);
+    int opposite[2];
+    int count = 0;
+    for(int i=0; i < kNumVerticesPerCell; i++) {
+      if(i != edge.x() && i != edge.y()) {
+        opposite[count++] = i;
+      }
+    }
+
+    const real_t cosine = std::clamp(normals[opposite[0]].dot(normals[opposite[1]]), static_cast<real_t>(-1.0), static_cast<real_t>(1.0));
+    angles[e] = M_PI - std::acos(cosine);
+  }
+
+  return angles;
+}
+
 vec3 Tetrahedra::centroid() const {
   static const real_t ratio = 1.0 / static_cast<real_t>(kNumVerticesPerCell);
 
@@ -165,6 +200,11 @@ real_t Tetrahedra::determinant() const {
   return ab.dot(ac.cross(ad));
 }
 
+int Tetrahedra::orientation() const {
+  // Orient3d is positive when the determinant is negative
+  return -Orient3d(vertices_.col(0), vertices_.col(1), vertices_.col(2), vertices_.col(3));
+}
+
 real_t Tetrahedra::volume() const {
   return static_cast<real_t>(1.0 / 6.0) * fabs(determinant());
 }
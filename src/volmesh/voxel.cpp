@@ -88,3 +88,35 @@ Voxel Voxel::CreateVoxel(const vec3& center,
     return Voxel(tmp);
 }
 
+
+vec3i Voxel::vertexOffsetLut(const int vertex_id) {
+  if(vertex_id >= 0 && vertex_id < kNumVerticesPerCell) {
+    //the vertex id holds the right, top and far bits
+    return vec3i((vertex_id >> 2) & 1, (vertex_id >> 1) & 1, vertex_id & 1);
+  } else {
+    throw std::out_of_range(fmt::format("The supplied vertex id {} is out of range. Accepted vertex id range is [{}, {}]",
+                                        vertex_id,
+                                        0,
+                                        kNumVerticesPerCell - 1));
+  }
+}
+
+vec4i Voxel::fittingTetrahedraVertexIdsLut(const int tet_id) {
+  static const vec4i kFittingTetrahedraVertexIdsLut[kNumFittingTetrahedra] = {
+    {VertexLocationId::LBN, VertexLocationId::LTN, VertexLocationId::RBN, VertexLocationId::LBF},
+    {VertexLocationId::RTN, VertexLocationId::LTN, VertexLocationId::LBF, VertexLocationId::RBN},
+    {VertexLocationId::RTN, VertexLocationId::LTN, VertexLocationId::LTF, VertexLocationId::LBF},
+    {VertexLocationId::RTN, VertexLocationId::RBN, VertexLocationId::LBF, VertexLocationId::RBF},
+    {VertexLocationId::RTN, VertexLocationId::LBF, VertexLocationId::LTF, VertexLocationId::RBF},
+    {VertexLocationId::RTN, VertexLocationId::LTF, VertexLocationId::RTF, VertexLocationId::RBF}
+  };
+
+  if(tet_id >= 0 && tet_id < kNumFittingTetrahedra) {
+    return kFittingTetrahedraVertexIdsLut[tet_id];
+  } else {
+    throw std::out_of_range(fmt::format("The supplied tetrahedron id {} is out of range. Accepted tetrahedron id range is [{}, {}]",
+                                        tet_id,
+                                        0,
+                                        kNumFittingTetrahedra - 1));
+  }
+}
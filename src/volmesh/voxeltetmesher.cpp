@@ -0,0 +1,391 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/voxeltetmesher.h"
+#include "volmesh/logger.h"
+#include "volmesh/parallel.h"
+#include "volmesh/tetrahedra.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace volmesh {
+
+  namespace {
+
+    /**
+     * @brief Checks whether all fields have the grid of the first one.
+     */
+    bool HaveSameGrid(const std::vector<const SignedDistanceField*>& in_sdfs) {
+      const SignedDistanceField& first = *in_sdfs.front();
+      for(size_t i = 1; i < in_sdfs.size(); i++) {
+        const SignedDistanceField& sdf = *in_sdfs[i];
+        const real_t tolerance = 1e-6 * first.voxelSize();
+        if(sdf.voxelsCount() != first.voxelsCount() ||
+           std::abs(sdf.voxelSize() - first.voxelSize()) > tolerance ||
+           (sdf.bounds().lower() - first.bounds().lower()).cwiseAbs().maxCoeff() > tolerance) {
+          SPDLOG_ERROR("The field of material [{}] is not on the grid of the first material", i);
+          return false;
+        }
+      }
+
+      return true;
+    }
+
+    /**
+     * @brief Selects the interior voxels of a range of rows of one z layer.
+     *
+     * @return The number of selected voxels.
+     */
+    uint64_t ClassifyInteriorVoxelRows(const SignedDistanceField& in_sdf,
+                                       int min_inside_corners,
+                                       int z,
+                                       int y_begin,
+                                       int y_end,
+                                       uint8_t* out_layer_mask) {
+      const int vx = in_sdf.voxelsCount().x();
+      const SignedDistanceField::SliceView near_slice = in_sdf.slice(SignedDistanceField::kSliceAxisZ, z);
+      const SignedDistanceField::SliceView far_slice = in_sdf.slice(SignedDistanceField::kSliceAxisZ, z + 1);
+      uint64_t count_selected = 0;
+      for(int y=y_begin; y < y_end; y++) {
+        for(int x=0; x < vx; x++) {
+          int count_inside = 0;
+          for(int c=0; c < Voxel::kNumVerticesPerCell; c++) {
+            const vec3i offset = Voxel::vertexOffsetLut(c);
+            const SignedDistanceField::SliceView& slice = (offset.z() == 0) ? near_slice : far_slice;
+            count_inside += (slice.at(x + offset.x(), y + offset.y()) < 0.0) ? 1 : 0;
+          }
+
+          const bool is_selected = (count_inside >= min_inside_corners);
+          out_layer_mask[static_cast<int64_t>(y) * vx + x] = is_selected ? 1 : 0;
+          count_selected += is_selected ? 1 : 0;
+        }
+      }
+
+      return count_selected;
+    }
+
+    /**
+     * @brief Numbers the grid points of a z layer used by the selected voxels below and above it.
+     *
+     * @param in_lower_mask The mask of the voxel layer below, empty for the first layer.
+     * @param in_upper_mask The mask of the voxel layer above, empty for the last layer.
+     * @param first_vertex_id The id of the first used grid point.
+     * @param out_vertex_ids One id per grid point of the layer with x varying fastest, -1 for the unused ones.
+     * @return The number of used grid points.
+     */
+    int32_t NumberGridPointLayer(const vec3i& voxels_count,
+                                 const std::vector<uint8_t>& in_lower_mask,
+                                 const std::vector<uint8_t>& in_upper_mask,
+                                 int32_t first_vertex_id,
+                                 std::vector<int32_t>& out_vertex_ids) {
+      const int vx = voxels_count.x();
+      const int vy = voxels_count.y();
+      out_vertex_ids.assign(static_cast<size_t>(vx + 1) * (vy + 1), -1);
+
+      int32_t vertex_id = first_vertex_id;
+      for(int y=0; y <= vy; y++) {
+        for(int x=0; x <= vx; x++) {
+          bool is_used = false;
+          for(int c=0; c < 4 && is_used == false; c++) {
+            const int voxel_x = x - (c & 1);
+            const int voxel_y = y - (c >> 1);
+            if(voxel_x < 0 || voxel_x >= vx || voxel_y < 0 || voxel_y >= vy) {
+              continue;
+            }
+
+            const size_t voxel_id = static_cast<size_t>(voxel_y) * vx + voxel_x;
+            is_used = (!in_lower_mask.empty() && in_lower_mask[voxel_id] != 0) ||
+                      (!in_upper_mask.empty() && in_upper_mask[voxel_id] != 0);
+          }
+
+          if(is_used) {
+            out_vertex_ids[static_cast<size_t>(y) * (vx + 1) + x] = vertex_id++;
+          }
+        }
+      }
+
+      return vertex_id - first_vertex_id;
+    }
+
+  }
+
+  uint64_t ClassifyInteriorVoxels(const SignedDistanceField& in_sdf,
+                                  int min_inside_corners,
+                                  std::vector<uint8_t>& out_voxel_mask) {
+    out_voxel_mask.clear();
+    const vec3i voxels_count = in_sdf.voxelsCount();
+    if(voxels_count.minCoeff() <= 0) {
+      return 0;
+    }
+
+    const int64_t vx = voxels_count.x();
+    const int64_t vy = voxels_count.y();
+    out_voxel_mask.resize(vx * vy * voxels_count.z());
+
+    std::atomic<uint64_t> count_selected(0);
+    ParallelFor(0, voxels_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      uint64_t count_chunk_selected = 0;
+      for(uint64_t z = chunk_begin; z < chunk_end; z++) {
+        count_chunk_selected += ClassifyInteriorVoxelRows(in_sdf, min_inside_corners, static_cast<int>(z), 0, static_cast<int>(vy),
+                                                          out_voxel_mask.data() + z * vx * vy);
+      }
+
+      count_selected += count_chunk_selected;
+    });
+
+    return count_selected.load();
+  }
+
+  bool MeshInteriorVoxels(const SignedDistanceField& in_sdf,
+                          TetMesh& out_mesh,
+                          int min_inside_corners) {
+    if(min_inside_corners < 1 || min_inside_corners > Voxel::kNumVerticesPerCell) {
+      SPDLOG_ERROR("The number of inside corners [{}] is outside [1, {}]", min_inside_corners, static_cast<int>(Voxel::kNumVerticesPerCell));
+      return false;
+    }
+
+    std::vector<uint8_t> voxel_mask;
+    const uint64_t count_selected = ClassifyInteriorVoxels(in_sdf, min_inside_corners, voxel_mask);
+    if(count_selected == 0) {
+      SPDLOG_ERROR("No voxel of the field has [{}] inside corners", min_inside_corners);
+      return false;
+    }
+
+    SPDLOG_INFO("Selected [{}] interior voxels out of [{}]", count_selected, voxel_mask.size());
+    return out_mesh.readFromVoxelGrid(in_sdf.bounds().lower(), in_sdf.voxelSize(), in_sdf.voxelsCount(), voxel_mask);
+  }
+
+  bool StreamInteriorVoxels(const SignedDistanceField& in_sdf,
+                            TetMeshStreamWriter& inout_writer,
+                            int min_inside_corners) {
+    if(min_inside_corners < 1 || min_inside_corners > Voxel::kNumVerticesPerCell) {
+      SPDLOG_ERROR("The number of inside corners [{}] is outside [1, {}]", min_inside_corners, static_cast<int>(Voxel::kNumVerticesPerCell));
+      return false;
+    }
+
+    if(inout_writer.isOpen() == false) {
+      SPDLOG_ERROR("The stream writer is not open");
+      return false;
+    }
+
+    const vec3i voxels_count = in_sdf.voxelsCount();
+    if(voxels_count.minCoeff() <= 0) {
+      SPDLOG_ERROR("The field has no voxels");
+      return false;
+    }
+
+    const int vx = voxels_count.x();
+    const int vy = voxels_count.y();
+    const int vz = voxels_count.z();
+    const vec3 origin = in_sdf.bounds().lower();
+    const real_t voxel_size = in_sdf.voxelSize();
+
+    //the masks of the voxel layers z - 1, z and z + 1, empty outside the grid
+    std::vector<uint8_t> lower_mask;
+    std::vector<uint8_t> mask;
+    std::vector<uint8_t> upper_mask;
+    uint64_t count_selected = 0;
+    auto classify_layer = [&](int z, std::vector<uint8_t>& out_layer_mask) {
+      out_layer_mask.clear();
+      if(z >= vz) {
+        return;
+      }
+
+      out_layer_mask.resize(static_cast<size_t>(vx) * vy);
+      std::atomic<uint64_t> count_layer_selected(0);
+      ParallelFor(0, vy, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+        count_layer_selected += ClassifyInteriorVoxelRows(in_sdf, min_inside_corners, z, static_cast<int>(chunk_begin),
+                                                          static_cast<int>(chunk_end), out_layer_mask.data());
+      });
+      count_selected += count_layer_selected.load();
+    };
+
+    //the vertices of a layer of grid points in the order of TetMesh::readFromVoxelGrid
+    std::vector<vec3> vertices;
+    int32_t count_vertices = 0;
+    auto write_point_layer = [&](int z, std::vector<int32_t>& out_vertex_ids) {
+      count_vertices += NumberGridPointLayer(voxels_count, lower_mask, mask, count_vertices, out_vertex_ids);
+      vertices.clear();
+      for(int y=0; y <= vy; y++) {
+        for(int x=0; x <= vx; x++) {
+          if(out_vertex_ids[static_cast<size_t>(y) * (vx + 1) + x] >= 0) {
+            vertices.push_back(origin + vec3i(x, y, z).cast<real_t>() * voxel_size);
+          }
+        }
+      }
+
+      return inout_writer.writeVertices(vertices);
+    };
+
+    //the grid points below layer 0 use the voxels of layer 0 only
+    classify_layer(0, mask);
+    classify_layer(1, upper_mask);
+    std::vector<int32_t> near_vertex_ids;
+    std::vector<int32_t> far_vertex_ids;
+    if(write_point_layer(0, near_vertex_ids) == false) {
+      return false;
+    }
+
+    std::vector<vec4i> cells;
+    for(int z=0; z < vz; z++) {
+      //the grid points of layer z + 1 are used by the voxels of layers z and z + 1
+      std::swap(lower_mask, mask);
+      std::swap(mask, upper_mask);
+      if(write_point_layer(z + 1, far_vertex_ids) == false) {
+        return false;
+      }
+
+      //the voxels of layer z are lower_mask now, their tetrahedra in voxel order
+      cells.clear();
+      for(int y=0; y < vy; y++) {
+        for(int x=0; x < vx; x++) {
+          if(lower_mask[static_cast<size_t>(y) * vx + x] == 0) {
+            continue;
+          }
+
+          for(int t=0; t < Voxel::kNumFittingTetrahedra; t++) {
+            const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+            vec4i cell;
+            for(int i=0; i < Tetrahedra::kNumVerticesPerCell; i++) {
+              const vec3i offset = Voxel::vertexOffsetLut(tet_lut[i]);
+              const std::vector<int32_t>& vertex_ids = (offset.z() == 0) ? near_vertex_ids : far_vertex_ids;
+              cell[i] = vertex_ids[static_cast<size_t>(y + offset.y()) * (vx + 1) + x + offset.x()];
+            }
+            cells.push_back(cell);
+          }
+        }
+      }
+
+      if(inout_writer.writeCells(cells) == false) {
+        return false;
+      }
+
+      std::swap(near_vertex_ids, far_vertex_ids);
+      classify_layer(z + 2, upper_mask);
+    }
+
+    if(count_selected == 0) {
+      SPDLOG_ERROR("No voxel of the field has [{}] inside corners", min_inside_corners);
+      return false;
+    }
+
+    SPDLOG_INFO("Streamed [{}] interior voxels out of [{}]", count_selected, static_cast<uint64_t>(vx) * vy * vz);
+    return true;
+  }
+
+  uint64_t ClassifyMaterialVoxels(const std::vector<const SignedDistanceField*>& in_sdfs,
+                                  int min_inside_corners,
+                                  std::vector<uint8_t>& out_voxel_mask,
+                                  std::vector<uint32_t>& out_voxel_labels) {
+    out_voxel_mask.clear();
+    out_voxel_labels.clear();
+    if(in_sdfs.empty() || HaveSameGrid(in_sdfs) == false) {
+      return 0;
+    }
+
+    const vec3i voxels_count = in_sdfs.front()->voxelsCount();
+    if(voxels_count.minCoeff() <= 0) {
+      return 0;
+    }
+
+    const int64_t vx = voxels_count.x();
+    const int64_t vy = voxels_count.y();
+    const uint32_t count_materials = static_cast<uint32_t>(in_sdfs.size());
+    out_voxel_mask.resize(vx * vy * voxels_count.z());
+    out_voxel_labels.resize(out_voxel_mask.size());
+
+    std::atomic<uint64_t> count_selected(0);
+    ParallelFor(0, voxels_count.z(), [&](uint64_t chunk_begin, uint64_t chunk_end) {
+      std::vector<SignedDistanceField::SliceView> near_slices;
+      std::vector<SignedDistanceField::SliceView> far_slices;
+      std::vector<int> count_inside(count_materials);
+      uint64_t count_chunk_selected = 0;
+      for(uint64_t z = chunk_begin; z < chunk_end; z++) {
+        near_slices.clear();
+        far_slices.clear();
+        for(const SignedDistanceField* sdf : in_sdfs) {
+          near_slices.push_back(sdf->slice(SignedDistanceField::kSliceAxisZ, static_cast<int>(z)));
+          far_slices.push_back(sdf->slice(SignedDistanceField::kSliceAxisZ, static_cast<int>(z + 1)));
+        }
+
+        uint8_t* mask = out_voxel_mask.data() + z * vx * vy;
+        uint32_t* labels = out_voxel_labels.data() + z * vx * vy;
+        for(int y=0; y < vy; y++) {
+          for(int x=0; x < vx; x++) {
+            std::fill(count_inside.begin(), count_inside.end(), 0);
+            int count_union_inside = 0;
+            for(int c=0; c < Voxel::kNumVerticesPerCell; c++) {
+              const vec3i offset = Voxel::vertexOffsetLut(c);
+              const std::vector<SignedDistanceField::SliceView>& slices = (offset.z() == 0) ? near_slices : far_slices;
+              bool is_inside = false;
+              for(uint32_t m=0; m < count_materials; m++) {
+                if(slices[m].at(x + offset.x(), y + offset.y()) < 0.0) {
+                  count_inside[m]++;
+                  is_inside = true;
+                }
+              }
+
+              count_union_inside += is_inside ? 1 : 0;
+            }
+
+            uint32_t label = 0;
+            for(uint32_t m=1; m < count_materials; m++) {
+              label = (count_inside[m] > count_inside[label]) ? m : label;
+            }
+
+            const bool is_selected = (count_union_inside >= min_inside_corners);
+            mask[y * vx + x] = is_selected ? 1 : 0;
+            labels[y * vx + x] = label;
+            count_chunk_selected += is_selected ? 1 : 0;
+          }
+        }
+      }
+
+      count_selected += count_chunk_selected;
+    });
+
+    return count_selected.load();
+  }
+
+  bool MeshMaterialVoxels(const std::vector<const SignedDistanceField*>& in_sdfs,
+                          TetMesh& out_mesh,
+                          int min_inside_corners) {
+    if(min_inside_corners < 1 || min_inside_corners > Voxel::kNumVerticesPerCell) {
+      SPDLOG_ERROR("The number of inside corners [{}] is outside [1, {}]", min_inside_corners, static_cast<int>(Voxel::kNumVerticesPerCell));
+      return false;
+    }
+
+    std::vector<uint8_t> voxel_mask;
+    std::vector<uint32_t> voxel_labels;
+    const uint64_t count_selected = ClassifyMaterialVoxels(in_sdfs, min_inside_corners, voxel_mask, voxel_labels);
+    if(count_selected == 0) {
+      SPDLOG_ERROR("No voxel of the [{}] fields has [{}] inside corners", in_sdfs.size(), min_inside_corners);
+      return false;
+    }
+
+    SPDLOG_INFO("Selected [{}] voxels of [{}] materials out of [{}]", count_selected, in_sdfs.size(), voxel_mask.size());
+    const SignedDistanceField& first = *in_sdfs.front();
+    if(out_mesh.readFromVoxelGrid(first.bounds().lower(), first.voxelSize(), first.voxelsCount(), voxel_mask) == false) {
+      return false;
+    }
+
+    // the cells are the tetrahedra of the selected voxels in voxel order
+    std::vector<uint32_t> cell_labels;
+    cell_labels.reserve(count_selected * Voxel::kNumFittingTetrahedra);
+    for(size_t i=0; i < voxel_mask.size(); i++) {
+      if(voxel_mask[i] != 0) {
+        cell_labels.insert(cell_labels.end(), static_cast<size_t>(Voxel::kNumFittingTetrahedra), voxel_labels[i]);
+      }
+    }
+
+    return out_mesh.setCellLabels(cell_labels);
+  }
+
+}
@@ -0,0 +1,226 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/windingnumber.h"
+#include "volmesh/logger.h"
+#include "volmesh/mathutils.h"
+
+#include <algorithm>
+#include <numeric>
+#include <math.h>
+
+using namespace volmesh;
+
+WindingNumberTree::WindingNumberTree() {
+
+}
+
+WindingNumberTree::~WindingNumberTree() {
+
+}
+
+bool WindingNumberTree::build(const TriangleMesh& in_mesh) {
+  const uint32_t count_faces = in_mesh.countFaces();
+  std::vector<vec3> vertices(count_faces * 3);
+  for(uint32_t i = 0; i < count_faces; i++) {
+    const auto v = in_mesh.halfFaceVertices(HalfFaceIndex::create(i));
+    vertices[i * 3 + 0] = v[0];
+    vertices[i * 3 + 1] = v[1];
+    vertices[i * 3 + 2] = v[2];
+  }
+
+  return build(vertices);
+}
+
+bool WindingNumberTree::build(const std::vector<vec3>& in_triangle_vertices) {
+  clear();
+
+  const uint32_t count_faces = static_cast<uint32_t>(in_triangle_vertices.size() / 3);
+  if(count_faces == 0) {
+    SPDLOG_ERROR("The supplied mesh does not have any faces.");
+    return false;
+  }
+
+  std::vector<vec3> centroids(count_faces);
+  std::vector<vec3> area_normals(count_faces);
+
+  for(uint32_t i = 0; i < count_faces; i++) {
+    const vec3* v = &in_triangle_vertices[i * 3];
+    centroids[i] = (v[0] + v[1] + v[2]) / static_cast<real_t>(3.0);
+    area_normals[i] = static_cast<real_t>(0.5) * (v[1] - v[0]).cross(v[2] - v[0]);
+  }
+
+  triangle_vertices_.assign(in_triangle_vertices.begin(), in_triangle_vertices.begin() + count_faces * 3);
+  triangle_centroids_ = std::move(centroids);
+  triangle_area_normals_ = std::move(area_normals);
+
+  // the tree is built over a permutation of the triangles
+  std::vector<uint32_t> order(count_faces);
+  std::iota(order.begin(), order.end(), 0);
+
+  nodes_.reserve(2 * (count_faces / kMaxTrianglesPerLeaf + 1));
+  buildRecursive(order, 0, count_faces);
+
+  // store the triangles in tree order so that leaves reference contiguous ranges
+  std::vector<vec3> sorted_vertices(count_faces * 3);
+  std::vector<vec3> sorted_centroids(count_faces);
+  std::vector<vec3> sorted_area_normals(count_faces);
+  for(uint32_t i = 0; i < count_faces; i++) {
+    const uint32_t src = order[i];
+    sorted_vertices[i * 3 + 0] = triangle_vertices_[src * 3 + 0];
+    sorted_vertices[i * 3 + 1] = triangle_vertices_[src * 3 + 1];
+    sorted_vertices[i * 3 + 2] = triangle_vertices_[src * 3 + 2];
+    sorted_centroids[i] = triangle_centroids_[src];
+    sorted_area_normals[i] = triangle_area_normals_[src];
+  }
+
+  triangle_vertices_ = std::move(sorted_vertices);
+  triangle_centroids_ = std::move(sorted_centroids);
+  triangle_area_normals_ = std::move(sorted_area_normals);
+
+  SPDLOG_DEBUG("Winding number tree has [{}] nodes over [{}] triangles", nodes_.size(), count_faces);
+
+  return true;
+}
+
+uint32_t WindingNumberTree::buildRecursive(std::vector<uint32_t>& order, uint32_t first, uint32_t count) {
+  const uint32_t node_id = static_cast<uint32_t>(nodes_.size());
+  nodes_.push_back(Node());
+
+  // moments of the node
+  real_t total_area = 0.0;
+  vec3 dipole(0.0, 0.0, 0.0);
+  vec3 weighted_centroid(0.0, 0.0, 0.0);
+  vec3 mean_centroid(0.0, 0.0, 0.0);
+  vec3 lower = vec3::Constant(std::numeric_limits<real_t>::max());
+  vec3 upper = vec3::Constant(std::numeric_limits<real_t>::lowest());
+
+  for(uint32_t i = first; i < first + count; i++) {
+    const uint32_t tri = order[i];
+    const real_t area = triangle_area_normals_[tri].norm();
+    total_area += area;
+    dipole += triangle_area_normals_[tri];
+    weighted_centroid += area * triangle_centroids_[tri];
+    mean_centroid += triangle_centroids_[tri];
+    lower = lower.cwiseMin(triangle_centroids_[tri]);
+    upper = upper.cwiseMax(triangle_centroids_[tri]);
+  }
+
+  const vec3 centroid = FuzzyIsNull(total_area) ?
+                        vec3(mean_centroid / static_cast<real_t>(count)) :
+                        vec3(weighted_centroid / total_area);
+
+  real_t radius = 0.0;
+  for(uint32_t i = first; i < first + count; i++) {
+    const uint32_t tri = order[i];
+    for(uint32_t j = 0; j < 3; j++) {
+      radius = std::max(radius, (triangle_vertices_[tri * 3 + j] - centroid).norm());
+    }
+  }
+
+  nodes_[node_id].centroid = centroid;
+  nodes_[node_id].dipole = dipole;
+  nodes_[node_id].radius = radius;
+  nodes_[node_id].first_triangle = first;
+  nodes_[node_id].count_triangles = count;
+
+  if(count <= kMaxTrianglesPerLeaf) {
+    return node_id;
+  }
+
+  // split at the median centroid along the longest axis
+  int axis = 0;
+  const vec3 extent = upper - lower;
+  if(extent.y() > extent[axis]) {
+    axis = 1;
+  }
+  if(extent.z() > extent[axis]) {
+    axis = 2;
+  }
+
+  const uint32_t half = count / 2;
+  std::nth_element(order.begin() + first,
+                   order.begin() + first + half,
+                   order.begin() + first + count,
+                   [this, axis](uint32_t a, uint32_t b) {
+                     return triangle_centroids_[a][axis] < triangle_centroids_[b][axis];
+                   });
+
+  const uint32_t left = buildRecursive(order, first, half);
+  const uint32_t right = buildRecursive(order, first + half, count - half);
+
+  nodes_[node_id].children[0] = left;
+  nodes_[node_id].children[1] = right;
+
+  return node_id;
+}
+
+void WindingNumberTree::clear() {
+  nodes_.clear();
+  triangle_vertices_.clear();
+  triangle_centroids_.clear();
+  triangle_area_normals_.clear();
+}
+
+uint32_t WindingNumberTree::countNodes() const {
+  return static_cast<uint32_t>(nodes_.size());
+}
+
+uint32_t WindingNumberTree::countTriangles() const {
+  return static_cast<uint32_t>(triangle_centroids_.size());
+}
+
+real_t WindingNumberTree::triangleSolidAngle(uint32_t tri, const vec3& p) const {
+  return TriangleSolidAngle(p,
+                            triangle_vertices_[tri * 3 + 0],
+                            triangle_vertices_[tri * 3 + 1],
+                            triangle_vertices_[tri * 3 + 2]);
+}
+
+real_t WindingNumberTree::windingNumber(const vec3& p, real_t accuracy) const {
+  if(nodes_.empty()) {
+    return 0.0;
+  }
+
+  real_t solid_angle = 0.0;
+
+  // the depth of a median split tree is logarithmic so a small fixed stack is sufficient
+  uint32_t stack[128];
+  int top = 0;
+  stack[top++] = 0;
+
+  while(top > 0) {
+    const Node& node = nodes_[stack[--top]];
+
+    const vec3 r = node.centroid - p;
+    const real_t dist = r.norm();
+
+    if(dist > accuracy * node.radius) {
+      // far field: the whole node acts like a single dipole at its centroid
+      solid_angle += node.dipole.dot(r) / (dist * dist * dist);
+    } else if(node.isLeaf()) {
+      for(uint32_t i = 0; i < node.count_triangles; i++) {
+        solid_angle += triangleSolidAngle(node.first_triangle + i, p);
+      }
+    } else {
+      stack[top++] = node.children[0];
+      stack[top++] = node.children[1];
+    }
+  }
+
+  return solid_angle / static_cast<real_t>(4.0 * M_PI);
+}
+
+real_t WindingNumberTree::exactWindingNumber(const vec3& p) const {
+  real_t solid_angle = 0.0;
+  for(uint32_t i = 0; i < countTriangles(); i++) {
+    solid_angle += triangleSolidAngle(i, p);
+  }
+
+  return solid_angle / static_cast<real_t>(4.0 * M_PI);
+}
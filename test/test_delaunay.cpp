@@ -0,0 +1,187 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/delaunay.h"
+#include "volmesh/parallel.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetrahedra.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace volmesh;
+
+static std::vector<vec3> CreateRandomPoints(size_t count, uint32_t seed, bool with_corners = true) {
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<real_t> distribution(0.0, 1.0);
+
+  // the corners make the convex hull the unit cube
+  std::vector<vec3> points;
+  for(int c = 0; c < 8 && with_corners; c++) {
+    points.push_back(vec3(c & 1, (c >> 1) & 1, (c >> 2) & 1));
+  }
+  for(size_t i = 0; i < count; i++) {
+    points.push_back(vec3(distribution(generator), distribution(generator), distribution(generator)));
+  }
+  return points;
+}
+
+static std::vector<vec3> CreateGridPoints(int count_per_axis) {
+  std::vector<vec3> points;
+  for(int z = 0; z < count_per_axis; z++) {
+    for(int y = 0; y < count_per_axis; y++) {
+      for(int x = 0; x < count_per_axis; x++) {
+        points.push_back(vec3(x, y, z) / static_cast<real_t>(count_per_axis - 1));
+      }
+    }
+  }
+  return points;
+}
+
+static real_t CircumsphereTest(const std::vector<vec3>& points, const vec4i& cell, const vec3& p) {
+  const vec3 a = points[cell[0]];
+  const vec3 u = points[cell[1]] - a;
+  const vec3 v = points[cell[2]] - a;
+  const vec3 w = points[cell[3]] - a;
+  const vec3 center = a + (u.squaredNorm() * v.cross(w) + v.squaredNorm() * w.cross(u) + w.squaredNorm() * u.cross(v)) / (2.0 * u.dot(v.cross(w)));
+  return (p - center).norm() - (a - center).norm();
+}
+
+/**
+ * @brief Checks that the tetrahedra are positively oriented, fill the unit cube, meet face to face and are locally Delaunay.
+ */
+static void ExpectDelaunayTetrahedralization(const std::vector<vec3>& points, const std::vector<vec4i>& cells) {
+  real_t volume = 0.0;
+  std::map<std::array<int, 3>, std::vector<std::pair<size_t, int>>> faces;
+  for(size_t c = 0; c < cells.size(); c++) {
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int i = 0; i < 4; i++) {
+      tet_vertices.col(i) = points[cells[c][i]];
+    }
+
+    const Tetrahedra tet(tet_vertices);
+    EXPECT_LT(tet.determinant(), 0.0);
+    volume += tet.volume();
+
+    for(int i = 0; i < 4; i++) {
+      std::array<int, 3> face;
+      for(int k = 0, m = 0; k < 4; k++) {
+        if(k != i) {
+          face[m++] = cells[c][k];
+        }
+      }
+      std::sort(face.begin(), face.end());
+      faces[face].push_back(std::make_pair(c, i));
+    }
+  }
+  EXPECT_NEAR(volume, 1.0, 1e-9);
+
+  for(const auto& [face, sides] : faces) {
+    EXPECT_LE(sides.size(), 2);
+    if(sides.size() != 2) {
+      continue;
+    }
+
+    // the opposite vertex of each neighbor is not inside the circumsphere
+    const vec3 p0 = points[cells[sides[1].first][sides[1].second]];
+    const vec3 p1 = points[cells[sides[0].first][sides[0].second]];
+    EXPECT_GE(CircumsphereTest(points, cells[sides[0].first], p0), -1e-9);
+    EXPECT_GE(CircumsphereTest(points, cells[sides[1].first], p1), -1e-9);
+  }
+}
+
+static std::vector<vec4i> SortedCells(std::vector<vec4i> cells) {
+  for(vec4i& cell : cells) {
+    std::sort(cell.data(), cell.data() + 4);
+  }
+  std::sort(cells.begin(), cells.end(), [](const vec4i& lhs, const vec4i& rhs) {
+    return std::lexicographical_compare(lhs.data(), lhs.data() + 4, rhs.data(), rhs.data() + 4);
+  });
+  return cells;
+}
+
+TEST(Delaunay, RandomPoints) {
+  const std::vector<vec3> points = CreateRandomPoints(2000, 7);
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(TetrahedralizeDelaunay(points, cells));
+  ExpectDelaunayTetrahedralization(points, cells);
+
+  // no point lies inside a circumsphere
+  for(const vec4i& cell : cells) {
+    real_t nearest = std::numeric_limits<real_t>::max();
+    for(const vec3& p : points) {
+      nearest = std::min(nearest, CircumsphereTest(points, cell, p));
+    }
+    EXPECT_GE(nearest, -1e-9);
+  }
+
+  // the slabs of the parallel variant yield the same tetrahedra for points in general position
+  SetMaxThreadsCount(4);
+  const std::vector<vec3> more_points = CreateRandomPoints(20000, 11, false);
+  std::vector<vec4i> parallel_cells;
+  EXPECT_TRUE(TetrahedralizeDelaunayParallel(more_points, parallel_cells));
+  std::vector<vec4i> serial_cells;
+  EXPECT_TRUE(TetrahedralizeDelaunay(more_points, serial_cells));
+  EXPECT_EQ(SortedCells(parallel_cells), SortedCells(serial_cells));
+
+  const std::vector<vec3> cube_points = CreateRandomPoints(20000, 13);
+  EXPECT_TRUE(TetrahedralizeDelaunayParallel(cube_points, parallel_cells));
+  ExpectDelaunayTetrahedralization(cube_points, parallel_cells);
+  SetMaxThreadsCount(0);
+}
+
+TEST(Delaunay, GridPoints) {
+  // every cube of the grid has eight cospherical corners
+  const std::vector<vec3> points = CreateGridPoints(8);
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(TetrahedralizeDelaunay(points, cells));
+  ExpectDelaunayTetrahedralization(points, cells);
+
+  const std::vector<vec3> more_points = CreateGridPoints(20);
+  SetMaxThreadsCount(3);
+  std::vector<vec4i> parallel_cells;
+  EXPECT_TRUE(TetrahedralizeDelaunayParallel(more_points, parallel_cells));
+  SetMaxThreadsCount(0);
+  ExpectDelaunayTetrahedralization(more_points, parallel_cells);
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(TetrahedralizeDelaunay(points, tet_mesh));
+  EXPECT_EQ(tet_mesh.countVertices(), points.size());
+  EXPECT_EQ(tet_mesh.countCells(), cells.size());
+
+  // the boundary of the cube holds two triangles per grid square
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), 6 * 7 * 7 * 2);
+}
+
+TEST(Delaunay, DegeneratePoints) {
+  // duplicates stay unused
+  std::vector<vec3> points = CreateRandomPoints(200, 3);
+  const size_t count_unique = points.size();
+  points.insert(points.end(), points.begin() + 10, points.begin() + 60);
+
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(TetrahedralizeDelaunay(points, cells));
+  std::vector<vec4i> unique_cells;
+  EXPECT_TRUE(TetrahedralizeDelaunay(std::vector<vec3>(points.begin(), points.begin() + count_unique), unique_cells));
+  EXPECT_EQ(cells.size(), unique_cells.size());
+  ExpectDelaunayTetrahedralization(points, cells);
+
+  // coplanar points span no volume
+  std::vector<vec3> coplanar_points;
+  for(int i = 0; i < 100; i++) {
+    coplanar_points.push_back(vec3(i % 10, i / 10, 0.0));
+  }
+  EXPECT_FALSE(TetrahedralizeDelaunay(coplanar_points, cells));
+  EXPECT_FALSE(TetrahedralizeDelaunay(std::vector<vec3>(3, vec3::Zero()), cells));
+}
@@ -0,0 +1,57 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/distancetransform.h"
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(DistanceTransform, MatchesBruteForce) {
+  const vec3i dims(13, 7, 9);
+  const int count = dims.x() * dims.y() * dims.z();
+
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<int> dist(0, count - 1);
+
+  std::vector<vec3i> features;
+  std::vector<real_t> values(count, kDistanceTransformInfinity);
+  for (int i = 0; i < 6; i++) {
+    const int id = dist(rng);
+    values[id] = 0.0;
+    features.push_back(vec3i(id % dims.x(), (id / dims.x()) % dims.y(), id / (dims.x() * dims.y())));
+  }
+
+  EXPECT_TRUE(SquaredDistanceTransform(dims, values));
+
+  for (int z = 0; z < dims.z(); z++) {
+    for (int y = 0; y < dims.y(); y++) {
+      for (int x = 0; x < dims.x(); x++) {
+        real_t expected = kDistanceTransformInfinity;
+        for (const auto& f : features) {
+          expected = std::min<real_t>(expected, (vec3i(x, y, z) - f).squaredNorm());
+        }
+        EXPECT_EQ(values[z * dims.x() * dims.y() + y * dims.x() + x], expected);
+      }
+    }
+  }
+}
+
+TEST(DistanceTransform, NoFeatures) {
+  const vec3i dims(4, 5, 6);
+  std::vector<real_t> values(4 * 5 * 6, kDistanceTransformInfinity);
+  EXPECT_TRUE(SquaredDistanceTransform(dims, values));
+  for (const real_t v : values) {
+    EXPECT_EQ(v, kDistanceTransformInfinity);
+  }
+
+  std::vector<real_t> wrong_size(10, 0.0);
+  EXPECT_FALSE(SquaredDistanceTransform(dims, wrong_size));
+}
@@ -0,0 +1,93 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/gridallocator.h"
+#include "volmesh/parallel.h"
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+
+using namespace volmesh;
+
+TEST(GridAllocator, LargeAndSmallArrays) {
+  const uint64_t kHugePageSize = 2ull << 20;
+
+  for (HugePagesMode mode : { kHugePagesNone, kHugePagesTransparent, kHugePagesExplicit }) {
+    SetHugePagesMode(mode);
+    EXPECT_EQ(GetHugePagesMode(), mode);
+
+    // large arrays are mapped, huge page aligned and filled in parallel
+    const uint64_t count = 3 * kHugePageSize / sizeof(real_t) + 17;
+    GridVector<real_t> values;
+    ParallelAssign(values, count, static_cast<real_t>(-2.5));
+    EXPECT_EQ(values.size(), count);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(values.data()) % kHugePageSize, 0);
+    for (uint64_t i = 0; i < count; i += 4099) {
+      EXPECT_EQ(values[i], -2.5);
+    }
+    EXPECT_EQ(values.back(), -2.5);
+
+    // growing keeps the content
+    values.push_back(1.0);
+    EXPECT_EQ(values[count - 1], -2.5);
+    EXPECT_EQ(values[count], 1.0);
+
+    // small arrays use the default allocator
+    GridVector<uint32_t> labels;
+    ParallelAssign(labels, 100, static_cast<uint32_t>(7));
+    EXPECT_EQ(labels.size(), 100);
+    EXPECT_EQ(labels[99], 7);
+
+    GridVector<real_t> other;
+    other.swap(values);
+    EXPECT_EQ(other.size(), count + 1);
+    EXPECT_TRUE(values.empty());
+
+    std::map<int, uint64_t> pages_per_node;
+    if (QueryPagePlacement(other.data(), other.size() * sizeof(real_t), pages_per_node)) {
+      uint64_t count_resident = 0;
+      for (const auto& [node, pages] : pages_per_node) {
+        if (node >= 0) {
+          count_resident += pages;
+        }
+      }
+
+      // every page has been touched
+      EXPECT_EQ(pages_per_node.count(-1), 0);
+      EXPECT_GT(count_resident, 0);
+    }
+
+    LogPagePlacement("test values", other.data(), other.size() * sizeof(real_t));
+  }
+
+  SetHugePagesMode(kHugePagesTransparent);
+}
+
+TEST(GridAllocator, ZeroFilledMemory) {
+  const uint64_t size_in_bytes = 5ull << 20;
+  char* bytes = static_cast<char*>(AllocateGridMemory(size_in_bytes));
+  ASSERT_NE(bytes, nullptr);
+  for (uint64_t i = 0; i < size_in_bytes; i += 997) {
+    EXPECT_EQ(bytes[i], 0);
+  }
+  FreeGridMemory(bytes, size_in_bytes);
+
+  // blocks allocated on the workers are zero filled too
+  SetMaxThreadsCount(4);
+  ParallelFor(0, 4, [&](uint64_t, uint64_t) {
+    char* worker_bytes = static_cast<char*>(AllocateGridMemory(size_in_bytes));
+    ASSERT_NE(worker_bytes, nullptr);
+    EXPECT_EQ(worker_bytes[size_in_bytes - 1], 0);
+    FreeGridMemory(worker_bytes, size_in_bytes);
+  });
+  SetMaxThreadsCount(0);
+
+  EXPECT_EQ(AllocateGridMemory(0), nullptr);
+}
@@ -0,0 +1,112 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/isosurfacestuffing.h"
+#include "volmesh/parallel.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetrahedra.h"
+#include "volmesh/trianglemesh.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(IsosurfaceStuffing, StuffSphere) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), 0.05, SignedDistanceField::kSignModeScanlineParity));
+
+  std::vector<vec3> vertices;
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(StuffIsosurface(sdf, 0.1, vertices, cells));
+  EXPECT_GT(cells.size(), 0);
+
+  // the tetrahedra are oriented like the voxels of a TetMesh
+  real_t volume = 0.0;
+  real_t min_angle = M_PI;
+  real_t max_angle = 0.0;
+  std::map<std::array<int, 3>, int> faces;
+  for(const vec4i& cell : cells) {
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int i = 0; i < 4; i++) {
+      tet_vertices.col(i) = vertices[cell[i]];
+    }
+
+    const Tetrahedra tet(tet_vertices);
+    EXPECT_LT(tet.determinant(), 0.0);
+    volume += tet.volume();
+
+    for(real_t angle : tet.dihedralAngles()) {
+      min_angle = std::min(min_angle, angle);
+      max_angle = std::max(max_angle, angle);
+    }
+
+    for(int f = 0; f < Tetrahedra::kNumFaces; f++) {
+      const vec3i face_lut = Tetrahedra::faceVertexIdsLut(f);
+      std::array<int, 3> face = {cell[face_lut[0]], cell[face_lut[1]], cell[face_lut[2]]};
+      std::sort(face.begin(), face.end());
+      faces[face]++;
+    }
+  }
+
+  EXPECT_NEAR(volume, 4.0 * M_PI / 3.0, 0.05);
+  // the dihedral angles measured for this sphere and spacing are in [21.7, 132.5] degrees, the
+  // diagonals through the smallest keys do not carry the bounds of the paper
+  EXPECT_GT(min_angle * 180.0 / M_PI, 21.0);
+  EXPECT_LT(max_angle * 180.0 / M_PI, 133.5);
+
+  // the mesh is conforming and its boundary is a closed surface on the sphere, every boundary edge has two boundary faces
+  uint64_t count_boundary_faces = 0;
+  std::map<std::pair<int, int>, int> boundary_edges;
+  for(const auto& [face, count] : faces) {
+    EXPECT_LE(count, 2);
+    if(count == 1) {
+      count_boundary_faces++;
+      for(int i = 0; i < 3; i++) {
+        EXPECT_NEAR(vertices[face[i]].norm(), 1.0, 0.01);
+        boundary_edges[std::minmax(face[i], face[(i + 1) % 3])]++;
+      }
+    }
+  }
+
+  for(const auto& [edge, count] : boundary_edges) {
+    EXPECT_EQ(count, 2);
+  }
+
+  // the output does not depend on the number of threads
+  SetMaxThreadsCount(1);
+  std::vector<vec3> serial_vertices;
+  std::vector<vec4i> serial_cells;
+  EXPECT_TRUE(StuffIsosurface(sdf, 0.1, serial_vertices, serial_cells));
+  SetMaxThreadsCount(0);
+  EXPECT_EQ(serial_vertices, vertices);
+  EXPECT_EQ(serial_cells, cells);
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(StuffIsosurface(sdf, 0.1, tet_mesh));
+  EXPECT_EQ(tet_mesh.countCells(), cells.size());
+  EXPECT_EQ(tet_mesh.countVertices(), vertices.size());
+
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), count_boundary_faces);
+
+  EXPECT_FALSE(StuffIsosurface(sdf, 0.0, vertices, cells));
+
+  SignedDistanceField empty;
+  EXPECT_FALSE(StuffIsosurface(empty, 0.1, vertices, cells));
+}
@@ -0,0 +1,121 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/trianglemesh.h"
+#include "volmesh/basetypes.h"
+#include "volmesh/labeleddistancefield.h"
+#include "volmesh/signeddistancefield.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(LabeledDistanceField, TwoSpheres) {
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.3, 0.3, 0.3);
+  const std::vector<vec3> centers = { vec3(0.0, 0.0, 0.0), vec3(2.5, 0.0, 0.0) };
+
+  TriangleMesh mesh_a;
+  CreateSphere(1.0, 24, 48, mesh_a, centers[0]);
+  TriangleMesh mesh_b;
+  CreateSphere(1.0, 24, 48, mesh_b, centers[1]);
+  const std::vector<const TriangleMesh*> meshes = { &mesh_a, &mesh_b };
+
+  LabeledDistanceField field;
+  EXPECT_TRUE(field.generate(meshes, expansion, voxel_size, true));
+  EXPECT_EQ(field.countObjects(), 2);
+  EXPECT_TRUE(field.hasObjectFields());
+
+  LabeledDistanceField field_wn;
+  EXPECT_TRUE(field_wn.generate(meshes, expansion, voxel_size, true, SignedDistanceField::kSignModeWindingNumber));
+  EXPECT_EQ(field.gridPointsCount(), field_wn.gridPointsCount());
+
+  auto sphere = [&](uint32_t label, const vec3& p) { return (p - centers[label]).norm() - 1.0; };
+
+  int count_checked = 0;
+  const vec3i gridpoints_count = field.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const vec3 p = field.gridPointPosition(coords);
+        const real_t dist_a = sphere(0, p);
+        const real_t dist_b = sphere(1, p);
+
+        // both sign modes agree wherever a label is assigned
+        EXPECT_EQ(field.label(coords), field_wn.label(coords));
+        if (field.label(coords) != LabeledDistanceField::kNoLabel) {
+          EXPECT_EQ(std::signbit(field.fieldValue(coords)), std::signbit(field_wn.fieldValue(coords)));
+        }
+
+        // the per object fields are exact within a voxel of their own surface
+        for(uint32_t label = 0; label < 2; label++) {
+          if (std::fabs(sphere(label, p)) <= voxel_size) {
+            EXPECT_TRUE(field.isInObjectBand(label, coords));
+            EXPECT_NEAR(field.objectFieldValue(label, coords), sphere(label, p), 0.01);
+          }
+        }
+
+        // the nearest object is exact within a voxel of either surface
+        if (std::min(std::fabs(dist_a), std::fabs(dist_b)) > voxel_size) {
+          continue;
+        }
+
+        const uint32_t expected_label = (std::fabs(dist_a) < std::fabs(dist_b)) ? 0 : 1;
+        EXPECT_EQ(field.label(coords), expected_label);
+        EXPECT_NEAR(field.fieldValue(coords), (expected_label == 0) ? dist_a : dist_b, 0.01);
+        count_checked++;
+      }
+    }
+  }
+
+  EXPECT_GT(count_checked, 0);
+
+  // the band of the first sphere does not reach the far side of the second
+  const vec3i far_coords((gridpoints_count.x() - 1), gridpoints_count.y() / 2, gridpoints_count.z() / 2);
+  EXPECT_FALSE(field.isInObjectBand(0, far_coords));
+  EXPECT_EQ(field.objectFieldValue(0, far_coords), std::numeric_limits<real_t>::max());
+
+  // the labeled field matches the field of the first sphere generated on its own at shared positions
+  SignedDistanceField sdf_a;
+  EXPECT_TRUE(sdf_a.generate(mesh_a, expansion, voxel_size));
+  const vec3 offset = (sdf_a.bounds().lower() - field.bounds().lower()) / voxel_size;
+  const vec3i shift(static_cast<int>(std::round(offset.x())),
+                    static_cast<int>(std::round(offset.y())),
+                    static_cast<int>(std::round(offset.z())));
+  const vec3i sdf_count = sdf_a.gridPointsCount();
+  for(int z = 0; z < sdf_count.z(); z++) {
+    for(int y = 0; y < sdf_count.y(); y++) {
+      for(int x = 0; x < sdf_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const vec3 p = sdf_a.gridPointPosition(coords);
+        if (std::fabs(sphere(0, p)) > voxel_size) {
+          continue;
+        }
+
+        EXPECT_NEAR(field.objectFieldValue(0, coords + shift), sdf_a.fieldValue(coords), 1e-9);
+      }
+    }
+  }
+
+  std::filesystem::path vti_path = std::filesystem::temp_directory_path() / "labeled.vti";
+  EXPECT_TRUE(field.saveAsVTI(vti_path.string()));
+
+  SignedDistanceField loaded;
+  EXPECT_TRUE(loaded.loadAsVTI(vti_path.string()));
+  EXPECT_EQ(loaded.gridPointsCount(), field.gridPointsCount());
+
+  // scanline parity is not supported
+  LabeledDistanceField field_sp;
+  EXPECT_FALSE(field_sp.generate(meshes, expansion, voxel_size, false, SignedDistanceField::kSignModeScanlineParity));
+}
@@ -0,0 +1,130 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/trianglemesh.h"
+#include "volmesh/basetypes.h"
+#include "volmesh/marchingcubes.h"
+#include "volmesh/parallel.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/stlserializer.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <map>
+#include <utility>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(MarchingCubes, Tables) {
+  EXPECT_EQ(MarchingCubes::edgeMask(0), 0);
+  EXPECT_EQ(MarchingCubes::edgeMask(255), 0);
+  EXPECT_EQ(MarchingCubes::triangleEdges(0)[0], -1);
+  EXPECT_EQ(MarchingCubes::triangleEdges(255)[0], -1);
+
+  for(int cube_index = 0; cube_index < 256; cube_index++) {
+    // the triangles use exactly the crossed edges
+    uint16_t used_edges = 0;
+    int count_triangles = 0;
+    const auto& triangle_edges = MarchingCubes::triangleEdges(cube_index);
+    for(int k = 0; triangle_edges[k] >= 0; k += 3) {
+      for(int i = 0; i < 3; i++) {
+        used_edges |= static_cast<uint16_t>(1 << triangle_edges[k + i]);
+      }
+      count_triangles++;
+    }
+
+    EXPECT_EQ(used_edges, MarchingCubes::edgeMask(cube_index));
+    EXPECT_LE(count_triangles, MarchingCubes::kMaxTrianglesPerCube);
+    EXPECT_EQ(MarchingCubes::edgeMask(cube_index), MarchingCubes::edgeMask(255 - cube_index));
+  }
+
+  // a single inside corner is cut off by one triangle facing away from it
+  const auto& corner_triangle = MarchingCubes::triangleEdges(1);
+  std::array<vec3, 3> points;
+  for(int i = 0; i < 3; i++) {
+    const int edge = corner_triangle[i];
+    const vec2i corners = MarchingCubes::edgeCornerIds(edge);
+    points[i] = 0.5 * (MarchingCubes::cornerOffset(corners[0]) + MarchingCubes::cornerOffset(corners[1])).cast<real_t>();
+    EXPECT_EQ(MarchingCubes::cornerOffset(corners[1]) - MarchingCubes::cornerOffset(corners[0]),
+              vec3i::Unit(MarchingCubes::edgeAxis(edge)));
+  }
+  EXPECT_EQ(corner_triangle[3], -1);
+  const vec3 normal = (points[1] - points[0]).cross(points[2] - points[0]);
+  EXPECT_GT(normal.dot(points[0]), 0.0);
+}
+
+TEST(MarchingCubes, ExtractSphere) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), 0.05));
+
+  std::vector<vec3> vertices;
+  std::vector<vec3i> faces;
+  EXPECT_TRUE(sdf.extractIsoSurface(vertices, faces));
+  EXPECT_GT(faces.size(), 0);
+
+  // every vertex lies close to the sphere
+  for(const vec3& v : vertices) {
+    EXPECT_NEAR(v.norm(), 1.0, 0.01);
+  }
+
+  // the surface is closed and consistently oriented, every directed edge has one opposite
+  std::map<std::pair<int, int>, int> directed_edges;
+  real_t volume = 0.0;
+  for(const vec3i& face : faces) {
+    for(int i = 0; i < 3; i++) {
+      directed_edges[std::make_pair(face[i], face[(i + 1) % 3])]++;
+    }
+    volume += vertices[face[0]].dot(vertices[face[1]].cross(vertices[face[2]])) / 6.0;
+  }
+
+  for(const auto& [edge, count] : directed_edges) {
+    EXPECT_EQ(count, 1);
+    EXPECT_EQ(directed_edges.count(std::make_pair(edge.second, edge.first)), 1);
+  }
+
+  EXPECT_NEAR(volume, 4.0 * M_PI / 3.0, 0.05);
+
+  // the output does not depend on the number of threads
+  SetMaxThreadsCount(1);
+  std::vector<vec3> serial_vertices;
+  std::vector<vec3i> serial_faces;
+  EXPECT_TRUE(sdf.extractIsoSurface(serial_vertices, serial_faces));
+  SetMaxThreadsCount(0);
+  EXPECT_EQ(serial_vertices, vertices);
+  EXPECT_EQ(serial_faces, faces);
+
+  // a larger iso value grows the surface
+  std::vector<vec3> offset_vertices;
+  std::vector<vec3i> offset_faces;
+  EXPECT_TRUE(sdf.extractIsoSurface(offset_vertices, offset_faces, 0.03));
+  for(const vec3& v : offset_vertices) {
+    EXPECT_NEAR(v.norm(), 1.03, 0.01);
+  }
+
+  TriangleMesh extracted;
+  EXPECT_TRUE(sdf.extractIsoSurface(extracted));
+  EXPECT_EQ(extracted.countVertices(), vertices.size());
+  EXPECT_EQ(extracted.countFaces(), faces.size());
+
+  std::filesystem::path stl_path = std::filesystem::temp_directory_path() / "sphere_marching_cubes.stl";
+  EXPECT_TRUE(sdf.saveIsoSurfaceAsSTL(stl_path.string()));
+  EXPECT_EQ(std::filesystem::file_size(stl_path), 84 + 50 * faces.size());
+
+  TriangleMesh loaded;
+  EXPECT_TRUE(ReadSTL(stl_path.string(), loaded));
+  EXPECT_EQ(loaded.countFaces(), faces.size());
+
+  SignedDistanceField empty;
+  EXPECT_FALSE(empty.extractIsoSurface(vertices, faces));
+}
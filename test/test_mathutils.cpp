@@ -128,4 +128,44 @@ TEST(MathUtils, PointTriangleDistanceMidPoint) {
   EXPECT_TRUE(FuzzyCompare(q.x(), expected_q.x()));
   EXPECT_TRUE(FuzzyCompare(q.y(), expected_q.y()));
   EXPECT_TRUE(FuzzyCompare(q.z(), expected_q.z()));
-}
\ No newline at end of file
+}
+
+TEST(MathUtils, TriangleSolidAngleClosedTetrahedron) {
+  const std::array<vec3, 4> v = {
+    vec3(0.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, 1.0)
+  };
+
+  // outward oriented faces
+  const std::array<vec3i, 4> faces = {
+    vec3i(0, 2, 1), vec3i(0, 1, 3), vec3i(0, 3, 2), vec3i(1, 2, 3)
+  };
+
+  auto total_solid_angle = [&](const vec3& p) {
+    real_t sum = 0.0;
+    for(const auto& f : faces) {
+      sum += TriangleSolidAngle(p, v[f[0]], v[f[1]], v[f[2]]);
+    }
+    return sum;
+  };
+
+  EXPECT_NEAR(total_solid_angle(vec3(0.1, 0.1, 0.1)), 4.0 * M_PI, 1e-9);
+  EXPECT_NEAR(total_solid_angle(vec3(2.0, 2.0, 2.0)), 0.0, 1e-9);
+  EXPECT_NEAR(total_solid_angle(vec3(-0.5, 0.2, 0.3)), 0.0, 1e-9);
+}
+
+TEST(MathUtils, PointTriangleDistanceBelowPlane) {
+  const vec3 a(-2.0, -2.0, 0.0);
+  const vec3 b(2.0, -2.0, 0.0);
+  const vec3 c(0.0, 2.0, 0.0);
+  const vec3 p(0.0, 0.0, -2.0);
+
+  vec3 q;
+  ClosestTriangleFeature closest_feature;
+
+  // the distance is unsigned on both sides of the triangle plane
+  const real_t dist = PointTriangleDistance(p, a, b, c, q, closest_feature);
+
+  EXPECT_TRUE(FuzzyCompare(dist, 2.0));
+  EXPECT_TRUE(FuzzyIsNull(q.z()));
+  EXPECT_EQ(closest_feature, ClosestTriangleFeature::kClosestTriangleFeatureInside);
+}
@@ -0,0 +1,106 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/occupancygrid.h"
+#include "volmesh/trianglemesh.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace volmesh;
+
+// outward oriented faces of the unit cube, vertex id = x * 4 + y * 2 + z
+static const std::vector<vec3i> kCubeFaces = {
+  vec3i(0, 1, 3), vec3i(0, 3, 2),
+  vec3i(4, 6, 7), vec3i(4, 7, 5),
+  vec3i(0, 4, 5), vec3i(0, 5, 1),
+  vec3i(2, 3, 7), vec3i(2, 7, 6),
+  vec3i(0, 2, 6), vec3i(0, 6, 4),
+  vec3i(1, 5, 7), vec3i(1, 7, 3)
+};
+
+static void CreateCube(bool flipped, TriangleMesh& out_mesh) {
+  std::vector<vec3> vertices;
+  for(int i = 0; i < 8; i++) {
+    vertices.push_back(vec3((i >> 2) & 1, (i >> 1) & 1, i & 1));
+  }
+  out_mesh.insertAllVertices(vertices);
+
+  for(const auto& f : kCubeFaces) {
+    if (flipped) {
+      out_mesh.insertTriangle(vec3i(f[0], f[2], f[1]));
+    } else {
+      out_mesh.insertTriangle(f);
+    }
+  }
+}
+
+TEST(OccupancyGrid, SetAndGet) {
+  OccupancyGrid grid;
+  EXPECT_TRUE(grid.resize(AABB(vec3(0, 0, 0), vec3(10, 1, 1)), 0.1));
+  EXPECT_EQ(grid.gridPointsCount(), vec3i(101, 11, 11));
+  EXPECT_EQ(grid.countWordsPerRow(), 2);
+  EXPECT_EQ(grid.countOccupied(), 0);
+
+  grid.setOccupied(vec3i(0, 0, 0), true);
+  grid.setOccupied(vec3i(64, 3, 7), true);
+  grid.setOccupied(vec3i(100, 10, 10), true);
+  EXPECT_TRUE(grid.isOccupied(vec3i(64, 3, 7)));
+  EXPECT_FALSE(grid.isOccupied(vec3i(63, 3, 7)));
+  EXPECT_EQ(grid.countOccupied(), 3);
+
+  grid.setOccupied(vec3i(64, 3, 7), false);
+  EXPECT_FALSE(grid.isOccupied(vec3i(64, 3, 7)));
+  EXPECT_EQ(grid.countOccupied(), 2);
+
+  EXPECT_THROW(grid.isOccupied(vec3i(101, 0, 0)), std::out_of_range);
+  EXPECT_FALSE(grid.resize(AABB(), 0.0));
+}
+
+TEST(OccupancyGrid, VoxelizeCube) {
+  TriangleMesh tmesh;
+  CreateCube(false, tmesh);
+
+  // grid points are located at -0.15 + 0.1 * i along each axis
+  OccupancyGrid grid;
+  EXPECT_TRUE(grid.generate(tmesh, vec3(0.3, 0.3, 0.3), 0.1));
+  EXPECT_EQ(grid.countOccupied(), 1000);
+
+  EXPECT_TRUE(grid.isOccupied(vec3i(2, 2, 2)));
+  EXPECT_TRUE(grid.isOccupied(vec3i(11, 11, 11)));
+  EXPECT_FALSE(grid.isOccupied(vec3i(1, 5, 5)));
+  EXPECT_FALSE(grid.isOccupied(vec3i(12, 5, 5)));
+
+  // the result does not depend on the orientation of the triangles
+  TriangleMesh flipped_mesh;
+  CreateCube(true, flipped_mesh);
+
+  OccupancyGrid flipped_grid;
+  EXPECT_TRUE(flipped_grid.generate(flipped_mesh, vec3(0.3, 0.3, 0.3), 0.1));
+  EXPECT_EQ(flipped_grid.countOccupied(), 1000);
+}
+
+TEST(OccupancyGrid, RaysThroughSharedEdges) {
+  TriangleMesh tmesh;
+  CreateCube(false, tmesh);
+
+  // grid points are located at -0.1 + 0.1 * i, the rays with y == z pass exactly
+  // through the diagonals shared by the two triangles of the x faces
+  OccupancyGrid grid;
+  EXPECT_TRUE(grid.generate(tmesh, vec3(0.2, 0.2, 0.2), 0.1));
+
+  for(int k = 2; k <= 10; k++) {
+    for(int j = 2; j <= 10; j++) {
+      EXPECT_FALSE(grid.isOccupied(vec3i(0, j, k)));
+      for(int i = 3; i <= 9; i++) {
+        EXPECT_TRUE(grid.isOccupied(vec3i(i, j, k)));
+      }
+      EXPECT_FALSE(grid.isOccupied(vec3i(12, j, k)));
+    }
+  }
+}
@@ -0,0 +1,134 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/octreetetmesher.h"
+#include "volmesh/parallel.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetrahedra.h"
+#include "volmesh/trianglemesh.h"
+#include "volmesh/voxeltetmesher.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(OctreeTetMesher, MeshSphere) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const real_t voxel_size = 0.05;
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), voxel_size, SignedDistanceField::kSignModeScanlineParity));
+
+  std::vector<vec3> vertices;
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(MeshGradedOctree(sdf, OctreeSizeField(), vertices, cells));
+  EXPECT_GT(cells.size(), 0);
+
+  // the tetrahedra are oriented like the voxels of a TetMesh and fill the sphere
+  real_t volume = 0.0;
+  real_t max_edge_length = 0.0;
+  std::map<std::array<int, 3>, int> faces;
+  for(const vec4i& cell : cells) {
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int i = 0; i < 4; i++) {
+      tet_vertices.col(i) = vertices[cell[i]];
+    }
+
+    const Tetrahedra tet(tet_vertices);
+    EXPECT_LT(tet.determinant(), 0.0);
+    volume += tet.volume();
+
+    for(int e = 0; e < Tetrahedra::kNumEdges; e++) {
+      const vec2i edge = Tetrahedra::edgeVertexIdsLut(e);
+      max_edge_length = std::max(max_edge_length, (vertices[cell[edge[0]]] - vertices[cell[edge[1]]]).norm());
+    }
+
+    for(int f = 0; f < Tetrahedra::kNumFaces; f++) {
+      const vec3i face_lut = Tetrahedra::faceVertexIdsLut(f);
+      std::array<int, 3> face = {cell[face_lut[0]], cell[face_lut[1]], cell[face_lut[2]]};
+      std::sort(face.begin(), face.end());
+      faces[face]++;
+    }
+  }
+  EXPECT_NEAR(volume, 4.0 * M_PI / 3.0, 0.1);
+
+  // the cells grow away from the surface
+  EXPECT_GT(max_edge_length, 4.0 * voxel_size);
+
+  // the mesh is conforming and its boundary is a closed surface along the sphere
+  uint64_t count_boundary_faces = 0;
+  std::map<std::pair<int, int>, int> boundary_edges;
+  for(const auto& [face, count] : faces) {
+    EXPECT_LE(count, 2);
+    if(count == 1) {
+      count_boundary_faces++;
+      for(int i = 0; i < 3; i++) {
+        EXPECT_NEAR(vertices[face[i]].norm(), 1.0, 2.0 * voxel_size);
+        boundary_edges[std::minmax(face[i], face[(i + 1) % 3])]++;
+      }
+    }
+  }
+
+  for(const auto& [edge, count] : boundary_edges) {
+    EXPECT_EQ(count, 2);
+  }
+
+  // far fewer cells than splitting every voxel inside the sphere
+  std::vector<uint8_t> voxel_mask;
+  const uint64_t count_voxels = ClassifyInteriorVoxels(sdf, 4, voxel_mask);
+  EXPECT_LT(cells.size(), count_voxels * Voxel::kNumFittingTetrahedra / 2);
+
+  // the output does not depend on the number of threads
+  SetMaxThreadsCount(1);
+  std::vector<vec3> serial_vertices;
+  std::vector<vec4i> serial_cells;
+  EXPECT_TRUE(MeshGradedOctree(sdf, OctreeSizeField(), serial_vertices, serial_cells));
+  SetMaxThreadsCount(0);
+  EXPECT_EQ(serial_vertices, vertices);
+  EXPECT_EQ(serial_cells, cells);
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(MeshGradedOctree(sdf, OctreeSizeField(), tet_mesh));
+  EXPECT_EQ(tet_mesh.countCells(), cells.size());
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), count_boundary_faces);
+
+  // the size field limits the cells
+  const real_t max_size = 2.0 * voxel_size;
+  std::vector<vec3> sized_vertices;
+  std::vector<vec4i> sized_cells;
+  EXPECT_TRUE(MeshGradedOctree(sdf, [max_size](const vec3&) { return max_size; }, sized_vertices, sized_cells));
+  EXPECT_GT(sized_cells.size(), cells.size());
+  for(const vec4i& cell : sized_cells) {
+    for(int e = 0; e < Tetrahedra::kNumEdges; e++) {
+      const vec2i edge = Tetrahedra::edgeVertexIdsLut(e);
+      EXPECT_LE((sized_vertices[cell[edge[0]]] - sized_vertices[cell[edge[1]]]).norm(), max_size * std::sqrt(3.0) + 1e-9);
+    }
+  }
+
+  // the target number of cells picks the finest uniform limit within it
+  std::vector<vec3> target_vertices;
+  std::vector<vec4i> target_cells;
+  EXPECT_TRUE(MeshGradedOctree(sdf, static_cast<uint64_t>(sized_cells.size()), target_vertices, target_cells));
+  EXPECT_EQ(target_cells.size(), sized_cells.size());
+  EXPECT_TRUE(MeshGradedOctree(sdf, static_cast<uint64_t>(sized_cells.size() - 1), target_vertices, target_cells));
+  EXPECT_LT(target_cells.size(), sized_cells.size());
+  EXPECT_GE(target_cells.size(), cells.size());
+
+  SignedDistanceField empty;
+  EXPECT_FALSE(MeshGradedOctree(empty, OctreeSizeField(), vertices, cells));
+}
@@ -0,0 +1,74 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/parallel.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(Parallel, VisitsEveryIndexOnce) {
+  SetMaxThreadsCount(4);
+  EXPECT_EQ(CountWorkerThreads(), 4);
+
+  const uint64_t count = 10007;
+  std::vector<std::atomic<int>> visits(count);
+  for (auto& v : visits) {
+    v.store(0);
+  }
+
+  ParallelFor(0, count, [&](uint64_t chunk_begin, uint64_t chunk_end) {
+    for (uint64_t i = chunk_begin; i < chunk_end; i++) {
+      visits[i]++;
+    }
+  }, 64);
+
+  for (uint64_t i = 0; i < count; i++) {
+    EXPECT_EQ(visits[i].load(), 1);
+  }
+
+  SetMaxThreadsCount(0);
+  EXPECT_GE(CountWorkerThreads(), 1);
+}
+
+TEST(Parallel, EmptyRange) {
+  bool called = false;
+  ParallelFor(5, 5, [&](uint64_t, uint64_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST(Parallel, RethrowsWorkerException) {
+  SetMaxThreadsCount(4);
+  EXPECT_THROW(ParallelFor(0, 100, [](uint64_t chunk_begin, uint64_t) {
+    if (chunk_begin == 42) {
+      throw std::runtime_error("failed");
+    }
+  }), std::runtime_error);
+  SetMaxThreadsCount(0);
+}
+
+TEST(Parallel, InsideParallelFor) {
+  EXPECT_FALSE(IsInsideParallelFor());
+
+  SetMaxThreadsCount(4);
+  std::atomic<int> count_inside(0);
+  ParallelFor(0, 100, [&](uint64_t, uint64_t) {
+    if (IsInsideParallelFor()) {
+      count_inside++;
+    }
+  });
+  EXPECT_EQ(count_inside.load(), 100);
+  SetMaxThreadsCount(0);
+
+  // a single chunk runs on the calling thread, which is inside while it runs
+  ParallelFor(0, 1, [](uint64_t, uint64_t) { EXPECT_TRUE(IsInsideParallelFor()); });
+  EXPECT_FALSE(IsInsideParallelFor());
+}
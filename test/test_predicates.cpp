@@ -0,0 +1,223 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/predicates.h"
+#include "volmesh/tetrahedra.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <random>
+
+using namespace volmesh;
+
+typedef __int128 int128_t;
+typedef std::array<int64_t, 3> Point3i;
+
+static int Sign(int128_t value) {
+  return (value > 0) ? 1 : ((value < 0) ? -1 : 0);
+}
+
+static vec3 ToVec3(const Point3i& p) {
+  return vec3(static_cast<real_t>(p[0]), static_cast<real_t>(p[1]), static_cast<real_t>(p[2]));
+}
+
+static int128_t Determinant3(const int128_t m[3][3]) {
+  return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+         m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+         m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+/**
+ * @brief The reference orientation of points with integer coordinates.
+ */
+static int ReferenceOrient3d(const Point3i& a, const Point3i& b, const Point3i& c, const Point3i& d) {
+  const Point3i* rows[3] = {&a, &b, &c};
+  int128_t m[3][3];
+  for(int i = 0; i < 3; i++) {
+    for(int k = 0; k < 3; k++) {
+      m[i][k] = (*rows[i])[k] - d[k];
+    }
+  }
+  return Sign(Determinant3(m));
+}
+
+/**
+ * @brief The reference in-sphere test of points with integer coordinates.
+ */
+static int ReferenceInSphere(const Point3i& a, const Point3i& b, const Point3i& c, const Point3i& d, const Point3i& e) {
+  const Point3i* rows[4] = {&a, &b, &c, &d};
+  int128_t m[4][4];
+  for(int i = 0; i < 4; i++) {
+    m[i][3] = 0;
+    for(int k = 0; k < 3; k++) {
+      m[i][k] = (*rows[i])[k] - e[k];
+      m[i][3] += m[i][k] * m[i][k];
+    }
+  }
+
+  int128_t det = 0;
+  for(int i = 0; i < 4; i++) {
+    int128_t minor[3][3];
+    for(int r = 0, row = 0; r < 4; r++) {
+      if(r != i) {
+        for(int k = 0; k < 3; k++) {
+          minor[row][k] = m[r][k];
+        }
+        row++;
+      }
+    }
+    det += ((i % 2 == 0) ? -1 : 1) * m[i][3] * Determinant3(minor);
+  }
+  return Sign(det);
+}
+
+TEST(Predicates, Orient2d) {
+  EXPECT_EQ(Orient2d(vec2(0, 0), vec2(1, 0), vec2(0, 1)), 1);
+  EXPECT_EQ(Orient2d(vec2(0, 0), vec2(0, 1), vec2(1, 0)), -1);
+  EXPECT_EQ(Orient2d(vec2(0, 0), vec2(1, 1), vec2(3, 3)), 0);
+
+  // the rounded products of nearly collinear points cancel
+  PredicateStatistics stats;
+  const real_t offset = 1 << 30;
+  for(int i = -2; i <= 2; i++) {
+    const vec2 a(offset, offset);
+    const vec2 b(offset + 3.0, offset + 5.0);
+    const vec2 c(offset + 3.0 * (1 << 25) + i, offset + 5.0 * (1 << 25));
+    EXPECT_EQ(Orient2d(a, b, c, &stats), (i > 0) ? -1 : ((i < 0) ? 1 : 0));
+  }
+  EXPECT_EQ(stats.count(), 5);
+}
+
+TEST(Predicates, Orient3dNearlyCoplanar) {
+  std::mt19937_64 generator(17);
+  std::uniform_int_distribution<int64_t> coordinate(-(int64_t(1) << 30), int64_t(1) << 30);
+  std::uniform_int_distribution<int64_t> weight(-8, 8);
+  std::uniform_int_distribution<int64_t> perturbation(-1, 1);
+
+  PredicateStatistics stats;
+  for(int i = 0; i < 2000; i++) {
+    Point3i a, b, c, d;
+    for(int k = 0; k < 3; k++) {
+      a[k] = coordinate(generator);
+      b[k] = coordinate(generator);
+      c[k] = coordinate(generator);
+    }
+
+    // d lies on the plane of a, b and c or next to it
+    const int64_t s = weight(generator);
+    const int64_t t = weight(generator);
+    for(int k = 0; k < 3; k++) {
+      d[k] = a[k] + s * (b[k] - a[k]) + t * (c[k] - a[k]) + perturbation(generator);
+    }
+
+    const int expected = ReferenceOrient3d(a, b, c, d);
+    EXPECT_EQ(Orient3d(ToVec3(a), ToVec3(b), ToVec3(c), ToVec3(d), &stats), expected);
+    EXPECT_EQ(Orient3d(ToVec3(b), ToVec3(a), ToVec3(c), ToVec3(d)), -expected);
+  }
+  EXPECT_EQ(stats.count(), 2000);
+  EXPECT_GT(stats.count_exact, 0);
+}
+
+TEST(Predicates, InSphereNearlyCospherical) {
+  std::mt19937_64 generator(23);
+  std::uniform_int_distribution<int64_t> offset(-(int64_t(1) << 18), int64_t(1) << 18);
+  std::uniform_int_distribution<int64_t> size(1, 1 << 20);
+  std::uniform_int_distribution<int64_t> perturbation(-1, 1);
+
+  // the corners of a box are cospherical
+  PredicateStatistics stats;
+  for(int i = 0; i < 2000; i++) {
+    const Point3i lower = {offset(generator), offset(generator), offset(generator)};
+    const Point3i extent = {size(generator), size(generator), size(generator)};
+    std::array<Point3i, 8> corners;
+    for(int c = 0; c < 8; c++) {
+      for(int k = 0; k < 3; k++) {
+        corners[c][k] = lower[k] + (((c >> k) & 1) ? extent[k] : 0);
+      }
+    }
+
+    Point3i a = corners[0];
+    Point3i b = corners[1];
+    Point3i c = corners[2];
+    const Point3i d = corners[4];
+    if(ReferenceOrient3d(a, b, c, d) < 0) {
+      std::swap(a, b);
+    }
+
+    Point3i e = corners[7];
+    for(int k = 0; k < 3; k++) {
+      e[k] += perturbation(generator);
+    }
+
+    const int expected = ReferenceInSphere(a, b, c, d, e);
+    EXPECT_EQ(InSphere(ToVec3(a), ToVec3(b), ToVec3(c), ToVec3(d), ToVec3(e), &stats), expected);
+  }
+  EXPECT_EQ(stats.count(), 2000);
+  EXPECT_GT(stats.count_exact, 0);
+
+  EXPECT_EQ(InSphere(vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, 0), vec3(0.5, 0.5, 0.5)), 1);
+  EXPECT_EQ(InSphere(vec3(1, 0, 0), vec3(0, 1, 0), vec3(0, 0, 1), vec3(0, 0, 0), vec3(2, 2, 2)), -1);
+}
+
+TEST(Predicates, StaticFilter) {
+  std::mt19937 generator(5);
+  std::uniform_real_distribution<real_t> distribution(-1.0, 1.0);
+  auto random_point = [&]() {
+    return vec3(distribution(generator), distribution(generator), distribution(generator));
+  };
+
+  const StaticPredicateFilter filter(AABB(vec3(-1, -1, -1), vec3(1, 1, 1)));
+  PredicateStatistics static_stats;
+  PredicateStatistics semi_static_stats;
+  for(int i = 0; i < 1000; i++) {
+    const vec3 a = random_point();
+    const vec3 b = random_point();
+    const vec3 c = random_point();
+    const vec3 d = random_point();
+    const vec3 e = random_point();
+
+    EXPECT_EQ(filter.orient2d(a.head<2>(), b.head<2>(), c.head<2>(), &static_stats), Orient2d(a.head<2>(), b.head<2>(), c.head<2>(), &semi_static_stats));
+    EXPECT_EQ(filter.orient3d(a, b, c, d, &static_stats), Orient3d(a, b, c, d, &semi_static_stats));
+    if(Orient3d(a, b, c, d) > 0) {
+      EXPECT_EQ(filter.inSphere(a, b, c, d, e, &static_stats), InSphere(a, b, c, d, e, &semi_static_stats));
+    }
+  }
+
+  // random points in general position are decided by the first filter
+  EXPECT_EQ(static_stats.count(), semi_static_stats.count());
+  EXPECT_GT(static_stats.count_static, static_stats.count() * 99 / 100);
+  EXPECT_EQ(semi_static_stats.count_static, 0);
+  EXPECT_GT(semi_static_stats.count_semi_static, semi_static_stats.count() * 99 / 100);
+  EXPECT_GT(static_stats.filterHitRate(), 0.99);
+
+  PredicateStatistics total = static_stats;
+  total += semi_static_stats;
+  EXPECT_EQ(total.count(), static_stats.count() * 2);
+  EXPECT_EQ(PredicateStatistics().filterHitRate(), 1.0);
+}
+
+TEST(Predicates, TetrahedraOrientation) {
+  Tetrahedra::TetraVertexArray vertices;
+  vertices.col(0) = vec3(0, 0, 0);
+  vertices.col(1) = vec3(1, 0, 0);
+  vertices.col(2) = vec3(0, 1, 0);
+  vertices.col(3) = vec3(0, 0, 1);
+  EXPECT_EQ(Tetrahedra(vertices).orientation(), 1);
+  EXPECT_GT(Tetrahedra(vertices).determinant(), 0.0);
+
+  vertices.col(3) = vec3(0, 0, -1);
+  EXPECT_EQ(Tetrahedra(vertices).orientation(), -1);
+
+  // a nearly flat tetrahedron
+  vertices.col(0) = vec3(0.1, 0.2, 0.3);
+  vertices.col(1) = vec3(1.7, 0.4, 0.9);
+  vertices.col(2) = vec3(0.3, 2.1, 0.5);
+  vertices.col(3) = vertices.col(1) + vertices.col(2) - vertices.col(0);
+  EXPECT_EQ(Tetrahedra(vertices).orientation(), Orient3d(vertices.col(0), vertices.col(1), vertices.col(3), vertices.col(2)));
+}
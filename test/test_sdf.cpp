@@ -8,11 +8,22 @@
 
 #include "volmesh/trianglemesh.h"
 #include "volmesh/basetypes.h"
+#include "volmesh/mathutils.h"
+#include "volmesh/pointcloudserializer.h"
 #include "volmesh/signeddistancefield.h"
+#include "volmesh/sampletetmeshes.h"
+#include "volmesh/tetmesh.h"
+#include "testmeshes.h"
 
 #include <gtest/gtest.h>
+#include <fmt/core.h>
+#include <functional>
 #include <vector>
 #include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <iostream>
+#include <map>
 
 using namespace volmesh;
 
@@ -50,4 +61,980 @@ TEST(SignedDistanceField, SaveLoadVTI) {
   EXPECT_EQ(sdf1.totalGridPointsCount(), sdf2.totalGridPointsCount());
 
   EXPECT_EQ(sdf1.getTotalMemoryUsageInBytes(), sdf2.getTotalMemoryUsageInBytes());
-}
\ No newline at end of file
+}
+
+TEST(SignedDistanceField, WindingNumberSignMode) {
+  // unit cube with outward oriented faces, vertex id = x * 4 + y * 2 + z
+  std::vector<vec3> vertices;
+  for(int i = 0; i < 8; i++) {
+    vertices.push_back(vec3((i >> 2) & 1, (i >> 1) & 1, i & 1));
+  }
+
+  const std::vector<vec3i> faces = {
+    vec3i(0, 1, 3), vec3i(0, 3, 2),
+    vec3i(4, 6, 7), vec3i(4, 7, 5),
+    vec3i(0, 4, 5), vec3i(0, 5, 1),
+    vec3i(2, 3, 7), vec3i(2, 7, 6),
+    vec3i(0, 2, 6), vec3i(0, 6, 4),
+    vec3i(1, 5, 7), vec3i(1, 7, 3)
+  };
+
+  TriangleMesh closed_mesh;
+  EXPECT_TRUE(closed_mesh.insertAllVertices(vertices));
+  for(const auto& f : faces) {
+    closed_mesh.insertTriangle(f);
+  }
+  closed_mesh.computeHalfEdgePseudoNormals();
+  closed_mesh.computeVertexPseudoNormals();
+
+  SignedDistanceField sdf_pn;
+  EXPECT_TRUE(sdf_pn.generate(closed_mesh, vec3(0.3, 0.3, 0.3), 0.1));
+
+  SignedDistanceField sdf_wn;
+  EXPECT_TRUE(sdf_wn.generate(closed_mesh, vec3(0.3, 0.3, 0.3), 0.1,
+                              SignedDistanceField::kSignModeWindingNumber));
+
+  // both modes agree on a watertight mesh
+  const vec3i gridpoints_count = sdf_wn.gridPointsCount();
+  EXPECT_EQ(gridpoints_count, sdf_pn.gridPointsCount());
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        EXPECT_NEAR(sdf_wn.fieldValue(coords), sdf_pn.fieldValue(coords), 1e-6);
+      }
+    }
+  }
+
+  // the winding number mode does not need pseudo normals and tolerates a missing face
+  TriangleMesh open_mesh;
+  EXPECT_TRUE(open_mesh.insertAllVertices(vertices));
+  for(size_t i = 0; i < faces.size() - 2; i++) {
+    open_mesh.insertTriangle(faces[i]);
+  }
+
+  SignedDistanceField sdf_open;
+  EXPECT_FALSE(sdf_open.generate(open_mesh, vec3(0.3, 0.3, 0.3), 0.1));
+  EXPECT_TRUE(sdf_open.generate(open_mesh, vec3(0.3, 0.3, 0.3), 0.1,
+                                SignedDistanceField::kSignModeWindingNumber));
+
+  // grid points are located at -0.15 + 0.1 * i along each axis
+  EXPECT_NEAR(sdf_open.fieldValue(vec3i(6, 6, 2)), -0.05, 1e-6);
+  EXPECT_NEAR(sdf_open.fieldValue(vec3i(2, 6, 6)), -0.05, 1e-6);
+  EXPECT_NEAR(sdf_open.fieldValue(vec3i(6, 6, 1)), 0.05, 1e-6);
+}
+
+TEST(SignedDistanceField, ScanlineParitySignMode) {
+  // unit cube with outward oriented faces, vertex id = x * 4 + y * 2 + z
+  std::vector<vec3> vertices;
+  for(int i = 0; i < 8; i++) {
+    vertices.push_back(vec3((i >> 2) & 1, (i >> 1) & 1, i & 1));
+  }
+
+  const std::vector<vec3i> faces = {
+    vec3i(0, 1, 3), vec3i(0, 3, 2),
+    vec3i(4, 6, 7), vec3i(4, 7, 5),
+    vec3i(0, 4, 5), vec3i(0, 5, 1),
+    vec3i(2, 3, 7), vec3i(2, 7, 6),
+    vec3i(0, 2, 6), vec3i(0, 6, 4),
+    vec3i(1, 5, 7), vec3i(1, 7, 3)
+  };
+
+  TriangleMesh tmesh;
+  EXPECT_TRUE(tmesh.insertAllVertices(vertices));
+  for(const auto& f : faces) {
+    tmesh.insertTriangle(f);
+  }
+  tmesh.computeHalfEdgePseudoNormals();
+  tmesh.computeVertexPseudoNormals();
+
+  SignedDistanceField sdf_pn;
+  EXPECT_TRUE(sdf_pn.generate(tmesh, vec3(0.3, 0.3, 0.3), 0.1));
+
+  SignedDistanceField sdf_sp;
+  EXPECT_TRUE(sdf_sp.generate(tmesh, vec3(0.3, 0.3, 0.3), 0.1,
+                              SignedDistanceField::kSignModeScanlineParity));
+
+  const vec3i gridpoints_count = sdf_sp.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const real_t value_pn = sdf_pn.fieldValue(coords);
+        const real_t value_sp = sdf_sp.fieldValue(coords);
+
+        // the band values agree, and both modes sign the points off the band alike
+        if (std::abs(value_pn) != std::numeric_limits<real_t>::max()) {
+          EXPECT_NEAR(value_sp, value_pn, 1e-6);
+        } else {
+          EXPECT_EQ(value_sp, value_pn);
+        }
+      }
+    }
+  }
+
+  // the center of the cube lies outside the band
+  EXPECT_EQ(sdf_sp.fieldValue(vec3i(6, 6, 6)), -std::numeric_limits<real_t>::max());
+}
+
+TEST(SignedDistanceField, DistanceTransformMatchesExact) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const real_t voxel_size = 0.05;
+  const vec3 expansion(0.3, 0.3, 0.3);
+
+  auto t0 = std::chrono::high_resolution_clock::now();
+
+  SignedDistanceField sdf_exact;
+  EXPECT_TRUE(sdf_exact.generate(tmesh, expansion, voxel_size,
+                                 SignedDistanceField::kSignModeScanlineParity));
+
+  auto t1 = std::chrono::high_resolution_clock::now();
+
+  SignedDistanceField sdf_edt;
+  EXPECT_TRUE(sdf_edt.generateByDistanceTransform(tmesh, expansion, voxel_size));
+
+  auto t2 = std::chrono::high_resolution_clock::now();
+
+  EXPECT_EQ(sdf_exact.gridPointsCount(), sdf_edt.gridPointsCount());
+
+  // compare within one voxel of the surface, where the band of the exact field is complete
+  real_t max_error = 0.0;
+  real_t sum_error = 0.0;
+  uint64_t count_band = 0;
+
+  const vec3i gridpoints_count = sdf_exact.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const real_t exact = sdf_exact.fieldValue(coords);
+        if (std::abs(exact) > voxel_size) {
+          continue;
+        }
+
+        const real_t error = std::abs(sdf_edt.fieldValue(coords) - exact);
+        max_error = std::max(max_error, error);
+        sum_error += error;
+        count_band++;
+      }
+    }
+  }
+
+  const auto exact_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+  const auto edt_ms = std::chrono::duration_cast<std::chrono::milliseconds>(t2 - t1).count();
+  std::cout << "exact generate = " << exact_ms << " ms, distance transform = " << edt_ms << " ms" << std::endl;
+  std::cout << "band points = " << count_band
+            << ", max error = " << max_error / voxel_size << " voxels"
+            << ", mean error = " << (sum_error / count_band) / voxel_size << " voxels" << std::endl;
+
+  EXPECT_GT(count_band, 0);
+  EXPECT_LT(max_error, voxel_size);
+
+  // the distance transform also covers the points outside the band
+  EXPECT_NEAR(sdf_edt.fieldValue(vec3(0.0, 0.0, 0.0)), -1.0, voxel_size);
+
+  // an open mesh has no inside, and the failure leaves the field as it was
+  TriangleMesh open_mesh;
+  open_mesh.insertAllVertices({vec3(0.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0)});
+  open_mesh.insertTriangle(vec3i(0, 1, 2));
+  EXPECT_FALSE(sdf_edt.generateByDistanceTransform(open_mesh, expansion, voxel_size * 2.0));
+  EXPECT_EQ(sdf_edt.voxelSize(), voxel_size);
+  EXPECT_EQ(sdf_edt.gridPointsCount(), gridpoints_count);
+  EXPECT_NEAR(sdf_edt.fieldValue(vec3(0.0, 0.0, 0.0)), -1.0, voxel_size);
+}
+
+TEST(SignedDistanceField, OutOfCoreMatchesInCore) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 12, 24, tmesh);
+
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.4, 0.4, 0.4);
+
+  SignedDistanceField sdf_in_core;
+  EXPECT_TRUE(sdf_in_core.generate(tmesh, expansion, voxel_size));
+  EXPECT_FALSE(sdf_in_core.isMapped());
+
+  // a budget of five z layers of magnitudes and signs
+  const vec3i gridpoints_count = sdf_in_core.gridPointsCount();
+  const uint64_t layer_bytes = gridpoints_count.x() * gridpoints_count.y() * 2 * sizeof(real_t);
+
+  std::filesystem::path bin_path = std::filesystem::temp_directory_path() / "sphere_out_of_core.sdf";
+
+  SignedDistanceField sdf_out_of_core;
+  EXPECT_FALSE(sdf_out_of_core.generateOutOfCore(tmesh, expansion, voxel_size, bin_path.string(), layer_bytes - 1));
+  EXPECT_TRUE(sdf_out_of_core.generateOutOfCore(tmesh, expansion, voxel_size, bin_path.string(), layer_bytes * 5));
+  EXPECT_TRUE(sdf_out_of_core.isMapped());
+  EXPECT_EQ(sdf_out_of_core.gridPointsCount(), gridpoints_count);
+
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        EXPECT_EQ(sdf_out_of_core.fieldValue(coords), sdf_in_core.fieldValue(coords));
+      }
+    }
+  }
+
+  // copies of a mapped field live in memory
+  SignedDistanceField sdf_copy(sdf_out_of_core);
+  EXPECT_FALSE(sdf_copy.isMapped());
+  EXPECT_EQ(sdf_copy.fieldValue(vec3(0.1, 0.2, 0.3)), sdf_in_core.fieldValue(vec3(0.1, 0.2, 0.3)));
+
+  // binary round trip
+  std::filesystem::path copy_path = std::filesystem::temp_directory_path() / "sphere_copy.sdf";
+  EXPECT_TRUE(sdf_copy.saveAsBinary(copy_path.string()));
+
+  SignedDistanceField sdf_loaded;
+  EXPECT_TRUE(sdf_loaded.loadAsBinary(copy_path.string()));
+  EXPECT_FALSE(sdf_loaded.isMapped());
+  EXPECT_EQ(sdf_loaded.gridPointsCount(), gridpoints_count);
+  EXPECT_EQ(sdf_loaded.fieldValue(vec3i(3, 4, 5)), sdf_in_core.fieldValue(vec3i(3, 4, 5)));
+
+  // generating again releases the mapping
+  EXPECT_TRUE(sdf_out_of_core.generate(tmesh, expansion, voxel_size));
+  EXPECT_FALSE(sdf_out_of_core.isMapped());
+
+  EXPECT_FALSE(sdf_loaded.loadAsBinary((std::filesystem::temp_directory_path() / "does_not_exist.sdf").string()));
+
+  // a file that fails to load or map leaves the field as it was
+  std::filesystem::path truncated_path = std::filesystem::temp_directory_path() / "sphere_truncated.sdf";
+  std::filesystem::path other_path = std::filesystem::temp_directory_path() / "sphere_other.sdf";
+  SignedDistanceField sdf_other;
+  EXPECT_TRUE(sdf_other.generate(tmesh, expansion * 2.0, voxel_size * 2.0));
+  EXPECT_TRUE(sdf_other.saveAsBinary(other_path.string()));
+  std::filesystem::copy_file(other_path, truncated_path, std::filesystem::copy_options::overwrite_existing);
+  std::filesystem::resize_file(truncated_path, std::filesystem::file_size(other_path) - sizeof(real_t));
+
+  EXPECT_FALSE(sdf_loaded.loadAsBinary(truncated_path.string()));
+  EXPECT_FALSE(sdf_loaded.mapBinary(truncated_path.string()));
+  EXPECT_EQ(sdf_loaded.voxelSize(), voxel_size);
+  EXPECT_EQ(sdf_loaded.gridPointsCount(), gridpoints_count);
+  EXPECT_EQ(sdf_loaded.bounds().lower(), sdf_in_core.bounds().lower());
+  EXPECT_EQ(sdf_loaded.fieldValue(vec3i(3, 4, 5)), sdf_in_core.fieldValue(vec3i(3, 4, 5)));
+
+  // so does an out-of-core generation with a small budget or an unwritable path
+  EXPECT_FALSE(sdf_loaded.generateOutOfCore(tmesh, expansion * 2.0, voxel_size * 2.0, other_path.string(), 1));
+  EXPECT_FALSE(sdf_loaded.generateOutOfCore(tmesh, expansion * 2.0, voxel_size * 2.0,
+                                            (std::filesystem::temp_directory_path() / "missing_dir" / "sphere.sdf").string()));
+  EXPECT_EQ(sdf_loaded.voxelSize(), voxel_size);
+  EXPECT_EQ(sdf_loaded.gridPointsCount(), gridpoints_count);
+  EXPECT_EQ(sdf_loaded.fieldValue(vec3i(3, 4, 5)), sdf_in_core.fieldValue(vec3i(3, 4, 5)));
+
+  // the file mapped by a field can be generated again
+  EXPECT_TRUE(sdf_loaded.mapBinary(copy_path.string()));
+  EXPECT_TRUE(sdf_loaded.generateOutOfCore(tmesh, expansion, voxel_size, copy_path.string(), layer_bytes * 3));
+  EXPECT_TRUE(sdf_loaded.isMapped());
+  EXPECT_EQ(sdf_loaded.fieldValue(vec3i(3, 4, 5)), sdf_in_core.fieldValue(vec3i(3, 4, 5)));
+}
+
+TEST(SignedDistanceField, ShardsMatchInCore) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 12, 24, tmesh);
+
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.4, 0.4, 0.4);
+  const uint32_t shard_count = 3;
+
+  SignedDistanceField sdf_in_core;
+  EXPECT_TRUE(sdf_in_core.generate(tmesh, expansion, voxel_size));
+  const vec3i gridpoints_count = sdf_in_core.gridPointsCount();
+
+  AABB shard_bounds;
+  EXPECT_FALSE(SignedDistanceField::ComputeShardBounds(sdf_in_core.bounds(), voxel_size, 3, 3, shard_bounds));
+  EXPECT_FALSE(SignedDistanceField::ComputeShardBounds(sdf_in_core.bounds(), voxel_size, 0, gridpoints_count.z() + 1, shard_bounds));
+
+  // the shards are listed out of order on purpose
+  std::vector<std::string> shard_paths;
+  int count_layers = 0;
+  for (uint32_t i = shard_count; i-- > 0;) {
+    SignedDistanceField shard;
+    EXPECT_TRUE(shard.generateShard(tmesh, expansion, voxel_size, i, shard_count));
+    EXPECT_EQ(shard.gridPointsCount().x(), gridpoints_count.x());
+    EXPECT_EQ(shard.gridPointsCount().y(), gridpoints_count.y());
+    count_layers += shard.gridPointsCount().z();
+
+    // every shard is a valid field on its own
+    const int z_offset = static_cast<int>(std::round((shard.bounds().lower().z() - sdf_in_core.bounds().lower().z()) / voxel_size));
+    for(int z = 0; z < shard.gridPointsCount().z(); z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          EXPECT_EQ(shard.fieldValue(vec3i(x, y, z)), sdf_in_core.fieldValue(vec3i(x, y, z + z_offset)));
+        }
+      }
+    }
+
+    std::filesystem::path shard_path = std::filesystem::temp_directory_path() / fmt::format("sphere_shard_{}.sdf", i);
+    EXPECT_TRUE(shard.saveAsBinary(shard_path.string()));
+    shard_paths.push_back(shard_path.string());
+  }
+
+  // neighbouring shards share one layer
+  EXPECT_EQ(count_layers, gridpoints_count.z() + static_cast<int>(shard_count) - 1);
+
+  std::filesystem::path merged_path = std::filesystem::temp_directory_path() / "sphere_merged.sdf";
+  EXPECT_TRUE(SignedDistanceField::MergeBinaryShards(shard_paths, merged_path.string()));
+
+  SignedDistanceField sdf_merged;
+  EXPECT_TRUE(sdf_merged.loadAsBinary(merged_path.string()));
+  EXPECT_EQ(sdf_merged.gridPointsCount(), gridpoints_count);
+
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        EXPECT_EQ(sdf_merged.fieldValue(coords), sdf_in_core.fieldValue(coords));
+      }
+    }
+  }
+
+  std::filesystem::path pvti_path = std::filesystem::temp_directory_path() / "sphere_merged.pvti";
+  EXPECT_TRUE(SignedDistanceField::SaveShardsAsPVTI(shard_paths, pvti_path.string()));
+  EXPECT_TRUE(std::filesystem::exists(std::filesystem::temp_directory_path() / "sphere_merged_0.vti"));
+
+  // a missing shard leaves a gap
+  const std::vector<std::string> incomplete_paths = {shard_paths[0], shard_paths[2]};
+  EXPECT_FALSE(SignedDistanceField::MergeBinaryShards(incomplete_paths, merged_path.string()));
+
+  // the scanline parity shards only voxelize their own layers and still match the in-core field
+  SignedDistanceField sdf_parity;
+  EXPECT_TRUE(sdf_parity.generate(tmesh, expansion, voxel_size, SignedDistanceField::kSignModeScanlineParity));
+  for (uint32_t i = 0; i < shard_count; i++) {
+    SignedDistanceField shard;
+    EXPECT_TRUE(shard.generateShard(tmesh, expansion, voxel_size, i, shard_count, SignedDistanceField::kSignModeScanlineParity));
+
+    const int z_offset = static_cast<int>(std::round((shard.bounds().lower().z() - sdf_parity.bounds().lower().z()) / voxel_size));
+    for(int z = 0; z < shard.gridPointsCount().z(); z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          EXPECT_EQ(shard.fieldValue(vec3i(x, y, z)), sdf_parity.fieldValue(vec3i(x, y, z + z_offset)));
+        }
+      }
+    }
+  }
+}
+
+TEST(SignedDistanceField, ShardBeyond32BitGridPointIds) {
+  // a needle so tall that the grid point ids of its tip do not fit in 32 bits
+  const real_t height = 3.0e8;
+  TriangleMesh tmesh;
+  tmesh.insertAllVertices({vec3(0.0, 0.0, 0.0), vec3(1.0, 0.0, 0.0), vec3(0.0, 1.0, 0.0), vec3(0.0, 0.0, height)});
+  tmesh.insertTriangle(vec3i(0, 2, 1));
+  tmesh.insertTriangle(vec3i(0, 1, 3));
+  tmesh.insertTriangle(vec3i(0, 3, 2));
+  tmesh.insertTriangle(vec3i(1, 2, 3));
+  tmesh.computeHalfEdgePseudoNormals();
+  tmesh.computeVertexPseudoNormals();
+
+  // only the last two layers of the global grid are allocated
+  const real_t voxel_size = 1.0;
+  const vec3 expansion(2.0, 2.0, 0.0);
+  const uint32_t shard_count = 150000000;
+  SignedDistanceField shard;
+  EXPECT_TRUE(shard.generateShard(tmesh, expansion, voxel_size, shard_count - 1, shard_count));
+
+  const vec3i gridpoints_count = shard.gridPointsCount();
+  EXPECT_GT(static_cast<uint64_t>(height) * gridpoints_count.x() * gridpoints_count.y(), uint64_t(1) << 32);
+  EXPECT_EQ(shard.bounds().upper().z(), height);
+
+  // the tip is on the last layer, and every grid point is within the band of the needle
+  const vec3i tip_coords(1, 1, gridpoints_count.z() - 1);
+  EXPECT_EQ(shard.gridPointPosition(tip_coords), vec3(0.0, 0.0, height));
+  EXPECT_NEAR(shard.fieldValue(tip_coords), 0.0, 1e-9);
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const real_t tip_distance = (shard.gridPointPosition(coords) - vec3(0.0, 0.0, height)).norm();
+        EXPECT_LE(std::fabs(shard.fieldValue(coords)), tip_distance + 1e-9);
+      }
+    }
+  }
+}
+
+TEST(SignedDistanceField, CsgOperations) {
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.3, 0.3, 0.3);
+  const vec3 center_a(0.0, 0.0, 0.0);
+  const vec3 center_b(1.0, 0.0, 0.0);
+
+  TriangleMesh mesh_a;
+  CreateSphere(1.0, 24, 48, mesh_a, center_a);
+  TriangleMesh mesh_b;
+  CreateSphere(1.0, 24, 48, mesh_b, center_b);
+
+  // the scanline parity signs cover the entire grid
+  SignedDistanceField sdf_a;
+  EXPECT_TRUE(sdf_a.generate(mesh_a, expansion, voxel_size, SignedDistanceField::kSignModeScanlineParity));
+
+  // b is aligned with the grid of a, c has a different voxel size and is resampled
+  SignedDistanceField sdf_b;
+  EXPECT_TRUE(sdf_b.generate(mesh_b, expansion, voxel_size, SignedDistanceField::kSignModeScanlineParity));
+  SignedDistanceField sdf_c;
+  EXPECT_TRUE(sdf_c.generate(mesh_b, expansion, 0.07, SignedDistanceField::kSignModeScanlineParity));
+
+  auto sphere_a = [&](const vec3& p) { return (p - center_a).norm() - 1.0; };
+  auto sphere_b = [&](const vec3& p) { return (p - center_b).norm() - 1.0; };
+
+  auto check = [&](const SignedDistanceField& sdf, const std::function<real_t(const vec3&)>& expected, real_t tolerance) {
+    int count_checked = 0;
+    const vec3i gridpoints_count = sdf.gridPointsCount();
+    for(int z = 0; z < gridpoints_count.z(); z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords(x, y, z);
+          const vec3 p = sdf.gridPointPosition(coords);
+
+          // the fields are exact within a voxel of both surfaces
+          if (std::fabs(sphere_a(p)) > voxel_size || std::fabs(sphere_b(p)) > voxel_size) {
+            continue;
+          }
+
+          EXPECT_NEAR(sdf.fieldValue(coords), expected(p), tolerance);
+          count_checked++;
+        }
+      }
+    }
+    EXPECT_GT(count_checked, 0);
+  };
+
+  auto union_ab = [&](const vec3& p) { return std::min(sphere_a(p), sphere_b(p)); };
+  auto intersection_ab = [&](const vec3& p) { return std::max(sphere_a(p), sphere_b(p)); };
+  auto difference_ab = [&](const vec3& p) { return std::max(sphere_a(p), -sphere_b(p)); };
+
+  SignedDistanceField sdf_union(sdf_a);
+  EXPECT_TRUE(sdf_union.combine(sdf_b, SignedDistanceField::kCsgUnion));
+  check(sdf_union, union_ab, 0.02);
+
+  SignedDistanceField sdf_intersection(sdf_a);
+  EXPECT_TRUE(sdf_intersection.combine(sdf_b, SignedDistanceField::kCsgIntersection));
+  check(sdf_intersection, intersection_ab, 0.02);
+
+  SignedDistanceField sdf_difference(sdf_a);
+  EXPECT_TRUE(sdf_difference.combine(sdf_b, SignedDistanceField::kCsgDifference));
+  check(sdf_difference, difference_ab, 0.02);
+  EXPECT_LT(sdf_difference.fieldValue(vec3i(5, 15, 15)), 0.0);
+
+  // resampling adds the trilinear interpolation error
+  SignedDistanceField sdf_union_resampled(sdf_a);
+  EXPECT_TRUE(sdf_union_resampled.combine(sdf_c, SignedDistanceField::kCsgUnion));
+  check(sdf_union_resampled, union_ab, 0.05);
+
+  // the smooth union is below the union and matches it away from the crease
+  const real_t blend_radius = 0.2;
+  SignedDistanceField sdf_blend(sdf_a);
+  EXPECT_TRUE(sdf_blend.combine(sdf_b, SignedDistanceField::kCsgUnion, blend_radius));
+  const vec3i gridpoints_count = sdf_blend.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        EXPECT_LE(sdf_blend.fieldValue(coords), sdf_union.fieldValue(coords));
+      }
+    }
+  }
+
+  const vec3i far_from_crease = vec3i(3, 13, 13);
+  EXPECT_EQ(sdf_blend.fieldValue(far_from_crease), sdf_union.fieldValue(far_from_crease));
+
+  // the difference of a field with itself is never inside
+  SignedDistanceField sdf_self(sdf_a);
+  EXPECT_TRUE(sdf_self.combine(sdf_self, SignedDistanceField::kCsgDifference));
+  EXPECT_GE(sdf_self.fieldValue(vec3i(13, 13, 13)), 0.0);
+
+  EXPECT_FALSE(sdf_self.combine(sdf_b, SignedDistanceField::kCsgUnion, -1.0));
+  EXPECT_FALSE(sdf_self.combine(SignedDistanceField(), SignedDistanceField::kCsgUnion));
+}
+
+TEST(SignedDistanceField, CsgOperationsNarrowBand) {
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.3, 0.3, 0.3);
+  const real_t kMaxValue = std::numeric_limits<real_t>::max();
+
+  // the small sphere lies in the off band interior of the big sphere, which is signed when generated
+  TriangleMesh mesh_big;
+  CreateSphere(2.0, 24, 48, mesh_big);
+  TriangleMesh mesh_small;
+  CreateSphere(0.5, 24, 48, mesh_small);
+
+  SignedDistanceField sdf_big;
+  EXPECT_TRUE(sdf_big.generate(mesh_big, expansion, voxel_size));
+  SignedDistanceField sdf_small;
+  EXPECT_TRUE(sdf_small.generate(mesh_small, expansion, voxel_size));
+
+  auto closest_coords = [](const SignedDistanceField& sdf, const vec3& p) {
+    const vec3 local = (p - sdf.bounds().lower()) / sdf.voxelSize();
+    return vec3i(static_cast<int>(std::round(local.x())),
+                 static_cast<int>(std::round(local.y())),
+                 static_cast<int>(std::round(local.z())));
+  };
+
+  const vec3i big_center = closest_coords(sdf_big, vec3(0.0, 0.0, 0.0));
+  const vec3i big_inside = closest_coords(sdf_big, vec3(1.2, 0.0, 0.0));
+  const vec3i small_center = closest_coords(sdf_small, vec3(0.0, 0.0, 0.0));
+  ASSERT_EQ(sdf_big.fieldValue(big_center), -kMaxValue);
+
+  // the small sphere is inside of both
+  SignedDistanceField sdf_intersection(sdf_small);
+  EXPECT_TRUE(sdf_intersection.combine(sdf_big, SignedDistanceField::kCsgIntersection));
+  EXPECT_LT(sdf_intersection.fieldValue(small_center), 0.0);
+
+  SignedDistanceField sdf_union(sdf_small);
+  EXPECT_TRUE(sdf_union.combine(sdf_big, SignedDistanceField::kCsgUnion));
+  EXPECT_LT(sdf_union.fieldValue(small_center), 0.0);
+
+  // the small sphere minus the big one is empty
+  SignedDistanceField sdf_empty(sdf_small);
+  EXPECT_TRUE(sdf_empty.combine(sdf_big, SignedDistanceField::kCsgDifference));
+  EXPECT_GT(sdf_empty.fieldValue(small_center), 0.0);
+
+  // the big sphere minus the small one is a hollow shell
+  SignedDistanceField sdf_shell(sdf_big);
+  EXPECT_TRUE(sdf_shell.combine(sdf_small, SignedDistanceField::kCsgDifference));
+  EXPECT_GT(sdf_shell.fieldValue(big_center), 0.0);
+  EXPECT_LT(sdf_shell.fieldValue(big_inside), 0.0);
+
+  // the off band grid points outside stay outside
+  EXPECT_EQ(sdf_shell.fieldValue(vec3i(0, 0, 0)), kMaxValue);
+}
+
+TEST(SignedDistanceField, Resample) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const vec3 expansion(0.3, 0.3, 0.3);
+
+  SignedDistanceField sdf_fine;
+  EXPECT_TRUE(sdf_fine.generate(tmesh, expansion, 0.05, SignedDistanceField::kSignModeScanlineParity));
+
+  SignedDistanceField sdf_coarse;
+  EXPECT_TRUE(sdf_coarse.generate(tmesh, expansion, 0.1, SignedDistanceField::kSignModeScanlineParity));
+
+  auto sphere = [](const vec3& p) { return p.norm() - 1.0; };
+
+  // compares the grid points whose interpolation cells lie within the exact part of the fine band
+  auto check = [&](const SignedDistanceField& sdf, const std::function<vec3(const vec3&)>& to_source, real_t tolerance) {
+    int count_checked = 0;
+    const vec3i gridpoints_count = sdf.gridPointsCount();
+    for(int z = 0; z < gridpoints_count.z(); z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords(x, y, z);
+          const vec3 p = to_source(sdf.gridPointPosition(coords));
+          if (std::fabs(sphere(p)) > 0.025) {
+            continue;
+          }
+
+          EXPECT_NEAR(sdf.fieldValue(coords), sphere(p), tolerance);
+          count_checked++;
+        }
+      }
+    }
+    EXPECT_GT(count_checked, 0);
+  };
+
+  auto identity = [](const vec3& p) { return p; };
+
+  SignedDistanceField sdf_trilinear;
+  EXPECT_TRUE(sdf_trilinear.resample(sdf_fine, sdf_coarse.bounds(), 0.1));
+  EXPECT_EQ(sdf_trilinear.gridPointsCount(), sdf_coarse.gridPointsCount());
+  check(sdf_trilinear, identity, 0.02);
+
+  SignedDistanceField sdf_tricubic;
+  EXPECT_TRUE(sdf_tricubic.resample(sdf_fine, sdf_coarse.bounds(), 0.1, SignedDistanceField::kInterpolationTricubic));
+  check(sdf_tricubic, identity, 0.02);
+
+  // resampling on the same grid reproduces the grid point values
+  SignedDistanceField sdf_same(sdf_fine);
+  EXPECT_TRUE(sdf_same.resample(sdf_same, sdf_fine.bounds(), sdf_fine.voxelSize(), SignedDistanceField::kInterpolationTricubic));
+  EXPECT_NEAR(sdf_same.fieldValue(vec3i(20, 25, 30)), sdf_fine.fieldValue(vec3i(20, 25, 30)), 1e-9);
+
+  // rotated by 30 degrees about z and shifted along x
+  mat4 transform = mat4::Identity();
+  transform.block<3, 3>(0, 0) = Eigen::AngleAxis<real_t>(M_PI / 6.0, vec3(0.0, 0.0, 1.0)).toRotationMatrix();
+  transform.block<3, 1>(0, 3) = vec3(0.25, 0.0, 0.0);
+  auto to_source = [&](const vec3& p) { return vec3(transform.block<3, 3>(0, 0) * p + vec3(0.25, 0.0, 0.0)); };
+
+  SignedDistanceField sdf_rotated;
+  EXPECT_TRUE(sdf_rotated.resample(sdf_fine, AABB(vec3(-1.6, -1.6, -1.6), vec3(1.6, 1.6, 1.6)), 0.1,
+                                   SignedDistanceField::kInterpolationTrilinear, transform));
+  check(sdf_rotated, to_source, 0.02);
+
+  mat4 scale = mat4::Identity() * 2.0;
+  scale(3, 3) = 1.0;
+  EXPECT_FALSE(sdf_rotated.resample(sdf_fine, sdf_fine.bounds(), 0.1, SignedDistanceField::kInterpolationTrilinear, scale));
+  EXPECT_FALSE(sdf_rotated.resample(sdf_fine, sdf_fine.bounds(), 0.0));
+  EXPECT_FALSE(sdf_rotated.resample(SignedDistanceField(), sdf_fine.bounds(), 0.1));
+}
+
+TEST(SignedDistanceField, ClosestFeatures) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 12, 24, tmesh);
+
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.3, 0.3, 0.3);
+
+  SignedDistanceField sdf;
+  EXPECT_EQ(sdf.closestFeatureStorage(), SignedDistanceField::kClosestFeatureNone);
+  EXPECT_TRUE(sdf.generate(tmesh, expansion, voxel_size));
+  EXPECT_FALSE(sdf.hasClosestFaceIds());
+  EXPECT_EQ(sdf.closestFaceId(vec3i(0, 0, 0)), SignedDistanceField::kInvalidFaceId);
+
+  sdf.setClosestFeatureStorage(SignedDistanceField::kClosestFeatureFaceIdsAndOffsets);
+  EXPECT_TRUE(sdf.generate(tmesh, expansion, voxel_size));
+  EXPECT_TRUE(sdf.hasClosestFaceIds());
+  EXPECT_TRUE(sdf.hasClosestPointOffsets());
+
+  int count_checked = 0;
+  const vec3i gridpoints_count = sdf.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const uint32_t face_id = sdf.closestFaceId(coords);
+        if (face_id == SignedDistanceField::kInvalidFaceId) {
+          continue;
+        }
+
+        // the offset leads to a point on the closest face at the field distance
+        const vec3 p = sdf.gridPointPosition(coords);
+        const vec3 offset = sdf.closestPointOffset(coords);
+        EXPECT_NEAR(offset.norm(), std::fabs(sdf.fieldValue(coords)), 1e-9);
+
+        const auto v = tmesh.halfFaceVertices(HalfFaceIndex::create(face_id));
+        vec3 q;
+        ClosestTriangleFeature feature;
+        EXPECT_NEAR(PointTriangleDistance(p, v[0], v[1], v[2], q, feature), offset.norm(), 1e-9);
+        EXPECT_NEAR((p + offset - q).norm(), 0.0, 1e-9);
+        count_checked++;
+      }
+    }
+  }
+  EXPECT_GT(count_checked, 0);
+
+  std::filesystem::path vti_path = std::filesystem::temp_directory_path() / "sphere_closest.vti";
+  EXPECT_TRUE(sdf.saveAsVTI(vti_path.string()));
+
+  std::ifstream vti_file(vti_path);
+  const std::string vti_content((std::istreambuf_iterator<char>(vti_file)), std::istreambuf_iterator<char>());
+  EXPECT_NE(vti_content.find("Name=\"ClosestFaceId\""), std::string::npos);
+  EXPECT_NE(vti_content.find("Name=\"ClosestPointOffset\""), std::string::npos);
+
+  // the field values are still loaded from the first array
+  SignedDistanceField sdf_loaded;
+  EXPECT_TRUE(sdf_loaded.loadAsVTI(vti_path.string()));
+  EXPECT_FALSE(sdf_loaded.hasClosestFaceIds());
+  EXPECT_NEAR(sdf_loaded.fieldValue(vec3i(3, 4, 5)), sdf.fieldValue(vec3i(3, 4, 5)), 1e-5);
+
+  // copies keep the closest features, other operations drop them
+  SignedDistanceField sdf_copy(sdf);
+  EXPECT_TRUE(sdf_copy.hasClosestPointOffsets());
+  EXPECT_TRUE(sdf_copy.combine(sdf, SignedDistanceField::kCsgUnion));
+  EXPECT_FALSE(sdf_copy.hasClosestFaceIds());
+}
+
+TEST(SignedDistanceField, GenerateFromTetMesh) {
+  TetMesh tet_mesh;
+  EXPECT_TRUE(createVoxelGrid(tet_mesh, 4, 4, 4, 1.0));
+
+  const real_t voxel_size = 0.1;
+  const vec3 expansion(0.3, 0.3, 0.3);
+
+  // the reference goes through the extracted boundary triangle mesh
+  TriangleMesh boundary_mesh;
+  EXPECT_TRUE(tet_mesh.extractBoundaryTriangleMesh(boundary_mesh));
+  boundary_mesh.computeHalfEdgePseudoNormals();
+  boundary_mesh.computeVertexPseudoNormals();
+
+  const std::vector<SignedDistanceField::SignMode> sign_modes = {
+    SignedDistanceField::kSignModePseudoNormals,
+    SignedDistanceField::kSignModeWindingNumber,
+    SignedDistanceField::kSignModeScanlineParity
+  };
+
+  for(const auto sign_mode : sign_modes) {
+    SignedDistanceField sdf_reference;
+    EXPECT_TRUE(sdf_reference.generate(boundary_mesh, expansion, voxel_size, sign_mode));
+
+    SignedDistanceField sdf;
+    sdf.setClosestFeatureStorage(SignedDistanceField::kClosestFeatureFaceIds);
+    EXPECT_TRUE(sdf.generate(tet_mesh, expansion, voxel_size, sign_mode));
+
+    EXPECT_EQ(sdf.gridPointsCount(), sdf_reference.gridPointsCount());
+    EXPECT_TRUE(sdf.bounds().lower().isApprox(sdf_reference.bounds().lower()));
+
+    const vec3i gridpoints_count = sdf.gridPointsCount();
+    for(int z = 0; z < gridpoints_count.z(); z++) {
+      for(int y = 0; y < gridpoints_count.y(); y++) {
+        for(int x = 0; x < gridpoints_count.x(); x++) {
+          const vec3i coords(x, y, z);
+          EXPECT_NEAR(sdf.fieldValue(coords), sdf_reference.fieldValue(coords), 1e-9);
+
+          // the closest faces are the boundary half-faces of the tetrahedral mesh
+          const uint32_t face_id = sdf.closestFaceId(coords);
+          if (face_id != SignedDistanceField::kInvalidFaceId) {
+            EXPECT_EQ(tet_mesh.countIncidentCellsPerHalfFace(HalfFaceIndex::create(face_id)), 0);
+          }
+        }
+      }
+    }
+  }
+
+  SignedDistanceField sdf;
+  EXPECT_FALSE(sdf.generate(tet_mesh, expansion, -voxel_size, SignedDistanceField::kSignModePseudoNormals));
+}
+
+TEST(SignedDistanceField, PointCloud) {
+  // oriented samples of the unit sphere on a fibonacci lattice
+  const int count_points = 20000;
+  const real_t golden_angle = M_PI * (3.0 - std::sqrt(5.0));
+  std::vector<vec3> positions;
+  std::vector<vec3> normals;
+  for(int i = 0; i < count_points; i++) {
+    const real_t z = 1.0 - 2.0 * (static_cast<real_t>(i) + 0.5) / static_cast<real_t>(count_points);
+    const real_t r = std::sqrt(1.0 - z * z);
+    const real_t phi = golden_angle * static_cast<real_t>(i);
+    positions.push_back(vec3(r * std::cos(phi), r * std::sin(phi), z));
+    normals.push_back(positions.back());
+  }
+
+  // xyz, ascii ply and binary little endian ply round trips
+  const std::filesystem::path xyz_path = std::filesystem::temp_directory_path() / "sphere_points.xyz";
+  const std::filesystem::path ascii_ply_path = std::filesystem::temp_directory_path() / "sphere_points_ascii.ply";
+  const std::filesystem::path binary_ply_path = std::filesystem::temp_directory_path() / "sphere_points_binary.ply";
+  {
+    std::ofstream xyz(xyz_path);
+    xyz << "# x y z nx ny nz" << std::endl;
+    std::ofstream ascii_ply(ascii_ply_path);
+    ascii_ply << "ply\nformat ascii 1.0\nelement vertex " << count_points << "\n"
+              << "property double x\nproperty double y\nproperty double z\n"
+              << "property double nx\nproperty double ny\nproperty double nz\nend_header\n";
+    std::ofstream binary_ply(binary_ply_path, std::ios::binary);
+    binary_ply << "ply\nformat binary_little_endian 1.0\nelement vertex " << count_points << "\n"
+               << "property float x\nproperty float y\nproperty float z\nproperty uchar red\n"
+               << "property float nx\nproperty float ny\nproperty float nz\nend_header\n";
+
+    for(int i = 0; i < count_points; i++) {
+      const vec3& p = positions[i];
+      const vec3& n = normals[i];
+      xyz << fmt::format("{} {} {}, {} {} {}\n", p.x(), p.y(), p.z(), n.x(), n.y(), n.z());
+      ascii_ply << fmt::format("{} {} {} {} {} {}\n", p.x(), p.y(), p.z(), n.x(), n.y(), n.z());
+
+      const float values[7] = { static_cast<float>(p.x()), static_cast<float>(p.y()), static_cast<float>(p.z()), 0.0f,
+                                static_cast<float>(n.x()), static_cast<float>(n.y()), static_cast<float>(n.z()) };
+      binary_ply.write(reinterpret_cast<const char*>(values), 3 * sizeof(float));
+      const uint8_t red = 255;
+      binary_ply.write(reinterpret_cast<const char*>(&red), sizeof(red));
+      binary_ply.write(reinterpret_cast<const char*>(values + 4), 3 * sizeof(float));
+    }
+  }
+
+  for(const std::filesystem::path& path : { xyz_path, ascii_ply_path, binary_ply_path }) {
+    std::vector<vec3> read_positions;
+    std::vector<vec3> read_normals;
+    EXPECT_TRUE(ReadPointCloud(path.string(), read_positions, read_normals));
+    EXPECT_EQ(read_positions.size(), positions.size());
+    EXPECT_EQ(read_normals.size(), normals.size());
+    for(size_t i = 0; i < std::min(read_positions.size(), positions.size()); i += 997) {
+      EXPECT_NEAR((read_positions[i] - positions[i]).norm(), 0.0, 1e-6);
+      EXPECT_NEAR((read_normals[i] - normals[i]).norm(), 0.0, 1e-6);
+    }
+  }
+
+  const real_t voxel_size = 0.05;
+  SignedDistanceField sdf;
+  EXPECT_FALSE(sdf.generateFromPointCloud(positions, std::vector<vec3>(), vec3(0.2, 0.2, 0.2), voxel_size));
+  EXPECT_TRUE(sdf.generateFromPointCloud(positions, normals, vec3(0.2, 0.2, 0.2), voxel_size, 0.15));
+
+  int count_checked = 0;
+  const vec3i gridpoints_count = sdf.gridPointsCount();
+  for(int z = 0; z < gridpoints_count.z(); z++) {
+    for(int y = 0; y < gridpoints_count.y(); y++) {
+      for(int x = 0; x < gridpoints_count.x(); x++) {
+        const vec3i coords(x, y, z);
+        const real_t expected = sdf.gridPointPosition(coords).norm() - 1.0;
+        if (std::fabs(expected) <= voxel_size) {
+          EXPECT_NEAR(sdf.fieldValue(coords), expected, 0.01);
+          count_checked++;
+        } else if (std::fabs(expected) > 0.3) {
+          EXPECT_EQ(sdf.fieldValue(coords), std::numeric_limits<real_t>::max());
+        }
+      }
+    }
+  }
+
+  EXPECT_GT(count_checked, 0);
+
+  // a radius too small for the extent of the cloud leaves the field as it was
+  EXPECT_FALSE(sdf.generateFromPointCloud(positions, normals, vec3(0.2, 0.2, 0.2), voxel_size * 2.0, 1e-8));
+  EXPECT_EQ(sdf.voxelSize(), voxel_size);
+  EXPECT_EQ(sdf.gridPointsCount(), gridpoints_count);
+}
+
+TEST(SignedDistanceField, SlicesAndNpy) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 12, 24, tmesh);
+
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.3, 0.4), 0.1));
+  const vec3i gridpoints_count = sdf.gridPointsCount();
+
+  // the views read the field in place
+  const SignedDistanceField::SliceAxis axes[3] = {
+    SignedDistanceField::kSliceAxisX, SignedDistanceField::kSliceAxisY, SignedDistanceField::kSliceAxisZ
+  };
+  for(SignedDistanceField::SliceAxis axis : axes) {
+    const int index = gridpoints_count[axis] / 2;
+    const SignedDistanceField::SliceView view = sdf.slice(axis, index);
+    const int axis_u = (axis == SignedDistanceField::kSliceAxisX) ? 1 : 0;
+    const int axis_v = (axis == SignedDistanceField::kSliceAxisZ) ? 1 : 2;
+    EXPECT_EQ(view.size, vec2i(gridpoints_count[axis_u], gridpoints_count[axis_v]));
+
+    for(int v = 0; v < view.size.y(); v++) {
+      for(int u = 0; u < view.size.x(); u++) {
+        vec3i coords;
+        coords[axis] = index;
+        coords[axis_u] = u;
+        coords[axis_v] = v;
+        EXPECT_EQ(view.at(u, v), sdf.fieldValue(coords));
+      }
+    }
+  }
+
+  EXPECT_EQ(sdf.slice(SignedDistanceField::kSliceAxisZ, 1).data - sdf.slice(SignedDistanceField::kSliceAxisZ, 0).data,
+            gridpoints_count.x() * gridpoints_count.y());
+  EXPECT_THROW(sdf.slice(SignedDistanceField::kSliceAxisY, gridpoints_count.y()), std::out_of_range);
+  EXPECT_THROW(sdf.slice(SignedDistanceField::kSliceAxisX, -1), std::out_of_range);
+
+  // the npy header is 64 byte aligned and followed by the raw values
+  std::filesystem::path npy_path = std::filesystem::temp_directory_path() / "sphere.npy";
+  EXPECT_TRUE(sdf.saveAsNpy(npy_path.string()));
+  {
+    std::ifstream file(npy_path, std::ios::binary);
+    char preamble[10];
+    file.read(preamble, sizeof(preamble));
+    EXPECT_EQ(std::string(preamble, 6), std::string("\x93NUMPY"));
+    EXPECT_EQ(preamble[6], 1);
+    const uint16_t header_size = static_cast<uint8_t>(preamble[8]) | (static_cast<uint8_t>(preamble[9]) << 8);
+    EXPECT_EQ((sizeof(preamble) + header_size) % 64, 0);
+
+    std::string header(header_size, ' ');
+    file.read(&header[0], header_size);
+    EXPECT_EQ(header.back(), '\n');
+    EXPECT_NE(header.find("'fortran_order': False"), std::string::npos);
+    EXPECT_NE(header.find(fmt::format("'shape': ({}, {}, {})", gridpoints_count.z(), gridpoints_count.y(), gridpoints_count.x())),
+              std::string::npos);
+    EXPECT_NE(header.find(fmt::format("f{}'", sizeof(real_t))), std::string::npos);
+
+    std::vector<real_t> values(sdf.totalGridPointsCount());
+    file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(real_t));
+    EXPECT_TRUE(file.good());
+    EXPECT_EQ(file.peek(), std::char_traits<char>::eof());
+    EXPECT_EQ(values[0], sdf.fieldValue(vec3i(0, 0, 0)));
+    const vec3i center = gridpoints_count / 2;
+    EXPECT_EQ(values[(center.z() * gridpoints_count.y() + center.y()) * gridpoints_count.x() + center.x()], sdf.fieldValue(center));
+  }
+
+  // the pgm slice has one byte per grid point, darker inside than outside, with v = 0 in the last row
+  std::filesystem::path pgm_path = std::filesystem::temp_directory_path() / "sphere_slice.pgm";
+  EXPECT_FALSE(sdf.saveSliceAsPGM(pgm_path.string(), SignedDistanceField::kSliceAxisZ, gridpoints_count.z()));
+  EXPECT_TRUE(sdf.saveSliceAsPGM(pgm_path.string(), SignedDistanceField::kSliceAxisZ, gridpoints_count.z() / 2));
+  {
+    std::ifstream file(pgm_path, std::ios::binary);
+    std::string magic;
+    int width = 0, height = 0, max_value = 0;
+    file >> magic >> width >> height >> max_value;
+    file.get();
+    EXPECT_EQ(magic, "P5");
+    EXPECT_EQ(width, gridpoints_count.x());
+    EXPECT_EQ(height, gridpoints_count.y());
+    EXPECT_EQ(max_value, 255);
+
+    std::vector<uint8_t> pixels(width * height);
+    file.read(reinterpret_cast<char*>(pixels.data()), pixels.size());
+    EXPECT_TRUE(file.good());
+
+    const int z = gridpoints_count.z() / 2;
+    for(int y = 0; y < height; y++) {
+      for(int x = 0; x < width; x++) {
+        const uint8_t pixel = pixels[(height - 1 - y) * width + x];
+        if (sdf.fieldValue(vec3i(x, y, z)) < 0.0) {
+          EXPECT_LT(pixel, 128);
+        } else {
+          EXPECT_GE(pixel, 128);
+        }
+      }
+    }
+  }
+}
+
+TEST(SignedDistanceField, SurfaceNets) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const real_t voxel_size = 0.05;
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), voxel_size));
+
+  // fraction of the triangles with an angle below 10 degrees
+  auto sliver_ratio = [](const std::vector<vec3>& vertices, const std::vector<vec3i>& faces) {
+    int count_slivers = 0;
+    for(const vec3i& face : faces) {
+      real_t min_angle = M_PI;
+      for(int i = 0; i < 3; i++) {
+        const vec3 a = vertices[face[(i + 1) % 3]] - vertices[face[i]];
+        const vec3 b = vertices[face[(i + 2) % 3]] - vertices[face[i]];
+        min_angle = std::min(min_angle, std::atan2(a.cross(b).norm(), a.dot(b)));
+      }
+      count_slivers += (min_angle < M_PI / 18.0) ? 1 : 0;
+    }
+    return static_cast<real_t>(count_slivers) / static_cast<real_t>(faces.size());
+  };
+
+  std::vector<vec3> mc_vertices;
+  std::vector<vec3i> mc_faces;
+  EXPECT_TRUE(sdf.extractIsoSurface(mc_vertices, mc_faces));
+  const real_t mc_sliver_ratio = sliver_ratio(mc_vertices, mc_faces);
+
+  SignedDistanceField sdf_offsets;
+  sdf_offsets.setClosestFeatureStorage(SignedDistanceField::kClosestFeatureFaceIdsAndOffsets);
+  EXPECT_TRUE(sdf_offsets.generate(tmesh, vec3(0.2, 0.2, 0.2), voxel_size));
+
+  for(const SignedDistanceField* field : { &sdf, &sdf_offsets }) {
+    std::vector<vec3> vertices;
+    std::vector<vec3i> faces;
+    EXPECT_TRUE(field->extractSurfaceNets(vertices, faces));
+
+    // as many triangles as marching cubes, with far fewer slivers
+    EXPECT_GT(faces.size(), 0);
+    EXPECT_LT(faces.size(), mc_faces.size() * 11 / 10);
+    EXPECT_LT(sliver_ratio(vertices, faces), 0.25 * mc_sliver_ratio);
+
+    for(const vec3& v : vertices) {
+      EXPECT_NEAR(v.norm(), 1.0, 0.01);
+    }
+
+    // closed and consistently oriented with the normals facing out
+    std::map<std::pair<int, int>, int> directed_edges;
+    real_t volume = 0.0;
+    for(const vec3i& face : faces) {
+      for(int i = 0; i < 3; i++) {
+        directed_edges[std::make_pair(face[i], face[(i + 1) % 3])]++;
+      }
+      volume += vertices[face[0]].dot(vertices[face[1]].cross(vertices[face[2]])) / 6.0;
+    }
+
+    for(const auto& [edge, count] : directed_edges) {
+      EXPECT_EQ(count, 1);
+      EXPECT_EQ(directed_edges.count(std::make_pair(edge.second, edge.first)), 1);
+    }
+
+    EXPECT_NEAR(volume, 4.0 * M_PI / 3.0, 0.05);
+
+    TriangleMesh extracted;
+    EXPECT_TRUE(field->extractSurfaceNets(extracted));
+    EXPECT_EQ(extracted.countVertices(), vertices.size());
+    EXPECT_EQ(extracted.countFaces(), faces.size());
+  }
+}
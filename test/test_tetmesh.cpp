@@ -7,13 +7,69 @@
 //-----------------------------------------------------------------------------
 
 #include "volmesh/tetmesh.h"
+#include "volmesh/parallel.h"
 #include "volmesh/sampletetmeshes.h"
 #include "volmesh/tetrahedra.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
 
 using namespace volmesh;
 
+/**
+ * @brief Inserts the tetrahedra one by one, the reference for the ids of the bulk builders.
+ */
+static bool InsertOneByOne(const std::vector<vec3>& vertices, const std::vector<vec4i>& tet_cells, TetMesh& out_mesh) {
+  bool result = out_mesh.insertAllVertices(vertices);
+  for(const vec4i& tet_cell : tet_cells) {
+    out_mesh.insertTetrahedra(tet_cell);
+  }
+  return result && (out_mesh.countCells() == tet_cells.size());
+}
+
+/**
+ * @brief Checks that two meshes have the same elements with the same ids, found through their incident lists.
+ */
+static void ExpectSameTopology(const TetMesh& lhs, const TetMesh& rhs) {
+  ASSERT_EQ(lhs.countVertices(), rhs.countVertices());
+  ASSERT_EQ(lhs.countHalfEdges(), rhs.countHalfEdges());
+  ASSERT_EQ(lhs.countHalfFaces(), rhs.countHalfFaces());
+  ASSERT_EQ(lhs.countCells(), rhs.countCells());
+
+  for(uint32_t i=0; i < lhs.countHalfEdges(); i++) {
+    const HalfEdge& hedge = lhs.halfEdge(HalfEdgeIndex::create(i));
+    EXPECT_TRUE(hedge.equals(rhs.halfEdge(HalfEdgeIndex::create(i))));
+
+    HalfEdgeIndex found_id(kSentinelIndex);
+    EXPECT_TRUE(rhs.findHalfEdge(hedge, found_id));
+    EXPECT_EQ(found_id.get(), i);
+  }
+
+  for(uint32_t i=0; i < lhs.countHalfFaces(); i++) {
+    const HalfFaceIndex hface_id = HalfFaceIndex::create(i);
+    const TetMesh::HalfFaceType& hface = lhs.halfFace(hface_id);
+    EXPECT_TRUE(hface.equals(rhs.halfFace(hface_id)));
+
+    HalfFaceIndex found_id(kSentinelIndex);
+    EXPECT_TRUE(rhs.findHalfFace(hface, found_id));
+    EXPECT_EQ(found_id.get(), i);
+
+    EXPECT_EQ(lhs.countIncidentCellsPerHalfFace(hface_id), rhs.countIncidentCellsPerHalfFace(hface_id));
+  }
+
+  for(uint32_t i=0; i < lhs.countCells(); i++) {
+    const TetMesh::CellType& cell = lhs.cell(CellIndex::create(i));
+    EXPECT_TRUE(cell.equals(rhs.cell(CellIndex::create(i))));
+
+    CellIndex found_id(kSentinelIndex);
+    EXPECT_TRUE(rhs.findCell(cell, found_id));
+    EXPECT_EQ(found_id.get(), i);
+  }
+}
+
 TEST(TetMesh, OneTetrahedra) {
   TetMesh mesh;
   createOneTetrahedra(mesh);
@@ -51,4 +107,281 @@ TEST(TetMesh, ExtractTriangleMesh) {
   TriangleMesh tri_mesh;
   EXPECT_TRUE(tet_mesh.extractBoundaryTriangleMesh(tri_mesh));
   EXPECT_EQ(tri_mesh.countHalfFaces(), 4);
-}
\ No newline at end of file
+}
+
+TEST(TetMesh, BoundaryHalfFaces) {
+  TetMesh tet_mesh;
+  EXPECT_TRUE(createVoxelGrid(tet_mesh, 3, 3, 3, 1.0));
+
+  // 2 x 2 x 2 voxels, every side of the block has 4 squares of 2 triangles each
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), 6 * 4 * 2);
+
+  // the block is convex, so all boundary faces face away from its center
+  const vec3 center(-0.5, 1.0, -0.5);
+  for(const auto& hface_id : boundary_hfaces) {
+    EXPECT_EQ(tet_mesh.countIncidentCellsPerHalfFace(hface_id), 0);
+
+    const TetMesh::HalfFaceType hface = tet_mesh.halfFace(hface_id);
+    const vec3 a = tet_mesh.vertex(VertexIndex::create(tet_mesh.halfEdge(hface.halfEdgeIndex(0)).start()));
+    const vec3 b = tet_mesh.vertex(VertexIndex::create(tet_mesh.halfEdge(hface.halfEdgeIndex(1)).start()));
+    const vec3 c = tet_mesh.vertex(VertexIndex::create(tet_mesh.halfEdge(hface.halfEdgeIndex(2)).start()));
+    EXPECT_GT((b - a).cross(c - a).dot((a + b + c) / 3.0 - center), 0.0);
+  }
+
+  TriangleMesh tri_mesh;
+  EXPECT_TRUE(tet_mesh.extractBoundaryTriangleMesh(tri_mesh));
+  EXPECT_EQ(tri_mesh.countFaces(), boundary_hfaces.size());
+}
+
+TEST(TetMesh, CreateVoxelGrid) {
+  const int nx = 4;
+  const int ny = 3;
+  const int nz = 5;
+  const real_t cellsize = 0.25;
+  TetMesh bulk_mesh;
+  EXPECT_TRUE(createVoxelGrid(bulk_mesh, nx, ny, nz, cellsize));
+
+  // the vertex and cell lists of the grid inserted one by one
+  const vec3 start = vec3(- static_cast<real_t>(nx)/2.0f, 0.0f, - static_cast<real_t>(nz)/2.0f) * cellsize;
+  std::vector<vec3> vertices;
+  for(int i=0; i < nx; i++) {
+    for(int j=0; j < ny; j++) {
+      for(int k=0; k < nz; k++) {
+        vertices.push_back(start + vec3(i, j, k) * cellsize);
+      }
+    }
+  }
+
+  std::vector<vec4i> tet_cells;
+  for(int i=0; i < nx-1; i++) {
+    for(int j=0; j < ny-1; j++) {
+      for(int k=0; k < nz-1; k++) {
+        std::array<int, Voxel::kNumVerticesPerCell> voxel_vertex_ids;
+        for(int c=0; c < Voxel::kNumVerticesPerCell; c++) {
+          const vec3i p = vec3i(i, j, k) + Voxel::vertexOffsetLut(c);
+          voxel_vertex_ids[c] = (p.x() * ny + p.y()) * nz + p.z();
+        }
+
+        for(int t=0; t < Voxel::kNumFittingTetrahedra; t++) {
+          const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+          tet_cells.push_back(vec4i(voxel_vertex_ids[tet_lut[0]], voxel_vertex_ids[tet_lut[1]],
+                                    voxel_vertex_ids[tet_lut[2]], voxel_vertex_ids[tet_lut[3]]));
+        }
+      }
+    }
+  }
+
+  TetMesh incremental_mesh;
+  EXPECT_TRUE(InsertOneByOne(vertices, tet_cells, incremental_mesh));
+
+  // the vertex and cell ids are the same
+  std::vector<vec3> bulk_vertices;
+  std::vector<vec4i> bulk_cells;
+  EXPECT_TRUE(bulk_mesh.writeToList(bulk_vertices, bulk_cells));
+  std::vector<vec3> incremental_vertices;
+  std::vector<vec4i> incremental_cells;
+  EXPECT_TRUE(incremental_mesh.writeToList(incremental_vertices, incremental_cells));
+  EXPECT_EQ(bulk_vertices, vertices);
+  EXPECT_EQ(incremental_vertices, vertices);
+  EXPECT_EQ(bulk_cells, incremental_cells);
+
+  // and so are the half-edge, half-face and cell ids of the generic path
+  TetMesh list_mesh;
+  EXPECT_TRUE(list_mesh.readFromList(vertices, tet_cells));
+  ExpectSameTopology(bulk_mesh, list_mesh);
+  ExpectSameTopology(bulk_mesh, incremental_mesh);
+
+  EXPECT_THROW(createVoxelGrid(bulk_mesh, nx, ny, nz, -cellsize), std::invalid_argument);
+  EXPECT_FALSE(bulk_mesh.readFromVoxelGrid(start, cellsize, vec3i(1, 1, 1), {1}, vec3i(0, 1, 1)));
+}
+
+TEST(TetMesh, ReadFromVoxelGrid) {
+  // an irregular selection of voxels with holes, touching corners and edges
+  const vec3i voxels_count(4, 3, 3);
+  std::vector<uint8_t> voxel_mask(voxels_count.prod());
+  for(size_t i=0; i < voxel_mask.size(); i++) {
+    voxel_mask[i] = ((i * 7) % 5 < 3) ? 1 : 0;
+  }
+
+  const vec3 origin(-1.0, 0.5, 2.0);
+  const real_t voxel_size = 0.5;
+  TetMesh bulk_mesh;
+  EXPECT_TRUE(bulk_mesh.readFromVoxelGrid(origin, voxel_size, voxels_count, voxel_mask));
+
+  // the same tetrahedra inserted one by one
+  std::vector<vec3> vertices;
+  for(int z=0; z <= voxels_count.z(); z++) {
+    for(int y=0; y <= voxels_count.y(); y++) {
+      for(int x=0; x <= voxels_count.x(); x++) {
+        vertices.push_back(origin + vec3(x, y, z) * voxel_size);
+      }
+    }
+  }
+
+  uint32_t count_selected = 0;
+  std::vector<vec4i> tet_cells;
+  for(int z=0; z < voxels_count.z(); z++) {
+    for(int y=0; y < voxels_count.y(); y++) {
+      for(int x=0; x < voxels_count.x(); x++) {
+        if(voxel_mask[(z * voxels_count.y() + y) * voxels_count.x() + x] == 0) {
+          continue;
+        }
+
+        std::array<int, Voxel::kNumVerticesPerCell> voxel_vertex_ids;
+        for(int c=0; c < Voxel::kNumVerticesPerCell; c++) {
+          const vec3i p = vec3i(x, y, z) + Voxel::vertexOffsetLut(c);
+          voxel_vertex_ids[c] = (p.z() * (voxels_count.y() + 1) + p.y()) * (voxels_count.x() + 1) + p.x();
+        }
+
+        for(int t=0; t < Voxel::kNumFittingTetrahedra; t++) {
+          const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(t);
+          tet_cells.push_back(vec4i(voxel_vertex_ids[tet_lut[0]], voxel_vertex_ids[tet_lut[1]],
+                                    voxel_vertex_ids[tet_lut[2]], voxel_vertex_ids[tet_lut[3]]));
+        }
+        count_selected++;
+      }
+    }
+  }
+
+  TetMesh incremental_mesh;
+  EXPECT_TRUE(InsertOneByOne(vertices, tet_cells, incremental_mesh));
+
+  EXPECT_LT(bulk_mesh.countVertices(), incremental_mesh.countVertices());
+  EXPECT_EQ(bulk_mesh.countCells(), count_selected * Voxel::kNumFittingTetrahedra);
+  EXPECT_EQ(bulk_mesh.countCells(), incremental_mesh.countCells());
+  EXPECT_EQ(bulk_mesh.countHalfFaces(), incremental_mesh.countHalfFaces());
+  EXPECT_EQ(bulk_mesh.countHalfEdges(), incremental_mesh.countHalfEdges());
+
+  // only the used grid points are vertices, otherwise the ids are those of inserting the cells one by one
+  std::vector<vec3> bulk_vertices;
+  std::vector<vec4i> bulk_cells;
+  EXPECT_TRUE(bulk_mesh.writeToList(bulk_vertices, bulk_cells));
+  TetMesh bulk_incremental_mesh;
+  EXPECT_TRUE(InsertOneByOne(bulk_vertices, bulk_cells, bulk_incremental_mesh));
+  ExpectSameTopology(bulk_mesh, bulk_incremental_mesh);
+
+  // the structured numbering matches the generic path for every order of the id axes and any number of threads
+  const std::array<vec3i, 3> id_axes = {vec3i(2, 1, 0), vec3i(0, 1, 2), vec3i(1, 2, 0)};
+  for(const vec3i& axes : id_axes) {
+    TetMesh axes_mesh;
+    EXPECT_TRUE(axes_mesh.readFromVoxelGrid(origin, voxel_size, voxels_count, voxel_mask, axes));
+    std::vector<vec3> axes_vertices;
+    std::vector<vec4i> axes_cells;
+    EXPECT_TRUE(axes_mesh.writeToList(axes_vertices, axes_cells));
+
+    TetMesh list_mesh;
+    EXPECT_TRUE(list_mesh.readFromList(axes_vertices, axes_cells));
+    ExpectSameTopology(axes_mesh, list_mesh);
+
+    SetMaxThreadsCount(1);
+    TetMesh serial_mesh;
+    EXPECT_TRUE(serial_mesh.readFromVoxelGrid(origin, voxel_size, voxels_count, voxel_mask, axes));
+    SetMaxThreadsCount(0);
+    ExpectSameTopology(axes_mesh, serial_mesh);
+  }
+
+  std::vector<HalfFaceIndex> bulk_boundary_hfaces;
+  std::vector<HalfFaceIndex> incremental_boundary_hfaces;
+  EXPECT_EQ(bulk_mesh.getBoundaryHalfFaces(bulk_boundary_hfaces),
+            incremental_mesh.getBoundaryHalfFaces(incremental_boundary_hfaces));
+
+  // both meshes have the same cells by vertex positions
+  auto cells_by_positions = [](const TetMesh& mesh) {
+    std::vector<vec3> mesh_vertices;
+    std::vector<vec4i> mesh_cells;
+    EXPECT_TRUE(mesh.writeToList(mesh_vertices, mesh_cells));
+
+    std::vector<std::array<real_t, 12>> cells;
+    for(const vec4i& cell : mesh_cells) {
+      std::array<real_t, 12> positions;
+      for(int i=0; i < 4; i++) {
+        for(int j=0; j < 3; j++) {
+          positions[i * 3 + j] = mesh_vertices[cell[i]][j];
+        }
+      }
+      cells.push_back(positions);
+    }
+
+    std::sort(cells.begin(), cells.end());
+    return cells;
+  };
+  EXPECT_EQ(cells_by_positions(bulk_mesh), cells_by_positions(incremental_mesh));
+
+  // invalid grids
+  EXPECT_FALSE(bulk_mesh.readFromVoxelGrid(origin, voxel_size, vec3i(4, 3, 2), voxel_mask));
+  EXPECT_FALSE(bulk_mesh.readFromVoxelGrid(origin, voxel_size, voxels_count, std::vector<uint8_t>(voxel_mask.size(), 0)));
+}
+
+TEST(TetMesh, ReadFromList) {
+  TetMesh grid_mesh;
+  EXPECT_TRUE(createVoxelGrid(grid_mesh, 5, 4, 6, 0.5));
+  std::vector<vec3> vertices;
+  std::vector<vec4i> tet_cells;
+  EXPECT_TRUE(grid_mesh.writeToList(vertices, tet_cells));
+
+  // shuffle the cells and start some of them at another vertex with the same orientation
+  std::mt19937 generator(3);
+  std::shuffle(tet_cells.begin(), tet_cells.end(), generator);
+  for(size_t i=0; i < tet_cells.size(); i += 3) {
+    tet_cells[i] = vec4i(tet_cells[i][1], tet_cells[i][0], tet_cells[i][3], tet_cells[i][2]);
+  }
+
+  TetMesh bulk_mesh;
+  EXPECT_TRUE(bulk_mesh.readFromList(vertices, tet_cells));
+  TetMesh incremental_mesh;
+  EXPECT_TRUE(InsertOneByOne(vertices, tet_cells, incremental_mesh));
+  ExpectSameTopology(bulk_mesh, incremental_mesh);
+
+  std::vector<vec3> bulk_vertices;
+  std::vector<vec4i> bulk_cells;
+  EXPECT_TRUE(bulk_mesh.writeToList(bulk_vertices, bulk_cells));
+  EXPECT_EQ(bulk_cells, tet_cells);
+
+  // a repeated cell is kept once
+  std::vector<vec4i> repeated_cells = tet_cells;
+  repeated_cells.push_back(tet_cells[7]);
+  repeated_cells.push_back(vec4i(tet_cells[7][1], tet_cells[7][0], tet_cells[7][3], tet_cells[7][2]));
+  EXPECT_FALSE(bulk_mesh.readFromList(vertices, repeated_cells));
+  TetMesh repeated_mesh;
+  EXPECT_FALSE(InsertOneByOne(vertices, repeated_cells, repeated_mesh));
+  EXPECT_EQ(bulk_mesh.countCells(), tet_cells.size() + 1);
+  ExpectSameTopology(bulk_mesh, repeated_mesh);
+
+  // cells with a repeated vertex are inserted one by one
+  std::vector<vec4i> degenerate_cells = tet_cells;
+  degenerate_cells.insert(degenerate_cells.begin() + 5, vec4i(0, 1, 1, 2));
+  EXPECT_TRUE(bulk_mesh.readFromList(vertices, degenerate_cells));
+  TetMesh degenerate_mesh;
+  EXPECT_TRUE(InsertOneByOne(vertices, degenerate_cells, degenerate_mesh));
+  ExpectSameTopology(bulk_mesh, degenerate_mesh);
+
+  EXPECT_THROW(bulk_mesh.readFromList(vertices, {vec4i(0, 1, 2, static_cast<int>(vertices.size()))}), std::out_of_range);
+  EXPECT_THROW(bulk_mesh.readFromList(vertices, {}), std::invalid_argument);
+}
+
+TEST(TetMesh, ReadFromListThreads) {
+  // enough cells for several blocks of occurrences
+  TetMesh grid_mesh;
+  EXPECT_TRUE(createVoxelGrid(grid_mesh, 17, 16, 16, 0.5));
+  std::vector<vec3> vertices;
+  std::vector<vec4i> tet_cells;
+  EXPECT_TRUE(grid_mesh.writeToList(vertices, tet_cells));
+
+  std::mt19937 generator(5);
+  std::shuffle(tet_cells.begin(), tet_cells.end(), generator);
+
+  // the ids do not depend on the number of threads
+  SetMaxThreadsCount(4);
+  TetMesh parallel_mesh;
+  EXPECT_TRUE(parallel_mesh.readFromList(vertices, tet_cells));
+  SetMaxThreadsCount(1);
+  TetMesh serial_mesh;
+  EXPECT_TRUE(serial_mesh.readFromList(vertices, tet_cells));
+  SetMaxThreadsCount(0);
+  ExpectSameTopology(parallel_mesh, serial_mesh);
+
+  TetMesh incremental_mesh;
+  EXPECT_TRUE(InsertOneByOne(vertices, tet_cells, incremental_mesh));
+  ExpectSameTopology(parallel_mesh, incremental_mesh);
+}
@@ -0,0 +1,172 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/isosurfacestuffing.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetmeshstreamwriter.h"
+#include "volmesh/tetrahedra.h"
+#include "volmesh/trianglemesh.h"
+#include "volmesh/voxeltetmesher.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace volmesh;
+
+static std::string ReadFileBytes(const std::filesystem::path& filepath) {
+  std::ifstream file(filepath, std::ios::in | std::ios::binary);
+  return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+/**
+ * @brief The volume enclosed by triangles that are counter clockwise when seen from outside.
+ */
+static real_t EnclosedVolume(const std::vector<vec3>& vertices, const std::vector<vec3i>& faces) {
+  real_t volume = 0.0;
+  for(const vec3i& face : faces) {
+    volume += vertices[face[0]].dot(vertices[face[1]].cross(vertices[face[2]])) / 6.0;
+  }
+  return volume;
+}
+
+static real_t CellsVolume(const std::vector<vec3>& vertices, const std::vector<vec4i>& cells) {
+  real_t volume = 0.0;
+  for(const vec4i& cell : cells) {
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int i = 0; i < 4; i++) {
+      tet_vertices.col(i) = vertices[cell[i]];
+    }
+    volume += Tetrahedra(tet_vertices).volume();
+  }
+  return volume;
+}
+
+TEST(TetMeshStreamWriter, StreamInteriorVoxels) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const real_t voxel_size = 0.1;
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), voxel_size, SignedDistanceField::kSignModeScanlineParity));
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(MeshInteriorVoxels(sdf, tet_mesh));
+
+  // the streamed file has the bytes of the exported mesh
+  const std::filesystem::path directory = std::filesystem::temp_directory_path();
+  for(bool is_binary : {false, true}) {
+    const std::filesystem::path exported_path = directory / "sphere_voxels_exported.vtk";
+    const std::filesystem::path streamed_path = directory / "sphere_voxels_streamed.vtk";
+    EXPECT_TRUE(tet_mesh.exportToVTK(exported_path.string(), is_binary));
+
+    TetMeshStreamWriter writer;
+    EXPECT_TRUE(writer.open(streamed_path.string(), is_binary));
+    EXPECT_TRUE(StreamInteriorVoxels(sdf, writer));
+    EXPECT_EQ(writer.countVertices(), tet_mesh.countVertices());
+    EXPECT_EQ(writer.countCells(), tet_mesh.countCells());
+
+    // the boundary encloses the voxels
+    std::vector<vec3> boundary_vertices;
+    std::vector<vec3i> boundary_faces;
+    EXPECT_TRUE(writer.extractBoundary(boundary_vertices, boundary_faces));
+    std::vector<HalfFaceIndex> boundary_hfaces;
+    EXPECT_EQ(boundary_faces.size(), tet_mesh.getBoundaryHalfFaces(boundary_hfaces));
+    EXPECT_NEAR(EnclosedVolume(boundary_vertices, boundary_faces),
+                tet_mesh.countCells() / 6 * std::pow(voxel_size, 3.0), 1e-9);
+    for(const vec3& p : boundary_vertices) {
+      EXPECT_LT(p.norm(), 1.0);
+    }
+
+    EXPECT_TRUE(writer.close());
+    EXPECT_FALSE(writer.isOpen());
+    EXPECT_EQ(ReadFileBytes(streamed_path), ReadFileBytes(exported_path));
+    EXPECT_FALSE(std::filesystem::exists(streamed_path.string() + ".cells.tmp"));
+  }
+
+  TetMeshStreamWriter writer;
+  EXPECT_FALSE(StreamInteriorVoxels(sdf, writer));
+  EXPECT_TRUE(writer.open((directory / "sphere_voxels_none.vtk").string(), true));
+  EXPECT_FALSE(StreamInteriorVoxels(sdf, writer, 0));
+}
+
+TEST(TetMeshStreamWriter, WriteChunks) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), 0.1, SignedDistanceField::kSignModeScanlineParity));
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(StuffIsosurface(sdf, 0.2, tet_mesh));
+  std::vector<vec3> vertices;
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(tet_mesh.writeToList(vertices, cells));
+
+  std::vector<uint32_t> labels(cells.size());
+  for(size_t i = 0; i < cells.size(); i++) {
+    labels[i] = (vertices[cells[i][0]].x() < 0.0) ? 0 : 1;
+  }
+  EXPECT_TRUE(tet_mesh.setCellLabels(labels));
+
+  const std::filesystem::path directory = std::filesystem::temp_directory_path();
+  const std::filesystem::path exported_path = directory / "sphere_stuffed_exported.vtk";
+  const std::filesystem::path streamed_path = directory / "sphere_stuffed_streamed.vtk";
+  EXPECT_TRUE(tet_mesh.exportToVTK(exported_path.string(), true));
+
+  // the cells may come before their vertices
+  TetMeshStreamWriter writer;
+  EXPECT_TRUE(writer.open(streamed_path.string(), true));
+  const size_t chunk_size = 1000;
+  for(size_t begin = 0; begin < cells.size(); begin += chunk_size) {
+    const size_t end = std::min(begin + chunk_size, cells.size());
+    EXPECT_TRUE(writer.writeCells(std::vector<vec4i>(cells.begin() + begin, cells.begin() + end),
+                                  std::vector<uint32_t>(labels.begin() + begin, labels.begin() + end)));
+  }
+  EXPECT_FALSE(writer.writeCells(cells));
+  EXPECT_FALSE(writer.writeCells(cells, std::vector<uint32_t>(1, 0)));
+
+  std::vector<vec3> boundary_vertices;
+  std::vector<vec3i> boundary_faces;
+  EXPECT_FALSE(writer.extractBoundary(boundary_vertices, boundary_faces));
+  EXPECT_TRUE(writer.writeVertices(vertices));
+  EXPECT_TRUE(writer.extractBoundary(boundary_vertices, boundary_faces));
+
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(boundary_faces.size(), tet_mesh.getBoundaryHalfFaces(boundary_hfaces));
+  EXPECT_NEAR(EnclosedVolume(boundary_vertices, boundary_faces), CellsVolume(vertices, cells), 1e-9);
+
+  EXPECT_TRUE(writer.close());
+  EXPECT_EQ(ReadFileBytes(streamed_path), ReadFileBytes(exported_path));
+
+  // the lattice stream holds the cells of the mesh, numbered slab by slab
+  EXPECT_TRUE(writer.open(streamed_path.string(), false));
+  EXPECT_TRUE(StuffIsosurface(sdf, 0.2, writer));
+  EXPECT_EQ(writer.countVertices(), vertices.size());
+  EXPECT_EQ(writer.countCells(), cells.size());
+  EXPECT_TRUE(writer.extractBoundary(boundary_vertices, boundary_faces));
+  EXPECT_EQ(boundary_faces.size(), boundary_hfaces.size());
+  EXPECT_NEAR(EnclosedVolume(boundary_vertices, boundary_faces), CellsVolume(vertices, cells), 1e-9);
+  EXPECT_TRUE(writer.close());
+
+  // the cells must refer to written vertices
+  EXPECT_TRUE(writer.open(streamed_path.string(), false));
+  EXPECT_FALSE(writer.close());
+  EXPECT_TRUE(writer.open(streamed_path.string(), false));
+  EXPECT_FALSE(writer.writeCells({vec4i(0, 1, 2, -1)}));
+  EXPECT_TRUE(writer.writeCells({vec4i(0, 1, 2, 3)}));
+  EXPECT_FALSE(writer.close());
+  EXPECT_FALSE(writer.writeVertices(vertices));
+}
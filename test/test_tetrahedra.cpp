@@ -9,6 +9,7 @@
 #include "volmesh/tetrahedra.h"
 
 #include <gtest/gtest.h>
+#include <cmath>
 
 using namespace volmesh;
 
@@ -69,6 +70,29 @@ TEST(Tetrahedra, DeterminantVolume) {
   EXPECT_NEAR(volume, volume_gt, kEpsilon);
 }
 
+TEST(Tetrahedra, DihedralAngles) {
+  // all dihedral angles of a regular tetrahedron are acos(1/3)
+  Tetrahedra::TetraVertexArray regular;
+  regular << 1, 1, -1, -1,
+             1, -1, 1, -1,
+             1, -1, -1, 1;
+  for(real_t angle : Tetrahedra(regular).dihedralAngles()) {
+    EXPECT_NEAR(angle, std::acos(1.0 / 3.0), kEpsilon);
+  }
+
+  // the corner of a cube has three right angles at the origin
+  Tetrahedra::TetraVertexArray corner;
+  corner << 0, 1, 0, 0,
+            0, 0, 1, 0,
+            0, 0, 0, 1;
+  const auto angles = Tetrahedra(corner).dihedralAngles();
+  for(int e = 0; e < Tetrahedra::kNumEdges; e++) {
+    const vec2i edge = Tetrahedra::edgeVertexIdsLut(e);
+    const real_t expected = (edge.x() == 0 || edge.y() == 0) ? M_PI / 2.0 : std::acos(1.0 / std::sqrt(3.0));
+    EXPECT_NEAR(angles[e], expected, kEpsilon);
+  }
+}
+
 TEST(Tetrahedra, faceVertexIdsLut) {
   static const vec3i kFaceVertexIdsLut[Tetrahedra::kNumFaces] = { {1, 2, 3}, {2, 0, 3}, {3, 0, 1}, {1, 0, 2} };
 
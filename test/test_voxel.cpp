@@ -7,6 +7,7 @@
 //-----------------------------------------------------------------------------
 
 #include "volmesh/voxel.h"
+#include "volmesh/tetrahedra.h"
 
 #include <gtest/gtest.h>
 
@@ -82,4 +83,26 @@ TEST(Voxel, Volume) {
 
   //2 x 4 x 8 = 64
   EXPECT_EQ(v1.volume(), 64);
-}
\ No newline at end of file
+}
+
+TEST(Voxel, FittingTetrahedra) {
+  Voxel v1(kVoxelVertices);
+
+  // the tetrahedra fill the voxel and are oriented like the cells of a TetMesh
+  real_t volume = 0.0;
+  for(int i=0; i < Voxel::kNumFittingTetrahedra; i++) {
+    const vec4i tet_lut = Voxel::fittingTetrahedraVertexIdsLut(i);
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int j=0; j < 4; j++) {
+      tet_vertices.col(j) = v1.vertex(tet_lut[j]);
+      EXPECT_EQ(v1.vertex(tet_lut[j]), v1.vertex(Voxel::LBN) + Voxel::vertexOffsetLut(tet_lut[j]).cast<real_t>().cwiseProduct(vec3(2, 4, 8)));
+    }
+
+    Tetrahedra tet(tet_vertices);
+    EXPECT_LT(tet.determinant(), 0.0);
+    volume += tet.volume();
+  }
+
+  EXPECT_NEAR(volume, v1.volume(), 1e-9);
+  EXPECT_THROW(Voxel::fittingTetrahedraVertexIdsLut(Voxel::kNumFittingTetrahedra), std::out_of_range);
+}
@@ -0,0 +1,170 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/basetypes.h"
+#include "volmesh/parallel.h"
+#include "volmesh/signeddistancefield.h"
+#include "volmesh/tetmesh.h"
+#include "volmesh/tetrahedra.h"
+#include "volmesh/trianglemesh.h"
+#include "volmesh/voxeltetmesher.h"
+#include "testmeshes.h"
+
+#include <gtest/gtest.h>
+#include <array>
+#include <cmath>
+#include <vector>
+
+using namespace volmesh;
+
+TEST(VoxelTetMesher, MeshSphereInterior) {
+  TriangleMesh tmesh;
+  CreateSphere(1.0, 24, 48, tmesh);
+
+  const real_t voxel_size = 0.1;
+  SignedDistanceField sdf;
+  EXPECT_TRUE(sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), voxel_size, SignedDistanceField::kSignModeScanlineParity));
+
+  // the selected voxels have all their corners inside
+  std::vector<uint8_t> voxel_mask;
+  const uint64_t count_selected = ClassifyInteriorVoxels(sdf, Voxel::kNumVerticesPerCell, voxel_mask);
+  EXPECT_GT(count_selected, 0);
+
+  const vec3i voxels_count = sdf.voxelsCount();
+  auto is_selected = [&](const vec3i& v) {
+    return (v.array() >= 0).all() && (v.array() < voxels_count.array()).all() &&
+           voxel_mask[(v.z() * voxels_count.y() + v.y()) * voxels_count.x() + v.x()] != 0;
+  };
+
+  uint64_t count_exposed_sides = 0;
+  for(int z = 0; z < voxels_count.z(); z++) {
+    for(int y = 0; y < voxels_count.y(); y++) {
+      for(int x = 0; x < voxels_count.x(); x++) {
+        const vec3i v(x, y, z);
+        if(is_selected(v) == false) {
+          continue;
+        }
+
+        for(int c = 0; c < Voxel::kNumVerticesPerCell; c++) {
+          EXPECT_LT(sdf.fieldValue(vec3i(v + Voxel::vertexOffsetLut(c))), 0.0);
+        }
+
+        for(int axis = 0; axis < 3; axis++) {
+          const vec3i step = vec3i::Unit(axis);
+          count_exposed_sides += is_selected(v - step) ? 0 : 1;
+          count_exposed_sides += is_selected(v + step) ? 0 : 1;
+        }
+      }
+    }
+  }
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(MeshInteriorVoxels(sdf, tet_mesh));
+  EXPECT_EQ(tet_mesh.countCells(), count_selected * Voxel::kNumFittingTetrahedra);
+
+  // the tetrahedra fill the selected voxels inside the sphere
+  std::vector<vec3> vertices;
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(tet_mesh.writeToList(vertices, cells));
+  real_t volume = 0.0;
+  for(const vec4i& cell : cells) {
+    Tetrahedra::TetraVertexArray tet_vertices;
+    for(int i = 0; i < 4; i++) {
+      tet_vertices.col(i) = vertices[cell[i]];
+      EXPECT_LT(vertices[cell[i]].norm(), 1.0);
+    }
+
+    const Tetrahedra tet(tet_vertices);
+    EXPECT_LT(tet.determinant(), 0.0);
+    volume += tet.volume();
+  }
+  EXPECT_NEAR(volume, count_selected * std::pow(voxel_size, 3.0), 1e-9);
+
+  // every exposed side of a selected voxel holds two boundary triangles
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), count_exposed_sides * 2);
+
+  // the output does not depend on the number of threads
+  SetMaxThreadsCount(1);
+  TetMesh serial_mesh;
+  EXPECT_TRUE(MeshInteriorVoxels(sdf, serial_mesh));
+  SetMaxThreadsCount(0);
+
+  std::vector<vec3> serial_vertices;
+  std::vector<vec4i> serial_cells;
+  EXPECT_TRUE(serial_mesh.writeToList(serial_vertices, serial_cells));
+  EXPECT_EQ(serial_vertices, vertices);
+  EXPECT_EQ(serial_cells, cells);
+
+  // voxels crossing the surface are added with fewer inside corners
+  TetMesh coarse_mesh;
+  EXPECT_TRUE(MeshInteriorVoxels(sdf, coarse_mesh, 1));
+  EXPECT_GT(coarse_mesh.countCells(), tet_mesh.countCells());
+
+  EXPECT_FALSE(MeshInteriorVoxels(sdf, coarse_mesh, 0));
+  EXPECT_FALSE(MeshInteriorVoxels(sdf, coarse_mesh, Voxel::kNumVerticesPerCell + 1));
+}
+
+TEST(VoxelTetMesher, MeshTwoMaterials) {
+  TriangleMesh tmesh;
+  CreateSphere(0.5, 24, 48, tmesh);
+
+  SignedDistanceField sphere_sdf;
+  EXPECT_TRUE(sphere_sdf.generate(tmesh, vec3(0.2, 0.2, 0.2), 0.05, SignedDistanceField::kSignModeScanlineParity));
+
+  // two overlapping spheres on one grid, centered at -0.3 and 0.3 along x
+  const real_t voxel_size = 0.05;
+  const AABB bounds(vec3(-1.0, -0.7, -0.7), vec3(1.0, 0.7, 0.7));
+  std::array<SignedDistanceField, 2> sdfs;
+  for(int i = 0; i < 2; i++) {
+    mat4 transform = mat4::Identity();
+    transform(0, 3) = (i == 0) ? 0.3 : -0.3;
+    EXPECT_TRUE(sdfs[i].resample(sphere_sdf, bounds, voxel_size, SignedDistanceField::kInterpolationTrilinear, transform));
+  }
+
+  TetMesh tet_mesh;
+  EXPECT_TRUE(MeshMaterialVoxels({&sdfs[0], &sdfs[1]}, tet_mesh));
+  EXPECT_TRUE(tet_mesh.hasCellLabels());
+  EXPECT_EQ(tet_mesh.cellLabels().size(), tet_mesh.countCells());
+
+  // the materials fill the union without gaps, so the mesh matches the one of the union field
+  SignedDistanceField union_sdf(sdfs[0]);
+  EXPECT_TRUE(union_sdf.combine(sdfs[1], SignedDistanceField::kCsgUnion));
+  TetMesh union_mesh;
+  EXPECT_TRUE(MeshInteriorVoxels(union_sdf, union_mesh));
+  EXPECT_FALSE(union_mesh.hasCellLabels());
+  EXPECT_EQ(tet_mesh.countCells(), union_mesh.countCells());
+
+  std::vector<HalfFaceIndex> boundary_hfaces;
+  std::vector<HalfFaceIndex> union_boundary_hfaces;
+  EXPECT_EQ(tet_mesh.getBoundaryHalfFaces(boundary_hfaces), union_mesh.getBoundaryHalfFaces(union_boundary_hfaces));
+
+  // the cells away from the overlap belong to their sphere
+  std::vector<vec3> vertices;
+  std::vector<vec4i> cells;
+  EXPECT_TRUE(tet_mesh.writeToList(vertices, cells));
+  uint64_t count_labels[2] = {0, 0};
+  for(uint32_t i = 0; i < cells.size(); i++) {
+    const vec3 centroid = 0.25 * (vertices[cells[i][0]] + vertices[cells[i][1]] + vertices[cells[i][2]] + vertices[cells[i][3]]);
+    const uint32_t label = tet_mesh.cellLabel(CellIndex::create(i));
+    EXPECT_LT(label, 2u);
+    count_labels[label]++;
+    if(std::abs(centroid.x()) > 0.25) {
+      EXPECT_EQ(label, (centroid.x() < 0.0) ? 0u : 1u);
+    }
+  }
+  // the first sphere takes the ties in the overlap
+  EXPECT_GT(count_labels[1], 0);
+  EXPECT_GT(count_labels[0], count_labels[1]);
+
+  EXPECT_THROW(tet_mesh.cellLabel(CellIndex::create(tet_mesh.countCells())), std::out_of_range);
+  EXPECT_FALSE(tet_mesh.setCellLabels(std::vector<uint32_t>(1, 0)));
+
+  // the fields must share a grid
+  EXPECT_FALSE(MeshMaterialVoxels({&sdfs[0], &sphere_sdf}, tet_mesh));
+}
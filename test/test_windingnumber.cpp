@@ -0,0 +1,128 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#include "volmesh/windingnumber.h"
+#include "volmesh/trianglemesh.h"
+
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace volmesh;
+
+// outward oriented faces of the unit cube, vertex id = x * 4 + y * 2 + z
+static const std::vector<vec3i> kCubeFaces = {
+  vec3i(0, 1, 3), vec3i(0, 3, 2),
+  vec3i(4, 6, 7), vec3i(4, 7, 5),
+  vec3i(0, 4, 5), vec3i(0, 5, 1),
+  vec3i(2, 3, 7), vec3i(2, 7, 6),
+  vec3i(0, 2, 6), vec3i(0, 6, 4),
+  vec3i(1, 5, 7), vec3i(1, 7, 3)
+};
+
+static vec3 CubeVertex(int id) {
+  return vec3((id >> 2) & 1, (id >> 1) & 1, id & 1);
+}
+
+// builds the unit cube as a triangle soup where every face is split into 4^levels triangles
+static void CreateSubdividedCube(int levels, TriangleMesh& out_mesh) {
+  std::vector<std::array<vec3, 3>> triangles;
+  for(const auto& f : kCubeFaces) {
+    triangles.push_back({CubeVertex(f[0]), CubeVertex(f[1]), CubeVertex(f[2])});
+  }
+
+  for(int level = 0; level < levels; level++) {
+    std::vector<std::array<vec3, 3>> subdivided;
+    for(const auto& t : triangles) {
+      const vec3 ab = (t[0] + t[1]) * 0.5;
+      const vec3 bc = (t[1] + t[2]) * 0.5;
+      const vec3 ca = (t[2] + t[0]) * 0.5;
+      subdivided.push_back({t[0], ab, ca});
+      subdivided.push_back({ab, t[1], bc});
+      subdivided.push_back({ca, bc, t[2]});
+      subdivided.push_back({ab, bc, ca});
+    }
+    triangles.swap(subdivided);
+  }
+
+  std::vector<vec3> vertices;
+  for(const auto& t : triangles) {
+    vertices.insert(vertices.end(), t.begin(), t.end());
+  }
+
+  out_mesh.insertAllVertices(vertices);
+  for(uint32_t i = 0; i < triangles.size(); i++) {
+    out_mesh.insertTriangle(i * 3, i * 3 + 1, i * 3 + 2);
+  }
+}
+
+TEST(WindingNumberTree, EmptyMesh) {
+  TriangleMesh tmesh;
+  WindingNumberTree tree;
+  EXPECT_FALSE(tree.build(tmesh));
+  EXPECT_EQ(tree.countNodes(), 0);
+  EXPECT_EQ(tree.windingNumber(vec3(0.0, 0.0, 0.0)), 0.0);
+}
+
+TEST(WindingNumberTree, ClosedCube) {
+  TriangleMesh tmesh;
+  CreateSubdividedCube(0, tmesh);
+
+  WindingNumberTree tree;
+  EXPECT_TRUE(tree.build(tmesh));
+  EXPECT_EQ(tree.countTriangles(), 12);
+
+  EXPECT_NEAR(tree.windingNumber(vec3(0.5, 0.5, 0.5)), 1.0, 1e-9);
+  EXPECT_NEAR(tree.windingNumber(vec3(0.05, 0.9, 0.2)), 1.0, 1e-9);
+  EXPECT_NEAR(tree.windingNumber(vec3(1.5, 0.5, 0.5)), 0.0, 1e-9);
+  EXPECT_NEAR(tree.windingNumber(vec3(-3.0, 2.0, 7.0)), 0.0, 1e-9);
+}
+
+TEST(WindingNumberTree, HierarchicalMatchesExact) {
+  TriangleMesh tmesh;
+  CreateSubdividedCube(3, tmesh);
+
+  WindingNumberTree tree;
+  EXPECT_TRUE(tree.build(tmesh));
+  EXPECT_EQ(tree.countTriangles(), 12 * 64);
+  EXPECT_GT(tree.countNodes(), 1);
+
+  const std::vector<vec3> points = {
+    vec3(0.5, 0.5, 0.5), vec3(0.1, 0.2, 0.9), vec3(0.95, 0.5, 0.05),
+    vec3(1.1, 0.5, 0.5), vec3(-0.2, -0.2, -0.2), vec3(4.0, 0.0, 0.0)
+  };
+
+  for(const auto& p : points) {
+    const real_t exact = tree.exactWindingNumber(p);
+    const real_t approx = tree.windingNumber(p);
+    EXPECT_NEAR(approx, exact, 5e-2);
+    EXPECT_EQ(approx > 0.5, exact > 0.5);
+  }
+}
+
+TEST(WindingNumberTree, OpenCube) {
+  TriangleMesh tmesh;
+
+  // the cube without its top face
+  std::vector<vec3> vertices;
+  for(int i = 0; i < 8; i++) {
+    vertices.push_back(CubeVertex(i));
+  }
+  tmesh.insertAllVertices(vertices);
+  for(size_t i = 0; i < kCubeFaces.size() - 2; i++) {
+    tmesh.insertTriangle(kCubeFaces[i]);
+  }
+
+  WindingNumberTree tree;
+  EXPECT_TRUE(tree.build(tmesh));
+
+  const real_t w_inside = tree.windingNumber(vec3(0.5, 0.5, 0.2));
+  EXPECT_GT(w_inside, 0.5);
+  EXPECT_LT(w_inside, 1.0);
+
+  EXPECT_LT(tree.windingNumber(vec3(0.5, 0.5, 2.0)), 0.5);
+}
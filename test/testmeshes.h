@@ -0,0 +1,66 @@
+//-----------------------------------------------------------------------------
+// Copyright (c) Pourya Shirazian
+// All rights reserved.
+//
+// This source code is licensed under the MIT license found in the
+// LICENSE file in the root directory of this source tree.
+//-----------------------------------------------------------------------------
+
+#pragma once
+
+#include "volmesh/basetypes.h"
+#include "volmesh/trianglemesh.h"
+
+#include <cmath>
+#include <vector>
+
+namespace volmesh {
+
+/**
+ * @brief Creates a closed UV sphere with counter clockwise triangles when seen from outside.
+ *
+ * The half-edge and vertex pseudo normals are computed, so the mesh is ready for every sign mode
+ * of the signed distance field.
+ *
+ * @param radius The radius of the sphere.
+ * @param stacks The number of rings between the poles, plus one.
+ * @param slices The number of vertices per ring.
+ * @param out_mesh The empty mesh that receives the sphere.
+ * @param center The center of the sphere.
+ */
+inline void CreateSphere(real_t radius, int stacks, int slices, TriangleMesh& out_mesh,
+                         const vec3& center = vec3(0.0, 0.0, 0.0)) {
+  std::vector<vec3> vertices;
+  vertices.push_back(center + vec3(0.0, 0.0, radius));
+  for(int i = 1; i < stacks; i++) {
+    const real_t theta = M_PI * static_cast<real_t>(i) / static_cast<real_t>(stacks);
+    for(int j = 0; j < slices; j++) {
+      const real_t phi = 2.0 * M_PI * static_cast<real_t>(j) / static_cast<real_t>(slices);
+      vertices.push_back(center + radius * vec3(std::sin(theta) * std::cos(phi),
+                                                std::sin(theta) * std::sin(phi),
+                                                std::cos(theta)));
+    }
+  }
+  vertices.push_back(center + vec3(0.0, 0.0, -radius));
+  out_mesh.insertAllVertices(vertices);
+
+  const int south = static_cast<int>(vertices.size()) - 1;
+  auto ring = [slices](int i, int j) { return 1 + (i - 1) * slices + (j % slices); };
+
+  for(int j = 0; j < slices; j++) {
+    out_mesh.insertTriangle(vec3i(0, ring(1, j), ring(1, j + 1)));
+    out_mesh.insertTriangle(vec3i(south, ring(stacks - 1, j + 1), ring(stacks - 1, j)));
+  }
+
+  for(int i = 1; i < stacks - 1; i++) {
+    for(int j = 0; j < slices; j++) {
+      out_mesh.insertTriangle(vec3i(ring(i, j), ring(i + 1, j), ring(i + 1, j + 1)));
+      out_mesh.insertTriangle(vec3i(ring(i, j), ring(i + 1, j + 1), ring(i, j + 1)));
+    }
+  }
+
+  out_mesh.computeHalfEdgePseudoNormals();
+  out_mesh.computeVertexPseudoNormals();
+}
+
+}